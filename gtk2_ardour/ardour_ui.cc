@@ -1142,6 +1142,10 @@ void
 ARDOUR_UI::every_point_one_seconds ()
 {
 	if (editor) editor->build_region_boundary_cache();
+
+	if (_session) {
+		_session->update_playback_lookaheads ();
+	}
 }
 
 void
@@ -1353,8 +1357,15 @@ ARDOUR_UI::update_peak_thread_work ()
 		const char* const bg = c > 2 ? " background=\"red\" foreground=\"white\"" : "";
 		snprintf (buf, sizeof (buf), "<span %s>%d</span>", bg, c);
 		peak_thread_work_label.set_markup (label + buf);
+
+		uint32_t done, total;
+		SourceFactory::peak_work_progress (done, total);
+		if (total > 0) {
+			ArdourWidgets::set_tooltip (peak_thread_work_label, string_compose (_("Peak-files built: %1 of %2"), done, total));
+		}
 	} else {
 		peak_thread_work_label.set_markup (X_(""));
+		ArdourWidgets::set_tooltip (peak_thread_work_label, X_(""));
 	}
 }
 
@@ -37,6 +37,7 @@
 #include "ardour/audiosource.h"
 #include "ardour/profile.h"
 #include "ardour/session.h"
+#include "ardour/source_factory.h"
 
 #include "pbd/memento_command.h"
 #include "pbd/stacktrace.h"
@@ -1224,6 +1225,12 @@ AudioRegionView::create_waves ()
 				// we'll get a PeaksReady signal from the source in the future
 				// and will call create_one_wave(n) then.
 				pending_peak_data->show ();
+
+				/* build peaks of regions in the visible time range first */
+				PublicEditor& e (trackview.editor ());
+				if (_region->coverage (e.leftmost_sample (), e.leftmost_sample () + e.current_page_samples ()) != Evoral::OverlapNone) {
+					SourceFactory::prioritize_peakfile (audio_region()->audio_source(n));
+				}
 			}
 
 		} else {
@@ -81,10 +81,12 @@
 #include "ardour/audioregion.h"
 #include "ardour/lmath.h"
 #include "ardour/location.h"
+#include "ardour/playlist.h"
 #include "ardour/profile.h"
 #include "ardour/route.h"
 #include "ardour/route_group.h"
 #include "ardour/session_playlists.h"
+#include "ardour/source_factory.h"
 #include "ardour/tempo.h"
 #include "ardour/utils.h"
 #include "ardour/vca_manager.h"
@@ -4719,6 +4721,47 @@ Editor::visual_changer (const VisualChange& vc)
 
 	_region_peak_cursor->hide ();
 	_summary->set_overlays_dirty ();
+
+	prioritize_visible_peakfiles ();
+}
+
+/** Move sources of regions which are on screen to the front
+ * of the peak-file building queue.
+ */
+void
+Editor::prioritize_visible_peakfiles ()
+{
+	if (!_session || SourceFactory::peak_work_queue_length () == 0) {
+		return;
+	}
+
+	double const      min_y = vertical_adjustment.get_value ();
+	double const      max_y = min_y + vertical_adjustment.get_page_size ();
+	samplepos_t const start = _leftmost_sample;
+	samplepos_t const end   = _leftmost_sample + current_page_samples ();
+
+	for (TrackViewList::const_iterator i = track_views.begin (); i != track_views.end (); ++i) {
+		if ((*i)->hidden () || (*i)->y_position () > max_y || (*i)->y_position () + (*i)->effective_height () < min_y) {
+			continue;
+		}
+
+		RouteTimeAxisView* rtv = dynamic_cast<RouteTimeAxisView*> (*i);
+		if (!rtv || !rtv->is_audio_track ()) {
+			continue;
+		}
+
+		boost::shared_ptr<RegionList> rl = rtv->track ()->playlist ()->regions_touched (start, end);
+
+		for (RegionList::const_iterator r = rl->begin (); r != rl->end (); ++r) {
+			boost::shared_ptr<AudioRegion> ar = boost::dynamic_pointer_cast<AudioRegion> (*r);
+			if (!ar) {
+				continue;
+			}
+			for (uint32_t n = 0; n < ar->n_channels (); ++n) {
+				SourceFactory::prioritize_peakfile (ar->audio_source (n));
+			}
+		}
+	}
 }
 
 struct EditorOrderTimeAxisSorter {
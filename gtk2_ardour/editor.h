@@ -1159,6 +1159,7 @@ private:
 	int idle_visual_changer ();
 	void visual_changer (const VisualChange&);
 	void ensure_visual_change_idle_handler ();
+	void prioritize_visible_peakfiles ();
 
 	/* track views */
 	TrackViewList track_views;
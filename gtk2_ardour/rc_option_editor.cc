@@ -2320,6 +2320,73 @@ RCOptionEditor::RCOptionEditor ()
 		procs->set_note (string_compose (_("This setting will only take effect when %1 is restarted."), PROGRAM_NAME));
 
 		add_option (_("General"), procs);
+
+		ComboOption<GraphSchedulerModel>* gsm = new ComboOption<GraphSchedulerModel> (
+				"graph-scheduler",
+				_("Parallel processing scheduler"),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::get_graph_scheduler),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::set_graph_scheduler)
+				);
+
+		gsm->add (SharedTriggerQueue, _("shared queue"));
+		gsm->add (WorkStealing, _("work-stealing"));
+
+		Gtkmm2ext::UI::instance()->set_tip (gsm->tip_widget(),
+				_("With work-stealing each processing thread keeps its own queue and prefers to process routes fed by the route it just processed. This reduces contention on systems with many CPU cores."));
+
+		add_option (_("General"), gsm);
+
+		ComboOption<uint32_t>* spin = new ComboOption<uint32_t> (
+				"graph-spin-usec",
+				_("Processing threads wait for work by"),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::get_graph_spin_usec),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::set_graph_spin_usec)
+				);
+
+		spin->add (0, _("sleeping"));
+		spin->add (10, _("spinning up to 10 usec, then sleeping"));
+		spin->add (25, _("spinning up to 25 usec, then sleeping"));
+		spin->add (50, _("spinning up to 50 usec, then sleeping"));
+		spin->add (100, _("spinning up to 100 usec, then sleeping"));
+
+		Gtkmm2ext::UI::instance()->set_tip (spin->tip_widget(),
+				_("Spinning avoids the overhead of putting a processing thread to sleep and waking it up again, at the cost of additional CPU usage. This can help at small buffer sizes. The actual spin-time adapts to how often spinning was successful."));
+
+		add_option (_("General"), spin);
+
+		bo = new BoolOption (
+				"route-pipelining",
+				_("Split plugin chains of busses across processors"),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::get_route_pipelining),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::set_route_pipelining)
+				);
+		Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
+				_("When enabled, busses with two or more plugins process the second half of their plugins concurrently with the first half. This adds one cycle of latency to these busses, which is compensated."));
+		add_option (_("General"), bo);
+
+		bo = new BoolOption (
+				"anticipative-processing",
+				_("Process plugins of playing tracks ahead of time"),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::get_anticipative_processing),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::set_anticipative_processing)
+				);
+		Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
+				_("When enabled, the plugins of audio tracks that play from disk and are not record-armed are processed by background threads, ahead of the playhead. This leaves more time in each process cycle to tracks that are monitored live. Changes to plugin parameters are heard with a delay of up to the lookahead."));
+		add_option (_("General"), bo);
+
+		ComboOption<uint32_t>* ahead = new ComboOption<uint32_t> (
+				"anticipative-lookahead",
+				_("Process ahead by"),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::get_anticipative_lookahead),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::set_anticipative_lookahead)
+				);
+
+		ahead->add (4096, _("4096 samples"));
+		ahead->add (8192, _("8192 samples"));
+		ahead->add (16384, _("16384 samples"));
+		ahead->add (32768, _("32768 samples"));
+
+		add_option (_("General"), ahead);
 	}
 
 	/* Image cache size */
@@ -2435,6 +2502,36 @@ RCOptionEditor::RCOptionEditor ()
 		     sigc::mem_fun (*_rc_config, &RCConfiguration::set_periodic_safety_backups)
 		     ));
 
+	bo = new BoolOption (
+		     "save-binary-state",
+		     _("Also save a binary snapshot of the session file"),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::get_save_binary_state),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::set_save_binary_state)
+		     );
+	add_option (_("General/Session"), bo);
+	Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
+			_("When enabled, a compact binary copy of the session state is written next to the .ardour file, which makes loading large sessions faster. The .ardour file remains authoritative: it is used whenever it is newer than the binary copy."));
+
+	bo = new BoolOption (
+		     "incremental-save",
+		     _("Save only changed objects to a session journal"),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::get_incremental_save),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::set_incremental_save)
+		     );
+	add_option (_("General/Session"), bo);
+	Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
+			_("When enabled, saving a large session only writes the routes, playlists, sources and regions that changed since the last complete save to a journal file next to the .ardour file. The journal is merged into the session file when the session is loaded, and a complete save is made when the journal grows too large."));
+
+	bo = new BoolOption (
+		     "lazy-session-load",
+		     _("Load unused playlists and MIDI data only when needed"),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::get_lazy_session_load),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::set_lazy_session_load)
+		     );
+	add_option (_("General/Session"), bo);
+	Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
+			_("When enabled, unused playlists are kept as saved and only created when they are selected or needed otherwise, and MIDI files are only parsed when their notes are first displayed or edited. This makes opening sessions with many alternate takes faster."));
+
 	add_option (_("General/Session"),
 	     new BoolOption (
 		     "only-copy-imported-files",
@@ -3581,6 +3678,46 @@ RCOptionEditor::RCOptionEditor ()
 	Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
 					    _("<b>When enabled</b> plugins will be reset at transport stop. When disabled plugins will be left unchanged at transport stop.\n\nThis mostly affects plugins with a \"tail\" like Reverbs."));
 
+	bo = new BoolOption (
+		"skip-silent-plugins",
+		_("Do not process plugins with silent input"),
+		sigc::mem_fun (*_rc_config, &RCConfiguration::get_skip_silent_plugins),
+		sigc::mem_fun (*_rc_config, &RCConfiguration::set_skip_silent_plugins)
+		);
+	add_option (_("Plugins"), bo);
+	Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
+					    _("<b>When enabled</b> effect plugins are not run while their input is silent, once their tail has decayed. This reduces the DSP load of sessions with many sparse tracks.\n\nPlugins which produce sound without input (e.g. noise generators) will be muted as well."));
+
+	add_option (_("Plugins"),
+	     new SpinOption<double> (
+		     "default-plugin-tail",
+		     _("Tail of plugins which do not report one"),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::get_default_plugin_tail),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::set_default_plugin_tail),
+		     0, 60, 0.5, 5,
+		     _("sec"), 1, 1
+		     ));
+
+	bo = new BoolOption (
+		"render-cache",
+		_("Render CPU-heavy track plugins in the background"),
+		sigc::mem_fun (*_rc_config, &RCConfiguration::get_render_cache),
+		sigc::mem_fun (*_rc_config, &RCConfiguration::set_render_cache)
+		);
+	add_option (_("Plugins"), bo);
+	Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
+					    _("<b>When enabled</b> the effect plugins of audio tracks are rendered to temporary files when the track has not been changed for a while. Playback then uses the rendered files instead of running the plugins, until a plugin, its automation or the track's regions are modified."));
+
+	add_option (_("Plugins"),
+	     new SpinOption<float> (
+		     "render-cache-min-dsp-load",
+		     _("Only render plugins using more than"),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::get_render_cache_min_dsp_load),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::set_render_cache_min_dsp_load),
+		     0, 100, 1, 5,
+		     _("% DSP"), 1, 1
+		     ));
+
 	bo = new BoolOption (
 		"new-plugins-active",
 			_("Make new plugins active"),
@@ -37,6 +37,7 @@
 #include "ardour/audioengine.h"
 #include "ardour/revision.h"
 #include "ardour/session.h"
+#include "ardour/session_playlists.h"
 
 #include "control_protocol/control_protocol.h"
 
@@ -140,6 +141,7 @@ print_help ()
 	     << "  -D, --debug <options>       Set debug flags. Use \"-D list\" to see available options\n"
 	     << "  -O, --no-hw-optimizations   Disable h/w specific optimizations\n"
 	     << "  -P, --no-connect-ports      Do not connect any ports at startup\n"
+	     << "  -T, --timing                Print the time it takes to load the session and exit\n"
 #ifdef WINDOWS_VST_SUPPORT
 	     << "  -V, --novst                 Do not use VST support\n"
 #endif
@@ -149,7 +151,7 @@ print_help ()
 int
 main (int argc, char* argv[])
 {
-	const char* optstring = "vhBdD:c:VOU:P";
+	const char* optstring = "vhBdD:c:VOU:PT";
 
 	/* clang-format off */
 	const struct option longopts[] = {
@@ -162,12 +164,14 @@ main (int argc, char* argv[])
 		{ "novst",               no_argument,       0, 'V' },
 		{ "no-hw-optimizations", no_argument,       0, 'O' },
 		{ "no-connect-ports",    no_argument,       0, 'P' },
+		{ "timing",              no_argument,       0, 'T' },
 		{ 0, 0, 0, 0 }
 	};
 	/* clang-format on */
 
 	bool use_vst             = true;
 	bool try_hw_optimization = true;
+	bool timing              = false;
 
 	backend_client_name = PBD::downcase (std::string (PROGRAM_NAME));
 
@@ -213,6 +217,10 @@ main (int argc, char* argv[])
 				ARDOUR::Port::set_connecting_blocked (true);
 				break;
 
+			case 'T':
+				timing = true;
+				break;
+
 			case 'V':
 #ifdef WINDOWS_VST_SUPPORT
 				use_vst = false;
@@ -238,6 +246,8 @@ main (int argc, char* argv[])
 
 	Session* s = 0;
 
+	const int64_t load_start = g_get_monotonic_time ();
+
 	try {
 		s = load_session (argv[optind], argv[optind + 1]);
 	} catch (failed_constructor& e) {
@@ -254,6 +264,25 @@ main (int argc, char* argv[])
 		exit (EXIT_FAILURE);
 	}
 
+	if (timing && s) {
+		const int64_t load_end = g_get_monotonic_time ();
+
+		/* unused playlists may not have been created while loading,
+		 * measure what this saved.
+		 */
+		s->playlists ()->load_deferred ();
+		const int64_t deferred_end = g_get_monotonic_time ();
+
+		cout << "Session loaded in " << (load_end - load_start) / 1000. << " ms"
+		     << ", deferred playlists loaded in " << (deferred_end - load_end) / 1000. << " ms\n";
+
+		AudioEngine::instance ()->remove_session ();
+		delete s;
+		AudioEngine::instance ()->stop ();
+		AudioEngine::destroy ();
+		return 0;
+	}
+
 	/* allow signal propagation, callback/thread-pool setup, etc
 	 * similar to to GUI "first idle"
 	 */
@@ -165,6 +165,28 @@ public:
 		_written = true;
 	}
 
+	/** Accumulate (add) \p len samples from the start of each of the \p n_src buffers
+	 * \p srcs into self at \p dst_offset, scaling each by the corresponding \p gains
+	 * (unity gain if \p gains is NULL).
+	 *
+	 * This is equivalent to calling accumulate_with_gain_from() for every source,
+	 * except that the destination is only read and written once.
+	 */
+	void accumulate_n_from (const Sample* const* srcs, const gain_t* gains, uint32_t n_src, samplecnt_t len, sampleoffset_t dst_offset = 0)
+	{
+		assert (_capacity > 0);
+		assert (len <= _capacity);
+
+		if (n_src == 0) {
+			return;
+		}
+
+		mix_buffers_n (_data + dst_offset, srcs, gains, n_src, len);
+
+		_silent  = false;
+		_written = true;
+	}
+
 	/** Accumulate (add) \p len samples from the start of \p src into self at \p dst_offset
 	 * using a linear gain ramp from \p initial to \p target .
 	 */
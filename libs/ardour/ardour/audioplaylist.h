@@ -25,6 +25,8 @@
 #include <vector>
 #include <list>
 
+#include <glibmm/threads.h>
+
 #include "ardour/ardour.h"
 #include "ardour/playlist.h"
 
@@ -34,6 +36,7 @@ class Session;
 class AudioRegion;
 class Source;
 class AudioPlaylist;
+class DiskPrefetch;
 
 class LIBARDOUR_API AudioPlaylist : public ARDOUR::Playlist
 {
@@ -45,6 +48,9 @@ public:
 
 	samplecnt_t read (Sample *dst, Sample *mixdown, float *gain_buffer, samplepos_t start, samplecnt_t cnt, uint32_t chan_n=0);
 
+	/** Queue read-ahead of the source data for a subsequent read() of the given range */
+	void prefetch (DiskPrefetch&, samplepos_t start, samplecnt_t cnt);
+
 	bool destroy_region (boost::shared_ptr<Region>);
 
 protected:
@@ -53,7 +59,41 @@ protected:
 	void post_combine (std::vector<boost::shared_ptr<Region> >&, boost::shared_ptr<Region>);
 	void pre_uncombine (std::vector<boost::shared_ptr<Region> >&, boost::shared_ptr<Region>);
 
+	void render_state_changed ();
+
 private:
+	/** A part of a region that is audible, in session samples */
+	struct RenderSegment {
+		boost::shared_ptr<AudioRegion> region;
+		samplepos_t                    from;
+		samplepos_t                    to;
+		samplepos_t                    max_to; ///< max. `to' in the subtree of this segment
+		uint32_t                       order;  ///< position in read order
+
+		bool operator< (RenderSegment const& other) const {
+			return from < other.from;
+		}
+	};
+
+	/** The flattened timeline of the whole playlist: all segments that
+	 *  read() needs to render, sorted by start and forming an implicit
+	 *  interval tree. Reading a range means reading the segments that
+	 *  intersect it, in read order.
+	 *  A plan is immutable once built, and replaced when the playlist
+	 *  changes.
+	 */
+	typedef std::vector<RenderSegment> RenderPlan;
+
+	boost::shared_ptr<RenderPlan const> render_plan ();
+	boost::shared_ptr<RenderPlan const> build_render_plan () const;
+	static samplepos_t build_segment_tree (RenderPlan&, size_t lo, size_t hi);
+	static bool collect_segments (RenderPlan const&, size_t lo, size_t hi, samplepos_t start, samplepos_t end,
+	                              RenderSegment const** hits, size_t& n_hits, size_t max_hits);
+	samplecnt_t read_unplanned (Sample*, Sample*, float*, samplepos_t, samplecnt_t, uint32_t);
+
+	Glib::Threads::Mutex                _render_plan_lock;
+	boost::shared_ptr<RenderPlan const> _render_plan;
+
 	int set_state (const XMLNode&, int version);
 	void dump () const;
 	bool region_changed (const PBD::PropertyChange&, boost::shared_ptr<Region>);
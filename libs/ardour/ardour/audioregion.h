@@ -60,6 +60,7 @@ class Playlist;
 class Session;
 class Filter;
 class AudioSource;
+class DiskPrefetch;
 
 
 class LIBARDOUR_API AudioRegion : public Region
@@ -124,6 +125,9 @@ class LIBARDOUR_API AudioRegion : public Region
 
 	virtual samplecnt_t read_raw_internal (Sample*, samplepos_t, samplecnt_t, int channel) const;
 
+	/** Queue read-ahead for the data needed to read the given range of the timeline */
+	void prefetch (DiskPrefetch&, samplepos_t position, samplecnt_t cnt) const;
+
 	XMLNode& state ();
 	XMLNode& get_basic_state ();
 	int set_state (const XMLNode&, int version);
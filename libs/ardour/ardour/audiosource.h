@@ -41,6 +41,8 @@
 
 namespace ARDOUR {
 
+class DiskPrefetch;
+
 class LIBARDOUR_API AudioSource : virtual public Source,
 		public ARDOUR::Readable
 {
@@ -61,6 +63,11 @@ class LIBARDOUR_API AudioSource : virtual public Source,
 	virtual samplecnt_t read (Sample *dst, samplepos_t start, samplecnt_t cnt, int channel=0) const;
 	virtual samplecnt_t write (Sample *src, samplecnt_t cnt);
 
+	/** Queue read-ahead of the given range. This is only a hint, and
+	 * silently does nothing if the source is currently in use.
+	 */
+	void prefetch (DiskPrefetch&, samplepos_t start, samplecnt_t cnt) const;
+
 	virtual float sample_rate () const = 0;
 
 	virtual void mark_streaming_write_completed (const Lock& lock);
@@ -96,6 +103,7 @@ class LIBARDOUR_API AudioSource : virtual public Source,
 
 	virtual int setup_peakfile () { return 0; }
 	int close_peakfile ();
+	int build_peak_pyramid ();
 
 	int prepare_for_peakfile_writes ();
 	void done_with_peakfile_writes (bool done = true);
@@ -112,6 +120,7 @@ class LIBARDOUR_API AudioSource : virtual public Source,
 
 	int initialize_peakfile (const std::string& path, const bool in_session = false);
 	int build_peaks_from_scratch ();
+	std::string peak_pyramid_path () const;
 	int compute_and_write_peaks (Sample* buf, samplecnt_t first_sample, samplecnt_t cnt,
 	bool force, bool intermediate_peaks_ready_signal);
 	void truncate_peakfile();
@@ -120,6 +129,7 @@ class LIBARDOUR_API AudioSource : virtual public Source,
 
 	virtual samplecnt_t read_unlocked (Sample *dst, samplepos_t start, samplecnt_t cnt) const = 0;
 	virtual samplecnt_t write_unlocked (Sample *dst, samplecnt_t cnt) = 0;
+	virtual void prefetch_unlocked (DiskPrefetch&, samplepos_t /*start*/, samplecnt_t /*cnt*/) const {}
 	virtual std::string construct_peak_filepath (const std::string& audio_path, const bool in_session = false, const bool old_peak_name = false) const = 0;
 
 	virtual int read_peaks_with_fpp (PeakData *peaks,
@@ -130,6 +140,9 @@ class LIBARDOUR_API AudioSource : virtual public Source,
 				     bool force, bool intermediate_peaks_ready_signal,
 				     samplecnt_t samples_per_peak);
 
+	int read_peaks_from_pyramid (PeakData *peaks, samplecnt_t npeaks, samplepos_t start, samplecnt_t cnt,
+	                             double samples_per_visual_peak) const;
+
   private:
 	bool _peaks_built;
 	/** This mutex is used to protect both the _peaks_built
@@ -142,6 +155,9 @@ class LIBARDOUR_API AudioSource : virtual public Source,
         Glib::Threads::Mutex _initialize_peaks_lock;
 
 	int        _peakfile_fd;
+	int        _peak_pyramid_fd;
+	/** incremented whenever the pyramid file is (re)created or removed */
+	gint       _pyramid_generation;
 	samplecnt_t peak_leftover_cnt;
 	samplecnt_t peak_leftover_size;
 	Sample*    peak_leftovers;
@@ -152,6 +168,16 @@ class LIBARDOUR_API AudioSource : virtual public Source,
 	mutable off_t _last_map_off;
 	mutable size_t  _last_raw_map_length;
 	mutable boost::scoped_array<PeakData> peak_cache;
+
+	/* read_peaks_from_pyramid() keeps the pyramid open and re-uses
+	 * its buffer across redraws. Protected by _lock. */
+	mutable int                           _pyramid_read_fd;
+	mutable gint                          _pyramid_read_generation;
+	mutable boost::scoped_array<PeakData> _pyramid_staging;
+	mutable samplecnt_t                   _pyramid_staging_size;
+
+	void update_peak_pyramid (int peak_fd, int pyramid_fd, samplepos_t first_peak, samplecnt_t n_peaks);
+	void pyramid_changed () { g_atomic_int_inc (&_pyramid_generation); }
 };
 
 }
@@ -24,12 +24,16 @@
 #define __ardour_butler_h__
 
 #include <pthread.h>
+#include <vector>
 
 #include <glibmm/threads.h>
 
+#include <boost/scoped_ptr.hpp>
+
 #include "pbd/crossthread.h"
 #include "pbd/ringbuffer.h"
 #include "pbd/pool.h"
+#include "pbd/semutils.h"
 #include "ardour/libardour_visibility.h"
 #include "ardour/types.h"
 #include "ardour/session_handle.h"
@@ -38,6 +42,9 @@
 
 namespace ARDOUR {
 
+class DiskPrefetch;
+class Track;
+
 /**
  *  One of the Butler's functions is to clean up (ie delete) unused CrossThreadPools.
  *  When a thread with a CrossThreadPool terminates, its CTP is added to pool_trash.
@@ -96,6 +103,60 @@ private:
 
 	bool flush_tracks_to_disk_normal (boost::shared_ptr<RouteList>, uint32_t& errors);
 
+	void prefetch_tracks (RouteList const&);
+	boost::scoped_ptr<DiskPrefetch> _prefetch;
+
+	/* parallel disk i/o, used if Config->get_butler_threads() > 1 */
+
+	struct DiskJob {
+		DiskJob (boost::shared_ptr<Track> t, float l)
+			: track (t), load (l), result (0), done (false) {}
+
+		boost::shared_ptr<Track> track;
+		float load;   ///< playback or capture buffer load at the time the job was queued
+		int   result; ///< return value of do_refill() or do_flush()
+		bool  done;   ///< false if the job was skipped due to a transport work request
+
+		/* buffers with the least data to play, or the least space to
+		 * write, are processed first.
+		 */
+		bool operator< (DiskJob const& other) const { return load < other.load; }
+	};
+
+	struct Worker {
+		Worker (Butler* b);
+		~Worker ();
+
+		Butler*   butler;
+		pthread_t thread;
+		/* per thread version of DiskReader's static working buffers */
+		Sample*   sum_buffer;
+		Sample*   mixdown_buffer;
+		gain_t*   gain_buffer;
+	};
+
+	bool refill_tracks_parallel (RouteList const&);
+	bool flush_tracks_to_disk_parallel (boost::shared_ptr<RouteList>, uint32_t& errors);
+
+	void run_jobs (bool refill);
+	void process_jobs (Worker*);
+
+	void reset_workers ();
+	void drop_workers ();
+
+	static void* _worker_thread (void*);
+	void worker_thread (Worker*);
+
+	std::vector<Worker*> _workers;
+	std::vector<DiskJob> _jobs;
+	bool                 _jobs_refill;
+	volatile guint       _next_job;
+	gint                 _workers_active;
+	gint                 _workers_changed;
+
+	PBD::Semaphore _job_run_sem;
+	PBD::Semaphore _job_end_sem;
+
 	/**
 	 * Add request to butler thread request queue
 	 */
@@ -179,6 +179,9 @@ protected:
 	virtual int add_channel_to (boost::shared_ptr<ChannelList>, uint32_t how_many) = 0;
 	int remove_channel_from (boost::shared_ptr<ChannelList>, uint32_t how_many);
 
+	/** @return the number of channels to use for the given input */
+	virtual uint32_t n_channels_for (ChanCount const& in) const { return in.n_audio (); }
+
 	boost::shared_ptr<Playlist> _playlists[DataType::num_types];
 	PBD::ScopedConnectionList playlist_connections;
 
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2026 The Ardour Team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _ardour_disk_prefetch_h_
+#define _ardour_disk_prefetch_h_
+
+#include <stdint.h>
+#include <vector>
+
+#include "ardour/libardour_visibility.h"
+
+namespace ARDOUR {
+
+/** Collects byte ranges of audio files that are about to be read by the
+ * butler, and asks the kernel to start reading them into the page cache,
+ * all at once.
+ *
+ * Ranges are queued by the sources (see AudioSource::prefetch()) and
+ * submitted as one batch. With io_uring (Linux, if built with liburing)
+ * this is a single system call for all tracks, otherwise every range is
+ * passed to posix_fadvise(). The subsequent synchronous reads of each
+ * track then mostly hit the page cache.
+ *
+ * Not thread-safe, this is meant to be used by the butler thread only.
+ */
+class LIBARDOUR_API DiskPrefetch
+{
+public:
+	DiskPrefetch ();
+	~DiskPrefetch ();
+
+	void add (int fd, int64_t offset, int64_t len);
+	void submit ();
+
+	bool   empty () const { return _ranges.empty (); }
+	size_t size () const { return _ranges.size (); }
+
+private:
+	struct Range {
+		Range (int f, int64_t o, int64_t l) : fd (f), offset (o), len (l) {}
+		int     fd;
+		int64_t offset;
+		int64_t len;
+	};
+
+	std::vector<Range> _ranges;
+
+	void reap (bool wait);
+
+	struct Ring;
+	Ring*    _ring;
+	uint32_t _in_flight;
+};
+
+} // namespace ARDOUR
+
+#endif
@@ -33,6 +33,7 @@ namespace ARDOUR
 class Playlist;
 class AudioPlaylist;
 class MidiPlaylist;
+class DiskPrefetch;
 
 template <typename T> class MidiRingBuffer;
 
@@ -79,6 +80,15 @@ public:
 	 */
 	int do_refill ();
 
+	/** As do_refill(), but using the given working buffers instead of the
+	 * static ones, so that several tracks can be refilled concurrently.
+	 * Each buffer must hold at least 2M samples.
+	 */
+	int do_refill (Sample* sum_buffer, Sample* mixdown_buffer, gain_t* gain_buffer);
+
+	/** Queue read-ahead for the data that the next do_refill() will read */
+	void prefetch (DiskPrefetch&);
+
 	/** For contexts outside the normal butler refill loop (allocates temporary working buffers) */
 	int do_refill_with_alloc (bool partial_fill, bool reverse);
 
@@ -99,6 +109,36 @@ public:
 	void playlist_modified ();
 	void reset_tracker ();
 
+	/** Play the given playlist -- a render of the track's plugins, see
+	 * RenderCache -- instead of the track's audio playlist. An empty
+	 * pointer switches back to the track's playlist. This takes effect
+	 * when the playback buffers are next overwritten or refilled.
+	 *
+	 * The render of a MIDI track is the audio output of its instrument,
+	 * with @a n_channels channels: the disk-reader adds playback buffers
+	 * for it, and writes it to the buffers of the instrument's output.
+	 */
+	void set_render_playlist (boost::shared_ptr<AudioPlaylist>, uint32_t n_channels = 0);
+	/** @return the render playlist that the playback buffers are filled from */
+	boost::shared_ptr<AudioPlaylist> render_playlist () const;
+
+	/** @return true if the playback buffers hold data from a render playlist */
+	bool reading_render_cache () const
+	{
+		return g_atomic_int_get (&_reading_render) != 0;
+	}
+
+	/** @return the position of the first sample that the next run() delivers */
+	samplepos_t playback_position () const { return playback_sample; }
+
+	/** Copy the data of channel @a chan that is buffered @a offset samples
+	 * after playback_position(), without consuming it. To be called from
+	 * the process thread, after run().
+	 * @return the number of samples copied, less than @a cnt when the data
+	 * has yet to be read from disk
+	 */
+	samplecnt_t read_ahead (uint32_t chan, Sample* dst, samplecnt_t offset, samplecnt_t cnt) const;
+
 	bool declick_in_progress () const;
 
 	/* inc/dec variants MUST be called as part of the process call tree, before any
@@ -152,6 +192,7 @@ protected:
 	void playlist_ranges_moved (std::list<Evoral::RangeMove<samplepos_t> > const&, bool);
 
 	int add_channel_to (boost::shared_ptr<ChannelList>, uint32_t how_many);
+	uint32_t n_channels_for (ChanCount const&) const;
 
 	class DeclickAmp
 	{
@@ -215,6 +256,17 @@ private:
 	static Declicker   loop_declick_out;
 	static samplecnt_t loop_fade_length;
 
+	mutable Glib::Threads::Mutex     _render_lock;
+	boost::shared_ptr<AudioPlaylist> _render_playlist; ///< butler thread, written with _render_lock held
+	boost::shared_ptr<AudioPlaylist> _pending_render_playlist;
+	bool                             _render_playlist_changed;
+	mutable gint                     _reading_render;
+	gint                             _render_switched;
+	gint                             _render_channels; ///< playback buffers needed for a render, atomic
+
+	void use_pending_render_playlist ();
+	boost::shared_ptr<AudioPlaylist> playback_playlist ();
+
 	samplecnt_t audio_read (Sample*      sum_buffer,
 	                        Sample*      mixdown_buffer,
 	                        float*       gain_buffer,
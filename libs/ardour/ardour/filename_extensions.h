@@ -28,8 +28,11 @@ namespace ARDOUR {
 
 	LIBARDOUR_API extern const char* const template_suffix;
 	LIBARDOUR_API extern const char* const statefile_suffix;
+	LIBARDOUR_API extern const char* const binary_statefile_suffix;
 	LIBARDOUR_API extern const char* const pending_suffix;
+	LIBARDOUR_API extern const char* const journal_suffix;
 	LIBARDOUR_API extern const char* const peakfile_suffix;
+	LIBARDOUR_API extern const char* const peak_pyramid_suffix;
 	LIBARDOUR_API extern const char* const backup_suffix;
 	LIBARDOUR_API extern const char* const temp_suffix;
 	LIBARDOUR_API extern const char* const history_suffix;
@@ -23,6 +23,7 @@
 #ifndef __ardour_graph_h__
 #define __ardour_graph_h__
 
+#include <algorithm>
 #include <list>
 #include <set>
 #include <string>
@@ -30,8 +31,12 @@
 
 #include <boost/shared_ptr.hpp>
 
+#include <glibmm/threads.h>
+
 #include "pbd/mpmc_queue.h"
 #include "pbd/semutils.h"
+#include "pbd/timing.h"
+#include "pbd/work_stealing_deque.h"
 
 #include "ardour/audio_backend.h"
 #include "ardour/libardour_visibility.h"
@@ -71,11 +76,21 @@ public:
 	int routes_no_roll (pframes_t nframes, samplepos_t start_sample, samplepos_t end_sample, bool non_rt_pending);
 
 	void process_one_route (Route* route);
+	void process_one_pipeline_stage (Route& route);
 
 	void clear_other_chain ();
 
 	bool in_process_thread () const;
 
+	/** true if nodes measure their execution time in the current cycle */
+	bool sample_cost () const { return _sample_cost; }
+
+	/** time it takes the graph to wake up for a process callback */
+	PBD::TimingHistogram& wakeup_latency () { return _wakeup_latency; }
+
+	/** time from waking the graph until all routes are processed */
+	PBD::TimingHistogram& execution_time () { return _execution_time; }
+
 protected:
 	virtual void session_going_away ();
 
@@ -86,10 +101,57 @@ private:
 	void main_thread ();
 	void prep ();
 	void dump (int chain) const;
+	void update_priorities (int chain);
+
+	/** order nodes by rank (highest first) */
+	struct RankSort {
+		RankSort (int c) : chain (c) {}
+		bool operator() (GraphNode const*, GraphNode const*) const;
+		bool operator() (node_ptr_t const&, node_ptr_t const&) const;
+		int chain;
+	};
+
+	/** Per process-thread state, used by the WorkStealing scheduler */
+	struct Worker {
+		Worker (guint i, size_t n_nodes)
+			: id (i)
+			, next (0)
+			, deque (std::max<size_t> (n_nodes, 1024))
+			, spin_budget (0)
+		{}
+
+		guint id;
+		/** node that was activated last by this thread, and will be run next.
+		 * It is not counted in _trigger_queue_size, no other thread can run it.
+		 */
+		GraphNode* next;
+		/** nodes that can be processed, other threads may steal from here */
+		PBD::WorkStealingDeque<GraphNode*> deque;
+		/** current spin-time [usec] before going to sleep, see spin_wait() */
+		guint spin_budget;
+	};
+
+	bool pop_work (GraphNode*&, bool& queued);
+	void spin_wait (PBD::Semaphore&, guint& budget);
+	void register_worker (guint id);
+	void drop_workers ();
+
+	std::vector<Worker*> _workers;
+	bool                 _work_stealing;
+
+	static Glib::Threads::Private<Worker> _thread_worker;
 
 	node_list_t _nodes_rt[2];
 	node_list_t _init_trigger_list[2];
 
+	/** all nodes in topological order, used to calculate node priorities */
+	std::vector<GraphNode*> _topo_order[2];
+
+	/** number of cycles since node priorities were last updated */
+	guint _priority_cycle_cnt;
+	/** set in prep (), while all process threads are idle */
+	bool  _sample_cost;
+
 	PBD::MPMCQueue<GraphNode*> _trigger_queue;      ///< nodes that can be processed
 	volatile guint             _trigger_queue_size; ///< number of entries in trigger-queue
 
@@ -103,6 +165,15 @@ private:
 	PBD::Semaphore _callback_start_sem;
 	PBD::Semaphore _callback_done_sem;
 
+	/** max. time [usec] to spin before waiting on a semaphore */
+	guint _spin_usec;
+	guint _callback_start_spin_budget;
+	guint _callback_done_spin_budget;
+
+	int64_t              _callback_start_time;
+	PBD::TimingHistogram _wakeup_latency;
+	PBD::TimingHistogram _execution_time;
+
 	/** The number of unprocessed nodes that do not feed any other node; updated during processing */
 	volatile guint _terminal_refcnt;
 
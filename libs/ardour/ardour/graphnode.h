@@ -23,10 +23,13 @@
 
 #include <list>
 #include <set>
+#include <string>
 #include <vector>
 
 #include <boost/shared_ptr.hpp>
 
+#include "pbd/timing.h"
+
 namespace ARDOUR
 {
 class Graph;
@@ -42,34 +45,53 @@ protected:
 	friend class Graph;
 	/** Nodes that we directly feed */
 	node_set_t _activation_set[2];
+	/** Nodes that we directly feed, ordered by priority (highest rank first) */
+	std::vector<GraphNode*> _activation_list[2];
 	/** The number of nodes that we directly feed us (one count for each chain) */
 	gint _init_refcount[2];
 };
 
-/** A node on our processing graph, ie a Route */
+/** A node on our processing graph, ie a Route or a part of a Route */
 class LIBARDOUR_API GraphNode : public GraphActivision
 {
 public:
 	GraphNode (boost::shared_ptr<Graph> Graph);
 	virtual ~GraphNode ();
 
-	void prep (int chain);
+	virtual void prep (int chain);
 	void trigger ();
 
-	void
-	run (int chain)
-	{
-		process ();
-		finish (chain);
-	}
+	void run (int chain);
 
-private:
-	void finish (int chain);
-	void process ();
+	virtual std::string graph_node_name () const = 0;
+
+protected:
+	virtual void process ();
 
 	boost::shared_ptr<Graph> _graph;
 
+private:
+	friend class Graph;
+
+	void finish (int chain);
+	void update_cost (int chain);
+
 	gint _refcount;
+
+	/** execution time of process (), measured only while the graph samples costs */
+	PBD::Timing _timing;
+	/** accumulated execution time [usec] and number of runs,
+	 * only written by the thread that runs the node
+	 */
+	uint64_t _run_usec;
+	uint64_t _run_cnt;
+	/** _run_usec and _run_cnt at the last update_cost () */
+	uint64_t _cost_usec;
+	uint64_t _cost_cnt;
+	/** average execution time [usec] (one for each chain) */
+	uint64_t _cost[2];
+	/** length of the critical path from this node to the end of the graph [usec] (one for each chain) */
+	uint64_t _rank[2];
 };
 }
 
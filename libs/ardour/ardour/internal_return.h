@@ -53,6 +53,8 @@ private:
 	std::list<InternalSend*> _sends;
 	/** mutex to protect _sends */
 	Glib::Threads::Mutex _sends_mutex;
+	/** audio data of all sends for one channel, used by run() */
+	std::vector<Sample const*> _mix_srcs;
 };
 
 } // namespace ARDOUR
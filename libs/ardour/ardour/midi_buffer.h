@@ -57,6 +57,18 @@ public:
 
 	uint8_t* reserve(TimeType time, Evoral::EventType event_type, size_t size);
 
+	/** Reserve space for events that the caller writes directly, as
+	 * [timestamp, event-type, event] records of record_size() bytes each.
+	 * The space MUST be filled immediately.
+	 * @return the location to write to, or 0 if @param size bytes do not fit
+	 */
+	uint8_t* reserve_records (size_t size);
+
+	/** @return the space that an event of @param size bytes takes in the buffer */
+	static size_t record_size (size_t size) {
+		return align32 (sizeof (TimeType) + sizeof (Evoral::EventType) + size);
+	}
+
 	void resize(size_t);
 	size_t size() const { return _size; }
 	bool empty() const { return _size == 0; }
@@ -27,6 +27,7 @@
 #include <deque>
 #include <queue>
 #include <utility>
+#include <vector>
 
 #include <boost/utility.hpp>
 #include <glibmm/threads.h>
@@ -151,6 +152,8 @@ public:
 
 		std::set<NotePtr> side_effect_removals;
 
+		void affected_notes (std::set<NotePtr>&);
+
 		XMLNode &marshal_change(const NoteChange&);
 		NoteChange unmarshal_change(XMLNode *xml_note);
 
@@ -299,6 +302,30 @@ public:
 	XMLNode& get_state();
 	int set_state(const XMLNode&) { return 0; }
 
+	/** A note as it was at the time of a note edit */
+	struct LIBARDOUR_API NoteSnapshot {
+		NoteSnapshot (Evoral::Note<TimeType> const&);
+
+		TimeType time;
+		TimeType end_time;
+		uint8_t  on[3];
+		uint8_t  off[3];
+	};
+
+	/** The notes that a note edit removed and added; a changed note is
+	 * both removed (as it was before) and added (as it is now).
+	 */
+	struct LIBARDOUR_API NoteDelta {
+		NoteDelta () : complete (true) {}
+
+		std::vector<NoteSnapshot> removed;
+		std::vector<NoteSnapshot> added;
+		bool complete; ///< false if the edit may have changed other notes, too
+	};
+
+	/** Emitted by note edits (and their undo), just before ContentsChanged */
+	PBD::Signal1<void, NoteDelta const&> NotesChanged;
+
 	PBD::Signal0<void> ContentsChanged;
 	PBD::Signal1<void, double> ContentsShifted;
 
@@ -74,6 +74,30 @@ public:
 	void render (MidiChannelFilter*);
 	RTMidiBuffer* rendered();
 
+	/** Render the events of the playlist into the given buffer, rather
+	 * than into the one that the disk-reader plays.
+	 */
+	void render (RTMidiBuffer&, MidiChannelFilter*);
+
+	/** Apply a note edit of one of our regions to the rendered events,
+	 * instead of rendering all of them again.
+	 * @return true if the rendered events are up to date
+	 */
+	bool patch_render (MidiRegion const&, MidiModel::NoteDelta const&);
+
+	/** Held while a change of the playlist's contents is signalled, that
+	 * has already been applied to the rendered events by patch_render().
+	 */
+	class LIBARDOUR_API PatchedChange {
+	  public:
+		PatchedChange (boost::shared_ptr<MidiPlaylist> pl) : _pl (pl) { if (_pl) { ++_pl->_patched_change; } }
+		~PatchedChange () { if (_pl) { --_pl->_patched_change; } }
+	  private:
+		boost::shared_ptr<MidiPlaylist> _pl;
+	};
+
+	bool in_patched_change () const { return _patched_change > 0; }
+
 	int set_state (const XMLNode&, int version);
 
 	bool destroy_region (boost::shared_ptr<Region>);
@@ -94,6 +118,9 @@ public:
 	samplepos_t  _read_end;
 
 	RTMidiBuffer _rendered;
+	gint         _render_valid;  ///< atomic
+	gint         _render_filter; ///< mode and mask of the channel filter used by the last render, or -1; atomic
+	uint32_t     _patched_change;
 };
 
 } /* namespace ARDOUR */
@@ -32,6 +32,7 @@
 
 #include "ardour/ardour.h"
 #include "ardour/midi_cursor.h"
+#include "ardour/midi_model.h"
 #include "ardour/region.h"
 
 class XMLNode;
@@ -165,6 +166,7 @@ class LIBARDOUR_API MidiRegion : public Region
 
 	void model_changed ();
 	void model_contents_changed ();
+	void model_notes_changed (MidiModel::NoteDelta const&);
 	void model_shifted (double qn_distance);
 	void model_automation_state_changed (Evoral::Parameter const &);
 
@@ -177,7 +179,9 @@ class LIBARDOUR_API MidiRegion : public Region
 	PBD::ScopedConnection _model_changed_connection;
 	PBD::ScopedConnection _source_connection;
 	PBD::ScopedConnection _model_contents_connection;
+	PBD::ScopedConnection _model_notes_connection;
 	bool _ignore_shift;
+	bool _notes_patched; ///< the last note edit was applied to the playlist's rendered events
 };
 
 } /* namespace ARDOUR */
@@ -182,6 +182,14 @@ class LIBARDOUR_API MidiSource : virtual public Source
 	virtual void load_model(const Glib::Threads::Mutex::Lock& lock, bool force_reload=false) = 0;
 	virtual void destroy_model(const Glib::Threads::Mutex::Lock& lock) = 0;
 
+	/** Postpone loading the model until it is first used. The source is
+	 * played from disk until then. Only possible if all controllers are
+	 * played back (the model is needed to filter them otherwise).
+	 * @return true if the model is deferred
+	 */
+	virtual bool defer_model (const Glib::Threads::Mutex::Lock& lock) { return false; }
+	bool model_deferred () const { return g_atomic_int_get (&_model_deferred); }
+
 	/** Reset cached information (like iterators) when things have changed.
 	 * @param lock Source lock, which must be held by caller.
 	 */
@@ -192,7 +200,8 @@ class LIBARDOUR_API MidiSource : virtual public Source
 
 	void set_note_mode(const Glib::Threads::Mutex::Lock& lock, NoteMode mode);
 
-	boost::shared_ptr<MidiModel> model() { return _model; }
+	/** @return the model, loading it first if it was deferred */
+	boost::shared_ptr<MidiModel> model();
 	void set_model(const Glib::Threads::Mutex::Lock& lock, boost::shared_ptr<MidiModel>);
 	void drop_model(const Glib::Threads::Mutex::Lock& lock);
 
@@ -237,6 +246,7 @@ class LIBARDOUR_API MidiSource : virtual public Source
 	                                   samplecnt_t                  cnt) = 0;
 
 	boost::shared_ptr<MidiModel> _model;
+	mutable gint                 _model_deferred;
 	bool                         _writing;
 
 	Temporal::Beats _length_beats;
@@ -258,6 +268,8 @@ class LIBARDOUR_API MidiSource : virtual public Source
 	 */
 	typedef std::map<Evoral::Parameter, AutoState> AutomationStateMap;
 	AutomationStateMap  _automation_state;
+
+	bool all_automation_played () const;
 };
 
 }
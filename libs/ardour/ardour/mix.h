@@ -55,6 +55,19 @@ LIBARDOUR_API void x86_sse_avx_find_peaks               (float const* buf, uint3
 LIBARDOUR_API void  x86_fma_mix_buffers_with_gain       (float* dst, float const* src, uint32_t nframes, float gain);
 #endif
 
+/* AVX-512F functions */
+#ifdef FPU_AVX512F_SUPPORT
+LIBARDOUR_API float x86_avx512f_compute_peak            (float const* buf, uint32_t nsamples, float current);
+LIBARDOUR_API void  x86_avx512f_find_peaks              (float const* buf, uint32_t nsamples, float* min, float* max);
+LIBARDOUR_API void  x86_avx512f_apply_gain_to_buffer    (float* buf, uint32_t nframes, float gain);
+LIBARDOUR_API void  x86_avx512f_mix_buffers_with_gain   (float* dst, float const* src, uint32_t nframes, float gain);
+LIBARDOUR_API void  x86_avx512f_mix_buffers_no_gain     (float* dst, float const* src, uint32_t nframes);
+LIBARDOUR_API void  x86_avx512f_copy_vector             (float* dst, float const* src, uint32_t nframes);
+LIBARDOUR_API void  x86_avx512f_mix_buffers_n           (float* dst, float const* const* srcs, float const* gains, uint32_t n_src, uint32_t nframes);
+LIBARDOUR_API float x86_avx512f_apply_gain_ramp         (float* buf, uint32_t nframes, float initial, float target, float coeff);
+LIBARDOUR_API void  x86_avx512f_apply_gain_vector       (float* buf, float const* gain, uint32_t nframes);
+#endif
+
 /* debug wrappers for SSE functions */
 
 LIBARDOUR_API float debug_compute_peak               (ARDOUR::Sample const* buf, ARDOUR::pframes_t nsamples, float current);
@@ -84,6 +97,21 @@ extern "C" {
 	LIBARDOUR_API void  arm_neon_find_peaks            (float const* src, uint32_t nframes, float* minf, float* maxf);
 	LIBARDOUR_API void  arm_neon_mix_buffers_no_gain   (float* dst, float const* src, uint32_t nframes);
 	LIBARDOUR_API void  arm_neon_mix_buffers_with_gain (float* dst, float const* src, uint32_t nframes, float gain);
+	LIBARDOUR_API float arm_neon_apply_gain_ramp       (float* buf, uint32_t nframes, float initial, float target, float coeff);
+	LIBARDOUR_API void  arm_neon_apply_gain_vector     (float* buf, float const* gain, uint32_t nframes);
+}
+#endif
+
+#if defined ARM_SVE_SUPPORT
+/* Vector-length agnostic SVE functions */
+extern "C" {
+	LIBARDOUR_API float arm_sve_compute_peak           (float const* buf, uint32_t nsamples, float current);
+	LIBARDOUR_API void  arm_sve_apply_gain_to_buffer   (float* buf, uint32_t nframes, float gain);
+	LIBARDOUR_API void  arm_sve_copy_vector            (float* dst, float const* src, uint32_t nframes);
+	LIBARDOUR_API void  arm_sve_find_peaks             (float const* src, uint32_t nframes, float* minf, float* maxf);
+	LIBARDOUR_API void  arm_sve_mix_buffers_no_gain    (float* dst, float const* src, uint32_t nframes);
+	LIBARDOUR_API void  arm_sve_mix_buffers_with_gain  (float* dst, float const* src, uint32_t nframes, float gain);
+	LIBARDOUR_API void  arm_sve_mix_buffers_n          (float* dst, float const* const* srcs, float const* gains, uint32_t n_src, uint32_t nframes);
 }
 #endif
 
@@ -95,5 +123,8 @@ LIBARDOUR_API void  default_apply_gain_to_buffer      (ARDOUR::Sample* buf, ARDO
 LIBARDOUR_API void  default_mix_buffers_with_gain     (ARDOUR::Sample* dst, ARDOUR::Sample const* src, ARDOUR::pframes_t nframes, float gain);
 LIBARDOUR_API void  default_mix_buffers_no_gain       (ARDOUR::Sample* dst, ARDOUR::Sample const* src, ARDOUR::pframes_t nframes);
 LIBARDOUR_API void  default_copy_vector               (ARDOUR::Sample* dst, ARDOUR::Sample const* src, ARDOUR::pframes_t nframes);
+LIBARDOUR_API void  default_mix_buffers_n             (ARDOUR::Sample* dst, ARDOUR::Sample const* const* srcs, float const* gains, uint32_t n_src, ARDOUR::pframes_t nframes);
+LIBARDOUR_API float default_apply_gain_ramp           (ARDOUR::Sample* buf, ARDOUR::pframes_t nframes, float initial, float target, float coeff);
+LIBARDOUR_API void  default_apply_gain_vector         (ARDOUR::Sample* buf, float const* gain, ARDOUR::pframes_t nframes);
 
 #endif /* __ardour_mix_h__ */
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2026 The Ardour Team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __ardour_playback_lookahead_h__
+#define __ardour_playback_lookahead_h__
+
+#include <list>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+#include <glib.h>
+#include <glibmm/threads.h>
+
+#include "pbd/rcu.h"
+#include "pbd/semutils.h"
+#include "pbd/signals.h"
+
+#include "ardour/libardour_visibility.h"
+#include "ardour/types.h"
+
+namespace ARDOUR {
+
+class AudioTrack;
+class BufferSet;
+class DiskReader;
+class PluginInsert;
+class Processor;
+class Session;
+
+/** Processing of the plugins of an audio track ahead of the playhead.
+ *
+ * While the track plays from disk, the process thread passes the data
+ * that the disk-reader has buffered ahead of the transport on to worker
+ * threads, which run copies of the plugins that directly follow the
+ * disk-reader. The results are queued and handed to the process thread,
+ * which then skips the original plugins. Whenever the queue cannot
+ * provide the data (after a locate, an edit, a change of the processors or
+ * when the workers fall behind) the track falls back to processing the
+ * plugins in realtime.
+ *
+ * update() and drop() must be called from the GUI thread, read(), stop()
+ * and the static methods are realtime safe and used by
+ * Route::process_output_buffers.
+ */
+class LIBARDOUR_API PlaybackLookahead : public PBD::ScopedConnectionList
+{
+public:
+	PlaybackLookahead (Session&, AudioTrack&);
+	~PlaybackLookahead ();
+
+	/** Set up, or replace, the plugin copies after the track's
+	 * configuration changed. To be called periodically.
+	 */
+	void update ();
+
+	/** Stop processing ahead, and discard the plugin copies */
+	void drop ();
+
+	class Chain;
+	typedef boost::shared_ptr<boost::shared_ptr<Chain> > ChainRef;
+	typedef std::list<boost::shared_ptr<Processor> > ProcessorList;
+
+	/** @return the current chain, to be held for a complete process cycle */
+	ChainRef chain () const { return _chain.reader (); }
+
+	/** @return true if the output of the given processor is provided by the chain */
+	static bool processes (ChainRef const&, boost::shared_ptr<Processor> const&);
+
+	/** @return true if the chain was set up for the active processors that
+	 * follow @param disk_reader in the route's processor list.
+	 */
+	static bool follows (ChainRef const&, ProcessorList::const_iterator disk_reader, ProcessorList::const_iterator end);
+
+	/** Replace the disk-reader's output in @param bufs with the output of
+	 * the chain for @param nframes starting at @param pos. To be called
+	 * after the disk-reader ran for the cycle.
+	 * @return true if the data was available
+	 */
+	bool read (ChainRef const&, DiskReader const&, BufferSet& bufs, samplepos_t pos, pframes_t nframes);
+
+	/** The chain's output is not used this cycle.
+	 * @return the number of processors following the disk-reader that
+	 * were skipped in the previous cycle, and have to be flushed before
+	 * running them again.
+	 */
+	uint32_t stop ();
+
+	/** @return the number of worker threads, each of which uses a set
+	 * of process-thread buffers (see BufferManager).
+	 */
+	static uint32_t max_workers ();
+
+private:
+	typedef std::vector<boost::shared_ptr<PluginInsert> > InsertList;
+
+	Session&    _session;
+	AudioTrack& _track;
+
+	gint        _generation; ///< incremented by every change, atomic
+	gint        _seen_generation;
+	uint32_t    _skipped;    ///< process thread
+
+	SerializedRCUManager<boost::shared_ptr<Chain> > _chain;
+
+	void invalidate ();
+	void contents_changed ();
+	void reconnect (InsertList const&);
+	void set_chain (boost::shared_ptr<Chain>);
+
+	static void worker ();
+	static void wakeup ();
+
+	static Glib::Threads::RWLock         _instance_lock;
+	static std::list<PlaybackLookahead*> _instances;
+	static PBD::Semaphore                _wakeup;
+	static gint                          _wakeup_pending;
+	static uint32_t                      _n_workers;
+};
+
+} // namespace ARDOUR
+
+#endif /* __ardour_playback_lookahead_h__ */
@@ -35,6 +35,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 #include <sys/stat.h>
 
@@ -398,6 +399,17 @@ protected:
 
 	boost::shared_ptr<RegionList> regions_touched_locked (samplepos_t start, samplepos_t end);
 
+	void invalidate_region_index ();
+	void region_index_add (boost::shared_ptr<Region>);
+	void region_index_remove (boost::shared_ptr<Region>);
+
+	/** Called whenever a change to the region list, the bounds, layering or
+	 *  any other property of a region may have altered what the playlist
+	 *  renders. Also called while holding state, before notifications are
+	 *  sent, and possibly from any thread.
+	 */
+	virtual void render_state_changed () {}
+
 	void notify_region_removed (boost::shared_ptr<Region>);
 	void notify_region_added (boost::shared_ptr<Region>);
 	void notify_layering_changed ();
@@ -476,6 +488,49 @@ private:
 
 	mutable boost::optional<std::pair<samplepos_t, samplepos_t> > _cached_extent;
 
+	/* Region lookup index: an implicit augmented interval tree over the
+	 * regions sorted by first sample. Each node of the (balanced) tree
+	 * spanning [lo, hi) is the entry at (lo + hi) / 2, and carries the
+	 * maximum last sample of its subtree, so queries can skip subtrees
+	 * that end before the range of interest.
+	 *
+	 * Regions that are added, removed, moved or trimmed are updated in
+	 * place: a move or trim only re-computes the nodes above the entries
+	 * that changed position, adding or removing a region shifts the
+	 * vector and re-computes all nodes, but needs no sort.
+	 * Bulk changes (clear, splice, ripple, set-state) invalidate the
+	 * index, which is then rebuilt on demand by the next lookup.
+	 *
+	 * While _region_index_in_order is true, the index is in playlist
+	 * order and the entries' order field is not maintained.
+	 */
+	struct RegionIndexEntry {
+		samplepos_t               first;
+		samplepos_t               last;
+		samplepos_t               max_last;
+		uint32_t                  order;
+		boost::shared_ptr<Region> region;
+
+		bool operator< (RegionIndexEntry const& other) const {
+			return first < other.first;
+		}
+	};
+
+	typedef std::vector<RegionIndexEntry> RegionIndex;
+
+	void update_region_index () const;
+	void region_index_bounds_changed (boost::shared_ptr<Region>, bool moved);
+	RegionIndex::iterator region_index_find (boost::shared_ptr<Region> const&) const;
+	void regions_in_index (samplepos_t first_max, samplepos_t last_min, std::vector<boost::shared_ptr<Region> >&) const;
+	void region_index_collect (size_t lo, size_t hi, samplepos_t first_max, samplepos_t last_min, std::vector<RegionIndexEntry const*>&) const;
+	static samplepos_t region_index_build (RegionIndex&, size_t lo, size_t hi);
+	static samplepos_t region_index_fix (RegionIndex&, size_t lo, size_t hi, size_t a, size_t b);
+
+	mutable Glib::Threads::Mutex _region_index_lock;
+	mutable RegionIndex          _region_index;
+	mutable bool                 _region_index_valid;
+	mutable bool                 _region_index_in_order;
+
 	samplepos_t _end_space; //this is used when we are pasting a range with extra space at the end
 	bool        _playlist_shift_active;
 };
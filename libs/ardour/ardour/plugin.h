@@ -160,6 +160,12 @@ public:
 	/** the max possible latency a plugin will have */
 	virtual samplecnt_t max_latency () const { return 0; }
 
+	/** @return the number of samples for which the plugin may produce
+	 * output after its input became silent (e.g. a reverb or delay tail).
+	 * Plugins which do not report a tail use the configured default.
+	 */
+	samplecnt_t signal_tail () const;
+
 	virtual int  set_block_size (pframes_t nframes) = 0;
 	virtual bool requires_fixed_sized_buffers () const { return false; }
 	virtual bool inplace_broken () const { return false; }
@@ -402,6 +408,9 @@ protected:
 private:
 	virtual samplecnt_t plugin_latency () const = 0;
 
+	/** @return the tail reported by the plugin, or -1 if it is unknown */
+	virtual samplecnt_t plugin_tail () const { return -1; }
+
 	/** Fill _presets with our presets */
 	virtual void find_presets () = 0;
 
@@ -70,6 +70,12 @@ public:
 	void set_owner (SessionObject*);
 	void set_state_dir (const std::string& d = "");
 
+	/** Create an unowned copy of this insert with new IDs, configured like
+	 * this one and activated, to process the route's audio elsewhere.
+	 * @return the copy, or a null pointer on failure
+	 */
+	boost::shared_ptr<PluginInsert> create_copy (pframes_t block_size);
+
 	void run (BufferSet& in, samplepos_t start_sample, samplepos_t end_sample, double speed, pframes_t nframes, bool);
 	void silence (samplecnt_t nframes, samplepos_t start_sample);
 
@@ -335,6 +341,9 @@ private:
 	uint32_t _sc_capture_latency;
 	uint32_t _plugin_signal_latency;
 
+	samplecnt_t _signal_tail;          ///< cached Plugin::signal_tail ()
+	samplecnt_t _silent_input_samples; ///< samples of silent input processed since the last non-silent cycle
+
 	boost::weak_ptr<Plugin> _impulseAnalysisPlugin;
 
 	samplecnt_t _signal_analysis_collect_nsamples;
@@ -404,6 +413,8 @@ private:
 	void automate_and_run (BufferSet& bufs, samplepos_t start, samplepos_t end, double speed, pframes_t nframes);
 	void connect_and_run (BufferSet& bufs, samplepos_t start, samplecnt_t end, double speed, pframes_t nframes, samplecnt_t offset, bool with_auto);
 	void bypass (BufferSet& bufs, pframes_t nframes);
+	bool input_is_silent (BufferSet const& bufs, pframes_t nframes) const;
+	bool skip_silent_input (BufferSet& bufs, samplepos_t start, pframes_t nframes);
 	void inplace_silence_unconnected (BufferSet&, const PinMappings&, samplecnt_t nframes, samplecnt_t offset) const;
 
 	void create_automatable_parameters ();
@@ -27,7 +27,9 @@
 
 #include <stdint.h>
 
+#include <boost/function.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
 
 #include "pbd/natsort.h"
 #include "pbd/rcu.h"
@@ -265,6 +267,26 @@ protected:
 	/** List of ports to be used between \ref cycle_start() and \ref cycle_end() */
 	boost::shared_ptr<Ports> _cycle_ports;
 
+	/* Parallel per-port processing using the session's RTTaskList.
+	 * The task-list is rebuilt when the set of ports changes (outside
+	 * the process thread), each task calls Port::cycle_start or
+	 * Port::cycle_end respectively on one port.
+	 */
+	struct PortTasks {
+		PortTasks () {}
+		PortTasks (boost::shared_ptr<Ports> p) : ports (p) {}
+
+		boost::shared_ptr<Ports>               ports; // keep ports alive
+		std::vector<boost::function<void ()> > start_tasks;
+		std::vector<boost::function<void ()> > end_tasks;
+	};
+
+	void update_port_tasks ();
+
+	SerializedRCUManager<PortTasks> _port_tasks;
+	boost::shared_ptr<PortTasks>    _cycle_port_tasks;
+	pframes_t                       _port_task_nframes;
+
 	void silence (pframes_t nframes, Session* s = 0);
 	void silence_outputs (pframes_t nframes);
 	void check_monitoring ();
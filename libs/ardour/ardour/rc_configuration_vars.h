@@ -94,6 +94,10 @@ CONFIG_VARIABLE (BufferingPreset, buffering_preset, "buffering-preset", Medium)
 CONFIG_VARIABLE (float, audio_capture_buffer_seconds, "capture-buffer-seconds", 5.0)
 CONFIG_VARIABLE (float, audio_playback_buffer_seconds, "playback-buffer-seconds", 5.0)
 CONFIG_VARIABLE (float, midi_track_buffer_seconds, "midi-track-buffer-seconds", 1.0)
+CONFIG_VARIABLE (uint32_t, butler_threads, "butler-threads", 1)
+CONFIG_VARIABLE (bool, disk_prefetch, "disk-prefetch", true)
+CONFIG_VARIABLE (bool, direct_pcm_reads, "direct-pcm-reads", true)
+CONFIG_VARIABLE (uint32_t, peak_building_threads, "peak-building-threads", 0) /* 0: automatic */
 CONFIG_VARIABLE (uint32_t, disk_choice_space_threshold,  "disk-choice-space-threshold", 57600000)
 CONFIG_VARIABLE (bool, auto_analyse_audio, "auto-analyse-audio", false)
 CONFIG_VARIABLE (float, transient_sensitivity, "transient-sensitivity", 50)
@@ -157,6 +161,10 @@ CONFIG_VARIABLE (bool, use_click_emphasis, "use-click-emphasis", true)
  */
 CONFIG_VARIABLE (bool, skip_playback, "skip-playback", true)
 CONFIG_VARIABLE (bool, plugins_stop_with_transport, "plugins-stop-with-transport", false)
+CONFIG_VARIABLE (bool, skip_silent_plugins, "skip-silent-plugins", false)
+CONFIG_VARIABLE (double, default_plugin_tail, "default-plugin-tail", 2.0) /* seconds */
+CONFIG_VARIABLE (bool, render_cache, "render-cache", false)
+CONFIG_VARIABLE (float, render_cache_min_dsp_load, "render-cache-min-dsp-load", 5.0) /* percent of a process cycle */
 CONFIG_VARIABLE (bool, recording_resets_xrun_count, "recording-resets-xrun-count,", false)
 CONFIG_VARIABLE (bool, stop_recording_on_xrun, "stop-recording-on-xrun", false)
 CONFIG_VARIABLE (bool, create_xrun_marker, "create-xrun-marker", true)
@@ -199,6 +207,9 @@ CONFIG_VARIABLE (int32_t, history_depth, "history-depth", 20)
 CONFIG_VARIABLE (RegionEquivalence, region_equivalence, "region-equivalency", LayerTime)
 CONFIG_VARIABLE (bool, periodic_safety_backups, "periodic-safety-backups", true)
 CONFIG_VARIABLE (uint32_t, periodic_safety_backup_interval, "periodic-safety-backup-interval", 120)
+CONFIG_VARIABLE (bool, save_binary_state, "save-binary-state", false)
+CONFIG_VARIABLE (bool, incremental_save, "incremental-save", false)
+CONFIG_VARIABLE (bool, lazy_session_load, "lazy-session-load", true)
 CONFIG_VARIABLE (float, automation_interval_msecs, "automation-interval-msecs", 30)
 #ifdef __APPLE__
 CONFIG_VARIABLE_SPECIAL (std::string, default_session_parent_dir, "default-session-parent-dir", "~/Music", poor_mans_glob)
@@ -209,6 +220,11 @@ CONFIG_VARIABLE_SPECIAL (std::string, default_session_parent_dir, "default-sessi
 #endif
 CONFIG_VARIABLE (bool, allow_special_bus_removal, "allow-special-bus-removal", false)
 CONFIG_VARIABLE (int32_t, processor_usage, "processor-usage", -1)
+CONFIG_VARIABLE (GraphSchedulerModel, graph_scheduler, "graph-scheduler", SharedTriggerQueue)
+CONFIG_VARIABLE (uint32_t, graph_spin_usec, "graph-spin-usec", 0)
+CONFIG_VARIABLE (bool, route_pipelining, "route-pipelining", false)
+CONFIG_VARIABLE (bool, anticipative_processing, "anticipative-processing", false)
+CONFIG_VARIABLE (uint32_t, anticipative_lookahead, "anticipative-lookahead", 8192) /* samples */
 CONFIG_VARIABLE (gain_t, max_gain, "max-gain", 2.0) /* +6.0dB */
 CONFIG_VARIABLE (uint32_t, max_recent_sessions, "max-recent-sessions", 10)
 CONFIG_VARIABLE (uint32_t, max_recent_templates, "max-recent-templates", 10)
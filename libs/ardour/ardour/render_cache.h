@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2026 The Ardour Team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __ardour_render_cache_h__
+#define __ardour_render_cache_h__
+
+#include <list>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+#include <glib.h>
+#include <glibmm/threads.h>
+
+#include "pbd/property_basics.h"
+#include "pbd/rcu.h"
+#include "pbd/signals.h"
+
+#include "ardour/libardour_visibility.h"
+#include "ardour/types.h"
+
+namespace ARDOUR {
+
+class AudioPlaylist;
+class AudioRegion;
+class AutomationControl;
+class PluginInsert;
+class Processor;
+class RenderCacheManager;
+class Session;
+class Track;
+
+/** Automatic background freeze of the plugins of a track.
+ *
+ * The plugins that directly follow the disk-reader (for a MIDI track: its
+ * instrument and the plugins after it) are rendered by a worker thread,
+ * using copies of the plugins, into private files. When the render is
+ * complete and the transport is stopped, the disk-reader plays the
+ * rendered files and the track skips the rendered plugins -- until a
+ * processor, automation or region of the track changes.
+ *
+ * update() is called by the session's RenderCacheManager thread. Changes
+ * stop the use of the cache from the thread that signals them, unless that
+ * is a process thread.
+ */
+class LIBARDOUR_API RenderCache : public PBD::ScopedConnectionList
+{
+public:
+	RenderCache (Session&, Track&);
+	~RenderCache ();
+
+	/** Advance the cache: cancel stale renders, collect finished ones,
+	 * start new renders and install or uninstall the cache as needed.
+	 * To be called periodically, from one thread only.
+	 */
+	void update ();
+
+	/** Stop using the cache and discard it, cancel any render in progress */
+	void drop ();
+
+	/** @return true if the disk-reader was told to play the rendered files */
+	bool installed () const;
+
+	typedef std::vector<boost::weak_ptr<Processor> > RenderedProcessors;
+
+	/** @return the processors whose output is contained in the rendered
+	 * files. Only to be used while the disk-reader reads the cache, and
+	 * until the route stopped skipping them. Realtime safe.
+	 */
+	boost::shared_ptr<RenderedProcessors> rendered_processors () const {
+		return _rendered.reader ();
+	}
+
+	/** @return true if the given processor is one of the rendered ones.
+	 * Realtime safe.
+	 */
+	static bool contains (RenderedProcessors const&, boost::shared_ptr<Processor> const&);
+
+	/** @return the number of worker threads that render, each of which
+	 * uses a set of process-thread buffers (see BufferManager).
+	 */
+	static uint32_t max_workers ();
+
+private:
+	friend class RenderCacheManager;
+
+	struct Job;
+	struct Result;
+
+	typedef std::vector<boost::shared_ptr<PluginInsert> > InsertList;
+
+	Session& _session;
+	Track&   _track;
+
+	boost::shared_ptr<RenderCacheManager> _manager;
+
+	gint        _generation; ///< incremented by every change, atomic
+	gint        _seen_generation;
+	gint        _failed_generation;
+	gint64      _stable_since;
+
+	boost::shared_ptr<Job>    _job;
+	boost::shared_ptr<Result> _ready;
+
+	/** protects _installed and _retired, which are also changed by
+	 * invalidate()
+	 */
+	mutable Glib::Threads::Mutex _lock;
+	boost::shared_ptr<Result>    _installed;
+	boost::shared_ptr<Result>    _retired;
+
+	SerializedRCUManager<RenderedProcessors> _rendered;
+
+	bool cached_inserts (InsertList&) const;
+	bool worth_rendering (InsertList const&) const;
+
+	void invalidate ();
+	void control_changed (boost::weak_ptr<AutomationControl>);
+	void region_changed (PBD::PropertyChange const&);
+	void reconnect (InsertList const&);
+
+	void start_job (InsertList const&);
+	void finish_job ();
+	void cancel_job ();
+	void install ();
+	void uninstall ();
+};
+
+/** Runs the render caches of a session: a thread that updates them
+ * periodically, or as soon as one of them is invalidated, and the worker
+ * threads that render. Owned by the Session, which stops it before the
+ * tracks go away.
+ */
+class LIBARDOUR_API RenderCacheManager
+{
+public:
+	RenderCacheManager (Session&);
+	~RenderCacheManager ();
+
+	/** Start the thread that updates the caches */
+	int start ();
+
+	/** Cancel all renders and join all threads */
+	void stop ();
+
+	/** Update the caches now, rather than at the next period. May be
+	 * called from any thread.
+	 */
+	void wake ();
+
+private:
+	friend class RenderCache;
+
+	Session&                             _session;
+	Glib::Threads::Thread*               _thread;
+	std::vector<Glib::Threads::Thread*>  _workers;
+
+	Glib::Threads::Mutex                 _lock;
+	Glib::Threads::Cond                  _wake;
+	Glib::Threads::Cond                  _jobs_queued;
+	Glib::Threads::Cond                  _job_done;
+	std::list<RenderCache::Job*>         _queue;
+	std::list<RenderCache::Job*>         _running;
+	bool                                 _quit;
+	gint                                 _woken; ///< atomic
+
+	void thread_main ();
+	void worker ();
+
+	bool queue (RenderCache::Job*);
+	void cancel (RenderCache::Job*);
+};
+
+} // namespace ARDOUR
+
+#endif /* __ardour_render_cache_h__ */
@@ -79,8 +79,11 @@ class PannerShell;
 class PolarityProcessor;
 class PortSet;
 class Processor;
+class PlaybackLookahead;
 class PluginInsert;
+class RenderCache;
 class RouteGroup;
+class RoutePipelineStage;
 class Send;
 class InternalReturn;
 class Location;
@@ -157,7 +160,7 @@ public:
 	void non_realtime_transport_stop (samplepos_t now, bool flush);
 	virtual void realtime_handle_transport_stopped ();
 
-	virtual void realtime_locate (bool) {}
+	virtual void realtime_locate (bool);
 	virtual void non_realtime_locate (samplepos_t);
 	void set_loop (ARDOUR::Location *);
 
@@ -238,6 +241,22 @@ public:
 
 	std::list<std::string> unknown_processors () const;
 
+	/** @return the background render of this route's plugins, if any */
+	boost::shared_ptr<RenderCache> render_cache () const { return _render_cache; }
+	/** @return the ahead-of-time processing of this route's plugins, if any */
+	boost::shared_ptr<PlaybackLookahead> playback_lookahead () const { return _playback_lookahead; }
+
+	/** Find the plugins that directly follow the disk-reader and process
+	 * nothing but its audio, up to the last one that produces one channel
+	 * per disk-reader channel (so that its output can replace the
+	 * disk-reader's).
+	 * @param with_instrument for a MIDI track, start with the instrument
+	 * that directly follows the disk-reader, and end with the last plugin
+	 * that processes nothing but its audio.
+	 * @return true if there is at least one such plugin
+	 */
+	bool disk_plugin_chain (std::vector<boost::shared_ptr<PluginInsert> >&, bool with_instrument = false) const;
+
 	RoutePinWindowProxy * pinmgr_proxy () const { return _pinmgr_proxy; }
 	void set_pingmgr_proxy (RoutePinWindowProxy* wp) { _pinmgr_proxy = wp ; }
 
@@ -361,6 +380,22 @@ public:
 
 	bool is_track();
 
+	std::string graph_node_name () const { return name (); }
+
+	/** @return the tail of the processor chain, to be processed by a
+	 * separate graph-node, if this route is pipelined.
+	 */
+	boost::shared_ptr<RoutePipelineStage> pipeline_stage () const;
+	void run_pipeline_tail (pframes_t nframes, samplepos_t start_sample, samplepos_t end_sample, bool roll);
+	void reset_pipeline ();
+
+	/** Execution time of the route's processors for each cycle,
+	 * excluding the tail of a pipelined route.
+	 * see also Processor::dsp_profile ()
+	 */
+	PBD::TimingHistogram& dsp_profile () { return _dsp_profile; }
+	void reset_dsp_profiles ();
+
 	/** track numbers - assigned by session
 	 * nubers > 0 indicate tracks (audio+midi)
 	 * nubers < 0 indicate busses
@@ -587,6 +622,8 @@ public:
 
 protected:
 	friend class Session;
+	friend class PlaybackLookahead;
+	friend class RenderCache;
 
 	void catch_up_on_solo_mute_override ();
 	void set_listen (bool);
@@ -701,6 +738,28 @@ protected:
 
 	boost::shared_ptr<DelayLine> _delayline;
 
+	/* sub-route parallelism, processors from _pipeline_split
+	 * onwards are processed by _pipeline_stage.
+	 */
+	boost::shared_ptr<RoutePipelineStage> _pipeline_stage;
+	boost::shared_ptr<Processor>          _pipeline_split;
+	bool                                  _pipeline_amp_in_tail;
+	volatile gint                         _pipelined; // atomic
+
+	PBD::TimingHistogram _dsp_profile;
+
+	/* processors directly after the disk-reader may be skipped while
+	 * the disk-reader plays a render of them
+	 */
+	boost::shared_ptr<RenderCache> _render_cache;
+	bool                           _render_skipped; ///< process thread only
+	/* ..or while their output is computed ahead of the playhead */
+	boost::shared_ptr<PlaybackLookahead> _playback_lookahead;
+
+	void update_pipeline_split ();
+	void process_pipeline_tail_unlocked (pframes_t nframes, samplepos_t start_sample, samplepos_t end_sample, bool gain_automation_ok);
+	void flush_pipeline_buffers_locked (samplecnt_t nframes, bool tail);
+
 	bool is_internal_processor (boost::shared_ptr<Processor>) const;
 
 	boost::shared_ptr<Processor> the_instrument_unlocked() const;
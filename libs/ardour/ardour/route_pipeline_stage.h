@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2026 The Ardour Team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __ardour_route_pipeline_stage_h__
+#define __ardour_route_pipeline_stage_h__
+
+#include <string>
+
+#include <glib.h>
+#include <boost/shared_ptr.hpp>
+
+#include "ardour/graphnode.h"
+#include "ardour/libardour_visibility.h"
+#include "ardour/types.h"
+
+namespace ARDOUR
+{
+class BufferSet;
+class Graph;
+class Route;
+
+/** The tail of a Route's processor-chain, scheduled as separate node
+ * in the process graph.
+ *
+ * The Route (head) processes all processors up to the split-point and
+ * hands over the audio to the tail using a FIFO that adds one cycle of
+ * latency. Since the tail processes data of the previous cycle, head
+ * and tail do not depend on each other and can run concurrently.
+ * The additional latency is reported as part of the Route's signal
+ * latency and compensated like any other latency.
+ */
+class LIBARDOUR_API RoutePipelineStage : public GraphNode
+{
+public:
+	RoutePipelineStage (boost::shared_ptr<Graph>, Route&);
+	~RoutePipelineStage ();
+
+	void        prep (int chain);
+	std::string graph_node_name () const;
+
+	/* Must be called with the Route's processor-lock held (writer) */
+	void set_capacity (uint32_t n_channels, samplecnt_t block_size);
+
+	uint32_t    n_channels () const { return _n_channels; }
+	samplecnt_t latency () const { return _block_size; }
+
+	/* called by the Route in the process thread */
+	void write (BufferSet const&, pframes_t);
+	void read (BufferSet&, pframes_t);
+	/** drop the data that read() would return */
+	void discard (pframes_t);
+	void advance ();
+
+	/** drop all data in flight, called in the process thread */
+	void clear ();
+	/** clear() at the start of the next cycle, may be called from any thread */
+	void request_clear () { g_atomic_int_set (&_pending_clear, 1); }
+
+	/** true if the stage was prepared as graph-node in the current cycle,
+	 * otherwise the head has to run the tail itself.
+	 */
+	bool scheduled ();
+
+protected:
+	void process ();
+
+private:
+	Route&      _route;
+	Sample*     _fifo;
+	uint32_t    _n_channels;
+	samplecnt_t _block_size;
+	samplecnt_t _wpos;
+	pframes_t   _written;
+	gint        _scheduled;
+	gint        _pending_clear;
+};
+
+} // namespace
+
+#endif /* __ardour_route_pipeline_stage_h__ */
@@ -24,6 +24,7 @@
 #define __ardour_rt_midi_buffer_h__
 
 #include <map>
+#include <vector>
 
 #include <glibmm/threads.h>
 
@@ -36,7 +37,13 @@ namespace ARDOUR {
 class MidiBuffer;
 class MidiStateTracker;
 
-/**  */
+/** Time-ordered MIDI events of a playlist, for realtime playback.
+ *
+ * The events are kept twice. Readers use one copy while the other one is
+ * written to; the copies are swapped when writing is complete, then the
+ * other copy is brought up to date. So realtime readers never wait for a
+ * render or patch to finish.
+ */
 class LIBARDOUR_API RTMidiBuffer : public Evoral::EventSink<samplepos_t>
 {
   public:
@@ -47,7 +54,7 @@ class LIBARDOUR_API RTMidiBuffer : public Evoral::EventSink<samplepos_t>
 
 	void clear();
 	void resize(size_t);
-	size_t size() const { return _size; }
+	size_t size() const;
 
 	uint32_t write (TimeType time, Evoral::EventType type, uint32_t size, const uint8_t* buf);
 	uint32_t read (MidiBuffer& dst, samplepos_t start, samplepos_t end, MidiStateTracker& tracker, samplecnt_t offset = 0);
@@ -64,40 +71,123 @@ class LIBARDOUR_API RTMidiBuffer : public Evoral::EventSink<samplepos_t>
 		};
 	};
 
+	/** @return an Item holding the given event of up to 3 bytes */
+	static Item make_item (samplepos_t time, uint8_t const* buf, uint32_t size);
+
+	/** Remove one instance of each event in @param remove, then insert
+	 * the events in @param insert, without rendering everything again.
+	 * Only events of up to 3 bytes are supported. Note-offs are inserted
+	 * before other events with the same timestamp, all other events after.
+	 *
+	 * @return false if an event to remove was not found, a note-on to
+	 * insert was already present, the events are reversed or a render is
+	 * in progress. Nothing is changed then.
+	 */
+	bool patch (std::vector<Item> const& remove, std::vector<Item> const& insert);
+
   private:
-	friend struct WriteProtectRender;
+	friend class WriteProtectRender;
 
 	struct Blob {
 		uint32_t size;
 		uint8_t data[0];
 	};
 
-	/* The main store. Holds Items (timestamp+up to 3 bytes of data OR
-	 * offset into secondary storage below)
-	 */
+	struct Storage {
+		Storage ();
+		~Storage ();
+
+		/* The main store. Holds Items (timestamp+up to 3 bytes of data OR
+		 * offset into secondary storage below)
+		 */
+
+		size_t size;
+		size_t capacity;
+		Item*  data;
+		bool   reversed;
+
+		/* secondary blob storage. Holds Blobs (arbitrary size + data) */
+
+		uint32_t pool_size;
+		uint32_t pool_capacity;
+		uint8_t* pool;
+
+		/* coarse time index: index[n] is the position of the first
+		 * Item at or after index_base + (n << index_shift). About one
+		 * entry per Item, rebuilt when a render or patch is complete.
+		 */
+
+		uint32_t*   index;
+		size_t      index_size;
+		size_t      index_capacity;
+		uint32_t    index_shift;
+		samplepos_t index_base;
+
+		/* events inserted by patch(), kept apart from the main store
+		 * until it is next rendered or compacted, so that a patch does
+		 * not move the main store. The key orders them among the events
+		 * with the same timestamp. Events removed by patch() are marked
+		 * in place (see n_events()).
+		 */
+
+		typedef std::map<std::pair<samplepos_t, int64_t>, Item> Patched;
+
+		Patched patched;
+		int64_t patch_seq;
+		size_t  n_removed;
+
+		/* held by readers (try-lock only) and by the writer while
+		 * this copy is modified.
+		 */
+		Glib::Threads::RWLock lock;
+
+		/** @return the number of events, without the ones removed by patch() */
+		size_t n_events () const { return size - n_removed + patched.size (); }
+
+		void resize (size_t);
+		uint32_t alloc_blob (uint32_t size);
+		uint32_t store_blob (uint32_t size, uint8_t const * data);
+		void copy (Storage const&);
+		void build_index ();
+		Item* lower_bound (samplepos_t) const;
+		Item* upper_bound (samplepos_t) const;
+		void reverse ();
+		bool patch (std::vector<Item> const& remove, std::vector<Item> const& insert);
+		bool contains (Item const&) const;
+		void compact ();
+		uint32_t read (MidiBuffer& dst, samplepos_t start, samplepos_t end, MidiStateTracker& tracker, samplecnt_t offset);
+		uint32_t read_unpatched (MidiBuffer& dst, samplepos_t start, samplepos_t end, MidiStateTracker& tracker, samplecnt_t offset);
+	};
 
-	size_t _size;
-	size_t _capacity;
-	Item*  _data;
-	bool   _reversed;
-	/* secondary blob storage. Holds Blobs (arbitrary size + data) */
+	Storage  _storage[2];
+	gint     _active;  ///< index of the copy used by readers, atomic
+	Storage* _writing; ///< copy being rendered into, if any
 
-	uint32_t alloc_blob (uint32_t size);
-	uint32_t store_blob (uint32_t size, uint8_t const * data);
-	uint32_t _pool_size;
-	uint32_t _pool_capacity;
-	uint8_t* _pool;
+	/* serializes renders, patches and reversal */
+	Glib::Threads::Mutex _write_lock;
 
-	Glib::Threads::RWLock _lock;
+	Storage& active () { return _storage[g_atomic_int_get (&_active)]; }
+	Storage const& active () const { return _storage[g_atomic_int_get (&_active)]; }
+	Storage& inactive () { return _storage[!g_atomic_int_get (&_active)]; }
+
+	void begin_write ();
+	void end_write ();
+	void publish ();
 
   public:
+	/** Held for the duration of a render. acquire() is to be called before
+	 * the first write (and clear()); the result is published when this
+	 * goes out of scope.
+	 */
 	class WriteProtectRender {
           public:
-		WriteProtectRender (RTMidiBuffer& rtm) : lm (rtm._lock, Glib::Threads::NOT_LOCK) {}
-		void acquire () { lm.acquire(); }
+		WriteProtectRender (RTMidiBuffer& rtm) : _rtm (rtm), _acquired (false) { _rtm._write_lock.lock (); }
+		~WriteProtectRender () { if (_acquired) { _rtm.end_write (); } _rtm._write_lock.unlock (); }
+		void acquire () { _rtm.begin_write (); _acquired = true; }
 
           private:
-		Glib::Threads::RWLock::WriterLock lm;
+		RTMidiBuffer& _rtm;
+		bool          _acquired;
 	};
 };
 
@@ -19,7 +19,7 @@
 #ifndef _ardour_rt_tasklist_h_
 #define _ardour_rt_tasklist_h_
 
-#include <list>
+#include <vector>
 #include <boost/function.hpp>
 
 #include "pbd/semutils.h"
@@ -37,10 +37,11 @@ public:
 	RTTaskList ();
 	~RTTaskList ();
 
-	// TODO use dedicated allocator of a boost::intrusive::list
-	typedef std::list<boost::function<void ()> > TaskList;
+	typedef std::vector<boost::function<void ()> > TaskList;
 
-	/** process tasks in list in parallel, wait for them to complete */
+	/** process tasks in list in parallel, wait for them to complete.
+	 * The list is not copied, the calling thread also processes tasks.
+	 */
 	void process (TaskList const&);
 
 private:
@@ -50,17 +51,21 @@ private:
 	void reset_thread_list ();
 	void drop_threads ();
 
-	void process_tasklist ();
+	void run_tasks ();
 
 	static void* _thread_run (void *arg);
 	void run ();
 
 	Glib::Threads::Mutex _process_mutex;
-	Glib::Threads::Mutex _tasklist_mutex;
 	PBD::Semaphore _task_run_sem;
 	PBD::Semaphore _task_end_sem;
 
-	TaskList _tasklist;
+	/* tasks of the current process () call, each thread claims
+	 * the next unprocessed task by incrementing _next_task.
+	 */
+	boost::function<void ()> const* _tasks;
+	guint                           _n_tasks;
+	volatile guint                  _next_task;
 };
 
 } // namespace ARDOUR
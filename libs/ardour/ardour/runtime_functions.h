@@ -30,6 +30,9 @@ namespace ARDOUR {
 	typedef void  (*apply_gain_to_buffer_t)  (ARDOUR::Sample *, pframes_t, float);
 	typedef void  (*mix_buffers_with_gain_t) (ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t, float);
 	typedef void  (*mix_buffers_no_gain_t)   (ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t);
+	typedef void  (*mix_buffers_n_t)         (ARDOUR::Sample *, const ARDOUR::Sample * const *, const float *, uint32_t, pframes_t);
+	typedef float (*apply_gain_ramp_t)       (ARDOUR::Sample *, pframes_t, float, float, float);
+	typedef void  (*apply_gain_vector_t)     (ARDOUR::Sample *, const float *, pframes_t);
 	typedef void  (*copy_vector_t)           (ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t);
 
 	LIBARDOUR_API extern compute_peak_t          compute_peak;
@@ -37,6 +40,9 @@ namespace ARDOUR {
 	LIBARDOUR_API extern apply_gain_to_buffer_t  apply_gain_to_buffer;
 	LIBARDOUR_API extern mix_buffers_with_gain_t mix_buffers_with_gain;
 	LIBARDOUR_API extern mix_buffers_no_gain_t   mix_buffers_no_gain;
+	LIBARDOUR_API extern mix_buffers_n_t         mix_buffers_n;
+	LIBARDOUR_API extern apply_gain_ramp_t       apply_gain_ramp;
+	LIBARDOUR_API extern apply_gain_vector_t     apply_gain_vector;
 	LIBARDOUR_API extern copy_vector_t           copy_vector;
 }
 
@@ -88,6 +88,7 @@
 #include "ardour/presentation_info.h"
 #include "ardour/route.h"
 #include "ardour/route_graph.h"
+#include "ardour/rt_tasklist.h"
 #include "ardour/transport_api.h"
 
 class XMLTree;
@@ -154,10 +155,10 @@ class ProcessThread;
 class Progress;
 class Processor;
 class Region;
+class RenderCacheManager;
 class Return;
 class Route;
 class RouteGroup;
-class RTTaskList;
 class SMFSource;
 class Send;
 class SceneChanger;
@@ -308,6 +309,17 @@ public:
 
 	void refresh_disk_space ();
 
+	/** Start, collect and install background renders of track plugins.
+	 * Called periodically by the RenderCacheManager thread, see RenderCache.
+	 */
+	void update_render_caches ();
+	boost::shared_ptr<RenderCacheManager> render_cache_manager () const { return _render_cache_manager; }
+
+	/** Set up the processing of track plugins ahead of the playhead.
+	 * Called periodically from the GUI thread, see PlaybackLookahead.
+	 */
+	void update_playback_lookaheads ();
+
 	int load_routes (const XMLNode&, int);
 	boost::shared_ptr<RouteList> get_routes() const {
 		return routes.reader ();
@@ -341,6 +353,7 @@ public:
 	uint32_t nbusses () const;
 
 	bool plot_process_graph (std::string const& file_name) const;
+	boost::shared_ptr<Graph> process_graph () const { return _process_graph; }
 
 	boost::shared_ptr<BundleList> bundles () {
 		return _bundles.reader ();
@@ -820,6 +833,11 @@ public:
 	unsigned int    get_xrun_count () const {return _xrun_count; }
 	void            reset_xrun_count () {_xrun_count = 0; }
 
+	/** clear the execution time histograms of all routes and processors,
+	 * see Route::dsp_profile () and Processor::dsp_profile ()
+	 */
+	void reset_dsp_profiles ();
+
 	/* region info  */
 
 	boost::shared_ptr<Region> find_whole_file_parent (boost::shared_ptr<Region const>) const;
@@ -1498,6 +1516,28 @@ private:
 
 	XMLTree*         state_tree;
 	bool             state_was_pending;
+
+	/* incremental save, see session_journal.cc */
+	typedef std::map<std::string, uint64_t> StateUnitHashes;
+	StateUnitHashes _state_journal_hashes;
+	std::string     _state_journal_base;
+	uint32_t        _state_journal_saves;
+
+	/* routes, playlists and sources that did not change since the last
+	 * complete save are not serialized by an incremental save */
+	struct StateCacheEntry;
+	typedef std::map<PBD::ID, boost::shared_ptr<StateCacheEntry> > StateCache;
+	StateCache      _state_cache;
+	StateCache      _state_cache_pending;
+	bool            _state_cache_in_use;
+
+	void     arm_state_cache ();
+	XMLNode* cached_state (PBD::Stateful const&, char const* node_name) const;
+
+	int  save_state_journal (XMLNode const& root, std::string const& snapshot_name, bool pending);
+	void set_state_journal_base (XMLNode const& root);
+	int  apply_state_journal (XMLNode& root, std::string const& path);
+	static bool is_state_journal (std::string const& path);
 	StateOfTheState _state_of_the_state;
 
 	friend class    StateProtector;
@@ -1538,6 +1578,8 @@ private:
 
 	Butler* _butler;
 
+	boost::shared_ptr<RenderCacheManager> _render_cache_manager;
+
 	TransportFSM* _transport_fsm;
 
 	static const PostTransportWork ProcessCannotProceedMask = PostTransportWork (PostTransportAudition);
@@ -2140,16 +2182,17 @@ private:
 	}
 
 	/* specialized version realtime "apply to set of controls" operations */
-	SessionEvent* get_rt_event (boost::shared_ptr<ControlList> cl, double arg, PBD::Controllable::GroupControlDisposition group_override) {
+	SessionEvent* get_rt_event (boost::shared_ptr<ControlList> cl, boost::shared_ptr<RTTaskList::TaskList> tasks, double arg, PBD::Controllable::GroupControlDisposition group_override) {
 		SessionEvent* ev = new SessionEvent (SessionEvent::RealTimeOperation, SessionEvent::Add, SessionEvent::Immediate, 0, 0.0);
-		ev->rt_slot = boost::bind (&Session::rt_set_controls, this, cl, arg, group_override);
+		ev->rt_slot = boost::bind (&Session::rt_set_controls, this, cl, tasks, arg, group_override);
 		ev->rt_return = Session::rt_cleanup;
 		ev->event_loop = PBD::EventLoop::get_event_loop_for_thread ();
 
 		return ev;
 	}
 
-	void rt_set_controls (boost::shared_ptr<ControlList>, double val, PBD::Controllable::GroupControlDisposition group_override);
+	void rt_set_controls (boost::shared_ptr<ControlList>, boost::shared_ptr<RTTaskList::TaskList>, double val, PBD::Controllable::GroupControlDisposition group_override);
+	boost::shared_ptr<RTTaskList::TaskList> rt_control_tasks (boost::shared_ptr<ControlList>, double val, PBD::Controllable::GroupControlDisposition group_override) const;
 	void rt_clear_all_solo_state (boost::shared_ptr<RouteList>, bool yn, PBD::Controllable::GroupControlDisposition group_override);
 
 	void setup_midi_machine_control ();
@@ -21,6 +21,7 @@
 #ifndef __ardour_session_playlists_h__
 #define __ardour_session_playlists_h__
 
+#include <list>
 #include <set>
 #include <vector>
 #include <string>
@@ -34,6 +35,7 @@ class XMLNode;
 
 namespace PBD {
 	class ID;
+	class Stateful;
 }
 
 namespace ARDOUR {
@@ -48,6 +50,7 @@ class Track;
 class LIBARDOUR_API SessionPlaylists : public PBD::ScopedConnectionList
 {
 public:
+	SessionPlaylists ();
 	~SessionPlaylists ();
 
 	boost::shared_ptr<Playlist> by_name (std::string name);
@@ -64,8 +67,14 @@ public:
 	std::vector<boost::shared_ptr<Playlist> > playlists_for_track (boost::shared_ptr<Track>) const;
 	std::vector<boost::shared_ptr<Playlist> > get_used () const;
 	std::vector<boost::shared_ptr<Playlist> > get_unused () const;
+	/** @return number of playlists in use (unused and deferred playlists are not counted) */
 	uint32_t n_playlists() const;
 
+	/** Create all unused playlists that were not created at session load.
+	 * @return true if there were any
+	 */
+	bool load_deferred () const;
+
 private:
 	friend class Session;
 
@@ -79,16 +88,27 @@ private:
 
 	void find_equivalent_playlist_regions (boost::shared_ptr<Region>, std::vector<boost::shared_ptr<Region> >& result);
 	void update_after_tempo_map_change ();
-	void add_state (XMLNode*, bool save_template, bool include_unused);
+	void add_state (XMLNode*, bool save_template, bool include_unused, boost::function<XMLNode* (PBD::Stateful const&)> cached_state = 0);
 	bool maybe_delete_unused (boost::function<int(boost::shared_ptr<Playlist>)>);
 	int load (Session &, const XMLNode&);
-	int load_unused (Session &, const XMLNode&);
+	int load_unused (Session &, const XMLNode&, bool defer);
 	boost::shared_ptr<Playlist> XMLPlaylistFactory (Session &, const XMLNode&);
+	boost::shared_ptr<Playlist> load_deferred (const char* prop, std::string const& value);
+	boost::shared_ptr<Playlist> load_deferred_node (XMLNode const&);
 
 	mutable Glib::Threads::Mutex lock;
 	typedef std::set<boost::shared_ptr<Playlist> > List;
 	List playlists;
 	List unused_playlists;
+
+	/** state of unused playlists, which are only created on demand */
+	typedef std::list<XMLNode*> DeferredList;
+	mutable DeferredList deferred_unused;
+	Session* deferred_session;
+	/** held while deferred playlists are created, until they are
+	 * added to the playlist lists
+	 */
+	mutable Glib::Threads::RecMutex deferred_lock;
 };
 
 }
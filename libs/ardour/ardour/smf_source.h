@@ -67,6 +67,7 @@ public:
 
 	void load_model (const Glib::Threads::Mutex::Lock& lock, bool force_reload=false);
 	void destroy_model (const Glib::Threads::Mutex::Lock& lock);
+	bool defer_model (const Glib::Threads::Mutex::Lock& lock);
 
 	static bool safe_midi_file_extension (const std::string& path);
 	static bool valid_midi_file (const std::string& path);
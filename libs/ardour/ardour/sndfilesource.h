@@ -84,11 +84,34 @@ class LIBARDOUR_API SndFileSource : public AudioFileSource {
 	samplecnt_t write_unlocked (Sample *dst, samplecnt_t cnt);
 	samplecnt_t write_float (Sample* data, samplepos_t pos, samplecnt_t cnt);
 
+	void prefetch_unlocked (DiskPrefetch&, samplepos_t start, samplecnt_t cnt) const;
+
   private:
 	SNDFILE* _sndfile;
 	SF_INFO _info;
 	BroadcastInfo *_broadcast_info;
 
+	/* Uncompressed PCM files are read directly with pread(2), which
+	 * needs a single system call per read, and the data can be
+	 * prefetched. libsndfile is still used to parse the header.
+	 */
+	enum DirectFormat {
+		DirectNone,
+		DirectPCM16,
+		DirectPCM24,
+		DirectPCM32,
+		DirectFloat
+	};
+
+	int          _direct_fd;     ///< file descriptor owned by _sndfile, or -1
+	off_t        _direct_offset; ///< byte offset of the first sample
+	DirectFormat _direct_format;
+	bool         _direct_big_endian;
+
+	void setup_direct_read (int fd);
+	samplecnt_t read_direct (Sample* dst, samplepos_t start, samplecnt_t cnt) const;
+	size_t direct_bytes_per_sample () const;
+
 	void init_sndfile ();
 	int open();
 	int setup_broadcast_info (samplepos_t when, struct tm&, time_t);
@@ -69,7 +69,10 @@ class LIBARDOUR_API SourceFactory {
 	static std::list< boost::weak_ptr<AudioSource> > files_with_peaks;
 
 	static int peak_work_queue_length ();
+	static void peak_work_progress (uint32_t& done, uint32_t& total);
 	static int setup_peakfile (boost::shared_ptr<Source>, bool async);
+	static void prioritize_peakfile (boost::shared_ptr<AudioSource>);
+	static void queue_peak_pyramid (boost::shared_ptr<AudioSource>);
 };
 
 }
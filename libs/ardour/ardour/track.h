@@ -37,6 +37,7 @@ class Playlist;
 class RouteGroup;
 class Source;
 class Region;
+class DiskPrefetch;
 class DiskReader;
 class DiskWriter;
 class IO;
@@ -137,6 +138,8 @@ public:
 	float playback_buffer_load () const;
 	float capture_buffer_load () const;
 	int do_refill ();
+	int do_refill (Sample* sum_buffer, Sample* mixdown_buffer, gain_t* gain_buffer);
+	void prefetch (DiskPrefetch&);
 	int do_flush (RunContext, bool force = false);
 	void set_pending_overwrite (OverwriteReason);
 	int seek (samplepos_t, bool complete_refill = false);
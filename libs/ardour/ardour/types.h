@@ -511,6 +511,13 @@ enum DenormalModel {
 	DenormalFTZDAZ
 };
 
+enum GraphSchedulerModel {
+	/** all process threads share a single trigger-queue */
+	SharedTriggerQueue,
+	/** per thread work-stealing deques, downstream nodes prefer the same thread */
+	WorkStealing
+};
+
 enum LayerModel {
 	LaterHigher,
 	Manual
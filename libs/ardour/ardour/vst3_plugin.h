@@ -160,6 +160,7 @@ public:
 
 	/* API for Ardour -- Setup/Processing */
 	uint32_t plugin_latency ();
+	uint32_t plugin_tail ();
 	bool     set_block_size (int32_t);
 	bool     activate ();
 	bool     deactivate ();
@@ -385,6 +386,7 @@ public:
 
 private:
 	samplecnt_t plugin_latency () const;
+	samplecnt_t plugin_tail () const;
 	void        init ();
 	void        find_presets ();
 	void        forward_resize_view (int w, int h);
@@ -121,6 +121,7 @@ protected:
 	XMLTree * presets_tree () const;
 	std::string presets_file () const;
 	samplecnt_t plugin_latency() const;
+	samplecnt_t plugin_tail () const;
 	void find_presets ();
 
 	VSTHandle* _handle;
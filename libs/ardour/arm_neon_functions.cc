@@ -515,4 +515,76 @@ arm_neon_copy_vector(
 	}
 }
 
+C_FUNC float
+arm_neon_apply_gain_ramp(float *dst, uint32_t nframes, float initial, float target, float coeff)
+{
+	const float r  = 1.f - coeff;
+	const float r2 = r * r;
+	const float r4 = r2 * r2;
+
+	// Distance to target for 4 consecutive samples,
+	// the closed form avoids a dependency on the previous sample
+	float d[4];
+	d[0] = initial - target;
+	d[1] = d[0] * r;
+	d[2] = d[1] * r;
+	d[3] = d[2] * r;
+
+	float32x4_t vt = vdupq_n_f32(target);
+	float32x4_t vd = vld1q_f32(d);
+
+	while (nframes >= 4) {
+		float32x4_t x0;
+
+		x0 = vld1q_f32(dst);
+		x0 = vmulq_f32(x0, vaddq_f32(vt, vd));
+		vst1q_f32(dst, x0);
+
+		vd = vmulq_n_f32(vd, r4);
+
+		dst += 4;
+		nframes -= 4;
+	}
+
+	float dn = vgetq_lane_f32(vd, 0);
+
+	while (nframes > 0) {
+		*dst *= target + dn;
+		dn *= r;
+
+		++dst;
+		--nframes;
+	}
+
+	return target + dn;
+}
+
+C_FUNC void
+arm_neon_apply_gain_vector(float *dst, const float *gain, uint32_t nframes)
+{
+	while (nframes >= 8) {
+		float32x4_t x0, x1, g0, g1;
+
+		x0 = vld1q_f32(dst + 0);
+		x1 = vld1q_f32(dst + 4);
+		g0 = vld1q_f32(gain + 0);
+		g1 = vld1q_f32(gain + 4);
+
+		vst1q_f32(dst + 0, vmulq_f32(x0, g0));
+		vst1q_f32(dst + 4, vmulq_f32(x1, g1));
+
+		dst += 8;
+		gain += 8;
+		nframes -= 8;
+	}
+
+	while (nframes > 0) {
+		*dst *= *gain;
+
+		++dst;
+		++gain;
+		--nframes;
+	}
+}
+
 #endif
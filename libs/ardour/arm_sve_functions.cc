@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2026 The Ardour Team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "ardour/mix.h"
+
+#ifdef ARM_SVE_SUPPORT
+
+#include <arm_sve.h>
+
+/* The SVE vector length is implementation defined (128 .. 2048 bit) and
+ * only known at run-time. All loops below are vector-length agnostic:
+ * svwhilelt() produces a predicate for the active lanes, which also takes
+ * care of the tail, so no scalar head or tail loop is required.
+ */
+
+#ifdef __cplusplus
+#define C_FUNC extern "C"
+#else
+#define C_FUNC
+#endif
+
+C_FUNC float
+arm_sve_compute_peak (const float* src, uint32_t nframes, float current)
+{
+	const uint64_t n  = nframes;
+	svfloat32_t    vc = svdup_n_f32 (current);
+
+	for (uint64_t i = 0; i < n; i += svcntw ()) {
+		const svbool_t pg = svwhilelt_b32 (i, n);
+		svfloat32_t    x0 = svld1_f32 (pg, src + i);
+		vc = svmax_f32_m (pg, vc, svabs_f32_x (pg, x0));
+	}
+
+	return svmaxv_f32 (svptrue_b32 (), vc);
+}
+
+C_FUNC void
+arm_sve_find_peaks (const float* src, uint32_t nframes, float* minf, float* maxf)
+{
+	const uint64_t n    = nframes;
+	svfloat32_t    vmin = svdup_n_f32 (*minf);
+	svfloat32_t    vmax = svdup_n_f32 (*maxf);
+
+	for (uint64_t i = 0; i < n; i += svcntw ()) {
+		const svbool_t pg = svwhilelt_b32 (i, n);
+		svfloat32_t    x0 = svld1_f32 (pg, src + i);
+		vmin = svmin_f32_m (pg, vmin, x0);
+		vmax = svmax_f32_m (pg, vmax, x0);
+	}
+
+	*minf = svminv_f32 (svptrue_b32 (), vmin);
+	*maxf = svmaxv_f32 (svptrue_b32 (), vmax);
+}
+
+C_FUNC void
+arm_sve_apply_gain_to_buffer (float* dst, uint32_t nframes, float gain)
+{
+	const uint64_t n = nframes;
+
+	for (uint64_t i = 0; i < n; i += svcntw ()) {
+		const svbool_t pg = svwhilelt_b32 (i, n);
+		svfloat32_t    x0 = svld1_f32 (pg, dst + i);
+		svst1_f32 (pg, dst + i, svmul_n_f32_x (pg, x0, gain));
+	}
+}
+
+C_FUNC void
+arm_sve_mix_buffers_with_gain (float* dst, const float* src, uint32_t nframes, float gain)
+{
+	const uint64_t n = nframes;
+
+	/* not fused (svmla), to produce the same result as the default function */
+	for (uint64_t i = 0; i < n; i += svcntw ()) {
+		const svbool_t pg = svwhilelt_b32 (i, n);
+		svfloat32_t    s0 = svld1_f32 (pg, src + i);
+		svfloat32_t    d0 = svld1_f32 (pg, dst + i);
+		svst1_f32 (pg, dst + i, svadd_f32_x (pg, d0, svmul_n_f32_x (pg, s0, gain)));
+	}
+}
+
+C_FUNC void
+arm_sve_mix_buffers_no_gain (float* dst, const float* src, uint32_t nframes)
+{
+	const uint64_t n = nframes;
+
+	for (uint64_t i = 0; i < n; i += svcntw ()) {
+		const svbool_t pg = svwhilelt_b32 (i, n);
+		svfloat32_t    s0 = svld1_f32 (pg, src + i);
+		svfloat32_t    d0 = svld1_f32 (pg, dst + i);
+		svst1_f32 (pg, dst + i, svadd_f32_x (pg, d0, s0));
+	}
+}
+
+C_FUNC void
+arm_sve_copy_vector (float* dst, const float* src, uint32_t nframes)
+{
+	const uint64_t n = nframes;
+
+	for (uint64_t i = 0; i < n; i += svcntw ()) {
+		const svbool_t pg = svwhilelt_b32 (i, n);
+		svst1_f32 (pg, dst + i, svld1_f32 (pg, src + i));
+	}
+}
+
+C_FUNC void
+arm_sve_mix_buffers_n (float* dst, const float* const* srcs, const float* gains, uint32_t n_src, uint32_t nframes)
+{
+	const uint64_t n = nframes;
+
+	/* add all sources to one vector of the destination before moving on */
+	for (uint64_t i = 0; i < n; i += svcntw ()) {
+		const svbool_t pg = svwhilelt_b32 (i, n);
+		svfloat32_t    d0 = svld1_f32 (pg, dst + i);
+		for (uint32_t s = 0; s < n_src; ++s) {
+			svfloat32_t s0 = svld1_f32 (pg, srcs[s] + i);
+			if (gains) {
+				s0 = svmul_n_f32_x (pg, s0, gains[s]);
+			}
+			d0 = svadd_f32_x (pg, d0, s0);
+		}
+		svst1_f32 (pg, dst + i, d0);
+	}
+}
+
+#endif
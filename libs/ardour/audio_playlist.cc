@@ -22,6 +22,8 @@
  */
 
 #include <algorithm>
+#include <limits>
+#include <map>
 
 #include <cstdlib>
 
@@ -191,6 +193,54 @@ AudioPlaylist::read (Sample *buf, Sample *mixdown_buffer, float *gain_buffer, sa
 
 	Playlist::RegionReadLock rl (this);
 
+	if (_session.solo_selection_active () && SoloSelectedActive ()) {
+		/* which regions are audible depends on the editor selection */
+		return read_unplanned (buf, mixdown_buffer, gain_buffer, start, cnt, chan_n);
+	}
+
+	boost::shared_ptr<RenderPlan const> plan = render_plan ();
+	samplepos_t const                   end  = start + cnt - 1;
+
+	/* Collect the segments that intersect the range ... */
+	static const size_t  max_hits = 128;
+	RenderSegment const* hits[max_hits];
+	size_t               n_hits = 0;
+
+	if (!collect_segments (*plan, 0, plan->size (), start, end, hits, n_hits, max_hits)) {
+		/* unusually deep or fragmented: don't bother */
+		return read_unplanned (buf, mixdown_buffer, gain_buffer, start, cnt, chan_n);
+	}
+
+	/* ... and put them into read order; there are few, and they are mostly sorted already */
+	for (size_t n = 1; n < n_hits; ++n) {
+		RenderSegment const* h = hits[n];
+		size_t               k = n;
+		for (; k > 0 && hits[k - 1]->order > h->order; --k) {
+			hits[k] = hits[k - 1];
+		}
+		hits[k] = h;
+	}
+
+	for (size_t n = 0; n < n_hits; ++n) {
+		samplepos_t const from = max (hits[n]->from, start);
+		samplepos_t const to   = min (hits[n]->to, end);
+		DEBUG_TRACE (DEBUG::AudioPlayback, string_compose ("\tPlaylist %1 read %2 @ %3 for %4, channel %5, buf @ %6 offset %7\n",
+								   name(), hits[n]->region->name(), from,
+								   to - from + 1, (int) chan_n,
+								   buf, from - start));
+		hits[n]->region->read_at (buf + from - start, mixdown_buffer, gain_buffer, from, to - from + 1, chan_n);
+	}
+
+	return cnt;
+}
+
+/** Read without using the render plan, sorting and flattening the regions
+ *  touched by the given range on the fly. Caller must hold the region lock,
+ *  and have zeroed @param buf.
+ */
+ARDOUR::samplecnt_t
+AudioPlaylist::read_unplanned (Sample *buf, Sample *mixdown_buffer, float *gain_buffer, samplepos_t start, samplecnt_t cnt, uint32_t chan_n)
+{
 	/* Find all the regions that are involved in the bit we are reading,
 	   and sort them by descending layer and ascending position.
 	*/
@@ -245,7 +295,7 @@ AudioPlaylist::read (Sample *buf, Sample *mixdown_buffer, float *gain_buffer, sa
 			if (ar->opaque ()) {
 				/* Cut this range down to just the body and mark it done */
 				Evoral::Range<samplepos_t> body = ar->body_range ();
-				if (body.from < d.to && body.to > d.from) {
+				if (body.from <= d.to && body.to >= d.from) {
 					d.from = max (d.from, body.from);
 					d.to = min (d.to, body.to);
 					done.add (d);
@@ -266,6 +316,206 @@ AudioPlaylist::read (Sample *buf, Sample *mixdown_buffer, float *gain_buffer, sa
 	return cnt;
 }
 
+/** Set max_to of the implicit tree over [lo, hi) of the plan, whose
+ *  root is the segment at (lo + hi) / 2.
+ */
+samplepos_t
+AudioPlaylist::build_segment_tree (RenderPlan& plan, size_t lo, size_t hi)
+{
+	if (lo >= hi) {
+		return std::numeric_limits<samplepos_t>::min ();
+	}
+
+	size_t const mid = lo + (hi - lo) / 2;
+
+	samplepos_t m = plan[mid].to;
+	m = max (m, build_segment_tree (plan, lo, mid));
+	m = max (m, build_segment_tree (plan, mid + 1, hi));
+
+	plan[mid].max_to = m;
+	return m;
+}
+
+/** Add the segments in [lo, hi) of the plan that intersect start .. end to @param hits.
+ *  @return false if there are more than @param max_hits of them.
+ */
+bool
+AudioPlaylist::collect_segments (RenderPlan const& plan, size_t lo, size_t hi, samplepos_t start, samplepos_t end,
+                                 RenderSegment const** hits, size_t& n_hits, size_t max_hits)
+{
+	while (lo < hi) {
+		size_t const         mid = lo + (hi - lo) / 2;
+		RenderSegment const& seg = plan[mid];
+
+		if (seg.max_to < start) {
+			return true;
+		}
+
+		if (!collect_segments (plan, lo, mid, start, end, hits, n_hits, max_hits)) {
+			return false;
+		}
+
+		if (seg.from > end) {
+			return true;
+		}
+
+		if (seg.to >= start) {
+			if (n_hits == max_hits) {
+				return false;
+			}
+			hits[n_hits++] = &seg;
+		}
+
+		lo = mid + 1;
+	}
+
+	return true;
+}
+
+boost::shared_ptr<AudioPlaylist::RenderPlan const>
+AudioPlaylist::render_plan ()
+{
+	Glib::Threads::Mutex::Lock lm (_render_plan_lock);
+
+	if (!_render_plan) {
+		_render_plan = build_render_plan ();
+	}
+
+	return _render_plan;
+}
+
+void
+AudioPlaylist::render_state_changed ()
+{
+	boost::shared_ptr<RenderPlan const> old;
+
+	{
+		Glib::Threads::Mutex::Lock lm (_render_plan_lock);
+		_render_plan.swap (old);
+	}
+
+	/* old plan, and maybe regions, are released here, without the lock */
+}
+
+/** Flatten the whole playlist into segments the same way read_unplanned()
+ *  does for a range: going from the top layer down, each region contributes
+ *  the parts not yet covered by the body of an opaque region above it.
+ *  Caller must hold the region lock.
+ */
+boost::shared_ptr<AudioPlaylist::RenderPlan const>
+AudioPlaylist::build_render_plan () const
+{
+	RenderPlan* plan = new RenderPlan;
+
+	RegionList all;
+	for (RegionList::const_iterator i = regions.begin(); i != regions.end(); ++i) {
+		/* muted regions don't figure into it at all */
+		if (!(*i)->muted()) {
+			all.push_back (*i);
+		}
+	}
+	all.sort (ReadSorter ());
+
+	/* the parts of the timeline that are done, as disjoint ranges from -> to */
+	typedef std::map<samplepos_t, samplepos_t> DoneMap;
+	DoneMap done;
+
+	std::vector<Evoral::Range<samplepos_t> > region_to_do;
+
+	for (RegionList::iterator i = all.begin(); i != all.end(); ++i) {
+		boost::shared_ptr<AudioRegion> ar = boost::dynamic_pointer_cast<AudioRegion> (*i);
+		Evoral::Range<samplepos_t> const region_range = ar->range ();
+
+		/* subtract the done ranges from the region */
+		region_to_do.clear ();
+
+		DoneMap::const_iterator d = done.upper_bound (region_range.from);
+		if (d != done.begin ()) {
+			DoneMap::const_iterator p = d;
+			--p;
+			if (p->second >= region_range.from) {
+				d = p;
+			}
+		}
+
+		samplepos_t pos = region_range.from;
+		for (; d != done.end () && d->first <= region_range.to && pos <= region_range.to; ++d) {
+			if (d->first > pos) {
+				region_to_do.push_back (Evoral::Range<samplepos_t> (pos, d->first - 1));
+			}
+			pos = max (pos, d->second + 1);
+		}
+		if (pos <= region_range.to) {
+			region_to_do.push_back (Evoral::Range<samplepos_t> (pos, region_range.to));
+		}
+
+		for (std::vector<Evoral::Range<samplepos_t> >::const_iterator j = region_to_do.begin(); j != region_to_do.end(); ++j) {
+			RenderSegment seg;
+			seg.region = ar;
+			seg.from   = j->from;
+			seg.to     = j->to;
+			plan->push_back (seg);
+
+			if (!ar->opaque ()) {
+				continue;
+			}
+
+			/* Cut this range down to just the body and mark it done */
+			Evoral::Range<samplepos_t> const body = ar->body_range ();
+			if (body.from > j->to || body.to < j->from) {
+				continue;
+			}
+
+			samplepos_t from = max (j->from, body.from);
+			samplepos_t to   = min (j->to, body.to);
+
+			/* merge with overlapping or adjacent done ranges */
+			DoneMap::iterator m = done.upper_bound (from);
+			if (m != done.begin ()) {
+				DoneMap::iterator p = m;
+				--p;
+				if (p->second + 1 >= from) {
+					m = p;
+				}
+			}
+			while (m != done.end () && m->first <= to + 1) {
+				from = min (from, m->first);
+				to   = max (to, m->second);
+				done.erase (m++);
+			}
+			done.insert (std::make_pair (from, to));
+		}
+	}
+
+	/* segments are read bottom up, i.e. in reverse order of creation */
+	uint32_t const n = plan->size ();
+	for (uint32_t k = 0; k < n; ++k) {
+		(*plan)[k].order = n - 1 - k;
+	}
+
+	std::stable_sort (plan->begin (), plan->end ());
+	build_segment_tree (*plan, 0, plan->size ());
+
+	DEBUG_TRACE (DEBUG::AudioPlayback, string_compose ("Playlist %1 render plan: %2 segments for %3 regions\n", name(), plan->size(), all.size()));
+
+	return boost::shared_ptr<RenderPlan const> (plan);
+}
+
+void
+AudioPlaylist::prefetch (DiskPrefetch& dp, samplepos_t start, samplecnt_t cnt)
+{
+	Playlist::RegionReadLock rl (this);
+
+	boost::shared_ptr<RegionList> all = regions_touched_locked (start, start + cnt - 1);
+
+	for (RegionList::iterator i = all->begin(); i != all->end(); ++i) {
+		boost::shared_ptr<AudioRegion> ar = boost::dynamic_pointer_cast<AudioRegion> (*i);
+		if (ar && !ar->muted ()) {
+			ar->prefetch (dp, start, cnt);
+		}
+	}
+}
+
 void
 AudioPlaylist::dump () const
 {
@@ -308,6 +558,7 @@ AudioPlaylist::destroy_region (boost::shared_ptr<Region> region)
 
 			if ((*i) == region) {
 				regions.erase (i);
+				region_index_remove (region);
 				changed = true;
 			}
 
@@ -46,6 +46,8 @@
 #include "ardour/profile.h"
 #include "ardour/region.h"
 #include "ardour/region_factory.h"
+#include "ardour/playback_lookahead.h"
+#include "ardour/render_cache.h"
 #include "ardour/session.h"
 #include "ardour/session_playlists.h"
 #include "ardour/source.h"
@@ -61,10 +63,16 @@ using namespace PBD;
 AudioTrack::AudioTrack (Session& sess, string name, TrackMode mode)
 	: Track (sess, name, PresentationInfo::AudioTrack, mode)
 {
+	_render_cache.reset (new RenderCache (sess, *this));
+	_playback_lookahead.reset (new PlaybackLookahead (sess, *this));
 }
 
 AudioTrack::~AudioTrack ()
 {
+	/* cancel any render before the track goes away */
+	_render_cache.reset ();
+	_playback_lookahead.reset ();
+
 	if (_freeze_record.playlist && !_session.deletion_in_progress()) {
 		_freeze_record.playlist->release();
 	}
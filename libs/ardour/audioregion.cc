@@ -1383,6 +1383,21 @@ AudioRegion::read_raw_internal (Sample* buf, samplepos_t pos, samplecnt_t cnt, i
 	return audio_source(channel)->read (buf, pos, cnt);
 }
 
+void
+AudioRegion::prefetch (DiskPrefetch& dp, samplepos_t position, samplecnt_t cnt) const
+{
+	const samplepos_t from = max (position, _position.val ());
+	const samplepos_t to   = min (position + cnt, _position.val () + _length.val ());
+
+	if (to <= from) {
+		return;
+	}
+
+	for (uint32_t n = 0; n < n_channels (); ++n) {
+		audio_source (n)->prefetch (dp, _start + (from - _position), to - from);
+	}
+}
+
 void
 AudioRegion::set_scale_amplitude (gain_t g)
 {
@@ -60,9 +60,11 @@
 #include "pbd/xml++.h"
 
 #include "ardour/audiosource.h"
+#include "ardour/filename_extensions.h"
 #include "ardour/rc_configuration.h"
 #include "ardour/runtime_functions.h"
 #include "ardour/session.h"
+#include "ardour/source_factory.h"
 
 #include "pbd/i18n.h"
 
@@ -79,12 +81,144 @@ bool AudioSource::_build_peakfiles = false;
 
 #define _FPP 256
 
+/* The peak pyramid is a sidecar to the peakfile with coarser levels of
+ * the same data, so that zoomed out views do not have to reduce the
+ * whole peakfile on every redraw.
+ *
+ * Levels are stored in fixed size blocks, each covering
+ * _PYR_BLOCK_SAMPLES of audio. Within a block all peaks of a level are
+ * contiguous. This allows to extend the pyramid while recording,
+ * without knowing the final length of the source.
+ */
+#define _PYR_MAGIC         0x52595041 // "APYR"
+#define _PYR_VERSION       1
+#define _PYR_LEVELS        2
+#define _PYR_HEADER_SIZE   64
+#define _PYR_BLOCK_SAMPLES (65536 * 256)
+
+static const samplecnt_t pyramid_fpp[_PYR_LEVELS] = { 4096, 65536 };
+
+struct PeakPyramidHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t base_fpp;
+	uint32_t n_levels;
+	uint32_t level_fpp[_PYR_LEVELS];
+	uint32_t block_samples;
+	uint32_t reserved;
+	int64_t  n_base_peaks; // number of base peaks the pyramid is valid for, 0 while writing
+};
+
+static samplecnt_t
+pyramid_block_peaks ()
+{
+	samplecnt_t n = 0;
+	for (int l = 0; l < _PYR_LEVELS; ++l) {
+		n += _PYR_BLOCK_SAMPLES / pyramid_fpp[l];
+	}
+	return n;
+}
+
+static off_t
+pyramid_offset (int level, samplepos_t peak)
+{
+	const samplecnt_t level_peaks = _PYR_BLOCK_SAMPLES / pyramid_fpp[level];
+	samplecnt_t level_off = 0;
+	for (int l = 0; l < level; ++l) {
+		level_off += _PYR_BLOCK_SAMPLES / pyramid_fpp[l];
+	}
+	const off_t block = peak / level_peaks;
+	return _PYR_HEADER_SIZE + (block * pyramid_block_peaks () + level_off + (peak % level_peaks)) * sizeof (PeakData);
+}
+
+/** read or write @param n peaks of the given level, splitting the I/O at block boundaries */
+static bool
+pyramid_io (int fd, bool write, int level, samplepos_t first, samplecnt_t n, PeakData* data)
+{
+	const samplecnt_t level_peaks = _PYR_BLOCK_SAMPLES / pyramid_fpp[level];
+
+	while (n > 0) {
+		const samplecnt_t run = min (n, level_peaks - (first % level_peaks));
+		const off_t byte = pyramid_offset (level, first);
+		const ssize_t bytes = run * sizeof (PeakData);
+
+		if (lseek (fd, byte, SEEK_SET) != byte) {
+			return false;
+		}
+		if (write) {
+			if (::write (fd, data, bytes) != bytes) {
+				return false;
+			}
+		} else {
+			ssize_t r = ::read (fd, data, bytes);
+			if (r < 0) {
+				return false;
+			}
+			if (r < bytes) {
+				/* sparse tail of the last block */
+				memset ((char*)data + r, 0, bytes - r);
+			}
+		}
+		first += run;
+		data += run;
+		n -= run;
+	}
+	return true;
+}
+
+static bool
+read_pyramid_header (int fd, PeakPyramidHeader& h)
+{
+	if (lseek (fd, 0, SEEK_SET) != 0 || ::read (fd, &h, sizeof (h)) != (ssize_t) sizeof (h)) {
+		return false;
+	}
+	if (h.magic != _PYR_MAGIC || h.version != _PYR_VERSION || h.base_fpp != _FPP
+	    || h.n_levels != _PYR_LEVELS || h.block_samples != _PYR_BLOCK_SAMPLES) {
+		return false;
+	}
+	for (int l = 0; l < _PYR_LEVELS; ++l) {
+		if (h.level_fpp[l] != pyramid_fpp[l]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool
+write_pyramid_header (int fd, int64_t n_base_peaks)
+{
+	PeakPyramidHeader h;
+	memset (&h, 0, sizeof (h));
+	h.magic         = _PYR_MAGIC;
+	h.version       = _PYR_VERSION;
+	h.base_fpp      = _FPP;
+	h.n_levels      = _PYR_LEVELS;
+	h.block_samples = _PYR_BLOCK_SAMPLES;
+	h.n_base_peaks  = n_base_peaks;
+	for (int l = 0; l < _PYR_LEVELS; ++l) {
+		h.level_fpp[l] = pyramid_fpp[l];
+	}
+	return lseek (fd, 0, SEEK_SET) == 0 && ::write (fd, &h, sizeof (h)) == (ssize_t) sizeof (h);
+}
+
+static void
+reduce_peaks (PeakData const* src, samplecnt_t n, PeakData& dst)
+{
+	dst = src[0];
+	for (samplecnt_t i = 1; i < n; ++i) {
+		dst.max = max (dst.max, src[i].max);
+		dst.min = min (dst.min, src[i].min);
+	}
+}
+
 AudioSource::AudioSource (Session& s, const string& name)
 	: Source (s, DataType::AUDIO, name)
 	, _length (0)
 	, _peak_byte_max (0)
 	, _peaks_built (false)
 	, _peakfile_fd (-1)
+	, _peak_pyramid_fd (-1)
+	, _pyramid_generation (0)
 	, peak_leftover_cnt (0)
 	, peak_leftover_size (0)
 	, peak_leftovers (0)
@@ -93,6 +227,9 @@ AudioSource::AudioSource (Session& s, const string& name)
 	, _last_scale (0.0)
 	, _last_map_off (0)
 	, _last_raw_map_length (0)
+	, _pyramid_read_fd (-1)
+	, _pyramid_read_generation (0)
+	, _pyramid_staging_size (0)
 {
 }
 
@@ -102,6 +239,8 @@ AudioSource::AudioSource (Session& s, const XMLNode& node)
 	, _peak_byte_max (0)
 	, _peaks_built (false)
 	, _peakfile_fd (-1)
+	, _peak_pyramid_fd (-1)
+	, _pyramid_generation (0)
 	, peak_leftover_cnt (0)
 	, peak_leftover_size (0)
 	, peak_leftovers (0)
@@ -110,6 +249,9 @@ AudioSource::AudioSource (Session& s, const XMLNode& node)
 	, _last_scale (0.0)
 	, _last_map_off (0)
 	, _last_raw_map_length (0)
+	, _pyramid_read_fd (-1)
+	, _pyramid_read_generation (0)
+	, _pyramid_staging_size (0)
 {
 	if (set_state (node, Stateful::loading_state_version)) {
 		throw failed_constructor();
@@ -129,6 +271,16 @@ AudioSource::~AudioSource ()
 		_peakfile_fd = -1;
 	}
 
+	if ((-1) != _peak_pyramid_fd) {
+		close (_peak_pyramid_fd);
+		_peak_pyramid_fd = -1;
+	}
+
+	if ((-1) != _pyramid_read_fd) {
+		close (_pyramid_read_fd);
+		_pyramid_read_fd = -1;
+	}
+
 	delete [] peak_leftovers;
 }
 
@@ -222,6 +374,7 @@ AudioSource::rename_peakfile (string newpath)
 	/* caller must hold _lock */
 
 	string oldpath = _peakpath;
+	string oldpyramid = peak_pyramid_path ();
 
 	if (Glib::file_test (oldpath, Glib::FILE_TEST_EXISTS)) {
 		if (g_rename (oldpath.c_str(), newpath.c_str()) != 0) {
@@ -232,9 +385,33 @@ AudioSource::rename_peakfile (string newpath)
 
 	_peakpath = newpath;
 
+	if (Glib::file_test (oldpyramid, Glib::FILE_TEST_EXISTS)) {
+		/* the pyramid is only a cache, if it cannot be moved, drop it */
+		if (g_rename (oldpyramid.c_str(), peak_pyramid_path ().c_str()) != 0) {
+			::g_unlink (oldpyramid.c_str());
+		}
+		pyramid_changed ();
+	}
+
 	return 0;
 }
 
+string
+AudioSource::peak_pyramid_path () const
+{
+	if (_peakpath.empty ()) {
+		return string ();
+	}
+
+	const string suffix (peakfile_suffix);
+
+	if (_peakpath.size () > suffix.size () && _peakpath.compare (_peakpath.size () - suffix.size (), suffix.size (), suffix) == 0) {
+		return _peakpath.substr (0, _peakpath.size () - suffix.size ()) + peak_pyramid_suffix;
+	}
+
+	return _peakpath + peak_pyramid_suffix;
+}
+
 int
 AudioSource::initialize_peakfile (const string& audio_path, const bool in_session)
 {
@@ -308,6 +485,24 @@ AudioSource::initialize_peakfile (const string& audio_path, const bool in_sessio
 
 	if (!empty() && !_peaks_built && _build_missing_peakfiles && _build_peakfiles) {
 		build_peaks_from_scratch ();
+	} else if (_peaks_built && _build_peakfiles) {
+		/* peakfiles written by older versions, or whose pyramid was lost */
+		GStatBuf stat_pyramid;
+		bool valid = false;
+		const string pyramid = peak_pyramid_path ();
+
+		if (g_stat (pyramid.c_str(), &stat_pyramid) == 0 && stat_pyramid.st_mtime >= statbuf.st_mtime) {
+			ScopedFileDescriptor sfd (g_open (pyramid.c_str(), O_RDONLY, 0444));
+			PeakPyramidHeader h;
+			valid = sfd >= 0 && read_pyramid_header (sfd, h) && h.n_base_peaks == (int64_t) (_peak_byte_max / sizeof (PeakData));
+		}
+
+		if (!valid) {
+			/* this can take a while for long files, and is not needed until the
+			 * user zooms out. Until it is done, the peakfile is used. */
+			DEBUG_TRACE(DEBUG::Peaks, string_compose("Peak pyramid %1 is missing or stale, queue rebuild\n", pyramid));
+			SourceFactory::queue_peak_pyramid (boost::dynamic_pointer_cast<AudioSource> (shared_from_this ()));
+		}
 	}
 
 	return 0;
@@ -322,6 +517,15 @@ AudioSource::read (Sample *dst, samplepos_t start, samplecnt_t cnt, int /*channe
 	return read_unlocked (dst, start, cnt);
 }
 
+void
+AudioSource::prefetch (DiskPrefetch& dp, samplepos_t start, samplecnt_t cnt) const
+{
+	Glib::Threads::Mutex::Lock lm (_lock, Glib::Threads::TRY_LOCK);
+	if (lm.locked ()) {
+		prefetch_unlocked (dp, start, cnt);
+	}
+}
+
 samplecnt_t
 AudioSource::write (Sample *dst, samplecnt_t cnt)
 {
@@ -334,9 +538,105 @@ AudioSource::write (Sample *dst, samplecnt_t cnt)
 int
 AudioSource::read_peaks (PeakData *peaks, samplecnt_t npeaks, samplepos_t start, samplecnt_t cnt, double samples_per_visual_peak) const
 {
+	if (samples_per_visual_peak >= pyramid_fpp[0]) {
+		if (read_peaks_from_pyramid (peaks, npeaks, start, cnt, samples_per_visual_peak) == 0) {
+			return 0;
+		}
+	}
 	return read_peaks_with_fpp (peaks, npeaks, start, cnt, samples_per_visual_peak, _FPP);
 }
 
+/** Read peaks from the coarsest pyramid level that still has at least the
+ *  requested resolution. The cost is proportional to @param npeaks, not to @param cnt.
+ *
+ *  @return 0 on success, -1 if the pyramid is not available or does not
+ *  (yet) cover the range, in which case the caller falls back to the peakfile.
+ */
+int
+AudioSource::read_peaks_from_pyramid (PeakData *peaks, samplecnt_t npeaks, samplepos_t start, samplecnt_t cnt,
+                                      double samples_per_visual_peak) const
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+
+	if (npeaks <= 0 || _peakpath.empty ()) {
+		return -1;
+	}
+
+	int level = 0;
+	while (level + 1 < _PYR_LEVELS && pyramid_fpp[level + 1] <= samples_per_visual_peak) {
+		++level;
+	}
+	const samplecnt_t fpp = pyramid_fpp[level];
+
+	/* keep the pyramid open across redraws, re-open if it was replaced */
+	const gint generation = g_atomic_int_get (&_pyramid_generation);
+
+	if (_pyramid_read_fd >= 0 && _pyramid_read_generation != generation) {
+		close (_pyramid_read_fd);
+		_pyramid_read_fd = -1;
+	}
+
+	if (_pyramid_read_fd < 0) {
+		if ((_pyramid_read_fd = g_open (peak_pyramid_path ().c_str(), O_RDONLY, 0444)) < 0) {
+			return -1;
+		}
+		_pyramid_read_generation = generation;
+	}
+
+	PeakPyramidHeader h;
+	if (!read_pyramid_header (_pyramid_read_fd, h)) {
+		return -1;
+	}
+
+	/* fix for near-end-of-file conditions */
+	samplecnt_t read_npeaks = npeaks;
+	if (cnt + start > _length) {
+		cnt = std::max ((samplecnt_t)0, _length - start);
+		read_npeaks = min ((samplecnt_t) ceil (cnt / samples_per_visual_peak), npeaks);
+	}
+
+	const samplepos_t end = start + cnt;
+
+	/* the pyramid is only finalized once the peakfile is complete */
+	if (read_npeaks > 0 && h.n_base_peaks < (int64_t) ((end + _FPP - 1) / _FPP)) {
+		return -1;
+	}
+
+	DEBUG_TRACE (DEBUG::Peaks, string_compose ("PYRAMID: npeaks = %1 start = %2 cnt = %3 spp = %4 level fpp = %5\n",
+	                                           npeaks, start, cnt, samples_per_visual_peak, fpp));
+
+	if (read_npeaks > 0) {
+		const samplepos_t first = start / fpp;
+		const samplecnt_t n = (end + fpp - 1) / fpp - first;
+
+		if (_pyramid_staging_size < n) {
+			_pyramid_staging.reset (new PeakData[n]);
+			_pyramid_staging_size = n;
+		}
+
+		PeakData* staging = _pyramid_staging.get ();
+
+		if (!pyramid_io (_pyramid_read_fd, false, level, first, n, staging)) {
+			error << string_compose (_("%1: could not read peak pyramid (%2)"), _name, strerror (errno)) << endmsg;
+			return -1;
+		}
+
+		for (samplecnt_t i = 0; i < read_npeaks; ++i) {
+			const samplepos_t s0 = start + (samplepos_t) floor (i * samples_per_visual_peak);
+			const samplepos_t s1 = min (end, start + (samplepos_t) floor ((i + 1) * samples_per_visual_peak));
+			const samplepos_t p0 = min (s0 / fpp - first, n - 1);
+			const samplepos_t p1 = max (p0 + 1, min ((s1 + fpp - 1) / fpp - first, n));
+			reduce_peaks (&staging[p0], p1 - p0, peaks[i]);
+		}
+	}
+
+	if (read_npeaks < npeaks) {
+		memset (&peaks[read_npeaks], 0, sizeof (PeakData) * (npeaks - read_npeaks));
+	}
+
+	return 0;
+}
+
 /** @param peaks Buffer to write peak data.
  *  @param npeaks Number of peaks to write.
  */
@@ -763,7 +1063,9 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, samplecnt_t npeaks, samplepos
 int
 AudioSource::build_peaks_from_scratch ()
 {
-	const samplecnt_t bufsize = 65536; // 256kB per disk read for mono data is about ideal
+	/* 1MB per disk read for mono data. Several sources are built concurrently,
+	 * larger reads keep each one sequential on disk. */
+	const samplecnt_t bufsize = 262144;
 
 	DEBUG_TRACE (DEBUG::Peaks, "Building peaks from scratch\n");
 
@@ -829,11 +1131,97 @@ AudioSource::build_peaks_from_scratch ()
 	if (ret) {
 		DEBUG_TRACE (DEBUG::Peaks, string_compose("Could not write peak data, attempting to remove peakfile %1\n", _peakpath));
 		::g_unlink (_peakpath.c_str());
+		::g_unlink (peak_pyramid_path ().c_str());
+		pyramid_changed ();
 	}
 
 	return ret;
 }
 
+/** (Re)build the peak pyramid from a complete peakfile.
+ *
+ *  This is called from a peak building thread, see SourceFactory::queue_peak_pyramid ().
+ *  The files are opened separately from the ones used while writing peaks,
+ *  and the lock is only held for each chunk, so that reading audio or peaks
+ *  is not blocked while the pyramid is built. If peaks are (re)written
+ *  meanwhile, the build is abandoned.
+ */
+int
+AudioSource::build_peak_pyramid ()
+{
+	const string pyramid = peak_pyramid_path ();
+	samplecnt_t  n_base_peaks;
+	gint         generation;
+
+	ScopedFileDescriptor peak_fd (g_open (_peakpath.c_str(), O_RDONLY, 0444));
+	if (peak_fd < 0) {
+		return -1;
+	}
+
+	ScopedFileDescriptor pyramid_fd (g_open (pyramid.c_str(), O_CREAT|O_RDWR, 0664));
+	if (pyramid_fd < 0) {
+		error << string_compose(_("AudioSource: cannot open peak pyramid \"%1\" (%2)"), pyramid, strerror (errno)) << endmsg;
+		return -1;
+	}
+
+	{
+		Glib::Threads::Mutex::Lock lp (_lock);
+
+		if (_peakfile_fd >= 0 || _peak_pyramid_fd >= 0) {
+			/* peaks are being written, the pyramid is updated along with them */
+			return -1;
+		}
+
+		pyramid_changed ();
+
+		if (!write_pyramid_header (pyramid_fd, 0) || 0 != ftruncate (pyramid_fd, _PYR_HEADER_SIZE)) {
+			::g_unlink (pyramid.c_str());
+			return -1;
+		}
+
+		n_base_peaks = _peak_byte_max / sizeof (PeakData);
+		generation   = g_atomic_int_get (&_pyramid_generation);
+	}
+
+	DEBUG_TRACE (DEBUG::Peaks, string_compose ("Building peak pyramid %1\n", pyramid));
+
+	/* multiple of the coarsest level, so that each chunk is self-contained */
+	const samplecnt_t chunk = 256 * (pyramid_fpp[_PYR_LEVELS - 1] / _FPP);
+
+	bool ok = true;
+
+	for (samplepos_t p = 0; ok && p < n_base_peaks; p += chunk) {
+		if (_session.deletion_in_progress() || _session.peaks_cleanup_in_progres()) {
+			ok = false;
+			break;
+		}
+
+		Glib::Threads::Mutex::Lock lp (_lock);
+
+		if (g_atomic_int_get (&_pyramid_generation) != generation) {
+			/* the peakfile was closed or re-opened for writing meanwhile */
+			DEBUG_TRACE (DEBUG::Peaks, string_compose ("Peak pyramid %1 was abandoned\n", pyramid));
+			return -1;
+		}
+
+		update_peak_pyramid (peak_fd, pyramid_fd, p, min (chunk, n_base_peaks - p));
+	}
+
+	Glib::Threads::Mutex::Lock lp (_lock);
+
+	if (g_atomic_int_get (&_pyramid_generation) != generation) {
+		return -1;
+	}
+
+	if (!ok || !write_pyramid_header (pyramid_fd, n_base_peaks)) {
+		::g_unlink (pyramid.c_str());
+		pyramid_changed ();
+		return -1;
+	}
+
+	return 0;
+}
+
 int
 AudioSource::close_peakfile ()
 {
@@ -842,8 +1230,14 @@ AudioSource::close_peakfile ()
 		close (_peakfile_fd);
 		_peakfile_fd = -1;
 	}
+	if (_peak_pyramid_fd >= 0) {
+		close (_peak_pyramid_fd);
+		_peak_pyramid_fd = -1;
+	}
 	if (!_peakpath.empty()) {
 		::g_unlink (_peakpath.c_str());
+		::g_unlink (peak_pyramid_path ().c_str());
+		pyramid_changed ();
 	}
 	_peaks_built = false;
 	return 0;
@@ -860,6 +1254,17 @@ AudioSource::prepare_for_peakfile_writes ()
 		error << string_compose(_("AudioSource: cannot open _peakpath (c) \"%1\" (%2)"), _peakpath, strerror (errno)) << endmsg;
 		return -1;
 	}
+
+	/* the pyramid is optional, failing to create it only costs zoomed-out redraw time */
+	const string pyramid = peak_pyramid_path ();
+	if ((_peak_pyramid_fd = g_open (pyramid.c_str(), O_CREAT|O_RDWR, 0664)) >= 0) {
+		if (!write_pyramid_header (_peak_pyramid_fd, 0) || ftruncate (_peak_pyramid_fd, _PYR_HEADER_SIZE)) {
+			close (_peak_pyramid_fd);
+			_peak_pyramid_fd = -1;
+			::g_unlink (pyramid.c_str());
+		}
+	}
+	pyramid_changed ();
 	return 0;
 }
 
@@ -871,6 +1276,10 @@ AudioSource::done_with_peakfile_writes (bool done)
 			close (_peakfile_fd);
 			_peakfile_fd = -1;
 		}
+		if (_peak_pyramid_fd >= 0) {
+			close (_peak_pyramid_fd);
+			_peak_pyramid_fd = -1;
+		}
 		return;
 	}
 
@@ -881,6 +1290,15 @@ AudioSource::done_with_peakfile_writes (bool done)
 	close (_peakfile_fd);
 	_peakfile_fd = -1;
 
+	if (_peak_pyramid_fd >= 0) {
+		/* only a complete pyramid is used for reading */
+		if (done) {
+			write_pyramid_header (_peak_pyramid_fd, _peak_byte_max / sizeof (PeakData));
+		}
+		close (_peak_pyramid_fd);
+		_peak_pyramid_fd = -1;
+	}
+
 	if (done) {
 		Glib::Threads::Mutex::Lock lm (_peaks_ready_lock);
 		_peaks_built = true;
@@ -947,6 +1365,10 @@ AudioSource::compute_and_write_peaks (Sample* buf, samplecnt_t first_sample, sam
 
 			_peak_byte_max = max (_peak_byte_max, (off_t) (byte + sizeof(PeakData)));
 
+			if (fpp == _FPP) {
+				update_peak_pyramid (_peakfile_fd, _peak_pyramid_fd, peak_leftover_sample / fpp, 1);
+			}
+
 			{
 				Glib::Threads::Mutex::Lock lm (_peaks_ready_lock);
 				PeakRangeReady (peak_leftover_sample, peak_leftover_cnt); /* EMIT SIGNAL */
@@ -1075,6 +1497,10 @@ AudioSource::compute_and_write_peaks (Sample* buf, samplecnt_t first_sample, sam
 
 	_peak_byte_max = max (_peak_byte_max, (off_t) (first_peak_byte + bytes_to_write));
 
+	if (fpp == _FPP && peaks_computed) {
+		update_peak_pyramid (_peakfile_fd, _peak_pyramid_fd, first_sample / fpp, peaks_computed);
+	}
+
 	if (samples_done) {
 		Glib::Threads::Mutex::Lock lm (_peaks_ready_lock);
 		PeakRangeReady (first_sample, samples_done); /* EMIT SIGNAL */
@@ -1086,6 +1512,70 @@ AudioSource::compute_and_write_peaks (Sample* buf, samplecnt_t first_sample, sam
 	return 0;
 }
 
+/** Recompute all pyramid peaks that depend on the given range of base
+ *  peaks, which must already be written to the peakfile.
+ *  _lock MUST be held by caller.
+ */
+void
+AudioSource::update_peak_pyramid (int peak_fd, int pyramid_fd, samplepos_t first_peak, samplecnt_t n_peaks)
+{
+	if (pyramid_fd < 0 || peak_fd < 0 || n_peaks <= 0) {
+		return;
+	}
+
+	/* range [first, last) of the current level, and the number of peaks available at that level */
+	samplepos_t first = first_peak;
+	samplepos_t last  = first_peak + n_peaks;
+	samplecnt_t avail = _peak_byte_max / sizeof (PeakData);
+	samplecnt_t src_fpp = _FPP;
+
+	for (int l = 0; l < _PYR_LEVELS; ++l) {
+		const samplecnt_t ratio = pyramid_fpp[l] / src_fpp;
+
+		const samplepos_t dst_first = first / ratio;
+		const samplepos_t dst_last  = (last + ratio - 1) / ratio;
+		const samplepos_t src_first = dst_first * ratio;
+		const samplecnt_t src_n     = min (dst_last * ratio, avail) - src_first;
+
+		if (src_n <= 0) {
+			break;
+		}
+
+		boost::scoped_array<PeakData> src (new PeakData[src_n]);
+		bool ok;
+
+		if (l == 0) {
+			const off_t byte = src_first * sizeof (PeakData);
+			const ssize_t bytes = src_n * sizeof (PeakData);
+			ok = lseek (peak_fd, byte, SEEK_SET) == byte && ::read (peak_fd, src.get(), bytes) == bytes;
+		} else {
+			ok = pyramid_io (pyramid_fd, false, l - 1, src_first, src_n, src.get());
+		}
+
+		if (!ok) {
+			error << string_compose(_("%1: could not read peak data for pyramid (%2)"), _name, strerror (errno)) << endmsg;
+			break;
+		}
+
+		const samplecnt_t dst_n = (src_n + ratio - 1) / ratio;
+		boost::scoped_array<PeakData> dst (new PeakData[dst_n]);
+
+		for (samplecnt_t i = 0; i < dst_n; ++i) {
+			reduce_peaks (&src[i * ratio], min (ratio, src_n - i * ratio), dst[i]);
+		}
+
+		if (!pyramid_io (pyramid_fd, true, l, dst_first, dst_n, dst.get())) {
+			error << string_compose(_("%1: could not write peak pyramid (%2)"), _name, strerror (errno)) << endmsg;
+			break;
+		}
+
+		first   = dst_first;
+		last    = dst_first + dst_n;
+		avail   = (avail + ratio - 1) / ratio;
+		src_fpp = pyramid_fpp[l];
+	}
+}
+
 void
 AudioSource::truncate_peakfile ()
 {
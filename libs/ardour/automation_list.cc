@@ -393,6 +393,22 @@ AutomationList::serialize_events (bool need_lock)
 	if (need_lock) {
 		lm.acquire ();
 	}
+
+	if (raw_state_arrays ()) {
+		/* binary state: store when/value pairs without text conversion */
+		std::string raw;
+		raw.reserve (_events.size () * 2 * sizeof (double));
+		for (iterator xx = _events.begin(); xx != _events.end(); ++xx) {
+			const double ev[2] = { (*xx)->when, (*xx)->value };
+			raw.append ((char const*) ev, sizeof (ev));
+		}
+		node->set_property (XML_RAW_F64_PROPERTY, (uint32_t) 2);
+		XMLNode* content_node = new XMLNode (X_("foo"));
+		content_node->set_content (raw);
+		node->add_child_nocopy (*content_node);
+		return *node;
+	}
+
 	for (iterator xx = _events.begin(); xx != _events.end(); ++xx) {
 		str << PBD::to_string ((*xx)->when);
 		str << ' ';
@@ -426,6 +442,21 @@ AutomationList::deserialize_events (const XMLNode& node)
         ControlList::freeze ();
 	clear ();
 
+	uint32_t raw_columns;
+	if (node.get_property (XML_RAW_F64_PROPERTY, raw_columns) && raw_columns == 2) {
+		std::string const& raw (content_node->content());
+		const size_t n_events = raw.size () / (2 * sizeof (double));
+		for (size_t i = 0; i < n_events; ++i) {
+			double ev[2];
+			memcpy (ev, raw.data () + i * sizeof (ev), sizeof (ev));
+			fast_simple_add (ev[0], std::min ((double)_desc.upper, std::max ((double)_desc.lower, ev[1])));
+		}
+		mark_dirty ();
+		maybe_signal_changed ();
+		thaw ();
+		return 0;
+	}
+
 	stringstream str (content_node->content());
 
 	std::string x_str;
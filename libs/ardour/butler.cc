@@ -20,6 +20,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
 #include <errno.h>
 #include <fcntl.h>
 #include <unistd.h>
@@ -34,6 +35,7 @@
 #include "ardour/butler.h"
 #include "ardour/debug.h"
 #include "ardour/disk_io.h"
+#include "ardour/disk_prefetch.h"
 #include "ardour/disk_reader.h"
 #include "ardour/io.h"
 #include "ardour/session.h"
@@ -54,9 +56,16 @@ Butler::Butler(Session& s)
 	, _audio_playback_buffer_size(0)
 	, _midi_buffer_size(0)
 	, pool_trash(16)
+	, _prefetch (new DiskPrefetch)
+	, _jobs_refill (true)
+	, _workers_active (0)
+	, _workers_changed (0)
+	, _job_run_sem ("butler_job_run", 0)
+	, _job_end_sem ("butler_job_done", 0)
 	, _xthread (true)
 {
 	g_atomic_int_set(&should_do_transport_work, 0);
+	g_atomic_int_set(&_next_job, 0);
 	SessionEvent::pool->set_trash (&pool_trash);
 
         /* catch future changes to parameters */
@@ -97,6 +106,10 @@ Butler::config_changed (std::string p)
 		_audio_playback_buffer_size = (uint32_t) floor (Config->get_audio_playback_buffer_seconds() * _session.sample_rate());
 		_session.adjust_capture_buffering ();
 		_session.adjust_playback_buffering ();
+	} else if (p == "butler-threads") {
+		/* workers are only ever added or removed by the butler thread itself */
+		g_atomic_int_set (&_workers_changed, 1);
+		summon ();
 	}
 }
 
@@ -118,6 +131,7 @@ Butler::start_thread()
 	_midi_buffer_size = (uint32_t) floor (Config->get_midi_track_buffer_seconds() * rate);
 
 	should_run = false;
+	g_atomic_int_set (&_workers_changed, 1);
 
 	if (pthread_create_and_store ("disk butler", &thread, _thread_work, this)) {
 		error << _("Session: could not create butler thread") << endmsg;
@@ -142,7 +156,9 @@ Butler::terminate_thread ()
                 DEBUG_TRACE (DEBUG::Butler, string_compose ("%1: ask butler to quit @ %2\n", DEBUG_THREAD_SELF, g_get_monotonic_time()));
 		queue_request (Request::Quit);
 		pthread_join (thread, &status);
+		have_thread = false;
 	}
+	drop_workers ();
 }
 
 void *
@@ -195,6 +211,9 @@ Butler::thread_work ()
 			}
 		}
 
+		if (g_atomic_int_compare_and_exchange (&_workers_changed, 1, 0)) {
+			reset_workers ();
+		}
 
 	  restart:
 		DEBUG_TRACE (DEBUG::Butler, "at restart for disk work\n");
@@ -232,8 +251,17 @@ Butler::thread_work ()
 		RouteList rl_with_auditioner = *rl;
 		rl_with_auditioner.push_back (_session.the_auditioner());
 
+		if (should_run && Config->get_disk_prefetch ()) {
+			prefetch_tracks (rl_with_auditioner);
+		}
+
 		DEBUG_TRACE (DEBUG::Butler, string_compose ("butler starts refill loop, twr = %1\n", transport_work_requested()));
 
+		if (!_workers.empty ()) {
+			disk_work_outstanding = refill_tracks_parallel (rl_with_auditioner);
+			goto refill_done;
+		}
+
 		for (i = rl_with_auditioner.begin(); !transport_work_requested() && should_run && i != rl_with_auditioner.end(); ++i) {
 
 			boost::shared_ptr<Track> tr = boost::dynamic_pointer_cast<Track> (*i);
@@ -273,12 +301,17 @@ Butler::thread_work ()
 			disk_work_outstanding = true;
 		}
 
+	  refill_done:
 		if (!err && transport_work_requested()) {
 			DEBUG_TRACE (DEBUG::Butler, "transport work requested during refill, back to restart\n");
 			goto restart;
 		}
 
-		disk_work_outstanding = disk_work_outstanding || flush_tracks_to_disk_normal (rl, err);
+		if (_workers.empty ()) {
+			disk_work_outstanding = disk_work_outstanding || flush_tracks_to_disk_normal (rl, err);
+		} else {
+			disk_work_outstanding = disk_work_outstanding || flush_tracks_to_disk_parallel (rl, err);
+		}
 
 		if (err && _session.actively_recording()) {
 			/* stop the transport and try to catch as much possible
@@ -411,6 +444,298 @@ Butler::flush_tracks_to_disk_after_locate (boost::shared_ptr<RouteList> rl, uint
 	return disk_work_outstanding;
 }
 
+/** Let the kernel start reading the data that all tracks are about to
+ * refill, before reading it track by track.
+ */
+void
+Butler::prefetch_tracks (RouteList const& rl)
+{
+	for (RouteList::const_iterator i = rl.begin(); !transport_work_requested() && i != rl.end(); ++i) {
+		boost::shared_ptr<Track> tr = boost::dynamic_pointer_cast<Track> (*i);
+
+		if (!tr) {
+			continue;
+		}
+
+		boost::shared_ptr<IO> io = tr->input ();
+
+		if (io && !io->active()) {
+			continue;
+		}
+
+		tr->prefetch (*_prefetch);
+	}
+
+	_prefetch->submit ();
+}
+
+bool
+Butler::refill_tracks_parallel (RouteList const& rl)
+{
+	bool disk_work_outstanding = false;
+
+	_jobs.clear ();
+
+	for (RouteList::const_iterator i = rl.begin(); i != rl.end(); ++i) {
+		boost::shared_ptr<Track> tr = boost::dynamic_pointer_cast<Track> (*i);
+
+		if (!tr) {
+			continue;
+		}
+
+		boost::shared_ptr<IO> io = tr->input ();
+
+		if (io && !io->active()) {
+			/* don't read inactive tracks */
+			continue;
+		}
+
+		_jobs.push_back (DiskJob (tr, tr->playback_buffer_load ()));
+	}
+
+	std::sort (_jobs.begin (), _jobs.end ());
+
+	DEBUG_TRACE (DEBUG::Butler, string_compose ("butler refills %1 tracks using %2 worker threads\n", _jobs.size (), _workers.size ()));
+
+	run_jobs (true);
+
+	for (std::vector<DiskJob>::const_iterator j = _jobs.begin (); j != _jobs.end (); ++j) {
+		if (!j->done) {
+			/* we didn't get to all the streams */
+			disk_work_outstanding = true;
+			continue;
+		}
+
+		switch (j->result) {
+		case 0:
+			break;
+
+		case 1:
+			DEBUG_TRACE (DEBUG::Butler, string_compose ("\ttrack refill unfinished %1\n", j->track->name()));
+			disk_work_outstanding = true;
+			break;
+
+		default:
+			error << string_compose(_("Butler read ahead failure on dstream %1"), j->track->name()) << endmsg;
+			std::cerr << string_compose(_("Butler read ahead failure on dstream %1"), j->track->name()) << std::endl;
+			break;
+		}
+	}
+
+	_jobs.clear ();
+
+	return disk_work_outstanding;
+}
+
+bool
+Butler::flush_tracks_to_disk_parallel (boost::shared_ptr<RouteList> rl, uint32_t& errors)
+{
+	bool disk_work_outstanding = false;
+
+	_jobs.clear ();
+
+	for (RouteList::const_iterator i = rl->begin(); i != rl->end(); ++i) {
+		boost::shared_ptr<Track> tr = boost::dynamic_pointer_cast<Track> (*i);
+
+		if (!tr) {
+			continue;
+		}
+
+		/* note that we still try to flush diskstreams attached to inactive routes
+		 */
+
+		_jobs.push_back (DiskJob (tr, tr->capture_buffer_load ()));
+	}
+
+	std::sort (_jobs.begin (), _jobs.end ());
+
+	run_jobs (false);
+
+	for (std::vector<DiskJob>::const_iterator j = _jobs.begin (); j != _jobs.end (); ++j) {
+		if (!j->done) {
+			disk_work_outstanding = true;
+			continue;
+		}
+
+		switch (j->result) {
+		case 0:
+			break;
+
+		case 1:
+			disk_work_outstanding = true;
+			break;
+
+		default:
+			errors++;
+			error << string_compose(_("Butler write-behind failure on dstream %1"), j->track->name()) << endmsg;
+			std::cerr << string_compose(_("Butler write-behind failure on dstream %1"), j->track->name()) << std::endl;
+			break;
+		}
+	}
+
+	_jobs.clear ();
+
+	return disk_work_outstanding;
+}
+
+/** Process all jobs in _jobs, using the worker threads as well as the
+ * butler thread. Returns when all jobs have been processed or skipped.
+ */
+void
+Butler::run_jobs (bool refill)
+{
+	if (_jobs.empty ()) {
+		return;
+	}
+
+	_jobs_refill = refill;
+	g_atomic_int_set (&_next_job, 0);
+
+	/* the semaphore also publishes the job list to the workers */
+	const size_t nt = std::min (_workers.size (), _jobs.size () - 1);
+
+	for (size_t i = 0; i < nt; ++i) {
+		_job_run_sem.signal ();
+	}
+
+	process_jobs (0);
+
+	for (size_t i = 0; i < nt; ++i) {
+		_job_end_sem.wait ();
+	}
+}
+
+/** Claim and process jobs until none are left.
+ * @param w worker, or 0 when called from the butler thread itself
+ */
+void
+Butler::process_jobs (Worker* w)
+{
+	const guint n_jobs = _jobs.size ();
+
+	while (true) {
+		const guint i = g_atomic_int_add (&_next_job, 1);
+
+		if (i >= n_jobs) {
+			break;
+		}
+
+		DiskJob& job (_jobs[i]);
+
+		if (transport_work_requested () || !should_run) {
+			/* leave the remaining jobs for the next iteration */
+			continue;
+		}
+
+		if (!_jobs_refill) {
+			job.result = job.track->do_flush (ButlerContext, false);
+		} else if (w) {
+			job.result = job.track->do_refill (w->sum_buffer, w->mixdown_buffer, w->gain_buffer);
+		} else {
+			job.result = job.track->do_refill ();
+		}
+
+		job.done = true;
+	}
+}
+
+Butler::Worker::Worker (Butler* b)
+	: butler (b)
+	, thread ()
+{
+	/* same size as DiskReader::allocate_working_buffers() */
+	sum_buffer     = new Sample[2 * 1048576];
+	mixdown_buffer = new Sample[2 * 1048576];
+	gain_buffer    = new gain_t[2 * 1048576];
+}
+
+Butler::Worker::~Worker ()
+{
+	delete[] sum_buffer;
+	delete[] mixdown_buffer;
+	delete[] gain_buffer;
+}
+
+/** Adjust the number of worker threads to Config->get_butler_threads().
+ * Must only be called from the butler thread, or while it is not running.
+ */
+void
+Butler::reset_workers ()
+{
+	const uint32_t n_workers = std::max ((uint32_t) 1, Config->get_butler_threads ()) - 1;
+
+	if (n_workers == _workers.size ()) {
+		return;
+	}
+
+	drop_workers ();
+
+	DEBUG_TRACE (DEBUG::Butler, string_compose ("butler starts %1 worker threads\n", n_workers));
+
+	g_atomic_int_set (&_workers_active, 1);
+
+	for (uint32_t i = 0; i < n_workers; ++i) {
+		Worker* w = new Worker (this);
+		if (pthread_create_and_store ("butler worker", &w->thread, _worker_thread, w)) {
+			error << _("Butler: could not create worker thread") << endmsg;
+			delete w;
+			break;
+		}
+		_workers.push_back (w);
+	}
+}
+
+void
+Butler::drop_workers ()
+{
+	if (_workers.empty ()) {
+		return;
+	}
+
+	g_atomic_int_set (&_workers_active, 0);
+
+	for (size_t i = 0; i < _workers.size (); ++i) {
+		_job_run_sem.signal ();
+	}
+
+	for (std::vector<Worker*>::iterator i = _workers.begin (); i != _workers.end (); ++i) {
+		void* status;
+		pthread_join ((*i)->thread, &status);
+		delete *i;
+	}
+
+	_workers.clear ();
+	_job_run_sem.reset ();
+	_job_end_sem.reset ();
+}
+
+void*
+Butler::_worker_thread (void* arg)
+{
+	Worker* w = static_cast<Worker*> (arg);
+	SessionEvent::create_per_thread_pool ("butler worker events", 64);
+	pthread_set_name (X_("butler worker"));
+	w->butler->worker_thread (w);
+	return 0;
+}
+
+void
+Butler::worker_thread (Worker* w)
+{
+	while (true) {
+		_job_run_sem.wait ();
+
+		if (0 == g_atomic_int_get (&_workers_active)) {
+			_job_end_sem.signal ();
+			break;
+		}
+
+		process_jobs (w);
+
+		_job_end_sem.signal ();
+	}
+}
+
 void
 Butler::schedule_transport_work ()
 {
@@ -173,7 +173,7 @@ DiskIOProcessor::configure_io (ChanCount in, ChanCount out)
 		RCUWriter<ChannelList> writer (channels);
 		boost::shared_ptr<ChannelList> c = writer.get_copy();
 
-		uint32_t n_audio = in.n_audio();
+		uint32_t n_audio = n_channels_for (in);
 
 		if (n_audio > c->size()) {
 			add_channel_to (c, n_audio - c->size());
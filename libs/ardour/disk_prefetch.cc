@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2026 The Ardour Team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifdef WAF_BUILD
+#include "libardour-config.h"
+#endif
+
+#include <algorithm>
+#include <fcntl.h>
+
+#ifdef HAVE_LIBURING
+#include <liburing.h>
+#endif
+
+#include "pbd/compose.h"
+
+#include "ardour/debug.h"
+#include "ardour/disk_prefetch.h"
+
+using namespace ARDOUR;
+
+#ifdef HAVE_LIBURING
+#define PREFETCH_RING_SIZE 256
+
+struct DiskPrefetch::Ring {
+	struct io_uring ring;
+};
+#else
+struct DiskPrefetch::Ring {};
+#endif
+
+DiskPrefetch::DiskPrefetch ()
+	: _ring (0)
+	, _in_flight (0)
+{
+#ifdef HAVE_LIBURING
+	_ring = new Ring;
+	int rv = io_uring_queue_init (PREFETCH_RING_SIZE, &_ring->ring, 0);
+	if (rv < 0) {
+		/* e.g. kernel too old, or io_uring disabled by sysctl */
+		DEBUG_TRACE (DEBUG::DiskIO, string_compose ("io_uring is not available (%1), using posix_fadvise\n", -rv));
+		delete _ring;
+		_ring = 0;
+	}
+#endif
+}
+
+DiskPrefetch::~DiskPrefetch ()
+{
+#ifdef HAVE_LIBURING
+	if (_ring) {
+		reap (true);
+		io_uring_queue_exit (&_ring->ring);
+		delete _ring;
+	}
+#endif
+}
+
+void
+DiskPrefetch::add (int fd, int64_t offset, int64_t len)
+{
+	if (fd < 0 || len <= 0) {
+		return;
+	}
+
+	/* merge with the previous range of the same file (e.g. adjacent
+	 * regions, or several channels of the same file)
+	 */
+	if (!_ranges.empty ()) {
+		Range& r (_ranges.back ());
+		if (r.fd == fd && offset <= r.offset + r.len && offset + len >= r.offset) {
+			const int64_t end = std::max (r.offset + r.len, offset + len);
+			r.offset = std::min (r.offset, offset);
+			r.len    = end - r.offset;
+			return;
+		}
+	}
+
+	_ranges.push_back (Range (fd, offset, len));
+}
+
+/** Issue read-ahead for all queued ranges, and clear the queue. Does not wait
+ * for the data to be read.
+ */
+void
+DiskPrefetch::submit ()
+{
+	if (_ranges.empty ()) {
+		return;
+	}
+
+	DEBUG_TRACE (DEBUG::DiskIO, string_compose ("prefetch %1 file ranges\n", _ranges.size ()));
+
+#ifdef HAVE_LIBURING
+	if (_ring) {
+		reap (false);
+
+		for (std::vector<Range>::const_iterator i = _ranges.begin (); i != _ranges.end (); ++i) {
+			if (_in_flight >= PREFETCH_RING_SIZE) {
+				/* queue is full, submit what we have, and make room */
+				io_uring_submit (&_ring->ring);
+				reap (true);
+			}
+
+			/* _in_flight includes prepared, but not yet submitted requests,
+			 * so there is always a free entry here.
+			 */
+			struct io_uring_sqe* sqe = io_uring_get_sqe (&_ring->ring);
+			if (!sqe) {
+				break;
+			}
+
+			io_uring_prep_fadvise (sqe, i->fd, i->offset, i->len, POSIX_FADV_WILLNEED);
+			++_in_flight;
+		}
+
+		io_uring_submit (&_ring->ring);
+		_ranges.clear ();
+		return;
+	}
+#endif
+
+#if defined (POSIX_FADV_WILLNEED) && !defined (PLATFORM_WINDOWS)
+	for (std::vector<Range>::const_iterator i = _ranges.begin (); i != _ranges.end (); ++i) {
+		posix_fadvise (i->fd, i->offset, i->len, POSIX_FADV_WILLNEED);
+	}
+#endif
+
+	_ranges.clear ();
+}
+
+/** Collect completions of previous submissions.
+ * @param wait if true, wait until all submitted requests have completed
+ */
+void
+DiskPrefetch::reap (bool wait)
+{
+#ifdef HAVE_LIBURING
+	while (_in_flight > 0) {
+		struct io_uring_cqe* cqe;
+		int rv = wait ? io_uring_wait_cqe (&_ring->ring, &cqe) : io_uring_peek_cqe (&_ring->ring, &cqe);
+		if (rv < 0) {
+			break;
+		}
+		/* the result is irrelevant, this is only a hint */
+		io_uring_cqe_seen (&_ring->ring, cqe);
+		--_in_flight;
+	}
+#endif
+}
@@ -65,10 +65,14 @@ DiskReader::DiskReader (Session& s, string const& str, DiskIOProcessor::Flag f)
 	, _declick_offs (0)
 	, _declick_enabled (false)
 	, last_refill_loop_start (0)
+	, _render_playlist_changed (false)
 {
 	file_sample[DataType::AUDIO] = 0;
 	file_sample[DataType::MIDI]  = 0;
 	g_atomic_int_set (&_pending_overwrite, 0);
+	g_atomic_int_set (&_reading_render, 0);
+	g_atomic_int_set (&_render_switched, 0);
+	g_atomic_int_set (&_render_channels, 0);
 }
 
 DiskReader::~DiskReader ()
@@ -122,6 +126,13 @@ DiskReader::add_channel_to (boost::shared_ptr<ChannelList> c, uint32_t how_many)
 	return 0;
 }
 
+uint32_t
+DiskReader::n_channels_for (ChanCount const& in) const
+{
+	/* keep the playback buffers that were added for a render */
+	return std::max (in.n_audio (), (uint32_t) g_atomic_int_get (&_render_channels));
+}
+
 void
 DiskReader::allocate_working_buffers ()
 {
@@ -239,6 +250,13 @@ DiskReader::adjust_buffering ()
 void
 DiskReader::playlist_modified ()
 {
+	boost::shared_ptr<MidiPlaylist> mpl = midi_playlist ();
+
+	if (mpl && mpl->in_patched_change () && !_playlists[DataType::AUDIO]) {
+		/* the rendered events were updated in place */
+		return;
+	}
+
 	_session.request_overwrite_buffer (_track, PlaylistModified);
 }
 
@@ -266,6 +284,60 @@ DiskReader::use_playlist (DataType dt, boost::shared_ptr<Playlist> playlist)
 	return 0;
 }
 
+void
+DiskReader::set_render_playlist (boost::shared_ptr<AudioPlaylist> pl, uint32_t n_channels)
+{
+	if (pl && n_channels > (uint32_t) g_atomic_int_get (&_render_channels)) {
+		g_atomic_int_set (&_render_channels, n_channels);
+
+		RCUWriter<ChannelList>         writer (channels);
+		boost::shared_ptr<ChannelList> c = writer.get_copy ();
+
+		if (n_channels > c->size ()) {
+			add_channel_to (c, n_channels - c->size ());
+		}
+	}
+
+	{
+		Glib::Threads::Mutex::Lock lm (_render_lock);
+		_pending_render_playlist = pl;
+		_render_playlist_changed = true;
+	}
+
+	_session.request_overwrite_buffer (_track, PlaylistChanged);
+}
+
+boost::shared_ptr<AudioPlaylist>
+DiskReader::render_playlist () const
+{
+	Glib::Threads::Mutex::Lock lm (_render_lock);
+	return _render_playlist;
+}
+
+void
+DiskReader::use_pending_render_playlist ()
+{
+	/* called from butler thread, before the buffers are (re)filled */
+	Glib::Threads::Mutex::Lock lm (_render_lock);
+
+	if (!_render_playlist_changed) {
+		return;
+	}
+
+	_render_playlist = _pending_render_playlist;
+	_pending_render_playlist.reset ();
+	_render_playlist_changed = false;
+
+	/* data before the read-pointer is from the previous playlist */
+	g_atomic_int_set (&_render_switched, 1);
+}
+
+boost::shared_ptr<AudioPlaylist>
+DiskReader::playback_playlist ()
+{
+	return _render_playlist ? _render_playlist : audio_playlist ();
+}
+
 void
 DiskReader::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_sample, double speed, pframes_t nframes, bool result_required)
 {
@@ -274,7 +346,7 @@ DiskReader::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_samp
 	ChannelList::iterator          chan;
 	sampleoffset_t                 disk_samples_to_consume;
 	MonitorState                   ms = _track->monitoring_state ();
-	const bool                     midi_only = (c->empty() || !_playlists[DataType::AUDIO]);
+	const bool                     midi_only = (c->empty () || bufs.available ().n_audio () == 0 || (!_playlists[DataType::AUDIO] && !reading_render_cache ()));
 
 	if (_active) {
 		if (!_pending_active) {
@@ -341,7 +413,14 @@ DiskReader::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_samp
 	}
 
 	if (midi_only) {
-		/* do nothing with audio */
+		/* do nothing with audio, but keep the playback buffers of a
+		 * MIDI track's render in step with the playback position.
+		 */
+		if (!still_locating || _no_disk_output) {
+			for (ChannelList::iterator chan = c->begin (); chan != c->end (); ++chan) {
+				(*chan)->rbuf->increment_read_ptr (disk_samples_to_consume);
+			}
+		}
 		goto midi;
 	}
 
@@ -379,6 +458,14 @@ DiskReader::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_samp
 
 		size_t n_buffers = bufs.count ().n_audio ();
 		size_t n_chans   = c->size ();
+
+		if (n_buffers == 0) {
+			/* the render of a MIDI track, use the buffers of its
+			 * instrument's output, see set_render_playlist()
+			 */
+			n_buffers = std::min (n_chans, (size_t) bufs.available ().n_audio ());
+		}
+
 		gain_t scaling;
 
 		if (n_chans > n_buffers) {
@@ -452,8 +539,12 @@ DiskReader::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_samp
 
 			Amp::apply_simple_gain (disk_buf, nframes, scaling);
 
-			if (ms & MonitoringInput) {
-				/* mix the disk signal into the input signal (already in bufs) */
+			if ((ms & MonitoringInput) && !reading_render_cache ()) {
+				/* mix the disk signal into the input signal (already in bufs).
+				 * A render already includes the track's plugins, which also
+				 * run on the input: leave it out until the RenderCache
+				 * switches back to the playlist.
+				 */
 				mix_buffers_no_gain (output.data (), disk_buf.data (), nframes);
 			}
 		}
@@ -495,7 +586,7 @@ midi:
 			playback_sample = loop_range.squish (playback_sample);
 		}
 
-		if (_playlists[DataType::AUDIO]) {
+		if (_playlists[DataType::AUDIO] || g_atomic_int_get (&_render_channels)) {
 			if (!c->empty ()) {
 				if (_slaved) {
 					if (c->front ()->rbuf->write_space () >= c->front ()->rbuf->bufsize () / 2) {
@@ -553,6 +644,18 @@ DiskReader::pending_overwrite () const
 	return g_atomic_int_get (&_pending_overwrite) != 0;
 }
 
+samplecnt_t
+DiskReader::read_ahead (uint32_t chan, Sample* dst, samplecnt_t offset, samplecnt_t cnt) const
+{
+	boost::shared_ptr<ChannelList> c = channels.reader ();
+
+	if (chan >= c->size () || reading_render_cache () || pending_overwrite ()) {
+		return 0;
+	}
+
+	return (*c)[chan]->rbuf->read (dst, cnt, false, offset);
+}
+
 void
 DiskReader::set_pending_overwrite (OverwriteReason why)
 {
@@ -791,9 +894,11 @@ DiskReader::overwrite_existing_buffers ()
 	bool ret = true;
 
 	if (g_atomic_int_get (&_pending_overwrite) & (PlaylistModified | LoopDisabled | LoopChanged | PlaylistChanged)) {
-		if (_playlists[DataType::AUDIO] && !overwrite_existing_audio ()) {
+		use_pending_render_playlist ();
+		if (playback_playlist () && !overwrite_existing_audio ()) {
 			ret = false;
 		}
+		g_atomic_int_set (&_reading_render, _render_playlist ? 1 : 0);
 	}
 
 	if (g_atomic_int_get (&_pending_overwrite) & (PlaylistModified | PlaylistChanged)) {
@@ -857,6 +962,9 @@ DiskReader::seek (samplepos_t sample, bool complete_refill)
 		assert ((*chan)->rbuf->reserved_size () == 0);
 	}
 
+	use_pending_render_playlist ();
+	g_atomic_int_set (&_render_switched, 0);
+
 	/* move the intended read target, so that after the refill is done,
 	 * the intended read target is "reservation" from the start of the
 	 * playback buffer. Then increment the read ptr, so that we can
@@ -890,6 +998,8 @@ DiskReader::seek (samplepos_t sample, bool complete_refill)
 		ret = do_refill_with_alloc (true, read_reversed);
 	}
 
+	g_atomic_int_set (&_reading_render, _render_playlist ? 1 : 0);
+
 	if (shift) {
 		/* now tell everyone where we really are, leaving the
 		 * "reserved" data represented by "shift" available in the
@@ -921,6 +1031,10 @@ DiskReader::can_internal_playback_seek (sampleoffset_t distance)
 	ChannelList::iterator          chan;
 	boost::shared_ptr<ChannelList> c = channels.reader ();
 
+	if (distance < 0 && g_atomic_int_get (&_render_switched)) {
+		return false;
+	}
+
 	for (chan = c->begin (); chan != c->end (); ++chan) {
 		if (!(*chan)->rbuf->can_seek (distance)) {
 			return false;
@@ -1045,7 +1159,7 @@ DiskReader::audio_read (Sample*            sum_buffer,
 		 * useful after the return from AudioPlayback::read()
 		 */
 
-		if (audio_playlist ()->read (sum_buffer, mixdown_buffer, gain_buffer, start, this_read, channel) != this_read) {
+		if (playback_playlist ()->read (sum_buffer, mixdown_buffer, gain_buffer, start, this_read, channel) != this_read) {
 			error << string_compose (_("DiskReader %1: cannot read %2 from playlist at sample %3"), id (), this_read, start) << endmsg;
 			return 0;
 		}
@@ -1103,6 +1217,42 @@ DiskReader::do_refill ()
 	return refill (_sum_buffer, _mixdown_buffer, _gain_buffer, 0, reversed);
 }
 
+int
+DiskReader::do_refill (Sample* sum_buffer, Sample* mixdown_buffer, gain_t* gain_buffer)
+{
+	const bool reversed = !_session.transport_will_roll_forwards ();
+	return refill (sum_buffer, mixdown_buffer, gain_buffer, 0, reversed);
+}
+
+void
+DiskReader::prefetch (DiskPrefetch& dp)
+{
+	if (_session.loading () || !playback_playlist () || !_session.transport_will_roll_forwards ()) {
+		return;
+	}
+
+	boost::shared_ptr<ChannelList> c = channels.reader ();
+
+	if (c->empty ()) {
+		return;
+	}
+
+	/* same conditions as refill_audio() */
+	const samplecnt_t total_space = c->front ()->rbuf->write_space ();
+
+	if (total_space < _chunk_samples && fabs (_session.transport_speed ()) < 2.0f) {
+		return;
+	}
+
+	const samplepos_t fsa = file_sample[DataType::AUDIO];
+
+	if (fsa > max_samplepos - total_space) {
+		return;
+	}
+
+	playback_playlist ()->prefetch (dp, fsa, total_space);
+}
+
 int
 DiskReader::do_refill_with_alloc (bool partial_fill, bool reversed)
 {
@@ -1298,7 +1448,7 @@ DiskReader::refill_audio (Sample* sum_buffer, Sample* mixdown_buffer, float* gai
 		if (to_read) {
 			ReaderChannelInfo* rci = dynamic_cast<ReaderChannelInfo*> (chan);
 
-			if (!_playlists[DataType::AUDIO]) {
+			if (!playback_playlist ()) {
 				chan->rbuf->write_zero (to_read);
 
 			} else {
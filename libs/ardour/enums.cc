@@ -88,6 +88,7 @@ setup_enum_writer ()
 	PFLPosition _PFLPosition;
 	AFLPosition _AFLPosition;
 	DenormalModel _DenormalModel;
+	GraphSchedulerModel _GraphSchedulerModel;
 	ClockDeltaMode _ClockDeltaMode;
 	LayerModel _LayerModel;
 	InsertMergePolicy _InsertMergePolicy;
@@ -353,6 +354,10 @@ setup_enum_writer ()
 	REGISTER_ENUM (DenormalFTZDAZ);
 	REGISTER (_DenormalModel);
 
+	REGISTER_ENUM (SharedTriggerQueue);
+	REGISTER_ENUM (WorkStealing);
+	REGISTER (_GraphSchedulerModel);
+
 	/*
 	 * EditorOrdered has been deprecated
 	 * since the removal of independent
@@ -27,8 +27,11 @@ namespace ARDOUR {
 
 const char* const template_suffix = X_(".template");
 const char* const statefile_suffix = X_(".ardour");
+const char* const binary_statefile_suffix = X_(".ardourb");
 const char* const pending_suffix = X_(".pending");
+const char* const journal_suffix = X_(".journal");
 const char* const peakfile_suffix = X_(".peak");
+const char* const peak_pyramid_suffix = X_(".pyramid");
 const char* const backup_suffix = X_(".bak");
 const char* const temp_suffix = X_(".tmp");
 const char* const history_suffix = X_(".history");
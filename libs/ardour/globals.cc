@@ -116,12 +116,14 @@
 #include "ardour/mix.h"
 #include "ardour/operations.h"
 #include "ardour/panner_manager.h"
+#include "ardour/playback_lookahead.h"
 #include "ardour/plugin_manager.h"
 #include "ardour/presentation_info.h"
 #include "ardour/process_thread.h"
 #include "ardour/profile.h"
 #include "ardour/rc_configuration.h"
 #include "ardour/region.h"
+#include "ardour/render_cache.h"
 #include "ardour/route_group.h"
 #include "ardour/runtime_functions.h"
 #include "ardour/session_event.h"
@@ -153,6 +155,9 @@ find_peaks_t            ARDOUR::find_peaks            = 0;
 apply_gain_to_buffer_t  ARDOUR::apply_gain_to_buffer  = 0;
 mix_buffers_with_gain_t ARDOUR::mix_buffers_with_gain = 0;
 mix_buffers_no_gain_t   ARDOUR::mix_buffers_no_gain   = 0;
+mix_buffers_n_t         ARDOUR::mix_buffers_n         = 0;
+apply_gain_ramp_t       ARDOUR::apply_gain_ramp       = 0;
+apply_gain_vector_t     ARDOUR::apply_gain_vector     = 0;
 copy_vector_t           ARDOUR::copy_vector           = 0;
 
 PBD::Signal1<void, std::string>                    ARDOUR::BootMessage;
@@ -188,6 +193,25 @@ setup_hardware_optimization (bool try_optimization)
 #if defined(ARCH_X86) && defined(BUILD_SSE_OPTIMIZATIONS)
 		/* We have AVX-optimized code for Windows and Linux */
 
+#ifdef FPU_AVX512F_SUPPORT
+		if (fpu->has_avx512f ()) {
+			info << "Using AVX-512F optimized routines" << endmsg;
+
+			// AVX-512F SET
+			compute_peak          = x86_avx512f_compute_peak;
+			find_peaks            = x86_avx512f_find_peaks;
+			apply_gain_to_buffer  = x86_avx512f_apply_gain_to_buffer;
+			mix_buffers_with_gain = x86_avx512f_mix_buffers_with_gain;
+			mix_buffers_no_gain   = x86_avx512f_mix_buffers_no_gain;
+			copy_vector           = x86_avx512f_copy_vector;
+			mix_buffers_n         = x86_avx512f_mix_buffers_n;
+			apply_gain_ramp       = x86_avx512f_apply_gain_ramp;
+			apply_gain_vector     = x86_avx512f_apply_gain_vector;
+
+			generic_mix_functions = false;
+
+		} else
+#endif
 #ifdef FPU_AVX_FMA_SUPPORT
 		if (fpu->has_fma ()) {
 			info << "Using AVX and FMA optimized routines" << endmsg;
@@ -199,6 +223,9 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_with_gain = x86_fma_mix_buffers_with_gain;
 			mix_buffers_no_gain   = x86_sse_avx_mix_buffers_no_gain;
 			copy_vector           = x86_sse_avx_copy_vector;
+			mix_buffers_n         = default_mix_buffers_n;
+			apply_gain_ramp       = default_apply_gain_ramp;
+			apply_gain_vector     = default_apply_gain_vector;
 
 			generic_mix_functions = false;
 
@@ -214,6 +241,9 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_with_gain = x86_sse_avx_mix_buffers_with_gain;
 			mix_buffers_no_gain   = x86_sse_avx_mix_buffers_no_gain;
 			copy_vector           = x86_sse_avx_copy_vector;
+			mix_buffers_n         = default_mix_buffers_n;
+			apply_gain_ramp       = default_apply_gain_ramp;
+			apply_gain_vector     = default_apply_gain_vector;
 
 			generic_mix_functions = false;
 
@@ -227,11 +257,32 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_with_gain = x86_sse_mix_buffers_with_gain;
 			mix_buffers_no_gain   = x86_sse_mix_buffers_no_gain;
 			copy_vector           = default_copy_vector;
+			mix_buffers_n         = default_mix_buffers_n;
+			apply_gain_ramp       = default_apply_gain_ramp;
+			apply_gain_vector     = default_apply_gain_vector;
 
 			generic_mix_functions = false;
 		}
 
 #elif defined ARM_NEON_SUPPORT
+#ifdef ARM_SVE_SUPPORT
+		if (fpu->has_sve ()) {
+			info << "Using ARM SVE optimized routines" << endmsg;
+
+			compute_peak          = arm_sve_compute_peak;
+			find_peaks            = arm_sve_find_peaks;
+			apply_gain_to_buffer  = arm_sve_apply_gain_to_buffer;
+			mix_buffers_with_gain = arm_sve_mix_buffers_with_gain;
+			mix_buffers_no_gain   = arm_sve_mix_buffers_no_gain;
+			copy_vector           = arm_sve_copy_vector;
+			mix_buffers_n         = arm_sve_mix_buffers_n;
+			apply_gain_ramp       = arm_neon_apply_gain_ramp;
+			apply_gain_vector     = arm_neon_apply_gain_vector;
+
+			generic_mix_functions = false;
+
+		} else
+#endif
 		/* Use NEON routines */
 		if (fpu->has_neon ()) {
 			info << "Using ARM NEON optimized routines" << endmsg;
@@ -242,6 +293,9 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_with_gain = arm_neon_mix_buffers_with_gain;
 			mix_buffers_no_gain   = arm_neon_mix_buffers_no_gain;
 			copy_vector           = arm_neon_copy_vector;
+			mix_buffers_n         = default_mix_buffers_n;
+			apply_gain_ramp       = arm_neon_apply_gain_ramp;
+			apply_gain_vector     = arm_neon_apply_gain_vector;
 
 			generic_mix_functions = false;
 		}
@@ -255,6 +309,9 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_with_gain = veclib_mix_buffers_with_gain;
 			mix_buffers_no_gain   = veclib_mix_buffers_no_gain;
 			copy_vector           = default_copy_vector;
+			mix_buffers_n         = default_mix_buffers_n;
+			apply_gain_ramp       = default_apply_gain_ramp;
+			apply_gain_vector     = default_apply_gain_vector;
 
 			generic_mix_functions = false;
 
@@ -274,6 +331,9 @@ setup_hardware_optimization (bool try_optimization)
 		mix_buffers_with_gain = default_mix_buffers_with_gain;
 		mix_buffers_no_gain   = default_mix_buffers_no_gain;
 		copy_vector           = default_copy_vector;
+		mix_buffers_n         = default_mix_buffers_n;
+		apply_gain_ramp       = default_apply_gain_ramp;
+		apply_gain_vector     = default_apply_gain_vector;
 
 		info << "No H/W specific optimizations in use" << endmsg;
 	}
@@ -590,8 +650,9 @@ ARDOUR::init (bool use_windows_vst, bool try_optimization, const char* localedir
 	/* the + 4 is a bit of a handwave. i don't actually know
 	   how many more per-thread buffer sets we need above
 	   the h/w concurrency, but its definitely > 1 more.
+	   Background workers that run plugins need their own.
 	*/
-	BufferManager::init (hardware_concurrency () + 4);
+	BufferManager::init (hardware_concurrency () + 4 + RenderCache::max_workers () + PlaybackLookahead::max_workers ());
 
 	PannerManager::instance ().discover_panners ();
 
@@ -20,17 +20,21 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
 #include <cmath>
+#include <map>
 #include <stdio.h>
 
 #include "pbd/compose.h"
 #include "pbd/debug_rt_alloc.h"
 #include "pbd/pthread_utils.h"
+#include "pbd/spinlock.h"
 
 #include "ardour/audioengine.h"
 #include "ardour/debug.h"
 #include "ardour/graph.h"
 #include "ardour/process_thread.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/route.h"
 #include "ardour/session.h"
 #include "ardour/types.h"
@@ -56,12 +60,33 @@ alloc_allowed ()
 
 #define g_atomic_uint_get(x) static_cast<guint> (g_atomic_int_get (x))
 
+/* node priorities are updated every priority_cycles process cycles,
+ * node execution times are measured during the cost_cycles before.
+ */
+static const guint priority_cycles = 256;
+static const guint cost_cycles     = 16;
+
+static void
+do_not_delete_the_worker (void*)
+{
+	/* Workers are owned by the Graph */
+}
+
+Glib::Threads::Private<Graph::Worker> Graph::_thread_worker (do_not_delete_the_worker);
+
 Graph::Graph (Session& session)
 	: SessionHandleRef (session)
 	, _execution_sem ("graph_execution", 0)
 	, _callback_start_sem ("graph_start", 0)
 	, _callback_done_sem ("graph_done", 0)
+	, _spin_usec (0)
+	, _callback_start_spin_budget (0)
+	, _callback_done_spin_budget (0)
+	, _callback_start_time (0)
 	, _graph_empty (true)
+	, _priority_cycle_cnt (0)
+	, _sample_cost (false)
+	, _work_stealing (false)
 	, _current_chain (0)
 	, _pending_chain (0)
 	, _setup_chain (1)
@@ -125,6 +150,16 @@ Graph::reset_thread_list ()
 		drop_threads ();
 	}
 
+	/* one worker per process-thread, index 0 is the main thread.
+	 * Each deque must be able to hold all nodes.
+	 */
+	size_t const n_nodes = std::max (_nodes_rt[0].size (), _nodes_rt[1].size ());
+
+	drop_workers ();
+	for (uint32_t i = 0; i < num_threads; ++i) {
+		_workers.push_back (new Worker (i, n_nodes));
+	}
+
 	/* Allow threads to run */
 	g_atomic_int_set (&_terminate, 0);
 
@@ -147,12 +182,15 @@ void
 Graph::session_going_away ()
 {
 	drop_threads ();
+	drop_workers ();
 
 	// now drop all references on the nodes.
 	_nodes_rt[0].clear ();
 	_nodes_rt[1].clear ();
 	_init_trigger_list[0].clear ();
 	_init_trigger_list[1].clear ();
+	_topo_order[0].clear ();
+	_topo_order[1].clear ();
 	g_atomic_int_set (&_trigger_queue_size, 0);
 	_trigger_queue.clear ();
 }
@@ -200,6 +238,22 @@ Graph::drop_threads ()
 #endif
 }
 
+void
+Graph::drop_workers ()
+{
+	for (std::vector<Worker*>::iterator i = _workers.begin (); i != _workers.end (); ++i) {
+		delete *i;
+	}
+	_workers.clear ();
+}
+
+void
+Graph::register_worker (guint id)
+{
+	assert (id < _workers.size ());
+	_thread_worker.set (_workers[id]);
+}
+
 /* special case route removal -- called from Session::remove_routes */
 void
 Graph::clear_other_chain ()
@@ -210,10 +264,12 @@ Graph::clear_other_chain ()
 		if (_setup_chain != _pending_chain) {
 			for (node_list_t::iterator ni = _nodes_rt[_setup_chain].begin (); ni != _nodes_rt[_setup_chain].end (); ++ni) {
 				(*ni)->_activation_set[_setup_chain].clear ();
+				(*ni)->_activation_list[_setup_chain].clear ();
 			}
 
 			_nodes_rt[_setup_chain].clear ();
 			_init_trigger_list[_setup_chain].clear ();
+			_topo_order[_setup_chain].clear ();
 			break;
 		}
 		/* setup chain == pending chain - we have
@@ -234,12 +290,30 @@ Graph::prep ()
 			_current_chain = _pending_chain;
 			/* ensure that all nodes can be queued */
 			_trigger_queue.reserve (_nodes_rt[_current_chain].size ());
+			for (std::vector<Worker*>::iterator w = _workers.begin (); w != _workers.end (); ++w) {
+				(*w)->deque.reserve (_nodes_rt[_current_chain].size ());
+			}
 			assert (g_atomic_uint_get (&_trigger_queue_size) == 0);
 			_cleanup_cond.signal ();
 		}
+		/* Periodically update the critical-path priorities,
+		 * using node execution times of the last cycles.
+		 * All other threads are idle, and rechain () cannot
+		 * modify the nodes while the swap mutex is held.
+		 * If it is not available, retry next cycle.
+		 */
+		if (++_priority_cycle_cnt >= priority_cycles) {
+			_priority_cycle_cnt = 0;
+			for (std::vector<GraphNode*>::const_iterator i = _topo_order[_current_chain].begin (); i != _topo_order[_current_chain].end (); ++i) {
+				(*i)->update_cost (_current_chain);
+			}
+			update_priorities (_current_chain);
+		}
 		_swap_mutex.unlock ();
 	}
 
+	_sample_cost = _priority_cycle_cnt >= priority_cycles - cost_cycles;
+
 	_graph_empty = true;
 
 	int chain = _current_chain;
@@ -254,20 +328,135 @@ Graph::prep ()
 
 	g_atomic_int_set (&_terminal_refcnt, _n_terminal_nodes[chain]);
 
-	/* Trigger the initial nodes for processing, which are the ones at the `input' end */
+	/* All other threads are idle and all queues are empty,
+	 * it is safe to switch the scheduler here.
+	 */
+	Worker* w = _thread_worker.get ();
+	_work_stealing = w && Config->get_graph_scheduler () == WorkStealing;
+	_spin_usec     = Config->get_graph_spin_usec ();
+
+	if (_work_stealing) {
+		for (std::vector<Worker*>::iterator wi = _workers.begin (); wi != _workers.end (); ++wi) {
+			assert (!(*wi)->next && (*wi)->deque.size () == 0);
+			(*wi)->deque.clear ();
+		}
+	}
+
+	/* Trigger the initial nodes for processing, which are the ones at the `input' end.
+	 * With work-stealing they are queued on this thread's deque, idle threads
+	 * will steal them.
+	 */
 	for (i = _init_trigger_list[chain].begin (); i != _init_trigger_list[chain].end (); i++) {
 		g_atomic_int_inc (&_trigger_queue_size);
-		_trigger_queue.push_back (i->get ());
+		if (!_work_stealing || !w->deque.push (i->get ())) {
+			_trigger_queue.push_back (i->get ());
+		}
 	}
 }
 
 void
 Graph::trigger (GraphNode* n)
 {
+	if (_work_stealing) {
+		Worker* w = _thread_worker.get ();
+		if (w) {
+			/* The first node that becomes ready is processed next by the same
+			 * thread (its input-buffers are likely still in the CPU cache),
+			 * any further nodes are made available to other threads.
+			 */
+			if (!w->next) {
+				w->next = n;
+				return;
+			}
+			g_atomic_int_inc (&_trigger_queue_size);
+			if (w->deque.push (n)) {
+				return;
+			}
+			_trigger_queue.push_back (n);
+			return;
+		}
+	}
+
 	g_atomic_int_inc (&_trigger_queue_size);
 	_trigger_queue.push_back (n);
 }
 
+/** Wait for the semaphore, optionally busy-waiting for a while first.
+ *
+ * Putting a thread to sleep and waking it up again requires system-calls
+ * and a context switch, which can take a significant part of the cycle at
+ * small buffer-sizes. If the semaphore is signalled soon, spinning is cheaper.
+ *
+ * The spin-time is adapted for each caller: it is doubled (up to the
+ * configured limit) when spinning was successful, and halved when
+ * the thread had to sleep anyway.
+ */
+void
+Graph::spin_wait (PBD::Semaphore& sem, guint& budget)
+{
+	const guint limit = _spin_usec;
+
+	if (limit > 0) {
+		budget = std::min (std::max (budget, std::max (1U, limit / 16)), limit);
+
+		const int64_t deadline = g_get_monotonic_time () + budget;
+		do {
+			for (int i = 0; i < 64; ++i) {
+				if (sem.try_wait ()) {
+					budget = std::min (2 * budget, limit);
+					return;
+				}
+				PBD::cpu_relax ();
+			}
+		} while (g_get_monotonic_time () < deadline);
+
+		budget /= 2;
+	}
+
+	sem.wait ();
+}
+
+/** Find a node to process, called by both the main thread and all helpers.
+ * @param queued set to true if the node was taken from a queue, and is
+ * hence counted in _trigger_queue_size
+ */
+bool
+Graph::pop_work (GraphNode*& to_run, bool& queued)
+{
+	queued = true;
+
+	if (!_work_stealing) {
+		return _trigger_queue.pop_front (to_run);
+	}
+
+	Worker* w = _thread_worker.get ();
+	assert (w);
+
+	if (w->next) {
+		to_run  = w->next;
+		w->next = 0;
+		queued  = false;
+		return true;
+	}
+
+	if (w->deque.pop (to_run)) {
+		return true;
+	}
+
+	if (_trigger_queue.pop_front (to_run)) {
+		return true;
+	}
+
+	/* steal from other threads, start with the next one to spread contention */
+	size_t const n_workers = _workers.size ();
+	for (size_t i = 1; i < n_workers; ++i) {
+		if (_workers[(w->id + i) % n_workers]->deque.steal (to_run)) {
+			return true;
+		}
+	}
+	return false;
+}
+
 /** Called when a node at the `output' end of the chain (ie one that has no-one to feed)
  *  is finished.
  */
@@ -293,17 +482,23 @@ Graph::reached_terminal_node ()
 		 * threads may only be "on the way" to become idle.
 		 */
 		guint n_workers = g_atomic_uint_get (&_n_workers);
-		while (g_atomic_uint_get (&_idle_thread_cnt) != n_workers) {
-			sched_yield ();
+		for (guint i = 0; g_atomic_uint_get (&_idle_thread_cnt) != n_workers; ++i) {
+			if (i < 256) {
+				PBD::cpu_relax ();
+			} else {
+				sched_yield ();
+			}
 		}
 
 		/* Block until the a process callback */
-		_callback_start_sem.wait ();
+		spin_wait (_callback_start_sem, _callback_start_spin_budget);
 
 		if (g_atomic_int_get (&_terminate)) {
 			return;
 		}
 
+		_wakeup_latency.add (g_get_monotonic_time () - _callback_start_time);
+
 		DEBUG_TRACE (DEBUG::ProcessThreads, string_compose ("%1 prepare new cycle.\n", pthread_name ()));
 
 		/* Prepare next cycle:
@@ -343,17 +538,34 @@ Graph::rechain (boost::shared_ptr<RouteList> routelist, GraphEdges const& edges)
 
 	_nodes_rt[chain].clear ();
 
-	/* Clear things out, and make _nodes_rt[chain] a copy of routelist */
+	/* Clear things out, and make _nodes_rt[chain] a copy of routelist,
+	 * plus the tail-stages of pipelined routes.
+	 */
 	for (RouteList::iterator ri = routelist->begin (); ri != routelist->end (); ri++) {
 		(*ri)->_init_refcount[chain] = 0;
 		(*ri)->_activation_set[chain].clear ();
+		(*ri)->_activation_list[chain].clear ();
 		_nodes_rt[chain].push_back (*ri);
+
+		node_ptr_t stage = (*ri)->pipeline_stage ();
+		if (stage) {
+			stage->_init_refcount[chain] = 0;
+			stage->_activation_set[chain].clear ();
+			stage->_activation_list[chain].clear ();
+			_nodes_rt[chain].push_back (stage);
+		}
 	}
 
 	// now add refs for the connections.
 
-	for (node_list_t::iterator ni = _nodes_rt[chain].begin (); ni != _nodes_rt[chain].end (); ni++) {
-		boost::shared_ptr<Route> r = boost::dynamic_pointer_cast<Route> (*ni);
+	for (RouteList::iterator ri = routelist->begin (); ri != routelist->end (); ri++) {
+		boost::shared_ptr<Route> r = *ri;
+
+		/* A pipelined route's tail processes data handed over by the
+		 * route in the previous cycle. It does not depend on any node
+		 * in this cycle, but feeds the same nodes as the route itself.
+		 */
+		node_ptr_t stage = r->pipeline_stage ();
 
 		/* The routes that are directly fed by r */
 		set<GraphVertex> fed_from_r = edges.from (r);
@@ -364,6 +576,9 @@ Graph::rechain (boost::shared_ptr<RouteList> routelist, GraphEdges const& edges)
 		/* Set up r's activation set */
 		for (set<GraphVertex>::iterator i = fed_from_r.begin (); i != fed_from_r.end (); ++i) {
 			r->_activation_set[chain].insert (*i);
+			if (stage) {
+				stage->_activation_set[chain].insert (*i);
+			}
 		}
 
 		/* r has an input if there are some incoming edges to r in the graph */
@@ -371,44 +586,131 @@ Graph::rechain (boost::shared_ptr<RouteList> routelist, GraphEdges const& edges)
 
 		/* Increment the refcount of any route that we directly feed */
 		for (node_set_t::iterator ai = r->_activation_set[chain].begin (); ai != r->_activation_set[chain].end (); ai++) {
-			(*ai)->_init_refcount[chain] += 1;
+			(*ai)->_init_refcount[chain] += stage ? 2 : 1;
 		}
 
 		if (!has_input) {
 			/* no input, so this node needs to be triggered initially to get things going */
-			_init_trigger_list[chain].push_back (*ni);
+			_init_trigger_list[chain].push_back (r);
+		}
+
+		if (stage) {
+			_init_trigger_list[chain].push_back (stage);
 		}
 
 		if (!has_output) {
 			/* no output, so this is one of the nodes that we can count off to decide
 			 * if we've finished
 			 */
-			_n_terminal_nodes[chain] += 1;
+			_n_terminal_nodes[chain] += stage ? 2 : 1;
+		}
+	}
+
+	/* Flatten activation sets, and find a topological order of all nodes */
+	std::map<GraphNode*, gint> refcnt;
+	std::list<GraphNode*>      ready;
+
+	_topo_order[chain].clear ();
+
+	for (node_list_t::iterator ni = _nodes_rt[chain].begin (); ni != _nodes_rt[chain].end (); ni++) {
+		for (node_set_t::iterator ai = (*ni)->_activation_set[chain].begin (); ai != (*ni)->_activation_set[chain].end (); ai++) {
+			(*ni)->_activation_list[chain].push_back (ai->get ());
+		}
+		refcnt[ni->get ()] = (*ni)->_init_refcount[chain];
+		if ((*ni)->_init_refcount[chain] == 0) {
+			ready.push_back (ni->get ());
+		}
+	}
+
+	while (!ready.empty ()) {
+		GraphNode* n = ready.front ();
+		ready.pop_front ();
+		_topo_order[chain].push_back (n);
+		for (std::vector<GraphNode*>::const_iterator ai = n->_activation_list[chain].begin (); ai != n->_activation_list[chain].end (); ++ai) {
+			if (--refcnt[*ai] == 0) {
+				ready.push_back (*ai);
+			}
 		}
 	}
 
+	assert (_topo_order[chain].size () == _nodes_rt[chain].size ());
+
+	/* start with the cost measured while the node was part of the current chain */
+	for (std::vector<GraphNode*>::const_iterator i = _topo_order[chain].begin (); i != _topo_order[chain].end (); ++i) {
+		(*i)->_cost[chain] = (*i)->_cost[_current_chain];
+	}
+
+	update_priorities (chain);
+
 	_pending_chain = chain;
 	dump (chain);
 }
 
+bool
+Graph::RankSort::operator() (GraphNode const* a, GraphNode const* b) const
+{
+	return a->_rank[chain] > b->_rank[chain];
+}
+
+bool
+Graph::RankSort::operator() (node_ptr_t const& a, node_ptr_t const& b) const
+{
+	return a->_rank[chain] > b->_rank[chain];
+}
+
+/** Prioritize nodes on the critical path (HEFT upward rank).
+ *
+ * The rank of a node is its average execution time plus the largest
+ * rank of the nodes it feeds, i.e. the time it takes at least
+ * from the start of this node until the end of the graph is reached.
+ * Nodes with a higher rank are queued first.
+ *
+ * Rank and cost are kept per chain. This is called with the swap mutex
+ * held, for the setup-chain by rechain(), and for the current chain from
+ * prep() when all other threads are idle.
+ */
+void
+Graph::update_priorities (int chain)
+{
+	for (std::vector<GraphNode*>::reverse_iterator i = _topo_order[chain].rbegin (); i != _topo_order[chain].rend (); ++i) {
+		GraphNode* n = *i;
+
+		uint64_t downstream = 0;
+		for (std::vector<GraphNode*>::const_iterator ai = n->_activation_list[chain].begin (); ai != n->_activation_list[chain].end (); ++ai) {
+			downstream = std::max (downstream, (*ai)->_rank[chain]);
+		}
+		n->_rank[chain] = n->_cost[chain] + downstream;
+	}
+
+	RankSort rank_sort (chain);
+
+	for (std::vector<GraphNode*>::const_iterator i = _topo_order[chain].begin (); i != _topo_order[chain].end (); ++i) {
+		std::sort ((*i)->_activation_list[chain].begin (), (*i)->_activation_list[chain].end (), rank_sort);
+	}
+
+	_init_trigger_list[chain].sort (rank_sort);
+}
+
 /** Called by both the main thread and all helpers. */
 void
 Graph::run_one ()
 {
 	GraphNode* to_run = NULL;
+	bool       queued = false;
 
 	if (g_atomic_int_get (&_terminate)) {
 		return;
 	}
 
-	if (_trigger_queue.pop_front (to_run)) {
+	if (pop_work (to_run, queued)) {
 		/* Wake up idle threads, but at most as many as there's
 		 * work in the trigger queue that can be processed by
 		 * other threads.
-		 * This thread as not yet decreased _trigger_queue_size.
+		 * This thread as not yet decreased _trigger_queue_size
+		 * (if the node was queued at all).
 		 */
 		guint idle_cnt   = g_atomic_uint_get (&_idle_thread_cnt);
-		guint work_avail = g_atomic_uint_get (&_trigger_queue_size);
+		guint work_avail = g_atomic_uint_get (&_trigger_queue_size) + (queued ? 0 : 1);
 		guint wakeup     = std::min (idle_cnt + 1, work_avail);
 
 		DEBUG_TRACE (DEBUG::ProcessThreads, string_compose ("%1 signals %2 threads\n", pthread_name (), wakeup));
@@ -423,7 +725,12 @@ Graph::run_one ()
 		assert (g_atomic_uint_get (&_idle_thread_cnt) <= _n_workers);
 
 		DEBUG_TRACE (DEBUG::ProcessThreads, string_compose ("%1 goes to sleep\n", pthread_name ()));
-		_execution_sem.wait ();
+		Worker* w = _thread_worker.get ();
+		if (w) {
+			spin_wait (_execution_sem, w->spin_budget);
+		} else {
+			_execution_sem.wait ();
+		}
 
 		if (g_atomic_int_get (&_terminate)) {
 			return;
@@ -434,11 +741,13 @@ Graph::run_one ()
 		g_atomic_int_dec_and_test (&_idle_thread_cnt);
 
 		/* Try to find some work to do */
-		_trigger_queue.pop_front (to_run);
+		pop_work (to_run, queued);
 	}
 
 	/* Process the graph-node */
-	g_atomic_int_dec_and_test (&_trigger_queue_size);
+	if (queued) {
+		g_atomic_int_dec_and_test (&_trigger_queue_size);
+	}
 	to_run->run (_current_chain);
 
 	DEBUG_TRACE (DEBUG::ProcessThreads, string_compose ("%1 has finished run_one()\n", pthread_name ()));
@@ -447,8 +756,9 @@ Graph::run_one ()
 void
 Graph::helper_thread ()
 {
-	g_atomic_int_inc (&_n_workers);
-	guint id = g_atomic_uint_get (&_n_workers);
+	guint id = g_atomic_int_add (&_n_workers, 1) + 1;
+
+	register_worker (id);
 
 	/* This is needed for ARDOUR::Session requests called from rt-processors
 	 * in particular Lua scripts may do cross-thread calls */
@@ -480,6 +790,8 @@ Graph::main_thread ()
 {
 	/* first time setup */
 
+	register_worker (0);
+
 	suspend_rt_malloc_checks ();
 	ProcessThread* pt = new ProcessThread ();
 
@@ -498,7 +810,7 @@ Graph::main_thread ()
 
 	/* Wait for initial process callback */
 again:
-	_callback_start_sem.wait ();
+	spin_wait (_callback_start_sem, _callback_start_spin_budget);
 
 	DEBUG_TRACE (DEBUG::ProcessThreads, "main thread is awake\n");
 
@@ -508,6 +820,8 @@ again:
 		return;
 	}
 
+	_wakeup_latency.add (g_get_monotonic_time () - _callback_start_time);
+
 	/* Bootstrap the trigger-list
 	 * (later this is done by Graph_reached_terminal_node) */
 	prep ();
@@ -538,16 +852,15 @@ Graph::dump (int chain) const
 
 	DEBUG_TRACE (DEBUG::Graph, "--------------------------------------------Graph dump:\n");
 	for (ni = _nodes_rt[chain].begin (); ni != _nodes_rt[chain].end (); ni++) {
-		boost::shared_ptr<Route> rp = boost::dynamic_pointer_cast<Route> (*ni);
-		DEBUG_TRACE (DEBUG::Graph, string_compose ("GraphNode: %1  refcount: %2\n", rp->name ().c_str (), (*ni)->_init_refcount[chain]));
+		DEBUG_TRACE (DEBUG::Graph, string_compose ("GraphNode: %1  refcount: %2\n", (*ni)->graph_node_name (), (*ni)->_init_refcount[chain]));
 		for (ai = (*ni)->_activation_set[chain].begin (); ai != (*ni)->_activation_set[chain].end (); ai++) {
-			DEBUG_TRACE (DEBUG::Graph, string_compose ("  triggers: %1\n", boost::dynamic_pointer_cast<Route> (*ai)->name ().c_str ()));
+			DEBUG_TRACE (DEBUG::Graph, string_compose ("  triggers: %1\n", (*ai)->graph_node_name ()));
 		}
 	}
 
 	DEBUG_TRACE (DEBUG::Graph, "------------- trigger list:\n");
 	for (ni = _init_trigger_list[chain].begin (); ni != _init_trigger_list[chain].end (); ni++) {
-		DEBUG_TRACE (DEBUG::Graph, string_compose ("GraphNode: %1  refcount: %2\n", boost::dynamic_pointer_cast<Route> (*ni)->name ().c_str (), (*ni)->_init_refcount[chain]));
+		DEBUG_TRACE (DEBUG::Graph, string_compose ("GraphNode: %1  refcount: %2\n", (*ni)->graph_node_name (), (*ni)->_init_refcount[chain]));
 	}
 
 	DEBUG_TRACE (DEBUG::Graph, string_compose ("final activation refcount: %1\n", _n_terminal_nodes[chain]));
@@ -569,7 +882,7 @@ Graph::plot (std::string const& file_name) const
 
 	for (ni = _nodes_rt[chain].begin (); ni != _nodes_rt[chain].end (); ni++) {
 		boost::shared_ptr<Route> sr = boost::dynamic_pointer_cast<Route> (*ni);
-		std::string sn = string_compose ("%1 (%2)", sr->name (), (*ni)->_init_refcount[chain]);
+		std::string sn = string_compose ("%1 (%2)", (*ni)->graph_node_name (), (*ni)->_init_refcount[chain]);
 		if ((*ni)->_init_refcount[chain] == 0 && (*ni)->_activation_set[chain].size() == 0) {
 				ss << "  \"" << sn << "\"[style=filled,fillcolor=gold1];\n";
 		} else if ((*ni)->_init_refcount[chain] == 0) {
@@ -579,9 +892,11 @@ Graph::plot (std::string const& file_name) const
 		}
 		for (ai = (*ni)->_activation_set[chain].begin (); ai != (*ni)->_activation_set[chain].end (); ai++) {
 			boost::shared_ptr<Route> dr = boost::dynamic_pointer_cast<Route> (*ai);
-			std::string dn = string_compose ("%1 (%2)", dr->name (), (*ai)->_init_refcount[chain]);
+			std::string dn = string_compose ("%1 (%2)", (*ai)->graph_node_name (), (*ai)->_init_refcount[chain]);
 			bool sends_only = false;
-			sr->direct_feeds_according_to_reality (dr, &sends_only);
+			if (sr && dr) {
+				sr->direct_feeds_according_to_reality (dr, &sends_only);
+			}
 			if (sends_only) {
 				ss << "  edge [style=dashed];\n";
 			}
@@ -622,8 +937,10 @@ Graph::process_routes (pframes_t nframes, samplepos_t start_sample, samplepos_t
 	_process_need_butler = false;
 
 	DEBUG_TRACE (DEBUG::ProcessThreads, "wake graph for non-silent process\n");
+	_callback_start_time = g_get_monotonic_time ();
 	_callback_start_sem.signal ();
-	_callback_done_sem.wait ();
+	spin_wait (_callback_done_sem, _callback_done_spin_budget);
+	_execution_time.add (g_get_monotonic_time () - _callback_start_time);
 	DEBUG_TRACE (DEBUG::ProcessThreads, "graph execution complete\n");
 
 	need_butler = _process_need_butler;
@@ -650,8 +967,9 @@ Graph::routes_no_roll (pframes_t nframes, samplepos_t start_sample, samplepos_t
 	_process_need_butler = false;
 
 	DEBUG_TRACE (DEBUG::ProcessThreads, "wake graph for no-roll process\n");
+	_callback_start_time = g_get_monotonic_time ();
 	_callback_start_sem.signal ();
-	_callback_done_sem.wait ();
+	spin_wait (_callback_done_sem, _callback_done_spin_budget);
 	DEBUG_TRACE (DEBUG::ProcessThreads, "graph execution complete\n");
 
 	return _process_retval;
@@ -681,6 +999,14 @@ Graph::process_one_route (Route* route)
 	}
 }
 
+void
+Graph::process_one_pipeline_stage (Route& route)
+{
+	DEBUG_TRACE (DEBUG::ProcessThreads, string_compose ("%1 runs pipeline stage of %2\n", pthread_name (), route.name ()));
+
+	route.run_pipeline_tail (_process_nframes, _process_start_sample, _process_end_sample, !_process_noroll);
+}
+
 bool
 Graph::in_process_thread () const
 {
@@ -26,7 +26,13 @@ using namespace ARDOUR;
 
 GraphNode::GraphNode (boost::shared_ptr<Graph> graph)
 	: _graph (graph)
+	, _run_usec (0)
+	, _run_cnt (0)
+	, _cost_usec (0)
+	, _cost_cnt (0)
 {
+	_cost[0] = _cost[1] = 0;
+	_rank[0] = _rank[1] = 0;
 }
 
 GraphNode::~GraphNode ()
@@ -40,6 +46,37 @@ GraphNode::prep (int chain)
 	g_atomic_int_set (&_refcount, _init_refcount[chain]);
 }
 
+/** Update the node's average execution time for the given chain
+ * from the runs since the last call.
+ *
+ * This must only be called while no process-thread runs the node.
+ */
+void
+GraphNode::update_cost (int chain)
+{
+	uint64_t const cnt = _run_cnt - _cost_cnt;
+	if (cnt > 1) {
+		_cost[chain] = (_run_usec - _cost_usec) / cnt;
+		_cost_usec   = _run_usec;
+		_cost_cnt    = _run_cnt;
+	}
+}
+
+void
+GraphNode::run (int chain)
+{
+	if (_graph->sample_cost ()) {
+		_timing.start ();
+		process ();
+		_timing.update ();
+		_run_usec += _timing.elapsed ();
+		++_run_cnt;
+	} else {
+		process ();
+	}
+	finish (chain);
+}
+
 /** Called by an upstream node, when it has completed processing */
 void
 GraphNode::trigger ()
@@ -58,11 +95,13 @@ GraphNode::trigger ()
 void
 GraphNode::finish (int chain)
 {
-	node_set_t::iterator i;
-	bool                 feeds = false;
+	std::vector<GraphNode*>::const_iterator i;
+	bool                                    feeds = false;
 
-	/* Notify downstream nodes that depend on this node */
-	for (i = _activation_set[chain].begin (); i != _activation_set[chain].end (); ++i) {
+	/* Notify downstream nodes that depend on this node,
+	 * those on the longest path to the end of the graph first.
+	 */
+	for (i = _activation_list[chain].begin (); i != _activation_list[chain].end (); ++i) {
 		(*i)->trigger ();
 		feeds = true;
 	}
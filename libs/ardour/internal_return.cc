@@ -21,6 +21,7 @@
 
 #include <glibmm/threads.h>
 
+#include "ardour/audio_buffer.h"
 #include "ardour/internal_return.h"
 #include "ardour/internal_send.h"
 #include "ardour/route.h"
@@ -48,9 +49,31 @@ InternalReturn::run (BufferSet& bufs, samplepos_t /*start_sample*/, samplepos_t
 		return;
 	}
 
+	/* sum all sends into each audio channel in a single pass, rather
+	 * than reading and writing the destination once per send.
+	 */
+	for (uint32_t c = 0; c < bufs.count ().n_audio (); ++c) {
+		_mix_srcs.clear ();
+		for (list<InternalSend*>::iterator i = _sends.begin(); i != _sends.end(); ++i) {
+			if ((*i)->active () && (!(*i)->source_route() || (*i)->source_route()->active())) {
+				BufferSet const& sb ((*i)->get_buffers ());
+				if (c < sb.count ().n_audio () && !sb.get_audio (c).silent ()) {
+					_mix_srcs.push_back (sb.get_audio (c).data ());
+				}
+			}
+		}
+		if (!_mix_srcs.empty ()) {
+			bufs.get_audio (c).accumulate_n_from (&_mix_srcs[0], 0, _mix_srcs.size (), nframes);
+		}
+	}
+
 	for (list<InternalSend*>::iterator i = _sends.begin(); i != _sends.end(); ++i) {
 		if ((*i)->active () && (!(*i)->source_route() || (*i)->source_route()->active())) {
-			bufs.merge_from ((*i)->get_buffers(), nframes);
+			BufferSet const&    sb ((*i)->get_buffers ());
+			BufferSet::iterator o = bufs.begin (DataType::MIDI);
+			for (BufferSet::const_iterator b = sb.begin (DataType::MIDI); b != sb.end (DataType::MIDI) && o != bufs.end (DataType::MIDI); ++b, ++o) {
+				o->merge_from (*b, nframes);
+			}
 		}
 	}
 }
@@ -60,6 +83,8 @@ InternalReturn::add_send (InternalSend* send)
 {
 	Glib::Threads::Mutex::Lock lm (_sends_mutex);
 	_sends.push_back (send);
+	/* run() must not allocate */
+	_mix_srcs.reserve (_sends.size ());
 }
 
 void
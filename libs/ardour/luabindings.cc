@@ -23,6 +23,7 @@
 #include <glibmm.h>
 
 #include "pbd/stateful_diff_command.h"
+#include "pbd/timing.h"
 #include "pbd/openuri.h"
 
 #include "temporal/bbt_time.h"
@@ -485,6 +486,15 @@ LuaBindings::common (lua_State* L)
 		.addFunction ("increment_write_ptr", &PBD::RingBufferNPT<int>::increment_write_ptr)
 		.endClass ()
 
+		.beginClass <PBD::TimingHistogram> ("TimingHistogram")
+		.addFunction ("reset", &PBD::TimingHistogram::reset)
+		.addFunction ("n_samples", &PBD::TimingHistogram::n_samples)
+		.addFunction ("bucket_count", &PBD::TimingHistogram::bucket_count)
+		.addFunction ("max_usec", &PBD::TimingHistogram::max_usec)
+		.addFunction ("percentile", &PBD::TimingHistogram::percentile)
+		.addStaticFunction ("bucket_limit", &PBD::TimingHistogram::bucket_limit)
+		.endClass ()
+
 		/* PBD enums */
 		.beginNamespace ("GroupControlDisposition")
 		.addConst ("InverseGroup", PBD::Controllable::GroupControlDisposition(PBD::Controllable::InverseGroup))
@@ -1094,6 +1104,8 @@ LuaBindings::common (lua_State* L)
 		.addFunction ("nth_plugin", &Route::nth_plugin)
 		.addFunction ("nth_processor", &Route::nth_processor)
 		.addFunction ("nth_send", &Route::nth_send)
+		.addFunction ("dsp_profile", &Route::dsp_profile)
+		.addFunction ("reset_dsp_profiles", &Route::reset_dsp_profiles)
 		.addFunction ("add_foldback_send", &Route::add_foldback_send)
 		.addFunction ("add_processor_by_index", &Route::add_processor_by_index)
 		.addFunction ("remove_processor", &Route::remove_processor)
@@ -1458,6 +1470,7 @@ LuaBindings::common (lua_State* L)
 		.addFunction ("output_streams", &Processor::output_streams)
 		.addFunction ("input_streams", &Processor::input_streams)
 		.addFunction ("signal_latency", &Processor::signal_latency)
+		.addFunction ("dsp_profile", &Processor::dsp_profile)
 		.endClass ()
 
 		.deriveWSPtrClass <DiskIOProcessor, Processor> ("DiskIOProcessor")
@@ -2159,6 +2172,11 @@ LuaBindings::common (lua_State* L)
 		.addConst ("DenormalFTZDAZ", ARDOUR::DenormalModel(DenormalFTZDAZ))
 		.endNamespace ()
 
+		.beginNamespace ("GraphSchedulerModel")
+		.addConst ("SharedTriggerQueue", ARDOUR::GraphSchedulerModel(SharedTriggerQueue))
+		.addConst ("WorkStealing", ARDOUR::GraphSchedulerModel(WorkStealing))
+		.endNamespace ()
+
 		.beginNamespace ("BufferingPreset")
 		.addConst ("Small", ARDOUR::BufferingPreset(Small))
 		.addConst ("Medium", ARDOUR::BufferingPreset(Medium))
@@ -2447,6 +2465,7 @@ LuaBindings::common (lua_State* L)
 		.addFunction ("get_play_loop", &Session::get_play_loop)
 		.addFunction ("get_xrun_count", &Session::get_xrun_count)
 		.addFunction ("reset_xrun_count", &Session::reset_xrun_count)
+		.addFunction ("reset_dsp_profiles", &Session::reset_dsp_profiles)
 		.addFunction ("last_transport_start", &Session::last_transport_start)
 		.addFunction ("goto_start", &Session::goto_start)
 		.addFunction ("goto_end", &Session::goto_end)
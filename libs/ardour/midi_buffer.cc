@@ -299,6 +299,21 @@ MidiBuffer::reserve(TimeType time, Evoral::EventType event_type, size_t size)
 	return write_loc;
 }
 
+uint8_t*
+MidiBuffer::reserve_records (size_t size)
+{
+	if (_size + size >= _capacity) {
+		return 0;
+	}
+
+	uint8_t* write_loc = _data + _size;
+
+	_size += size;
+	_silent = false;
+
+	return write_loc;
+}
+
 
 void
 MidiBuffer::silence (samplecnt_t /*nframes*/, samplecnt_t /*offset*/)
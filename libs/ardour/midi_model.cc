@@ -24,6 +24,7 @@
  */
 
 #include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <set>
 #include <stdexcept>
@@ -230,12 +231,62 @@ MidiModel::NoteDiffCommand::operator+= (const NoteDiffCommand& other)
 	return *this;
 }
 
+MidiModel::NoteSnapshot::NoteSnapshot (Evoral::Note<TimeType> const& note)
+	: time (note.time ())
+	, end_time (note.end_time ())
+{
+	memcpy (on, note.on_event ().buffer (), sizeof (on));
+	memcpy (off, note.off_event ().buffer (), sizeof (off));
+}
+
+/** Collect all notes that this command may add, remove or modify */
+void
+MidiModel::NoteDiffCommand::affected_notes (set<NotePtr>& notes)
+{
+	notes.insert (_added_notes.begin (), _added_notes.end ());
+	notes.insert (_removed_notes.begin (), _removed_notes.end ());
+	notes.insert (side_effect_removals.begin (), side_effect_removals.end ());
+
+	for (ChangeList::iterator i = _changes.begin (); i != _changes.end (); ++i) {
+		if (!i->note) {
+			i->note = _model->find_note (i->note_id);
+		}
+		if (i->note) {
+			notes.insert (i->note);
+		}
+	}
+}
+
+/** Append snapshots of those of @param notes that are currently part of @param model */
+static void
+snapshot_notes (MidiModel const& model, set<MidiModel::NotePtr> const& notes, vector<MidiModel::NoteSnapshot>& snapshots)
+{
+	for (set<MidiModel::NotePtr>::const_iterator n = notes.begin (); n != notes.end (); ++n) {
+		/* notes are ordered by time only, find this very note among the ones at its time */
+		pair<MidiModel::Notes::const_iterator, MidiModel::Notes::const_iterator> r = model.notes ().equal_range (*n);
+		for (MidiModel::Notes::const_iterator i = r.first; i != r.second; ++i) {
+			if (*i == *n) {
+				snapshots.push_back (MidiModel::NoteSnapshot (**n));
+				break;
+			}
+		}
+	}
+}
+
 void
 MidiModel::NoteDiffCommand::operator() ()
 {
+	NoteDelta delta;
+
 	{
 		MidiModel::WriteLock lock(_model->edit_lock());
 
+		set<NotePtr> affected;
+		affected_notes (affected);
+		snapshot_notes (*_model, affected, delta.removed);
+
+		const size_t n_notes = _model->n_notes ();
+
 		for (NoteList::iterator i = _added_notes.begin(); i != _added_notes.end(); ++i) {
 			if (!_model->add_note_unlocked(*i)) {
 				/* failed to add it, so don't leave it in the removed list, to
@@ -322,17 +373,35 @@ MidiModel::NoteDiffCommand::operator() ()
 				cerr << "\t" << *i << ' ' << **i << endl;
 			}
 		}
+
+		set<NotePtr> now_affected;
+		affected_notes (now_affected);
+		snapshot_notes (*_model, now_affected, delta.added);
+
+		/* overlap resolution may have modified or removed other notes */
+		delta.complete = now_affected.size () == affected.size ()
+			&& _model->insert_merge_policy () == InsertMergeRelax
+			&& n_notes - delta.removed.size () + delta.added.size () == _model->n_notes ();
 	}
 
+	_model->NotesChanged (delta); /* EMIT SIGNAL */
 	_model->ContentsChanged(); /* EMIT SIGNAL */
 }
 
 void
 MidiModel::NoteDiffCommand::undo ()
 {
+	NoteDelta delta;
+
 	{
 		MidiModel::WriteLock lock(_model->edit_lock());
 
+		set<NotePtr> affected;
+		affected_notes (affected);
+		snapshot_notes (*_model, affected, delta.removed);
+
+		const size_t n_notes = _model->n_notes ();
+
 		for (NoteList::iterator i = _added_notes.begin(); i != _added_notes.end(); ++i) {
 			_model->remove_note_unlocked(*i);
 		}
@@ -432,8 +501,14 @@ MidiModel::NoteDiffCommand::undo ()
 		for (set<NotePtr>::iterator i = side_effect_removals.begin(); i != side_effect_removals.end(); ++i) {
 			_model->add_note_unlocked (*i);
 		}
+
+		snapshot_notes (*_model, affected, delta.added);
+
+		delta.complete = _model->insert_merge_policy () == InsertMergeRelax
+			&& n_notes - delta.removed.size () + delta.added.size () == _model->n_notes ();
 	}
 
+	_model->NotesChanged (delta); /* EMIT SIGNAL */
 	_model->ContentsChanged(); /* EMIT SIGNAL */
 }
 
@@ -485,7 +560,7 @@ MidiModel::NoteDiffCommand::unmarshal_note (XMLNode *xml_note)
 		warning << "note information missing velocity" << endmsg;
 	}
 
-	NotePtr note_ptr(new Evoral::Note<TimeType>(channel, time, length, note, velocity));
+	NotePtr note_ptr (_model->new_note (channel, time, length, note, velocity));
 	note_ptr->set_id (id);
 
 	return note_ptr;
@@ -1458,7 +1533,7 @@ MidiModel::resolve_overlaps_unlocked (const NotePtr note, void* arg)
 	TimeType ea  = note->end_time();
 
 	const Pitches& p (pitches (note->channel()));
-	NotePtr search_note(new Note<TimeType>(0, TimeType(), TimeType(), note->note()));
+	NotePtr search_note (new_note (0, TimeType(), TimeType(), note->note()));
 	set<NotePtr> to_be_deleted;
 	bool set_note_length = false;
 	bool set_note_time = false;
@@ -22,14 +22,17 @@
 #include <algorithm>
 #include <cassert>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <utility>
 
 #include "evoral/EventList.h"
 #include "evoral/Control.h"
+#include "evoral/midi_events.h"
 
 #include "ardour/beats_samples_converter.h"
 #include "ardour/debug.h"
+#include "ardour/midi_channel_filter.h"
 #include "ardour/midi_model.h"
 #include "ardour/midi_playlist.h"
 #include "ardour/midi_region.h"
@@ -51,6 +54,9 @@ MidiPlaylist::MidiPlaylist (Session& session, const XMLNode& node, bool hidden)
 	: Playlist (session, node, DataType::MIDI, hidden)
 	, _note_mode(Sustained)
 	, _read_end(0)
+	, _render_valid (0)
+	, _render_filter (-1)
+	, _patched_change (0)
 {
 #ifndef NDEBUG
 	XMLProperty const * prop = node.property("type");
@@ -70,6 +76,9 @@ MidiPlaylist::MidiPlaylist (Session& session, string name, bool hidden)
 	: Playlist (session, name, DataType::MIDI, hidden)
 	, _note_mode(Sustained)
 	, _read_end(0)
+	, _render_valid (0)
+	, _render_filter (-1)
+	, _patched_change (0)
 {
 }
 
@@ -77,6 +86,9 @@ MidiPlaylist::MidiPlaylist (boost::shared_ptr<const MidiPlaylist> other, string
 	: Playlist (other, name, hidden)
 	, _note_mode(other->_note_mode)
 	, _read_end(0)
+	, _render_valid (0)
+	, _render_filter (-1)
+	, _patched_change (0)
 {
 }
 
@@ -88,6 +100,9 @@ MidiPlaylist::MidiPlaylist (boost::shared_ptr<const MidiPlaylist> other,
 	: Playlist (other, start, dur, name, hidden)
 	, _note_mode(other->_note_mode)
 	, _read_end(0)
+	, _render_valid (0)
+	, _render_filter (-1)
+	, _patched_change (0)
 {
 }
 
@@ -185,6 +200,7 @@ MidiPlaylist::destroy_region (boost::shared_ptr<Region> region)
 
 			if ((*i) == region) {
 				regions.erase (i);
+				region_index_remove (region);
 				changed = true;
 			}
 
@@ -301,8 +317,25 @@ MidiPlaylist::contained_automation()
 void
 MidiPlaylist::render (MidiChannelFilter* filter)
 {
-	typedef pair<MidiStateTracker*,samplepos_t> TrackerInfo;
+	if (filter) {
+		ChannelMode mode;
+		uint16_t    mask;
+		filter->get_mode_and_mask (&mode, &mask);
+		g_atomic_int_set (&_render_filter, (mode << 16) | mask);
+	} else {
+		g_atomic_int_set (&_render_filter, -1);
+	}
+
+	render (_rendered, filter);
+
+	g_atomic_int_set (&_render_valid, 1);
+
+	DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("---- End MidiPlaylist::render, events: %1\n", _rendered.size()));
+}
 
+void
+MidiPlaylist::render (RTMidiBuffer& dst, MidiChannelFilter* filter)
+{
 	Playlist::RegionReadLock rl (this);
 
 	DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("---- MidiPlaylist::render (regions: %1)-----\n", regions.size()));
@@ -320,24 +353,24 @@ MidiPlaylist::render (MidiChannelFilter* filter)
 		regs.push_back (*i);
 	}
 
-	/* If we are reading from a single region, we can read directly into _rendered.  Otherwise,
-	   we read into a temporarily list, sort it, then write that to _rendered.
+	/* If we are reading from a single region, we can read directly into dst.  Otherwise,
+	   we read into a temporarily list, sort it, then write that to dst.
 	*/
 	Evoral::EventList<samplepos_t>  evlist;
 	Evoral::EventSink<samplepos_t>* tgt;
 
 	/* RAII */
-	RTMidiBuffer::WriteProtectRender wpr (_rendered);
+	RTMidiBuffer::WriteProtectRender wpr (dst);
 
 	if (regs.empty()) {
 		wpr.acquire ();
-		_rendered.clear ();
+		dst.clear ();
 	} else {
 
 		if (regs.size() == 1) {
-			tgt = &_rendered;
+			tgt = &dst;
 			wpr.acquire ();
-			_rendered.clear ();
+			dst.clear ();
 		} else {
 			tgt = &evlist;
 		}
@@ -361,22 +394,20 @@ MidiPlaylist::render (MidiChannelFilter* filter)
 			EventsSortByTimeAndType<samplepos_t> cmp;
 			evlist.sort (cmp);
 
-			/* Copy ordered events from event list to _rendered. */
+			/* Copy ordered events from event list to dst. */
 
 			wpr.acquire ();
-			_rendered.clear ();
+			dst.clear ();
 
 			for (Evoral::EventList<samplepos_t>::iterator e = evlist.begin(); e != evlist.end(); ++e) {
 				Evoral::Event<samplepos_t>* ev (*e);
-				_rendered.write (ev->time(), ev->event_type(), ev->size(), ev->buffer());
+				dst.write (ev->time(), ev->event_type(), ev->size(), ev->buffer());
 				delete ev;
 			}
 		}
 	}
 
 	/* no need to release - RAII with WriteProtectRender takes care of it */
-
-	DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("---- End MidiPlaylist::render, events: %1\n", _rendered.size()));
 }
 
 RTMidiBuffer*
@@ -384,3 +415,103 @@ MidiPlaylist::rendered ()
 {
 	return &_rendered;
 }
+
+/** Append the events that MidiRegion::render() produces for a note.
+ * @return false if the note is not handled here
+ */
+static bool
+note_items (MidiRegion const& region, MidiModel::NoteSnapshot const& note, MidiChannelFilter* filter, vector<RTMidiBuffer::Item>& items)
+{
+	TempoMap const& tmap (region.session ().tempo_map ());
+
+	const double      start_qn  = region.quarter_note () - region.start_beats ();
+	const samplepos_t start     = region.position ();
+	const samplepos_t end       = region.position () + region.length ();
+	const samplepos_t on_time   = tmap.sample_at_quarter_note (note.time.to_double () + start_qn);
+	const samplepos_t off_time  = tmap.sample_at_quarter_note (note.end_time.to_double () + start_qn);
+
+	if (on_time >= end) {
+		return true;
+	}
+
+	if (on_time < start || off_time <= on_time || note.on[2] == 0) {
+		/* the note-off may be read without the note-on, or the order
+		 * of the events is ambiguous
+		 */
+		return false;
+	}
+
+	uint8_t on[3];
+	uint8_t off[3];
+
+	memcpy (on, note.on, sizeof (on));
+	memcpy (off, note.off, sizeof (off));
+
+	const bool filtered = filter && filter->filter (on, sizeof (on));
+
+	if (!filtered) {
+		items.push_back (RTMidiBuffer::make_item (on_time, on, sizeof (on)));
+	}
+
+	if (off_time < end) {
+		if (!(filter && filter->filter (off, sizeof (off)))) {
+			items.push_back (RTMidiBuffer::make_item (off_time, off, sizeof (off)));
+		}
+	} else {
+		/* resolved by the region's state tracker, which also tracks
+		 * filtered notes
+		 */
+		off[0] = MIDI_CMD_NOTE_OFF | (note.off[0] & 0xf);
+		off[1] = note.off[1];
+		off[2] = 0;
+		items.push_back (RTMidiBuffer::make_item (end, off, sizeof (off)));
+	}
+
+	return true;
+}
+
+bool
+MidiPlaylist::patch_render (MidiRegion const& region, MidiModel::NoteDelta const& delta)
+{
+	if (!g_atomic_int_get (&_render_valid) || !delta.complete || _note_mode != Sustained || holding_state () || _session.solo_selection_active ()) {
+		return false;
+	}
+
+	if (region.muted ()) {
+		/* not rendered */
+		return true;
+	}
+
+	MidiChannelFilter  channel_filter;
+	MidiChannelFilter* filter = 0;
+
+	const gint mode_mask = g_atomic_int_get (&_render_filter);
+
+	if (mode_mask >= 0) {
+		channel_filter.set_channel_mode (ChannelMode ((mode_mask >> 16) & 0xffff), mode_mask & 0xffff);
+		filter = &channel_filter;
+	}
+
+	vector<RTMidiBuffer::Item> remove;
+	vector<RTMidiBuffer::Item> insert;
+
+	for (vector<MidiModel::NoteSnapshot>::const_iterator n = delta.removed.begin (); n != delta.removed.end (); ++n) {
+		if (!note_items (region, *n, filter, remove)) {
+			return false;
+		}
+	}
+
+	for (vector<MidiModel::NoteSnapshot>::const_iterator n = delta.added.begin (); n != delta.added.end (); ++n) {
+		if (!note_items (region, *n, filter, insert)) {
+			return false;
+		}
+	}
+
+	if (remove.empty () && insert.empty ()) {
+		return true;
+	}
+
+	DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("%1 patch rendered events, remove %2 insert %3\n", name (), remove.size (), insert.size ()));
+
+	return _rendered.patch (remove, insert);
+}
@@ -41,6 +41,7 @@
 #include "ardour/automation_control.h"
 #include "ardour/midi_cursor.h"
 #include "ardour/midi_model.h"
+#include "ardour/midi_playlist.h"
 #include "ardour/midi_region.h"
 #include "ardour/midi_ring_buffer.h"
 #include "ardour/midi_source.h"
@@ -88,6 +89,7 @@ MidiRegion::MidiRegion (const SourceList& srcs)
 	, _start_beats (Properties::start_beats, 0.0)
 	, _length_beats (Properties::length_beats, midi_source(0)->length_beats().to_double())
 	, _ignore_shift (false)
+	, _notes_patched (false)
 {
 	register_properties ();
 	midi_source(0)->ModelChanged.connect_same_thread (_source_connection, boost::bind (&MidiRegion::model_changed, this));
@@ -101,6 +103,7 @@ MidiRegion::MidiRegion (boost::shared_ptr<const MidiRegion> other)
 	, _start_beats (Properties::start_beats, other->_start_beats)
 	, _length_beats (Properties::length_beats, other->_length_beats)
 	, _ignore_shift (false)
+	, _notes_patched (false)
 {
 	//update_length_beats ();
 	register_properties ();
@@ -116,6 +119,7 @@ MidiRegion::MidiRegion (boost::shared_ptr<const MidiRegion> other, MusicSample o
 	, _start_beats (Properties::start_beats, other->_start_beats)
 	, _length_beats (Properties::length_beats, other->_length_beats)
 	, _ignore_shift (false)
+	, _notes_patched (false)
 {
 
 	register_properties ();
@@ -190,9 +194,8 @@ MidiRegion::clone (boost::shared_ptr<MidiSource> newsrc) const
 		boost::shared_ptr<MidiSource> ms = midi_source(0);
 		Source::Lock lm (ms->mutex());
 
-		if (!ms->model()) {
-			ms->load_model (lm);
-		}
+		/* no-op if the model is already loaded */
+		ms->load_model (lm);
 
 		/* Lock our source since we'll be reading from it.  write_to() will
 		   take a lock on newsrc.
@@ -650,7 +653,8 @@ MidiRegion::clobber_sources (boost::shared_ptr<MidiSource> s)
 void
 MidiRegion::model_changed ()
 {
-	if (!model()) {
+	/* a deferred model announces itself when it is loaded */
+	if (midi_source()->model_deferred () || !model()) {
 		return;
 	}
 
@@ -674,12 +678,30 @@ MidiRegion::model_changed ()
 		);
 
 	model()->ContentsShifted.connect_same_thread (_model_shift_connection, boost::bind (&MidiRegion::model_shifted, this, _1));
+	model()->NotesChanged.connect_same_thread (_model_notes_connection, boost::bind (&MidiRegion::model_notes_changed, this, _1));
 	model()->ContentsChanged.connect_same_thread (_model_changed_connection, boost::bind (&MidiRegion::model_contents_changed, this));
 }
 
+void
+MidiRegion::model_notes_changed (MidiModel::NoteDelta const& delta)
+{
+	/* try to update the playlist's rendered events in place, which spares
+	 * the disk-reader a complete render of the playlist.
+	 */
+	boost::shared_ptr<MidiPlaylist> mpl = boost::dynamic_pointer_cast<MidiPlaylist> (playlist ());
+	_notes_patched = mpl && mpl->patch_render (*this, delta);
+}
+
 void
 MidiRegion::model_contents_changed ()
 {
+	if (_notes_patched) {
+		_notes_patched = false;
+		MidiPlaylist::PatchedChange pc (boost::dynamic_pointer_cast<MidiPlaylist> (playlist ()));
+		send_change (Properties::contents);
+		return;
+	}
+
 	send_change (Properties::contents);
 }
 
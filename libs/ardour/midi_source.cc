@@ -65,6 +65,7 @@ using namespace PBD;
 
 MidiSource::MidiSource (Session& s, string name, Source::Flag flags)
 	: Source(s, DataType::MIDI, name, flags)
+	, _model_deferred(0)
 	, _writing(false)
 	, _length_beats(0.0)
 	, _capture_length(0)
@@ -74,6 +75,7 @@ MidiSource::MidiSource (Session& s, string name, Source::Flag flags)
 
 MidiSource::MidiSource (Session& s, const XMLNode& node)
 	: Source(s, node)
+	, _model_deferred(0)
 	, _writing(false)
 	, _length_beats(0.0)
 	, _capture_length(0)
@@ -406,6 +408,10 @@ MidiSource::export_write_to (const Lock& lock, boost::shared_ptr<MidiSource> new
 {
 	Lock newsrc_lock (newsrc->mutex ());
 
+	if (!_model && g_atomic_int_get (&_model_deferred)) {
+		load_model (lock);
+	}
+
 	if (!_model) {
 		error << string_compose (_("programming error: %1"), X_("no model for MidiSource during export"));
 		return -1;
@@ -427,6 +433,10 @@ MidiSource::write_to (const Lock& lock, boost::shared_ptr<MidiSource> newsrc, Te
 	newsrc->copy_interpolation_from (this);
 	newsrc->copy_automation_state_from (this);
 
+	if (!_model && g_atomic_int_get (&_model_deferred)) {
+		load_model (lock);
+	}
+
 	if (_model) {
 		if (begin == Temporal::Beats() && end == std::numeric_limits<Temporal::Beats>::max()) {
 			_model->write_to (newsrc, newsrc_lock);
@@ -492,9 +502,35 @@ MidiSource::set_note_mode(const Lock& lock, NoteMode mode)
 	}
 }
 
+boost::shared_ptr<MidiModel>
+MidiSource::model ()
+{
+	if (g_atomic_int_get (&_model_deferred)) {
+		Lock lm (_lock);
+		/* another thread may have loaded it meanwhile */
+		if (!_model && g_atomic_int_get (&_model_deferred)) {
+			load_model (lm);
+		}
+		return _model;
+	}
+	return _model;
+}
+
+bool
+MidiSource::all_automation_played () const
+{
+	for (AutomationStateMap::const_iterator i = _automation_state.begin(); i != _automation_state.end(); ++i) {
+		if (i->second != Play) {
+			return false;
+		}
+	}
+	return true;
+}
+
 void
 MidiSource::drop_model (const Lock& lock)
 {
+	g_atomic_int_set (&_model_deferred, 0);
 	_model.reset();
 	invalidate(lock);
 	ModelChanged (); /* EMIT SIGNAL */
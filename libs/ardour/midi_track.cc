@@ -57,6 +57,7 @@
 #include "ardour/port.h"
 #include "ardour/processor.h"
 #include "ardour/profile.h"
+#include "ardour/render_cache.h"
 #include "ardour/route_group_specialized.h"
 #include "ardour/session.h"
 #include "ardour/session_playlists.h"
@@ -89,10 +90,14 @@ MidiTrack::MidiTrack (Session& sess, string name, TrackMode mode)
 
 	_playback_filter.ChannelModeChanged.connect_same_thread (*this, boost::bind (&Track::playlist_modified, this));
 	_playback_filter.ChannelMaskChanged.connect_same_thread (*this, boost::bind (&Track::playlist_modified, this));
+
+	_render_cache.reset (new RenderCache (sess, *this));
 }
 
 MidiTrack::~MidiTrack ()
 {
+	/* cancel any render before the track goes away */
+	_render_cache.reset ();
 }
 
 int
@@ -365,6 +370,8 @@ MidiTrack::no_roll_unlocked (pframes_t nframes, samplepos_t start_sample, sample
 void
 MidiTrack::realtime_locate (bool for_loop_end)
 {
+	Track::realtime_locate (for_loop_end);
+
 	Glib::Threads::RWLock::ReaderLock lm (_processor_lock, Glib::Threads::TRY_LOCK);
 
 	if (!lm.locked ()) {
@@ -145,6 +145,94 @@ default_copy_vector (ARDOUR::Sample * dst, const ARDOUR::Sample * src, pframes_t
 	memcpy(dst, src, nframes*sizeof(ARDOUR::Sample));
 }
 
+/** Apply a one-pole low-pass filtered gain ramp from \p initial towards \p target.
+ *
+ * This is equivalent to
+ * @code
+ * for (i = 0; i < nframes; ++i) { buf[i] *= g; g += coeff * (target - g); }
+ * @endcode
+ * but uses the closed form g[n] = target + (initial - target) * (1 - coeff)^n,
+ * computed for 8 consecutive samples at a time, so that there is no
+ * loop-carried dependency on the previous sample, and the compiler can
+ * vectorize the loop.
+ *
+ * @return the gain after the last sample, to be used as \p initial of the next call
+ */
+float
+default_apply_gain_ramp (ARDOUR::Sample * buf, pframes_t nframes, float initial, float target, float coeff)
+{
+	const float r  = 1.f - coeff;
+	const float r2 = r * r;
+	const float r4 = r2 * r2;
+	const float r8 = r4 * r4;
+	float       d[8];
+
+	d[0] = initial - target;
+	for (int k = 1; k < 8; ++k) {
+		d[k] = d[k - 1] * r;
+	}
+
+	pframes_t i = 0;
+	for (; i + 8 <= nframes; i += 8) {
+		for (int k = 0; k < 8; ++k) {
+			buf[i + k] *= target + d[k];
+			d[k] *= r8;
+		}
+	}
+
+	float dn = d[0];
+	for (; i < nframes; ++i) {
+		buf[i] *= target + dn;
+		dn *= r;
+	}
+
+	return target + dn;
+}
+
+/** Multiply \p buf with a per-sample \p gain vector */
+void
+default_apply_gain_vector (ARDOUR::Sample * buf, const float * gain, pframes_t nframes)
+{
+	for (pframes_t i = 0; i < nframes; ++i) {
+		buf[i] *= gain[i];
+	}
+}
+
+/** Add \p n_src buffers to \p dst, each scaled by the corresponding gain.
+ * If \p gains is NULL, unity gain is used for all sources.
+ *
+ * The destination is processed in blocks that fit into L1 cache, and all
+ * sources are added to a block before moving on to the next one. The
+ * summation order per sample is the same as calling mix_buffers_with_gain()
+ * for each source in turn.
+ */
+void
+default_mix_buffers_n (ARDOUR::Sample * dst, const ARDOUR::Sample * const * srcs, const float * gains, uint32_t n_src, pframes_t nframes)
+{
+	const pframes_t block = 256;
+
+	for (pframes_t off = 0; off < nframes; off += block) {
+		const pframes_t n   = min (block, nframes - off);
+		ARDOUR::Sample* d   = dst + off;
+		if (gains) {
+			for (uint32_t s = 0; s < n_src; ++s) {
+				const ARDOUR::Sample* src  = srcs[s] + off;
+				const float           gain = gains[s];
+				for (pframes_t i = 0; i < n; ++i) {
+					d[i] += src[i] * gain;
+				}
+			}
+		} else {
+			for (uint32_t s = 0; s < n_src; ++s) {
+				const ARDOUR::Sample* src = srcs[s] + off;
+				for (pframes_t i = 0; i < n; ++i) {
+					d[i] += src[i];
+				}
+			}
+		}
+	}
+}
+
 #if defined (__APPLE__) && defined (BUILD_VECLIB_OPTIMIZATIONS)
 #include <Accelerate/Accelerate.h>
 
@@ -0,0 +1,660 @@
+/*
+ * Copyright (C) 2026 The Ardour Team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+
+#include <boost/scoped_array.hpp>
+
+#include "pbd/compose.h"
+#include "pbd/cpus.h"
+#include "pbd/pthread_utils.h"
+#include "pbd/ringbuffer.h"
+
+#include "ardour/audio_buffer.h"
+#include "ardour/audio_track.h"
+#include "ardour/audioengine.h"
+#include "ardour/automation_control.h"
+#include "ardour/automation_list.h"
+#include "ardour/buffer_set.h"
+#include "ardour/butler.h"
+#include "ardour/debug.h"
+#include "ardour/disk_reader.h"
+#include "ardour/playback_lookahead.h"
+#include "ardour/plugin.h"
+#include "ardour/plugin_insert.h"
+#include "ardour/process_thread.h"
+#include "ardour/rc_configuration.h"
+#include "ardour/session.h"
+#include "ardour/session_event.h"
+
+using namespace ARDOUR;
+using namespace PBD;
+
+Glib::Threads::RWLock         PlaybackLookahead::_instance_lock;
+std::list<PlaybackLookahead*> PlaybackLookahead::_instances;
+PBD::Semaphore                PlaybackLookahead::_wakeup ("playback_lookahead", 0);
+gint                          PlaybackLookahead::_wakeup_pending = 0;
+uint32_t                      PlaybackLookahead::_n_workers = 0;
+
+/* plugins with longer (or infinite) tails are pre-rolled this long (sec) */
+static const samplecnt_t max_preroll_tail = 4;
+
+/* the process thread passes on at most this many blocks per cycle */
+static const samplecnt_t max_feed_blocks = 8;
+
+/** Copies of a track's plugins, and the queues of their input and output.
+ *
+ * The input is the data that the disk-reader buffered ahead of the
+ * playhead; it is copied by the process thread, so that the track's
+ * playlist is only read once. Each queue has a single reader and a single
+ * writer: the process thread and whichever worker holds _fill_lock. After a
+ * locate the process thread requests a reset; until the worker
+ * acknowledges it, only the worker touches the queues.
+ *
+ * After a reset the copies are pre-rolled by their latency and tail, so
+ * that their output matches that of the originals, which ran continuously.
+ * Since the disk-reader only holds the data after the playhead, the copies
+ * start that far ahead of it.
+ */
+class PlaybackLookahead::Chain
+{
+public:
+	Chain (InsertList const& originals, InsertList const& copies, uint32_t n_inputs, pframes_t block, samplecnt_t size, samplecnt_t preroll);
+
+	const pframes_t   block;
+	const samplecnt_t size;
+
+	bool processes (boost::shared_ptr<Processor> const& p) const {
+		for (Originals::const_iterator o = _originals.begin (); o != _originals.end (); ++o) {
+			/* compare the owners, a processor that was removed since
+			 * does not match another one at the same address.
+			 */
+			if (!o->owner_before (p) && !p.owner_before (*o)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool follows (ProcessorList::const_iterator, ProcessorList::const_iterator) const;
+	uint32_t n_processors () const { return _originals.size (); }
+
+	bool read (DiskReader const&, BufferSet&, samplepos_t, pframes_t);
+	void fill ();
+
+	void mark_stale () { g_atomic_int_set (&_stale, 1); }
+
+private:
+	typedef std::vector<boost::weak_ptr<Processor> > Originals;
+	typedef std::vector<std::pair<boost::shared_ptr<AutomationControl>, boost::shared_ptr<AutomationControl> > > ControlPairs;
+	typedef std::vector<boost::shared_ptr<PBD::RingBuffer<Sample> > > FIFOs;
+
+	Originals         _originals;
+	InsertList        _copies;
+	ControlPairs      _controls;
+	FIFOs             _inputs;
+	FIFOs             _fifos;
+	const samplecnt_t _lead;
+	const samplecnt_t _preroll;
+
+	/* worker */
+	Glib::Threads::Mutex _fill_lock;
+	BufferSet            _bufs;
+	samplepos_t          _fill_pos;
+	gint                 _reset_done;
+
+	/* shared */
+	gint        _reset_req;   ///< written by the process thread, atomic
+	gint        _reset_ack;   ///< written by the worker, atomic
+	samplepos_t _reset_pos;   ///< valid while a reset is requested
+	samplepos_t _start_pos;   ///< valid once a reset is acknowledged
+	gint        _stale;       ///< set on playlist edits, atomic
+
+	/* process thread */
+	samplepos_t _read_pos;
+	samplepos_t _feed_pos;
+	bool        _started;
+	bool        _synced;
+
+	void request_reset (samplepos_t);
+	bool feed (DiskReader const&, samplepos_t);
+
+	static guint read_space (FIFOs const&);
+};
+
+PlaybackLookahead::Chain::Chain (InsertList const& originals, InsertList const& copies, uint32_t n_inputs, pframes_t b, samplecnt_t s, samplecnt_t preroll)
+	: block (b)
+	, size (s)
+	, _copies (copies)
+	, _lead (s / 4)
+	, _preroll (preroll)
+	, _fill_pos (0)
+	, _reset_done (0)
+	, _reset_req (0)
+	, _reset_ack (0)
+	, _reset_pos (0)
+	, _start_pos (0)
+	, _stale (0)
+	, _read_pos (0)
+	, _feed_pos (0)
+	, _started (false)
+	, _synced (false)
+{
+	ChanCount max_streams (DataType::AUDIO, n_inputs);
+
+	for (InsertList::size_type n = 0; n < originals.size (); ++n) {
+		_originals.push_back (originals[n]);
+
+		max_streams = ChanCount::max (max_streams, copies[n]->required_buffers ());
+		max_streams = ChanCount::max (max_streams, copies[n]->output_streams ());
+
+		/* controls that are not automated follow the originals */
+		for (Automatable::Controls::const_iterator c = originals[n]->controls ().begin (); c != originals[n]->controls ().end (); ++c) {
+			boost::shared_ptr<AutomationControl> ac = boost::dynamic_pointer_cast<AutomationControl> (c->second);
+			boost::shared_ptr<AutomationControl> cc = copies[n]->automation_control (c->first);
+			if (ac && cc) {
+				_controls.push_back (std::make_pair (ac, cc));
+			}
+		}
+	}
+
+	_bufs.ensure_buffers (max_streams, block);
+
+	for (uint32_t n = 0; n < n_inputs; ++n) {
+		_inputs.push_back (boost::shared_ptr<PBD::RingBuffer<Sample> > (new PBD::RingBuffer<Sample> (size)));
+	}
+
+	for (uint32_t n = 0; n < originals.back ()->output_streams ().n_audio (); ++n) {
+		_fifos.push_back (boost::shared_ptr<PBD::RingBuffer<Sample> > (new PBD::RingBuffer<Sample> (size)));
+	}
+}
+
+guint
+PlaybackLookahead::Chain::read_space (FIFOs const& fifos)
+{
+	guint rv = fifos.front ()->read_space ();
+	for (FIFOs::const_iterator f = fifos.begin (); f != fifos.end (); ++f) {
+		rv = std::min (rv, (*f)->read_space ());
+	}
+	return rv;
+}
+
+bool
+PlaybackLookahead::Chain::follows (ProcessorList::const_iterator i, ProcessorList::const_iterator end) const
+{
+	for (Originals::const_iterator o = _originals.begin (); o != _originals.end (); ++o) {
+		if (++i == end || !(*i)->active () || o->owner_before (*i) || i->owner_before (*o)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void
+PlaybackLookahead::Chain::request_reset (samplepos_t pos)
+{
+	_reset_pos = pos;
+	_started   = true;
+	_synced    = false;
+	g_atomic_int_set (&_reset_req, _reset_req + 1);
+	PlaybackLookahead::wakeup ();
+}
+
+bool
+PlaybackLookahead::Chain::feed (DiskReader const& dr, samplepos_t next)
+{
+	if (_feed_pos < next) {
+		/* the disk-reader delivered data that the workers did not get */
+		return false;
+	}
+
+	const samplecnt_t offset = _feed_pos - next;
+	samplecnt_t       cnt    = std::min<samplecnt_t> (_inputs.front ()->write_space (), max_feed_blocks * block);
+
+	for (uint32_t n = 0; n < _inputs.size () && cnt > 0; ++n) {
+		PBD::RingBuffer<Sample>::rw_vector vec;
+		_inputs[n]->get_write_vector (&vec);
+
+		samplecnt_t got = dr.read_ahead (n, vec.buf[0], offset, std::min<samplecnt_t> (cnt, vec.len[0]));
+		if (got == (samplecnt_t) vec.len[0] && got < cnt) {
+			got += dr.read_ahead (n, vec.buf[1], offset + got, std::min<samplecnt_t> (cnt - got, vec.len[1]));
+		}
+		/* the butler refills one channel after the other */
+		cnt = std::min (cnt, got);
+	}
+
+	for (FIFOs::const_iterator f = _inputs.begin (); f != _inputs.end (); ++f) {
+		(*f)->increment_write_idx (cnt);
+	}
+	_feed_pos += cnt;
+
+	if (read_space (_inputs) >= block) {
+		PlaybackLookahead::wakeup ();
+	}
+
+	return true;
+}
+
+bool
+PlaybackLookahead::Chain::read (DiskReader const& dr, BufferSet& bufs, samplepos_t pos, pframes_t nframes)
+{
+	/* the disk-reader's buffers start here */
+	const samplepos_t next = pos + nframes;
+
+	if (g_atomic_int_get (&_reset_ack) != _reset_req) {
+		/* the worker has yet to start over */
+		return false;
+	}
+
+	if (dr.pending_overwrite ()) {
+		/* the data that was passed on is about to be replaced */
+		mark_stale ();
+		return false;
+	}
+
+	if (!_started || g_atomic_int_compare_and_exchange (&_stale, 1, 0)) {
+		request_reset (next);
+		return false;
+	}
+
+	if (!_synced) {
+		_read_pos = _start_pos;
+		_feed_pos = _start_pos - _preroll;
+		_synced   = true;
+	}
+
+	if (!feed (dr, next)) {
+		request_reset (next);
+		return false;
+	}
+
+	guint avail = read_space (_fifos);
+
+	if (pos > _read_pos && avail > 0) {
+		/* drop data that is no longer needed */
+		const guint skip = std::min<samplecnt_t> (avail, pos - _read_pos);
+		for (FIFOs::const_iterator f = _fifos.begin (); f != _fifos.end (); ++f) {
+			(*f)->increment_read_idx (skip);
+		}
+		_read_pos += skip;
+		avail     -= skip;
+	}
+
+	if (pos != _read_pos || avail < nframes) {
+		if (pos < _read_pos - _lead || pos > _read_pos + _lead) {
+			/* locate, or the workers fell far behind */
+			request_reset (next);
+		} else {
+			PlaybackLookahead::wakeup ();
+		}
+		return false;
+	}
+
+	uint32_t n = 0;
+	for (FIFOs::const_iterator f = _fifos.begin (); f != _fifos.end (); ++f, ++n) {
+		(*f)->read (bufs.get_audio (n).data (), nframes);
+	}
+
+	_read_pos += nframes;
+
+	if (_fifos.front ()->write_space () >= block) {
+		PlaybackLookahead::wakeup ();
+	}
+
+	return true;
+}
+
+void
+PlaybackLookahead::Chain::fill ()
+{
+	Glib::Threads::Mutex::Lock lm (_fill_lock, Glib::Threads::TRY_LOCK);
+
+	if (!lm.locked ()) {
+		/* another worker is at it */
+		return;
+	}
+
+	const gint req = g_atomic_int_get (&_reset_req);
+
+	if (req != _reset_done) {
+		/* the process thread does not touch the queues until acknowledged */
+		for (FIFOs::const_iterator f = _inputs.begin (); f != _inputs.end (); ++f) {
+			(*f)->reset ();
+		}
+		for (FIFOs::const_iterator f = _fifos.begin (); f != _fifos.end (); ++f) {
+			(*f)->reset ();
+		}
+		for (InsertList::const_iterator i = _copies.begin (); i != _copies.end (); ++i) {
+			(*i)->flush ();
+		}
+		/* leave the workers some headroom before the process thread catches up */
+		_start_pos  = _reset_pos + _lead + _preroll;
+		_fill_pos   = _reset_pos + _lead;
+		_reset_done = req;
+		g_atomic_int_set (&_reset_ack, req);
+	}
+
+	if (_reset_done == 0) {
+		/* nothing was requested yet */
+		return;
+	}
+
+	const uint32_t n_in  = _inputs.size ();
+	const uint32_t n_out = _fifos.size ();
+
+	while (_fifos.front ()->write_space () >= block && read_space (_inputs) >= block) {
+
+		if (g_atomic_int_get (&_reset_req) != _reset_done) {
+			break;
+		}
+
+		for (ControlPairs::const_iterator c = _controls.begin (); c != _controls.end (); ++c) {
+			if (c->first->automation_playback ()) {
+				/* the copy plays its own copy of the automation */
+				continue;
+			}
+			const double val = c->first->get_value ();
+			if (val != c->second->get_value ()) {
+				c->second->set_value (val, Controllable::NoGroup);
+			}
+		}
+
+		/* same as the disk-reader's output */
+		_bufs.set_count (ChanCount (DataType::AUDIO, n_in));
+
+		for (uint32_t n = 0; n < n_in; ++n) {
+			_inputs[n]->read (_bufs.get_audio (n).data (), block);
+		}
+
+		/* same as Route::process_output_buffers */
+		samplecnt_t latency = 0;
+		for (InsertList::const_iterator i = _copies.begin (); i != _copies.end (); ++i) {
+			latency += (*i)->effective_latency ();
+			(*i)->run (_bufs, _fill_pos - latency, _fill_pos - latency + block, 1.0, block, true);
+			_bufs.set_count ((*i)->output_streams ());
+		}
+
+		if (_fill_pos + block > _start_pos) {
+			/* discard the pre-roll */
+			const samplecnt_t offset = std::max<samplecnt_t> (0, _start_pos - _fill_pos);
+			for (uint32_t n = 0; n < n_out; ++n) {
+				_fifos[n]->write (_bufs.get_audio (n).data () + offset, block - offset);
+			}
+		}
+
+		_fill_pos += block;
+	}
+}
+
+PlaybackLookahead::PlaybackLookahead (Session& s, AudioTrack& t)
+	: _session (s)
+	, _track (t)
+	, _generation (0)
+	, _seen_generation (-1)
+	, _skipped (0)
+	, _chain (new boost::shared_ptr<Chain>)
+{
+	Glib::Threads::RWLock::WriterLock lm (_instance_lock);
+	_instances.push_back (this);
+}
+
+PlaybackLookahead::~PlaybackLookahead ()
+{
+	{
+		/* wait for workers to finish with the chain */
+		Glib::Threads::RWLock::WriterLock lm (_instance_lock);
+		_instances.remove (this);
+	}
+	drop_connections ();
+}
+
+bool
+PlaybackLookahead::processes (ChainRef const& c, boost::shared_ptr<Processor> const& p)
+{
+	return *c && (*c)->processes (p);
+}
+
+bool
+PlaybackLookahead::follows (ChainRef const& c, ProcessorList::const_iterator disk_reader, ProcessorList::const_iterator end)
+{
+	return *c && (*c)->follows (disk_reader, end);
+}
+
+bool
+PlaybackLookahead::read (ChainRef const& c, DiskReader const& dr, BufferSet& bufs, samplepos_t pos, pframes_t nframes)
+{
+	if (!*c || !(*c)->read (dr, bufs, pos, nframes)) {
+		return false;
+	}
+	_skipped = (*c)->n_processors ();
+	return true;
+}
+
+uint32_t
+PlaybackLookahead::stop ()
+{
+	/* the chain may have been replaced since, the count is kept here */
+	const uint32_t rv = _skipped;
+	_skipped = 0;
+	return rv;
+}
+
+void
+PlaybackLookahead::invalidate ()
+{
+	/* may be called from any thread */
+	g_atomic_int_inc (&_generation);
+
+	if (!AudioEngine::instance ()->in_process_thread ()) {
+		/* do not wait for update(), the next cycle must not use
+		 * copies of the previous configuration.
+		 */
+		set_chain (boost::shared_ptr<Chain> ());
+	}
+}
+
+void
+PlaybackLookahead::contents_changed ()
+{
+	/* the queued data was processed from the previous contents */
+	ChainRef c = chain ();
+	if (*c) {
+		(*c)->mark_stale ();
+	}
+}
+
+void
+PlaybackLookahead::update ()
+{
+	if (!Config->get_anticipative_processing ()) {
+		drop ();
+		return;
+	}
+
+	ChainRef c = chain ();
+
+	if (*c && ((*c)->block != _session.get_block_size () || (*c)->size != Config->get_anticipative_lookahead ())) {
+		invalidate ();
+	}
+
+	const gint generation = g_atomic_int_get (&_generation);
+
+	if (generation == _seen_generation) {
+		return;
+	}
+
+	_seen_generation = generation;
+
+	InsertList il;
+	if (_track.freeze_state () != Track::Frozen) {
+		_track.disk_plugin_chain (il);
+	}
+
+	reconnect (il);
+
+	boost::shared_ptr<DiskReader> dr = _track._disk_reader;
+
+	if (il.empty () || !dr || dr->output_streams ().n_audio () == 0) {
+		set_chain (boost::shared_ptr<Chain> ());
+		return;
+	}
+
+	InsertList  copies;
+	samplecnt_t latency = 0;
+	samplecnt_t tail    = 0;
+
+	for (InsertList::const_iterator i = il.begin (); i != il.end (); ++i) {
+		boost::shared_ptr<PluginInsert> copy = (*i)->create_copy (_session.get_block_size ());
+		if (!copy) {
+			set_chain (boost::shared_ptr<Chain> ());
+			return;
+		}
+		copies.push_back (copy);
+		latency += (*i)->effective_latency ();
+		tail     = std::max (tail, (*i)->plugin ()->signal_tail ());
+	}
+
+	tail = std::min (tail, max_preroll_tail * _session.sample_rate ());
+
+	/* the pre-roll has to fit into the disk-reader's buffers, along with the lookahead */
+	const samplecnt_t preroll = std::min<samplecnt_t> (latency + tail, _session.butler ()->audio_playback_buffer_size () / 4);
+
+	DEBUG_TRACE (DEBUG::Processors, string_compose ("%1: processing %2 plugin(s) ahead\n", _track.name (), il.size ()));
+
+	set_chain (boost::shared_ptr<Chain> (new Chain (il, copies, dr->output_streams ().n_audio (), _session.get_block_size (), Config->get_anticipative_lookahead (), preroll)));
+
+	Glib::Threads::RWLock::WriterLock lm (_instance_lock);
+
+	if (_n_workers == 0) {
+		_n_workers = max_workers ();
+		for (uint32_t n = 0; n < _n_workers; ++n) {
+			Glib::Threads::Thread::create (sigc::ptr_fun (&PlaybackLookahead::worker));
+		}
+	}
+}
+
+void
+PlaybackLookahead::drop ()
+{
+	if (*chain ()) {
+		set_chain (boost::shared_ptr<Chain> ());
+	}
+
+	drop_connections ();
+	_seen_generation = -1;
+}
+
+void
+PlaybackLookahead::set_chain (boost::shared_ptr<Chain> c)
+{
+	/* the previous chain is destroyed in this thread, once the process
+	 * thread and the workers are done with it.
+	 */
+	boost::shared_ptr<boost::shared_ptr<Chain> > cp = _chain.write_copy ();
+	*cp = c;
+	_chain.update (cp);
+}
+
+void
+PlaybackLookahead::reconnect (InsertList const& il)
+{
+	drop_connections ();
+
+	_track.processors_changed.connect_same_thread (*this, boost::bind (&PlaybackLookahead::invalidate, this));
+	_track.PlaylistChanged.connect_same_thread (*this, boost::bind (&PlaybackLookahead::invalidate, this));
+
+	boost::shared_ptr<Playlist> pl = _track.playlist ();
+	if (pl) {
+		pl->ContentsChanged.connect_same_thread (*this, boost::bind (&PlaybackLookahead::contents_changed, this));
+	}
+
+	{
+		/* activating any processor may extend (or shorten) the chain */
+		Glib::Threads::RWLock::ReaderLock lm (_track._processor_lock);
+		for (ProcessorList::const_iterator i = _track._processors.begin (); i != _track._processors.end (); ++i) {
+			(*i)->ActiveChanged.connect_same_thread (*this, boost::bind (&PlaybackLookahead::invalidate, this));
+		}
+	}
+
+	/* control values are passed on by the workers, anything else
+	 * requires new copies.
+	 */
+	for (InsertList::const_iterator i = il.begin (); i != il.end (); ++i) {
+		boost::shared_ptr<PluginInsert> pi (*i);
+
+		pi->PluginConfigChanged.connect_same_thread (*this, boost::bind (&PlaybackLookahead::invalidate, this));
+		pi->PluginMapChanged.connect_same_thread (*this, boost::bind (&PlaybackLookahead::invalidate, this));
+		pi->plugin ()->PresetLoaded.connect_same_thread (*this, boost::bind (&PlaybackLookahead::invalidate, this));
+
+		for (Automatable::Controls::const_iterator c = pi->controls ().begin (); c != pi->controls ().end (); ++c) {
+			boost::shared_ptr<AutomationControl> ac = boost::dynamic_pointer_cast<AutomationControl> (c->second);
+			boost::shared_ptr<AutomationList> al = ac ? ac->alist () : boost::shared_ptr<AutomationList> ();
+			if (al) {
+				al->Dirty.connect_same_thread (*this, boost::bind (&PlaybackLookahead::invalidate, this));
+				al->automation_state_changed.connect_same_thread (*this, boost::bind (&PlaybackLookahead::invalidate, this));
+			}
+		}
+	}
+}
+
+void
+PlaybackLookahead::wakeup ()
+{
+	if (g_atomic_int_compare_and_exchange (&_wakeup_pending, 0, 1)) {
+		_wakeup.signal ();
+	}
+}
+
+uint32_t
+PlaybackLookahead::max_workers ()
+{
+	/* one per track would be plenty, but leave cores to the process threads */
+	return std::max (1U, std::min (hardware_concurrency () / 2, 4U));
+}
+
+void
+PlaybackLookahead::worker ()
+{
+	SessionEvent::create_per_thread_pool (X_("Lookahead"), 64);
+	pthread_set_name ("Lookahead");
+
+	ProcessThread* pt = new ProcessThread ();
+
+	while (true) {
+		_wakeup.wait ();
+
+		/* further requests wake another worker, which then
+		 * takes care of the chains that this one does not hold.
+		 */
+		g_atomic_int_set (&_wakeup_pending, 0);
+
+		pt->get_buffers ();
+
+		{
+			Glib::Threads::RWLock::ReaderLock lm (_instance_lock);
+			for (std::list<PlaybackLookahead*>::const_iterator i = _instances.begin (); i != _instances.end (); ++i) {
+				ChainRef c ((*i)->chain ());
+				if (*c) {
+					(*c)->fill ();
+				}
+			}
+		}
+
+		pt->drop_buffers ();
+	}
+}
@@ -26,6 +26,7 @@
  */
 
 #include <algorithm>
+#include <limits>
 #include <set>
 #include <stdint.h>
 #include <string>
@@ -357,6 +358,8 @@ Playlist::init (bool hide)
 	_combine_ops                = 0;
 	_end_space                  = 0;
 	_playlist_shift_active      = false;
+	_region_index_valid         = false;
+	_region_index_in_order      = true;
 
 	_session.history ().BeginUndoRedo.connect_same_thread (*this, boost::bind (&Playlist::begin_undo, this));
 	_session.history ().EndUndoRedo.connect_same_thread (*this, boost::bind (&Playlist::end_undo, this));
@@ -475,6 +478,8 @@ Playlist::release_notifications (bool from_undo)
 void
 Playlist::notify_contents_changed ()
 {
+	render_state_changed ();
+
 	if (holding_state ()) {
 		pending_contents_change = true;
 	} else {
@@ -486,6 +491,8 @@ Playlist::notify_contents_changed ()
 void
 Playlist::notify_layering_changed ()
 {
+	render_state_changed ();
+
 	if (holding_state ()) {
 		pending_layering = true;
 	} else {
@@ -783,6 +790,7 @@ Playlist::add_region_internal (boost::shared_ptr<Region> region, samplepos_t pos
 
 	regions.insert (upper_bound (regions.begin (), regions.end (), region, cmp), region);
 	all_regions.insert (region);
+	region_index_add (region);
 
 	possibly_splice_unlocked (position, region->length (), region, thawlist);
 
@@ -843,6 +851,7 @@ Playlist::remove_region_internal (boost::shared_ptr<Region> region, ThawList& th
 			samplecnt_t distance = (*i)->length ();
 
 			regions.erase (i);
+			region_index_remove (region);
 
 			possibly_splice_unlocked (pos, -distance, boost::shared_ptr<Region> (), thawlist);
 
@@ -1721,6 +1730,13 @@ Playlist::region_changed_proxy (const PropertyChange& what_changed, boost::weak_
 		return;
 	}
 
+	if (what_changed.contains (Properties::position) || what_changed.contains (Properties::length)) {
+		/* also during set-state, splice etc. which skip region_bounds_changed () */
+		region_index_bounds_changed (region, what_changed.contains (Properties::position));
+	} else {
+		render_state_changed ();
+	}
+
 	/* this makes a virtual call to the right kind of playlist ... */
 
 	region_changed (what_changed, region);
@@ -1789,6 +1805,7 @@ Playlist::drop_regions ()
 	RegionWriteLock rl (this);
 	regions.clear ();
 	all_regions.clear ();
+	invalidate_region_index ();
 }
 
 void
@@ -1817,6 +1834,7 @@ Playlist::clear (bool with_signals)
 		}
 
 		regions.clear ();
+		invalidate_region_index ();
 
 		for (set<boost::shared_ptr<Region> >::iterator s = pending_removes.begin (); s != pending_removes.end (); ++s) {
 			remove_dependents (*s);
@@ -1928,9 +1946,12 @@ Playlist::find_regions_at (samplepos_t sample)
 {
 	/* Caller must hold lock */
 
-	boost::shared_ptr<RegionList> rlist (new RegionList);
+	boost::shared_ptr<RegionList>           rlist (new RegionList);
+	std::vector<boost::shared_ptr<Region> > candidates;
 
-	for (RegionList::iterator i = regions.begin (); i != regions.end (); ++i) {
+	regions_in_index (sample, sample, candidates);
+
+	for (std::vector<boost::shared_ptr<Region> >::const_iterator i = candidates.begin (); i != candidates.end (); ++i) {
 		if ((*i)->covers (sample)) {
 			rlist->push_back (*i);
 		}
@@ -1942,10 +1963,14 @@ Playlist::find_regions_at (samplepos_t sample)
 boost::shared_ptr<RegionList>
 Playlist::regions_with_start_within (Evoral::Range<samplepos_t> range)
 {
-	RegionReadLock                rlock (this);
-	boost::shared_ptr<RegionList> rlist (new RegionList);
+	RegionReadLock                          rlock (this);
+	boost::shared_ptr<RegionList>           rlist (new RegionList);
+	std::vector<boost::shared_ptr<Region> > candidates;
 
-	for (RegionList::iterator i = regions.begin (); i != regions.end (); ++i) {
+	/* regions ending before range.from cannot start inside it */
+	regions_in_index (range.to, range.from, candidates);
+
+	for (std::vector<boost::shared_ptr<Region> >::const_iterator i = candidates.begin (); i != candidates.end (); ++i) {
 		if ((*i)->first_sample () >= range.from && (*i)->first_sample () <= range.to) {
 			rlist->push_back (*i);
 		}
@@ -1957,10 +1982,14 @@ Playlist::regions_with_start_within (Evoral::Range<samplepos_t> range)
 boost::shared_ptr<RegionList>
 Playlist::regions_with_end_within (Evoral::Range<samplepos_t> range)
 {
-	RegionReadLock                rlock (this);
-	boost::shared_ptr<RegionList> rlist (new RegionList);
+	RegionReadLock                          rlock (this);
+	boost::shared_ptr<RegionList>           rlist (new RegionList);
+	std::vector<boost::shared_ptr<Region> > candidates;
 
-	for (RegionList::iterator i = regions.begin (); i != regions.end (); ++i) {
+	/* regions starting after range.to cannot end inside it */
+	regions_in_index (range.to, range.from, candidates);
+
+	for (std::vector<boost::shared_ptr<Region> >::const_iterator i = candidates.begin (); i != candidates.end (); ++i) {
 		if ((*i)->last_sample () >= range.from && (*i)->last_sample () <= range.to) {
 			rlist->push_back (*i);
 		}
@@ -1979,9 +2008,12 @@ Playlist::regions_touched (samplepos_t start, samplepos_t end)
 boost::shared_ptr<RegionList>
 Playlist::regions_touched_locked (samplepos_t start, samplepos_t end)
 {
-	boost::shared_ptr<RegionList> rlist (new RegionList);
+	boost::shared_ptr<RegionList>           rlist (new RegionList);
+	std::vector<boost::shared_ptr<Region> > candidates;
 
-	for (RegionList::iterator i = regions.begin (); i != regions.end (); ++i) {
+	regions_in_index (end, start, candidates);
+
+	for (std::vector<boost::shared_ptr<Region> >::const_iterator i = candidates.begin (); i != candidates.end (); ++i) {
 		if ((*i)->coverage (start, end) != Evoral::OverlapNone) {
 			rlist->push_back (*i);
 		}
@@ -1990,6 +2022,299 @@ Playlist::regions_touched_locked (samplepos_t start, samplepos_t end)
 	return rlist;
 }
 
+/** Drop the region lookup index, it will be rebuilt by the next lookup.
+ *  Used for bulk changes of the region list, single regions are updated
+ *  in place by region_index_add (), region_index_remove () and
+ *  region_index_bounds_changed ().
+ */
+void
+Playlist::invalidate_region_index ()
+{
+	RegionIndex old;
+
+	{
+		Glib::Threads::Mutex::Lock lm (_region_index_lock);
+		_region_index_valid = false;
+		_region_index.swap (old);
+	}
+
+	/* the index holds references to regions; releasing the last one may
+	 * destroy a region, which must not happen with _region_index_lock held.
+	 */
+
+	render_state_changed ();
+}
+
+/* Caller must hold _region_index_lock */
+void
+Playlist::update_region_index () const
+{
+	if (_region_index_valid) {
+		return;
+	}
+
+	_region_index.clear ();
+	_region_index.reserve (regions.size ());
+	_region_index_in_order = true;
+
+	uint32_t order = 0;
+	for (RegionList::const_iterator i = regions.begin (); i != regions.end (); ++i, ++order) {
+		RegionIndexEntry e;
+		e.first    = (*i)->first_sample ();
+		e.last     = (*i)->last_sample ();
+		e.max_last = e.last;
+		e.order    = order;
+		e.region   = *i;
+		if (!_region_index.empty () && e.first < _region_index.back ().first) {
+			_region_index_in_order = false;
+		}
+		_region_index.push_back (e);
+	}
+
+	if (!_region_index_in_order) {
+		/* stable: regions at the same position remain in list order */
+		std::stable_sort (_region_index.begin (), _region_index.end ());
+	}
+
+	region_index_build (_region_index, 0, _region_index.size ());
+	_region_index_valid = true;
+}
+
+samplepos_t
+Playlist::region_index_build (RegionIndex& index, size_t lo, size_t hi)
+{
+	if (lo >= hi) {
+		return std::numeric_limits<samplepos_t>::min ();
+	}
+
+	size_t const mid = lo + (hi - lo) / 2;
+
+	samplepos_t m = index[mid].last;
+	m = std::max (m, region_index_build (index, lo, mid));
+	m = std::max (m, region_index_build (index, mid + 1, hi));
+
+	index[mid].max_last = m;
+	return m;
+}
+
+/* Re-compute max_last of all nodes whose subtree includes an entry
+ * in [a, b], after those entries were modified. Other subtrees are
+ * unchanged, this is O(b - a + log n).
+ */
+samplepos_t
+Playlist::region_index_fix (RegionIndex& index, size_t lo, size_t hi, size_t a, size_t b)
+{
+	if (lo >= hi) {
+		return std::numeric_limits<samplepos_t>::min ();
+	}
+
+	size_t const mid = lo + (hi - lo) / 2;
+
+	if (b < lo || a >= hi) {
+		return index[mid].max_last;
+	}
+
+	samplepos_t m = index[mid].last;
+	m = std::max (m, region_index_fix (index, lo, mid, a, b));
+	m = std::max (m, region_index_fix (index, mid + 1, hi, a, b));
+
+	index[mid].max_last = m;
+	return m;
+}
+
+/* Caller must hold _region_index_lock, the index must be valid */
+Playlist::RegionIndex::iterator
+Playlist::region_index_find (boost::shared_ptr<Region> const& region) const
+{
+	/* the entry is usually found at its previous or current position */
+	samplepos_t const hints[] = { region->last_position (), region->first_sample () };
+
+	for (size_t h = 0; h < sizeof (hints) / sizeof (hints[0]); ++h) {
+		RegionIndexEntry probe;
+		probe.first = hints[h];
+		std::pair<RegionIndex::iterator, RegionIndex::iterator> r = std::equal_range (_region_index.begin (), _region_index.end (), probe);
+		for (RegionIndex::iterator i = r.first; i != r.second; ++i) {
+			if (i->region == region) {
+				return i;
+			}
+		}
+	}
+
+	for (RegionIndex::iterator i = _region_index.begin (); i != _region_index.end (); ++i) {
+		if (i->region == region) {
+			return i;
+		}
+	}
+
+	return _region_index.end ();
+}
+
+/** Add a region to the index, it must already be in the region list */
+void
+Playlist::region_index_add (boost::shared_ptr<Region> region)
+{
+	{
+		Glib::Threads::Mutex::Lock lm (_region_index_lock);
+
+		if (_region_index_valid && _region_index_in_order) {
+			/* same position as in the region list, see add_region_internal () */
+			RegionIndexEntry e;
+			e.first    = region->first_sample ();
+			e.last     = region->last_sample ();
+			e.max_last = e.last;
+			e.order    = 0;
+			e.region   = region;
+
+			_region_index.insert (std::upper_bound (_region_index.begin (), _region_index.end (), e), e);
+			region_index_build (_region_index, 0, _region_index.size ());
+		} else {
+			_region_index_valid = false;
+		}
+	}
+
+	render_state_changed ();
+}
+
+void
+Playlist::region_index_remove (boost::shared_ptr<Region> region)
+{
+	/* see invalidate_region_index () */
+	boost::shared_ptr<Region> keep;
+	RegionIndex               old;
+
+	{
+		Glib::Threads::Mutex::Lock lm (_region_index_lock);
+
+		RegionIndex::iterator i = _region_index_valid ? region_index_find (region) : _region_index.end ();
+
+		if (i != _region_index.end ()) {
+			keep.swap (i->region);
+			_region_index.erase (i);
+			region_index_build (_region_index, 0, _region_index.size ());
+		} else {
+			_region_index_valid = false;
+			_region_index.swap (old);
+		}
+	}
+
+	render_state_changed ();
+}
+
+/** Update the index after a region was moved or trimmed.
+ *
+ * A moved region is re-inserted after all regions at the same position,
+ * as region_bounds_changed () does for the region list.
+ */
+void
+Playlist::region_index_bounds_changed (boost::shared_ptr<Region> region, bool moved)
+{
+	if (moved && (in_set_state || _splicing || _rippling || _nudging || _shuffling)) {
+		/* the region list is not re-sorted, see region_bounds_changed () */
+		invalidate_region_index ();
+		return;
+	}
+
+	{
+		Glib::Threads::Mutex::Lock lm (_region_index_lock);
+
+		RegionIndex::iterator e = (_region_index_valid && _region_index_in_order) ? region_index_find (region) : _region_index.end ();
+
+		if (e == _region_index.end ()) {
+			_region_index_valid = false;
+		} else {
+			size_t const i = e - _region_index.begin ();
+			size_t       j = i;
+
+			if (moved) {
+				RegionIndexEntry probe;
+				probe.first = region->first_sample ();
+
+				/* position in the index without entry i */
+				j = std::upper_bound (_region_index.begin (), _region_index.end (), probe) - _region_index.begin ();
+				if (j > i) {
+					--j;
+				}
+				if (j > i) {
+					std::rotate (_region_index.begin () + i, _region_index.begin () + i + 1, _region_index.begin () + j + 1);
+				} else if (j < i) {
+					std::rotate (_region_index.begin () + j, _region_index.begin () + i, _region_index.begin () + i + 1);
+				}
+			}
+
+			_region_index[j].first = region->first_sample ();
+			_region_index[j].last  = region->last_sample ();
+
+			region_index_fix (_region_index, 0, _region_index.size (), std::min (i, j), std::max (i, j));
+		}
+	}
+
+	render_state_changed ();
+}
+
+/* Collect all entries with first <= first_max and last >= last_min,
+ * in order of their first sample.
+ */
+void
+Playlist::region_index_collect (size_t lo, size_t hi, samplepos_t first_max, samplepos_t last_min, std::vector<RegionIndexEntry const*>& result) const
+{
+	while (lo < hi) {
+		size_t const            mid = lo + (hi - lo) / 2;
+		RegionIndexEntry const& e   = _region_index[mid];
+
+		if (e.max_last < last_min) {
+			/* nothing in this subtree reaches last_min */
+			return;
+		}
+
+		region_index_collect (lo, mid, first_max, last_min, result);
+
+		if (e.first > first_max) {
+			/* neither does anything to the right start early enough */
+			return;
+		}
+
+		if (e.last >= last_min) {
+			result.push_back (&e);
+		}
+
+		/* continue with the right subtree */
+		lo = mid + 1;
+	}
+}
+
+struct RegionIndexEntryOrderSorter {
+	template <typename T>
+	bool operator() (T const* a, T const* b) const
+	{
+		return a->order < b->order;
+	}
+};
+
+/** Find all regions which may start at or before @param first_max and end at or
+ *  after @param last_min, in playlist order. Region bounds are those at the time
+ *  the index was built; callers must check the actual bounds of the result.
+ *  Caller must hold the region lock.
+ */
+void
+Playlist::regions_in_index (samplepos_t first_max, samplepos_t last_min, std::vector<boost::shared_ptr<Region> >& result) const
+{
+	Glib::Threads::Mutex::Lock lm (_region_index_lock);
+
+	update_region_index ();
+
+	std::vector<RegionIndexEntry const*> entries;
+	region_index_collect (0, _region_index.size (), first_max, last_min, entries);
+
+	if (!_region_index_in_order) {
+		std::sort (entries.begin (), entries.end (), RegionIndexEntryOrderSorter ());
+	}
+
+	result.reserve (entries.size ());
+	for (std::vector<RegionIndexEntry const*>::const_iterator i = entries.begin (); i != entries.end (); ++i) {
+		result.push_back ((*i)->region);
+	}
+}
+
 samplepos_t
 Playlist::find_next_transient (samplepos_t from, int dir)
 {
@@ -2896,6 +3221,7 @@ Playlist::shuffle (boost::shared_ptr<Region> region, int dir)
 						regions.erase (i); /* removes the region from the list */
 						next++;
 						regions.insert (next, region); /* adds it back after next */
+						invalidate_region_index ();
 
 						moved = true;
 					}
@@ -2936,6 +3262,7 @@ Playlist::shuffle (boost::shared_ptr<Region> region, int dir)
 
 						regions.erase (i);             /* remove region */
 						regions.insert (prev, region); /* insert region before prev */
+						invalidate_region_index ();
 
 						moved = true;
 					}
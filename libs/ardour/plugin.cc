@@ -59,6 +59,7 @@
 #include "ardour/plugin.h"
 #include "ardour/plugin_manager.h"
 #include "ardour/port.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/session.h"
 #include "ardour/types.h"
 
@@ -348,6 +349,16 @@ Plugin::possible_output () const
 	return oc;
 }
 
+samplecnt_t
+Plugin::signal_tail () const
+{
+	samplecnt_t tail = plugin_tail ();
+	if (tail < 0) {
+		tail = rint (Config->get_default_plugin_tail () * _session.sample_rate ());
+	}
+	return tail;
+}
+
 const Plugin::PresetRecord *
 Plugin::preset_by_label (const string& label)
 {
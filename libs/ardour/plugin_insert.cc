@@ -80,6 +80,8 @@ PluginInsert::PluginInsert (Session& s, boost::shared_ptr<Plugin> plug)
 	, _sc_playback_latency (0)
 	, _sc_capture_latency (0)
 	, _plugin_signal_latency (0)
+	, _signal_tail (0)
+	, _silent_input_samples (0)
 	, _signal_analysis_collect_nsamples (0)
 	, _signal_analysis_collect_nsamples_max (0)
 	, _configured (false)
@@ -679,6 +681,10 @@ PluginInsert::activate ()
 		(*i)->activate ();
 	}
 
+	/* querying the tail may not be realtime safe, cache it */
+	_signal_tail = _plugins.empty () ? 0 : _plugins.front ()->signal_tail ();
+	_silent_input_samples = 0;
+
 	Processor::activate ();
 	/* when setting state e.g ProcessorBox::paste_processor_state ()
 	 * the plugin is not yet owned by a route.
@@ -718,6 +724,28 @@ PluginInsert::flush ()
 	g_atomic_int_set (&_flush, 1);
 }
 
+boost::shared_ptr<PluginInsert>
+PluginInsert::create_copy (pframes_t block_size)
+{
+	/* the copy must not share IDs (and controllables) with the original */
+	Stateful::ForceIDRegeneration force_ids;
+
+	boost::shared_ptr<PluginInsert> copy (new PluginInsert (_session));
+
+	XMLNode& state (get_state ());
+	int rv = copy->set_state (state, Stateful::current_state_version);
+	delete &state;
+
+	if (rv || !copy->configure_io (input_streams (), output_streams ())) {
+		return boost::shared_ptr<PluginInsert> ();
+	}
+
+	copy->set_block_size (block_size);
+	copy->activate ();
+
+	return copy;
+}
+
 void
 PluginInsert::enable (bool yn)
 {
@@ -1228,6 +1256,83 @@ PluginInsert::bypass (BufferSet& bufs, pframes_t nframes)
 	}
 }
 
+/** @return true if all audio inputs of the plugin(s) are silent for this cycle.
+ * Plugins with MIDI inputs (instruments, MIDI processors) may produce sound
+ * without audio input (e.g. a held note) and are never considered silent.
+ */
+bool
+PluginInsert::input_is_silent (BufferSet const& bufs, pframes_t nframes) const
+{
+	const ChanCount ins (natural_input_streams ());
+
+	if (ins.n_midi () > 0 || ins.n_audio () == 0) {
+		return false;
+	}
+#ifdef MIXBUS
+	if (is_channelstrip ()) {
+		return false;
+	}
+#endif
+
+	for (uint32_t pc = 0; pc < get_count (); ++pc) {
+		ChanMapping const& in_map (_in_map.p (pc));
+		for (uint32_t in = 0; in < ins.n_audio (); ++in) {
+			bool valid;
+			uint32_t idx = in_map.get (DataType::AUDIO, in, &valid);
+			if (!valid) {
+				/* unconnected inputs are fed silence */
+				continue;
+			}
+			AudioBuffer const& ab (bufs.get_audio (idx));
+			pframes_t n;
+			if (!ab.silent () && !ab.check_silence (nframes, n)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/** Skip running the plugin(s) if the input is silent and the tail of any
+ * previous input has decayed, the plugin(s) would only produce silence.
+ * Not done when signals are routed around the plugin (thru map), those
+ * are not checked for silence and would be lost.
+ * @return true if the plugin was skipped and its outputs silenced.
+ */
+bool
+PluginInsert::skip_silent_input (BufferSet& bufs, samplepos_t start, pframes_t nframes)
+{
+	if (!Config->get_skip_silent_plugins ()
+	    || _latency_changed
+	    || _thru_map.n_total () > 0
+	    || _signal_analysis_collect_nsamples_max > 0
+	    || !input_is_silent (bufs, nframes)) {
+		_silent_input_samples = 0;
+		return false;
+	}
+
+	/* the tail starts after the plugin's latency */
+	if (_silent_input_samples < _signal_tail || _silent_input_samples - _signal_tail < (samplecnt_t) _plugin_signal_latency) {
+		_silent_input_samples += nframes;
+		return false;
+	}
+
+	automation_run (start, nframes, true); // evaluate automation only
+
+	bufs.set_count (ChanCount::max (bufs.count (), _configured_out));
+
+	for (uint32_t out = 0; out < _configured_out.n_audio (); ++out) {
+		bufs.get_audio (out).silence (nframes);
+	}
+	for (uint32_t out = 0; out < _configured_out.n_midi (); ++out) {
+		if (out == 0 && has_midi_bypass ()) {
+			continue;
+		}
+		bufs.get_midi (out).silence (nframes);
+	}
+	return true;
+}
+
 void
 PluginInsert::silence (samplecnt_t nframes, samplepos_t start_sample)
 {
@@ -1274,6 +1379,10 @@ PluginInsert::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_sa
 		}
 	}
 
+	if (_pending_active && _active && skip_silent_input (bufs, start_sample, nframes)) {
+		return;
+	}
+
 	if (_pending_active) {
 #if defined MIXBUS && defined NDEBUG
 		if (!is_channelstrip ()) {
@@ -1305,6 +1414,7 @@ PluginInsert::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_sa
 		bypass (bufs, nframes);
 		automation_run (start_sample, nframes, true); // evaluate automation only
 		_delaybuffers.flush ();
+		_silent_input_samples = 0;
 	}
 
 	_active = _pending_active;
@@ -3332,8 +3442,10 @@ PluginInsert::latency_changed ()
 	// XXX This needs a proper API not an owner() hack:
 	// TODO Route should subscribe to LatencyChanged() and forward it
 	// to the session as processor_latency_changed.
-	assert (owner ());
-	static_cast<Route*>(owner ())->processor_latency_changed (); /* EMIT SIGNAL */
+	// Copies that are used for offline rendering (RenderCache) have no owner.
+	if (owner ()) {
+		static_cast<Route*>(owner ())->processor_latency_changed (); /* EMIT SIGNAL */
+	}
 }
 
 void
@@ -141,6 +141,8 @@ PortManager::PortManager ()
 	: ports (new Ports)
 	, _port_remove_in_progress (false)
 	, _port_deletions_pending (8192) /* ick, arbitrary sizing */
+	, _port_tasks (new PortTasks)
+	, _port_task_nframes (0)
 	, _midi_info_dirty (true)
 	, _audio_input_ports (new AudioInputPorts)
 	, _midi_input_ports (new MIDIInputPorts)
@@ -179,9 +181,12 @@ PortManager::remove_all_ports ()
 		ps->clear ();
 	}
 
+	update_port_tasks ();
+
 	/* clear dead wood list in RCU */
 
 	ports.flush ();
+	_port_tasks.flush ();
 
 	/* clear out pending port deletion list. we know this is safe because
 	 * the auto connect thread in Session is already dead when this is
@@ -522,6 +527,8 @@ PortManager::register_port (DataType dtype, const string& portname, bool input,
 		throw PortRegistrationFailure (string_compose ("unable to create port '%1': %2", portname, _("(unknown error)")));
 	}
 
+	update_port_tasks ();
+
 	DEBUG_TRACE (DEBUG::Ports, string_compose ("\t%2 port registration success, ports now = %1\n", ports.reader()->size(), this));
 	return newport;
 }
@@ -562,7 +569,10 @@ PortManager::unregister_port (boost::shared_ptr<Port> port)
 		/* writer goes out of scope, forces update */
 	}
 
+	update_port_tasks ();
+
 	ports.flush ();
+	_port_tasks.flush ();
 
 	return 0;
 }
@@ -1019,7 +1029,8 @@ PortManager::cycle_start (pframes_t nframes, Session* s)
 	Port::set_global_port_buffer_offset (0);
 	Port::set_cycle_samplecnt (nframes);
 
-	_cycle_ports = ports.reader ();
+	_cycle_ports      = ports.reader ();
+	_cycle_port_tasks = _port_tasks.reader ();
 
 	/* TODO optimize
 	 *  - when speed == 1.0, the resampler copies data without processing
@@ -1041,13 +1052,8 @@ PortManager::cycle_start (pframes_t nframes, Session* s)
 	 *    input-ports. Currently re-sampling is per input.
 	 */
 	if (s && s->rt_tasklist () && fabs (Port::speed_ratio ()) != 1.0) {
-		RTTaskList::TaskList tl;
-		for (Ports::iterator p = _cycle_ports->begin(); p != _cycle_ports->end(); ++p) {
-			if (!(p->second->flags() & TransportSyncPort)) {
-				tl.push_back (boost::bind (&Port::cycle_start, p->second, nframes));
-			}
-		}
-		s->rt_tasklist()->process (tl);
+		_port_task_nframes = nframes;
+		s->rt_tasklist()->process (_cycle_port_tasks->start_tasks);
 	} else {
 		for (Ports::iterator p = _cycle_ports->begin(); p != _cycle_ports->end(); ++p) {
 			if (!(p->second->flags() & TransportSyncPort)) {
@@ -1059,18 +1065,35 @@ PortManager::cycle_start (pframes_t nframes, Session* s)
 	run_input_meters (nframes, s ? s->nominal_sample_rate () : 0);
 }
 
+/** Rebuild the per-port task-list from the current set of ports.
+ * Called from non-realtime context when ports were added or removed,
+ * the process thread picks up the new list at the next cycle_start().
+ */
+void
+PortManager::update_port_tasks ()
+{
+	boost::shared_ptr<PortTasks> pt (new PortTasks (ports.reader ()));
+
+	pt->start_tasks.reserve (pt->ports->size ());
+	pt->end_tasks.reserve (pt->ports->size ());
+	for (Ports::iterator p = pt->ports->begin(); p != pt->ports->end(); ++p) {
+		if (!(p->second->flags() & TransportSyncPort)) {
+			pt->start_tasks.push_back (boost::bind (&Port::cycle_start, p->second.get (), boost::cref (_port_task_nframes)));
+			pt->end_tasks.push_back (boost::bind (&Port::cycle_end, p->second.get (), boost::cref (_port_task_nframes)));
+		}
+	}
+
+	_port_tasks.update (pt);
+}
+
 void
 PortManager::cycle_end (pframes_t nframes, Session* s)
 {
 	// see optimzation note in ::cycle_start()
-	if (0 && s && s->rt_tasklist () && fabs (Port::speed_ratio ()) != 1.0) {
-		RTTaskList::TaskList tl;
-		for (Ports::iterator p = _cycle_ports->begin(); p != _cycle_ports->end(); ++p) {
-			if (!(p->second->flags() & TransportSyncPort)) {
-				tl.push_back (boost::bind (&Port::cycle_end, p->second, nframes));
-			}
-		}
-		s->rt_tasklist()->process (tl);
+	if (s && s->rt_tasklist () && fabs (Port::speed_ratio ()) != 1.0) {
+		/* resample output ports in parallel */
+		_port_task_nframes = nframes;
+		s->rt_tasklist()->process (_cycle_port_tasks->end_tasks);
 	} else {
 		for (Ports::iterator p = _cycle_ports->begin(); p != _cycle_ports->end(); ++p) {
 			if (!(p->second->flags() & TransportSyncPort)) {
@@ -1086,6 +1109,7 @@ PortManager::cycle_end (pframes_t nframes, Session* s)
 	}
 
 	_cycle_ports.reset ();
+	_cycle_port_tasks.reset ();
 
 	/* we are done */
 }
@@ -1172,14 +1196,10 @@ void
 PortManager::cycle_end_fade_out (gain_t base_gain, gain_t gain_step, pframes_t nframes, Session* s)
 {
 	// see optimzation note in ::cycle_start()
-	if (0 && s && s->rt_tasklist () && fabs (Port::speed_ratio ()) != 1.0) {
-		RTTaskList::TaskList tl;
-		for (Ports::iterator p = _cycle_ports->begin(); p != _cycle_ports->end(); ++p) {
-			if (!(p->second->flags() & TransportSyncPort)) {
-				tl.push_back (boost::bind (&Port::cycle_end, p->second, nframes));
-			}
-		}
-		s->rt_tasklist()->process (tl);
+	if (s && s->rt_tasklist () && fabs (Port::speed_ratio ()) != 1.0) {
+		/* resample output ports in parallel */
+		_port_task_nframes = nframes;
+		s->rt_tasklist()->process (_cycle_port_tasks->end_tasks);
 	} else {
 		for (Ports::iterator p = _cycle_ports->begin(); p != _cycle_ports->end(); ++p) {
 			if (!(p->second->flags() & TransportSyncPort)) {
@@ -1206,6 +1226,7 @@ PortManager::cycle_end_fade_out (gain_t base_gain, gain_t gain_step, pframes_t n
 		}
 	}
 	_cycle_ports.reset ();
+	_cycle_port_tasks.reset ();
 	/* we are done */
 }
 
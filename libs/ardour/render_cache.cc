@@ -0,0 +1,852 @@
+/*
+ * Copyright (C) 2026 The Ardour Team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <ctime>
+
+#include <boost/scoped_array.hpp>
+
+#include "pbd/compose.h"
+#include "pbd/cpus.h"
+#include "pbd/error.h"
+#include "pbd/failed_constructor.h"
+#include "pbd/pthread_utils.h"
+
+#include "ardour/audio_buffer.h"
+#include "ardour/audioengine.h"
+#include "ardour/audioplaylist.h"
+#include "ardour/audioregion.h"
+#include "ardour/automation_control.h"
+#include "ardour/automation_list.h"
+#include "ardour/buffer_set.h"
+#include "ardour/debug.h"
+#include "ardour/disk_reader.h"
+#include "ardour/midi_buffer.h"
+#include "ardour/midi_playlist.h"
+#include "ardour/midi_state_tracker.h"
+#include "ardour/midi_track.h"
+#include "ardour/playlist_factory.h"
+#include "ardour/plugin.h"
+#include "ardour/plugin_insert.h"
+#include "ardour/process_thread.h"
+#include "ardour/rc_configuration.h"
+#include "ardour/region.h"
+#include "ardour/region_factory.h"
+#include "ardour/render_cache.h"
+#include "ardour/rt_midibuffer.h"
+#include "ardour/session.h"
+#include "ardour/session_event.h"
+#include "ardour/sndfilesource.h"
+#include "ardour/tempo.h"
+#include "ardour/utils.h"
+
+#include "pbd/i18n.h"
+
+using namespace ARDOUR;
+using namespace PBD;
+
+/* wait this long after the last change before rendering (usec) */
+static const gint64 settle_time = 2000000;
+/* update the caches at least this often (usec) */
+static const gint64 update_period = 100000;
+/* plugins with longer (or infinite) tails are cut off after this (sec) */
+static const samplecnt_t max_tail = 30;
+
+/** A render in progress. Set up by the manager thread, run by a worker */
+struct RenderCache::Job {
+	Job ()
+		: start (0)
+		, read_end (0)
+		, end (0)
+		, chunk (0)
+		, generation (0)
+		, cancelled (0)
+		, done (0)
+		, ok (false)
+	{}
+
+	InsertList                                       inserts;    ///< copies of the track's plugins
+	RenderedProcessors                               processors; ///< the track's plugins
+	boost::shared_ptr<AudioPlaylist>                 playlist;   ///< input of an audio track
+	RTMidiBuffer                                     events;     ///< input of a MIDI track
+	std::vector<boost::shared_ptr<AudioFileSource> > sources;
+
+	samplepos_t start;
+	samplepos_t read_end;
+	samplepos_t end;
+	samplecnt_t chunk;
+	gint        generation;
+	gint        cancelled; // atomic
+	gint        done;      // atomic
+	bool        ok;
+
+	void run ();
+};
+
+/** A completed render */
+struct RenderCache::Result {
+	boost::shared_ptr<AudioPlaylist> playlist;
+	uint32_t                         n_channels;
+	RenderedProcessors               processors;
+	gint                             generation;
+};
+
+RenderCache::RenderCache (Session& s, Track& t)
+	: _session (s)
+	, _track (t)
+	, _manager (s.render_cache_manager ())
+	, _generation (0)
+	, _seen_generation (-1)
+	, _failed_generation (-1)
+	, _stable_since (0)
+	, _rendered (new RenderedProcessors)
+{
+}
+
+RenderCache::~RenderCache ()
+{
+	/* the track is going away, do not touch its disk-reader */
+	drop_connections ();
+	cancel_job ();
+}
+
+void
+RenderCache::invalidate ()
+{
+	/* may be called from any thread */
+	g_atomic_int_inc (&_generation);
+
+	if (!AudioEngine::instance ()->in_process_thread () && SessionEvent::has_per_thread_pool ()) {
+		/* stop playing the render now, rather than on the next update */
+		Glib::Threads::Mutex::Lock lm (_lock);
+		if (_installed) {
+			uninstall ();
+		}
+	}
+
+	_manager->wake ();
+}
+
+void
+RenderCache::control_changed (boost::weak_ptr<AutomationControl> wac)
+{
+	boost::shared_ptr<AutomationControl> ac (wac.lock ());
+	if (ac && ac->automation_playback ()) {
+		/* automation is part of the render */
+		return;
+	}
+	invalidate ();
+}
+
+void
+RenderCache::region_changed (PropertyChange const& what_changed)
+{
+	PropertyChange inaudible;
+
+	inaudible.add (Properties::name);
+	inaudible.add (Properties::locked);
+	inaudible.add (Properties::video_locked);
+	inaudible.add (Properties::position_locked);
+	inaudible.add (Properties::sync_marked);
+	inaudible.add (Properties::sync_position);
+	inaudible.add (Properties::valid_transients);
+	inaudible.add (Properties::tags);
+
+	for (PropertyChange::const_iterator i = what_changed.begin (); i != what_changed.end (); ++i) {
+		if (inaudible.find (*i) == inaudible.end ()) {
+			invalidate ();
+			return;
+		}
+	}
+}
+
+bool
+RenderCache::installed () const
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+	return _installed.get () != 0;
+}
+
+void
+RenderCache::update ()
+{
+	if (!_track._disk_reader) {
+		return;
+	}
+
+	if (!Config->get_render_cache ()) {
+		drop ();
+		return;
+	}
+
+	const gint generation = g_atomic_int_get (&_generation);
+
+	if (generation != _seen_generation) {
+		InsertList il;
+		cached_inserts (il);
+		reconnect (il);
+		_seen_generation = generation;
+		_stable_since    = g_get_monotonic_time ();
+	}
+
+	if (_ready && _ready->generation != generation) {
+		_ready.reset ();
+	}
+
+	/* With cue monitoring the input is mixed with the disk signal before
+	 * the plugins, which then have to run. Play the track's playlist
+	 * until only disk is monitored again, and keep the render.
+	 */
+	const bool cue = _track.monitoring_state () == MonitoringCue;
+	bool       installed;
+
+	{
+		Glib::Threads::Mutex::Lock lm (_lock);
+
+		/* release a cache once the disk-reader no longer uses it */
+		if (_retired && _track._disk_reader->render_playlist () != _retired->playlist) {
+			_retired.reset ();
+		}
+
+		if (_installed && _installed->generation != generation) {
+			/* usually already done by invalidate () */
+			uninstall ();
+		} else if (_installed && cue) {
+			_ready = _installed;
+			uninstall ();
+		}
+
+		installed = _installed.get () != 0;
+	}
+
+	if (_job) {
+		if (!g_atomic_int_get (&_job->done)) {
+			if (_job->generation != generation) {
+				g_atomic_int_set (&_job->cancelled, 1);
+			}
+			return;
+		}
+		finish_job ();
+	}
+
+	if (_ready && !cue && !_session.transport_rolling ()) {
+		Glib::Threads::Mutex::Lock lm (_lock);
+		/* a change since the render was checked must not be missed */
+		if (!_retired && _ready->generation == g_atomic_int_get (&_generation)) {
+			install ();
+			installed = true;
+		}
+	}
+
+	if (installed || _ready || generation == _failed_generation) {
+		return;
+	}
+
+	if (g_get_monotonic_time () - _stable_since < settle_time) {
+		return;
+	}
+
+	InsertList il;
+	if (cached_inserts (il) && worth_rendering (il)) {
+		start_job (il);
+	} else {
+		/* check again later, the DSP load may change */
+		_stable_since = g_get_monotonic_time ();
+	}
+}
+
+void
+RenderCache::drop ()
+{
+	cancel_job ();
+	_ready.reset ();
+
+	{
+		Glib::Threads::Mutex::Lock lm (_lock);
+		if (_installed) {
+			uninstall ();
+		}
+	}
+
+	drop_connections ();
+	_seen_generation = -1;
+}
+
+/** Find the plugins that can be rendered, see Route::disk_plugin_chain */
+bool
+RenderCache::cached_inserts (InsertList& il) const
+{
+	il.clear ();
+
+	if (_track.freeze_state () == Track::Frozen) {
+		return false;
+	}
+
+	return _track.disk_plugin_chain (il, true);
+}
+
+bool
+RenderCache::worth_rendering (InsertList const& il) const
+{
+	double dsp_usec = 0;
+
+	for (InsertList::const_iterator i = il.begin (); i != il.end (); ++i) {
+		uint64_t min, max;
+		double   avg, dev;
+		if ((*i)->get_stats (min, max, avg, dev)) {
+			dsp_usec += avg;
+		}
+	}
+
+	const double cycle_usec = 1e6 * _session.get_block_size () / (double) _session.sample_rate ();
+
+	return 100.0 * dsp_usec / cycle_usec >= Config->get_render_cache_min_dsp_load ();
+}
+
+void
+RenderCache::reconnect (InsertList const& il)
+{
+	drop_connections ();
+
+	_track.processors_changed.connect_same_thread (*this, boost::bind (&RenderCache::invalidate, this));
+	_track.PlaylistChanged.connect_same_thread (*this, boost::bind (&RenderCache::invalidate, this));
+	_session.tempo_map ().PropertyChanged.connect_same_thread (*this, boost::bind (&RenderCache::invalidate, this));
+
+	boost::shared_ptr<Playlist> pl = _track.playlist ();
+	if (pl) {
+		pl->ContentsChanged.connect_same_thread (*this, boost::bind (&RenderCache::invalidate, this));
+
+		boost::shared_ptr<RegionList> rl = pl->region_list ();
+		for (RegionList::const_iterator r = rl->begin (); r != rl->end (); ++r) {
+			(*r)->PropertyChanged.connect_same_thread (*this, boost::bind (&RenderCache::region_changed, this, _1));
+		}
+	}
+
+	MidiTrack* mt = dynamic_cast<MidiTrack*> (&_track);
+	if (mt) {
+		mt->playback_filter ().ChannelModeChanged.connect_same_thread (*this, boost::bind (&RenderCache::invalidate, this));
+		mt->playback_filter ().ChannelMaskChanged.connect_same_thread (*this, boost::bind (&RenderCache::invalidate, this));
+	}
+
+	{
+		/* activating any processor may extend (or shorten) the chain */
+		Glib::Threads::RWLock::ReaderLock lm (_track._processor_lock);
+		for (ProcessorList::const_iterator i = _track._processors.begin (); i != _track._processors.end (); ++i) {
+			(*i)->ActiveChanged.connect_same_thread (*this, boost::bind (&RenderCache::invalidate, this));
+		}
+	}
+
+	for (InsertList::const_iterator i = il.begin (); i != il.end (); ++i) {
+		boost::shared_ptr<PluginInsert> pi (*i);
+
+		pi->PluginConfigChanged.connect_same_thread (*this, boost::bind (&RenderCache::invalidate, this));
+		pi->PluginMapChanged.connect_same_thread (*this, boost::bind (&RenderCache::invalidate, this));
+
+		boost::shared_ptr<Plugin> plugin = pi->plugin ();
+		plugin->PresetLoaded.connect_same_thread (*this, boost::bind (&RenderCache::invalidate, this));
+		plugin->ParameterChangedExternally.connect_same_thread (*this, boost::bind (&RenderCache::invalidate, this));
+		plugin->PropertyChanged.connect_same_thread (*this, boost::bind (&RenderCache::invalidate, this));
+
+		for (Automatable::Controls::const_iterator c = pi->controls ().begin (); c != pi->controls ().end (); ++c) {
+			boost::shared_ptr<AutomationControl> ac = boost::dynamic_pointer_cast<AutomationControl> (c->second);
+			if (!ac) {
+				continue;
+			}
+			ac->Changed.connect_same_thread (*this, boost::bind (&RenderCache::control_changed, this, boost::weak_ptr<AutomationControl> (ac)));
+
+			boost::shared_ptr<AutomationList> al = ac->alist ();
+			if (al) {
+				al->Dirty.connect_same_thread (*this, boost::bind (&RenderCache::invalidate, this));
+				al->automation_state_changed.connect_same_thread (*this, boost::bind (&RenderCache::invalidate, this));
+			}
+		}
+	}
+}
+
+void
+RenderCache::start_job (InsertList const& il)
+{
+	boost::shared_ptr<Playlist> playlist = _track.playlist ();
+
+	if (!playlist) {
+		return;
+	}
+
+	std::pair<samplepos_t, samplepos_t> extent = playlist->get_extent ();
+
+	if (extent.second <= extent.first) {
+		return;
+	}
+
+	samplecnt_t latency = 0;
+	samplecnt_t tail    = 0;
+
+	for (InsertList::const_iterator i = il.begin (); i != il.end (); ++i) {
+		latency += (*i)->effective_latency ();
+		tail     = std::max (tail, (*i)->plugin ()->signal_tail ());
+	}
+
+	tail = std::min (tail, max_tail * _session.sample_rate ());
+
+	boost::shared_ptr<Job> job (new Job);
+
+	job->start      = extent.first;
+	job->read_end   = extent.second;
+	job->end        = extent.second + latency + tail;
+	job->chunk      = _session.get_block_size ();
+	job->generation = _seen_generation;
+
+	if (il.front ()->input_streams ().n_midi () > 0) {
+		/* a MIDI track is rendered through its instrument, see Route::disk_plugin_chain */
+		boost::shared_ptr<MidiPlaylist> mpl = boost::dynamic_pointer_cast<MidiPlaylist> (playlist);
+		MidiTrack*                      mt  = dynamic_cast<MidiTrack*> (&_track);
+		if (!mpl || !mt) {
+			return;
+		}
+		mpl->render (job->events, &mt->playback_filter ());
+	} else {
+		job->playlist = boost::dynamic_pointer_cast<AudioPlaylist> (playlist);
+		if (!job->playlist) {
+			return;
+		}
+	}
+
+	for (InsertList::const_iterator i = il.begin (); i != il.end (); ++i) {
+		boost::shared_ptr<PluginInsert> copy = (*i)->create_copy (job->chunk);
+
+		if (!copy) {
+			_failed_generation = job->generation;
+			return;
+		}
+
+		job->inserts.push_back (copy);
+		job->processors.push_back (*i);
+	}
+
+	const uint32_t n_chn = il.back ()->output_streams ().n_audio ();
+
+	for (uint32_t n = 0; n < n_chn; ++n) {
+		const std::string path = _session.new_audio_source_path (legalize_for_path (_track.name ()) + X_("-render"), n_chn, n, false);
+
+		if (path.empty ()) {
+			_failed_generation = job->generation;
+			return;
+		}
+
+		try {
+			boost::shared_ptr<AudioFileSource> afs (new SndFileSource (_session, path, std::string (),
+			                                                           FormatFloat,
+			                                                           _session.config.get_native_file_header_format (),
+			                                                           _session.sample_rate (),
+			                                                           Source::Flag (SndFileSource::default_writable_flags | Source::NoPeakFile)));
+			/* the files are only kept while the cache is in use */
+			afs->mark_for_remove ();
+			job->sources.push_back (afs);
+		} catch (failed_constructor& err) {
+			error << string_compose (_("cannot create render cache file \"%1\" for %2"), path, _track.name ()) << endmsg;
+			_failed_generation = job->generation;
+			return;
+		}
+	}
+
+	DEBUG_TRACE (DEBUG::Processors, string_compose ("%1: rendering %2 plugin(s) %3 .. %4\n", _track.name (), il.size (), job->start, job->end));
+
+	if (_manager->queue (job.get ())) {
+		_job = job;
+	}
+}
+
+void
+RenderCache::cancel_job ()
+{
+	if (!_job) {
+		return;
+	}
+
+	_manager->cancel (_job.get ());
+
+	/* destroy the plugin copies in this thread */
+	_job->inserts.clear ();
+	_job.reset ();
+}
+
+void
+RenderCache::finish_job ()
+{
+	boost::shared_ptr<Job> job (_job);
+
+	_job.reset ();
+	job->inserts.clear ();
+
+	if (!job->ok) {
+		_failed_generation = job->generation;
+		return;
+	}
+
+	if (job->generation != g_atomic_int_get (&_generation)) {
+		return;
+	}
+
+	time_t now;
+	time (&now);
+	struct tm* xnow = localtime (&now);
+
+	SourceList srcs;
+
+	for (std::vector<boost::shared_ptr<AudioFileSource> >::const_iterator s = job->sources.begin (); s != job->sources.end (); ++s) {
+		(*s)->update_header (job->start, *xnow, now);
+		(*s)->flush_header ();
+		srcs.push_back (*s);
+	}
+
+	PropertyList plist;
+
+	plist.add (Properties::start, 0);
+	plist.add (Properties::length, job->end - job->start);
+	plist.add (Properties::name, string_compose (X_("%1 render"), _track.name ()));
+
+	boost::shared_ptr<AudioRegion> region = boost::dynamic_pointer_cast<AudioRegion> (RegionFactory::create (srcs, plist, false));
+
+	if (!region) {
+		_failed_generation = job->generation;
+		return;
+	}
+
+	/* play back exactly what was rendered */
+	region->set_position_lock_style (AudioTime);
+	region->set_fade_in_active (false);
+	region->set_fade_out_active (false);
+
+	boost::shared_ptr<Result> result (new Result);
+
+	result->playlist   = boost::dynamic_pointer_cast<AudioPlaylist> (PlaylistFactory::create (DataType::AUDIO, _session, string_compose (X_("%1.render"), _track.name ()), true));
+	result->n_channels = srcs.size ();
+	result->processors = job->processors;
+	result->generation = job->generation;
+
+	result->playlist->add_region (region, job->start);
+
+	_ready = result;
+}
+
+/* must be called with _lock held */
+void
+RenderCache::install ()
+{
+	DEBUG_TRACE (DEBUG::Processors, string_compose ("%1: using render cache\n", _track.name ()));
+
+	/* the disk-reader does not read the cache yet, so the route does
+	 * not skip the processors on the list.
+	 */
+	boost::shared_ptr<RenderedProcessors> rp = _rendered.write_copy ();
+	*rp = _ready->processors;
+	_rendered.update (rp);
+
+	_installed = _ready;
+	_ready.reset ();
+
+	_track._disk_reader->set_render_playlist (_installed->playlist, _installed->n_channels);
+}
+
+/* must be called with _lock held */
+void
+RenderCache::uninstall ()
+{
+	DEBUG_TRACE (DEBUG::Processors, string_compose ("%1: dropping render cache\n", _track.name ()));
+
+	/* the route keeps skipping the rendered processors until the
+	 * disk-reader has switched back, and then flushes them.
+	 */
+	_track._disk_reader->set_render_playlist (boost::shared_ptr<AudioPlaylist> ());
+
+	/* keep the files until the disk-reader has switched back */
+	_retired = _installed;
+	_installed.reset ();
+}
+
+bool
+RenderCache::contains (RenderedProcessors const& rp, boost::shared_ptr<Processor> const& p)
+{
+	for (RenderedProcessors::const_iterator i = rp.begin (); i != rp.end (); ++i) {
+		/* compare the owners, a processor that was removed since
+		 * does not match another one at the same address.
+		 */
+		if (!i->owner_before (p) && !p.owner_before (*i)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+uint32_t
+RenderCache::max_workers ()
+{
+	/* rendering is CPU bound, leave most cores to the process threads */
+	return std::max (1U, std::min (hardware_concurrency () / 4, 2U));
+}
+
+void
+RenderCache::Job::run ()
+{
+	const ChanCount in (inserts.front ()->input_streams ());
+	const uint32_t  n_chn = sources.size ();
+
+	ChanCount max_streams (ChanCount::max (in, ChanCount (DataType::AUDIO, n_chn)));
+	for (InsertList::const_iterator i = inserts.begin (); i != inserts.end (); ++i) {
+		max_streams = ChanCount::max (max_streams, (*i)->required_buffers ());
+		max_streams = ChanCount::max (max_streams, (*i)->output_streams ());
+	}
+
+	BufferSet bufs;
+	bufs.ensure_buffers (DataType::AUDIO, max_streams.n_audio (), chunk);
+	bufs.ensure_buffers (DataType::MIDI, max_streams.n_midi (), AudioEngine::instance ()->raw_buffer_size (DataType::MIDI));
+
+	boost::scoped_array<Sample> mixdown_buffer (new Sample[chunk]);
+	boost::scoped_array<gain_t> gain_buffer (new gain_t[chunk]);
+	MidiStateTracker            tracker;
+
+	for (samplepos_t pos = start; pos < end; pos += chunk) {
+
+		if (g_atomic_int_get (&cancelled)) {
+			return;
+		}
+
+		const pframes_t nframes = std::min (chunk, end - pos);
+
+		bufs.set_count (in);
+
+		for (uint32_t n = 0; n < in.n_audio (); ++n) {
+			Sample* buf = bufs.get_audio (n).data ();
+			memset (buf, 0, sizeof (Sample) * nframes);
+			if (pos < read_end) {
+				playlist->read (buf, mixdown_buffer.get (), gain_buffer.get (), pos, std::min<samplecnt_t> (nframes, read_end - pos), n);
+			}
+		}
+
+		if (in.n_midi ()) {
+			MidiBuffer& mbuf (bufs.get_midi (0));
+			mbuf.silence (nframes);
+			if (pos < read_end) {
+				const samplecnt_t n_read = std::min<samplecnt_t> (nframes, read_end - pos);
+				events.read (mbuf, pos, pos + n_read, tracker);
+				if (pos + n_read == read_end) {
+					/* like the end of the track's regions */
+					tracker.resolve_notes (mbuf, n_read - 1);
+				}
+			}
+		}
+
+		/* same as Route::process_output_buffers, minus the disk-reader
+		 * alignment: the disk-reader plays the result at the time it
+		 * reads the input, so the plugin latency is kept.
+		 */
+		samplecnt_t latency = 0;
+		for (InsertList::const_iterator i = inserts.begin (); i != inserts.end (); ++i) {
+			latency += (*i)->effective_latency ();
+			(*i)->run (bufs, pos - latency, pos - latency + nframes, 1.0, nframes, true);
+			bufs.set_count ((*i)->output_streams ());
+		}
+
+		for (uint32_t n = 0; n < n_chn; ++n) {
+			if (sources[n]->write (bufs.get_audio (n).data (), nframes) != (samplecnt_t) nframes) {
+				return;
+			}
+		}
+	}
+
+	ok = true;
+}
+
+RenderCacheManager::RenderCacheManager (Session& s)
+	: _session (s)
+	, _thread (0)
+	, _quit (false)
+	, _woken (0)
+{
+}
+
+RenderCacheManager::~RenderCacheManager ()
+{
+	stop ();
+}
+
+int
+RenderCacheManager::start ()
+{
+	try {
+		_thread = Glib::Threads::Thread::create (sigc::mem_fun (*this, &RenderCacheManager::thread_main));
+	} catch (Glib::Threads::ThreadError const&) {
+		return -1;
+	}
+	return 0;
+}
+
+void
+RenderCacheManager::stop ()
+{
+	{
+		Glib::Threads::Mutex::Lock lm (_lock);
+
+		_quit = true;
+
+		/* never run, the caches see them as failed */
+		for (std::list<RenderCache::Job*>::const_iterator i = _queue.begin (); i != _queue.end (); ++i) {
+			g_atomic_int_set (&(*i)->done, 1);
+		}
+		_queue.clear ();
+
+		for (std::list<RenderCache::Job*>::const_iterator i = _running.begin (); i != _running.end (); ++i) {
+			g_atomic_int_set (&(*i)->cancelled, 1);
+		}
+
+		_wake.signal ();
+		_jobs_queued.broadcast ();
+		_job_done.broadcast ();
+	}
+
+	if (_thread) {
+		_thread->join ();
+		_thread = 0;
+	}
+
+	for (std::vector<Glib::Threads::Thread*>::const_iterator i = _workers.begin (); i != _workers.end (); ++i) {
+		(*i)->join ();
+	}
+	_workers.clear ();
+}
+
+void
+RenderCacheManager::wake ()
+{
+	/* no lock, the update thread wakes up by itself at the latest
+	 * after update_period.
+	 */
+	g_atomic_int_set (&_woken, 1);
+	_wake.signal ();
+}
+
+void
+RenderCacheManager::thread_main ()
+{
+	SessionEvent::create_per_thread_pool (X_("Render Cache"), 64);
+	pthread_set_name ("RenderCache");
+
+	Glib::Threads::Mutex::Lock lm (_lock);
+
+	while (!_quit) {
+
+		if (!g_atomic_int_compare_and_exchange (&_woken, 1, 0)) {
+			_wake.wait_until (_lock, g_get_monotonic_time () + update_period);
+			g_atomic_int_set (&_woken, 0);
+			if (_quit) {
+				break;
+			}
+		}
+
+		lm.release ();
+
+		if (!_session.loading () && !_session.deletion_in_progress ()) {
+			_session.update_render_caches ();
+		}
+
+		lm.acquire ();
+	}
+}
+
+bool
+RenderCacheManager::queue (RenderCache::Job* job)
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+
+	if (_quit) {
+		return false;
+	}
+
+	if (_workers.empty ()) {
+		const uint32_t n_workers = RenderCache::max_workers ();
+		for (uint32_t n = 0; n < n_workers; ++n) {
+			_workers.push_back (Glib::Threads::Thread::create (sigc::mem_fun (*this, &RenderCacheManager::worker)));
+		}
+	}
+
+	_queue.push_back (job);
+	_jobs_queued.signal ();
+
+	return true;
+}
+
+void
+RenderCacheManager::cancel (RenderCache::Job* job)
+{
+	g_atomic_int_set (&job->cancelled, 1);
+
+	Glib::Threads::Mutex::Lock lm (_lock);
+
+	std::list<RenderCache::Job*>::iterator i = std::find (_queue.begin (), _queue.end (), job);
+
+	if (i != _queue.end ()) {
+		_queue.erase (i);
+		return;
+	}
+
+	while (!g_atomic_int_get (&job->done)) {
+		_job_done.wait (_lock);
+	}
+}
+
+void
+RenderCacheManager::worker ()
+{
+	SessionEvent::create_per_thread_pool (X_("Render Cache Worker"), 64);
+	pthread_set_name ("RenderCacheWorker");
+
+	ProcessThread* pt = new ProcessThread ();
+
+	Glib::Threads::Mutex::Lock lm (_lock);
+
+	while (true) {
+
+		while (_queue.empty () && !_quit) {
+			_jobs_queued.wait (_lock);
+		}
+
+		if (_quit) {
+			break;
+		}
+
+		RenderCache::Job* job = _queue.front ();
+		_queue.pop_front ();
+		_running.push_back (job);
+
+		lm.release ();
+
+		pt->get_buffers ();
+		job->run ();
+		pt->drop_buffers ();
+
+		lm.acquire ();
+
+		_running.remove (job);
+		g_atomic_int_set (&job->done, 1);
+		_job_done.broadcast ();
+	}
+
+	lm.release ();
+
+	delete pt;
+}
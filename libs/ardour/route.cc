@@ -84,9 +84,12 @@
 #include "ardour/port_insert.h"
 #include "ardour/processor.h"
 #include "ardour/profile.h"
+#include "ardour/playback_lookahead.h"
+#include "ardour/render_cache.h"
 #include "ardour/revision.h"
 #include "ardour/route.h"
 #include "ardour/route_group.h"
+#include "ardour/route_pipeline_stage.h"
 #include "ardour/send.h"
 #include "ardour/session.h"
 #include "ardour/solo_control.h"
@@ -126,6 +129,8 @@ Route::Route (Session& sess, string name, PresentationInfo::Flag flag, DataType
 	, _instrument_fanned_out (false)
 	, _loop_location (NULL)
 	, _volume_applies_to_output (true)
+	, _pipeline_amp_in_tail (false)
+	, _render_skipped (false)
 	, _track_number (0)
 	, _strict_io (false)
 	, _in_configure_processors (false)
@@ -136,6 +141,7 @@ Route::Route (Session& sess, string name, PresentationInfo::Flag flag, DataType
 	, _patch_selector_dialog (0)
 {
 	processor_max_streams.reset();
+	g_atomic_int_set (&_pipelined, 0);
 }
 
 boost::weak_ptr<Route>
@@ -279,6 +285,13 @@ Route::init ()
 		panner_shell()->select_panner_by_uri ("http://ardour.org/plugin/panner_balance");
 	}
 
+	/* busses can split their processor-chain into two graph-nodes,
+	 * tracks use the disk-reader's look-ahead instead.
+	 */
+	if (_session._process_graph && !dynamic_cast<Track*>(this) && !is_monitor () && !is_auditioner ()) {
+		_pipeline_stage.reset (new RoutePipelineStage (_session._process_graph, *this));
+	}
+
 	/* now set up processor chain and invisible processors */
 	{
 		Glib::Threads::Mutex::Lock lx (AudioEngine::instance()->process_lock ());
@@ -354,6 +367,8 @@ Route::process_output_buffers (BufferSet& bufs,
 		return;
 	}
 
+	_dsp_profile.start ();
+
 	/* We should offset the route-owned ctrls by the given latency, however
 	 * this only affects Mute. Other route-owned controls (solo, polarity..)
 	 * are not automatable.
@@ -367,13 +382,17 @@ Route::process_output_buffers (BufferSet& bufs,
 		_pannable->automation_run (start_sample + _signal_latency, nframes);
 	}
 
-	/* figure out if we're going to use gain automation */
+	/* figure out if we're going to use gain automation,
+	 * if the fader is processed by the pipeline's tail, it takes care of it.
+	 */
 	if (gain_automation_ok) {
-		_amp->set_gain_automation_buffer (_session.gain_automation_buffer ());
-		_amp->setup_gain_automation (
-				start_sample + _amp->output_latency (),
-				end_sample + _amp->output_latency (),
-				nframes);
+		if (!(_pipeline_split && _pipeline_amp_in_tail)) {
+			_amp->set_gain_automation_buffer (_session.gain_automation_buffer ());
+			_amp->setup_gain_automation (
+					start_sample + _amp->output_latency (),
+					end_sample + _amp->output_latency (),
+					nframes);
+		}
 
 		_trim->set_gain_automation_buffer (_session.trim_automation_buffer ());
 		_trim->setup_gain_automation (
@@ -475,8 +494,40 @@ Route::process_output_buffers (BufferSet& bufs,
 
 	samplecnt_t latency = 0;
 
+	/* processors whose output the disk-reader currently plays back.
+	 * Only without input: with cue monitoring the disk-reader does not
+	 * mix a render into the input, and the processors have to run.
+	 * Once they run again, they start from a clean state.
+	 */
+	boost::shared_ptr<RenderCache::RenderedProcessors> rendered;
+	bool render_flush = false;
+	if (_render_cache && _disk_reader) {
+		const bool skip = ms == MonitoringDisk && _disk_reader->reading_render_cache ();
+		if (skip || _render_skipped) {
+			rendered = _render_cache->rendered_processors ();
+		}
+		render_flush    = _render_skipped && !skip;
+		_render_skipped = skip;
+	}
+
+	/* processors whose output may have been computed ahead of time */
+	PlaybackLookahead::ChainRef ahead;
+	samplepos_t ahead_pos   = 0;
+	bool        ahead_read  = false;
+	uint32_t    ahead_flush = 0;
+	if (_playback_lookahead && _disk_reader) {
+		ahead     = _playback_lookahead->chain ();
+		ahead_pos = _disk_reader->playback_position ();
+	}
+
 	for (ProcessorList::const_iterator i = _processors.begin(); i != _processors.end(); ++i) {
 
+		if ((*i) == _pipeline_split) {
+			/* hand over to the tail, see ::process_pipeline_tail_unlocked */
+			_pipeline_stage->write (bufs, nframes);
+			break;
+		}
+
 		bool re_inject_oob_data = false;
 		if ((*i) == _disk_reader) {
 			/* ignore port-count from prior plugins, use DR's count.
@@ -524,11 +575,41 @@ Route::process_output_buffers (BufferSet& bufs,
 			latency += (*i)->effective_latency ();
 		}
 
+		const bool was_rendered = rendered && RenderCache::contains (*rendered, *i);
+
+		if ((was_rendered && !render_flush)
+		    || (ahead_read && PlaybackLookahead::processes (ahead, *i))) {
+			/* the disk-reader's output already includes this processor,
+			 * only keep its automation (and control displays) current.
+			 */
+			if (speed != 0) {
+				(*i)->automation_run (speed < 0 ? start_sample + latency : start_sample - latency, nframes);
+			}
+			bufs.set_count ((*i)->output_streams());
+			continue;
+		}
+
+		if (was_rendered && render_flush) {
+			/* resume from a clean state, the render was played until now */
+			boost::static_pointer_cast<PluginInsert> (*i)->flush ();
+		}
+
+		if (ahead_flush > 0) {
+			/* resume from a clean state, the ahead-of-time copy was used until now */
+			boost::shared_ptr<PluginInsert> pi = boost::dynamic_pointer_cast<PluginInsert> (*i);
+			if (pi) {
+				pi->flush ();
+			}
+			--ahead_flush;
+		}
+
+		(*i)->dsp_profile ().start ();
 		if (speed < 0) {
 			(*i)->run (bufs, start_sample + latency, end_sample + latency, pspeed, nframes, *i != _processors.back());
 		} else {
 			(*i)->run (bufs, start_sample - latency, end_sample - latency, pspeed, nframes, *i != _processors.back());
 		}
+		(*i)->dsp_profile ().update ();
 
 		bufs.set_count ((*i)->output_streams());
 
@@ -536,12 +617,28 @@ Route::process_output_buffers (BufferSet& bufs,
 			write_out_of_band_data (bufs, nframes);
 		}
 
+		if (ahead && (*i) == _disk_reader) {
+			if (ms == MonitoringDisk && speed == 1.0 && run_disk_reader
+			    && !DiskReader::no_disk_output ()
+			    && !_disk_reader->declick_in_progress ()
+			    && !_disk_reader->reading_render_cache ()
+			    && !(_disk_writer && _disk_writer->record_enabled ())
+			    && PlaybackLookahead::follows (ahead, i, _processors.end ())) {
+				ahead_read = _playback_lookahead->read (ahead, *_disk_reader, bufs, ahead_pos, nframes);
+			}
+			if (!ahead_read) {
+				ahead_flush = _playback_lookahead->stop ();
+			}
+		}
+
 #if 0
 		if ((*i) == _delayline) {
 			latency += _delayline->delay ();
 		}
 #endif
 	}
+
+	_dsp_profile.update ();
 }
 
 void
@@ -718,7 +815,19 @@ Route::run_route (samplepos_t start_sample, samplepos_t end_sample, pframes_t nf
 	/* map events (e.g. MIDI-CC) back to control-parameters */
 	update_controls (bufs);
 
-	flush_processor_buffers_locked (nframes);
+	if (!_pipeline_split) {
+		flush_processor_buffers_locked (nframes);
+		return;
+	}
+
+	flush_pipeline_buffers_locked (nframes, false);
+
+	if (!_pipeline_stage->scheduled ()) {
+		/* the tail is not (yet) part of the process graph, process it here */
+		process_pipeline_tail_unlocked (nframes, start_sample, end_sample, gain_automation_ok);
+		flush_pipeline_buffers_locked (nframes, true);
+		_pipeline_stage->advance ();
+	}
 }
 
 void
@@ -1974,6 +2083,11 @@ Route::configure_processors_unlocked (ProcessorStreams* err, Glib::Threads::RWLo
 	*/
 	_session.ensure_buffers (n_process_buffers ());
 
+	if (_pipeline_stage) {
+		_pipeline_stage->set_capacity (processor_max_streams.n_audio (), _session.engine ().samples_per_cycle ());
+		update_pipeline_split ();
+	}
+
 	DEBUG_TRACE (DEBUG::Processors, string_compose ("%1: configuration complete\n", _name));
 
 	_in_configure_processors = false;
@@ -3621,9 +3735,22 @@ Route::non_realtime_transport_stop (samplepos_t now, bool flush)
 	}
 }
 
+void
+Route::realtime_locate (bool for_loop_end)
+{
+	if (_pipeline_stage && !for_loop_end) {
+		/* the data in flight is from before the locate */
+		_pipeline_stage->request_clear ();
+	}
+}
+
 void
 Route::realtime_handle_transport_stopped ()
 {
+	if (_pipeline_stage) {
+		_pipeline_stage->request_clear ();
+	}
+
 	Glib::Threads::RWLock::ReaderLock lm (_processor_lock);
 
 	/* currently only by Plugin, queue note-off events */
@@ -3954,6 +4081,186 @@ Route::silent_roll (pframes_t nframes, samplepos_t /*start_sample*/, samplepos_t
 	return 0;
 }
 
+boost::shared_ptr<RoutePipelineStage>
+Route::pipeline_stage () const
+{
+	if (g_atomic_int_get (&_pipelined)) {
+		return _pipeline_stage;
+	}
+	return boost::shared_ptr<RoutePipelineStage> ();
+}
+
+/** clear the DSP profile of the route and all its processors */
+void
+Route::reset_dsp_profiles ()
+{
+	_dsp_profile.reset ();
+
+	Glib::Threads::RWLock::ReaderLock lm (_processor_lock);
+	for (ProcessorList::const_iterator i = _processors.begin(); i != _processors.end(); ++i) {
+		(*i)->dsp_profile ().reset ();
+	}
+}
+
+void
+Route::reset_pipeline ()
+{
+	Glib::Threads::Mutex::Lock lx (AudioEngine::instance()->process_lock ());
+	Glib::Threads::RWLock::WriterLock lm (_processor_lock);
+	update_pipeline_split ();
+}
+
+/** Decide if and where to split the processor chain.
+ * Must be called with the processor lock held (writer).
+ *
+ * The split-point is placed in the middle of the plugins, so that
+ * one half of the plugins is processed by the route, the other half
+ * concurrently by the tail. Only audio is handed over.
+ */
+void
+Route::update_pipeline_split ()
+{
+	_pipeline_split.reset ();
+	_pipeline_amp_in_tail = false;
+
+	if (_pipeline_stage && Config->get_route_pipelining ()) {
+		std::vector<boost::shared_ptr<Processor> > plugins;
+		for (ProcessorList::const_iterator i = _processors.begin(); i != _processors.end(); ++i) {
+			if (boost::dynamic_pointer_cast<PluginInsert> (*i) && (*i)->active ()) {
+				plugins.push_back (*i);
+			}
+		}
+
+		if (plugins.size () > 1) {
+			boost::shared_ptr<Processor> split = plugins[plugins.size () / 2];
+			ChanCount const& in = split->input_streams ();
+			if (in.n_midi () == 0 && in.n_audio () > 0 && in.n_audio () <= _pipeline_stage->n_channels ()) {
+				_pipeline_split = split;
+			}
+		}
+	}
+
+	if (_pipeline_split) {
+		ProcessorList::const_iterator s = find (_processors.begin (), _processors.end (), _pipeline_split);
+		_pipeline_amp_in_tail = find (s, _processors.end (), _amp) != _processors.end ();
+	}
+
+	g_atomic_int_set (&_pipelined, _pipeline_split ? 1 : 0);
+}
+
+void
+Route::run_pipeline_tail (pframes_t nframes, samplepos_t start_sample, samplepos_t end_sample, bool roll)
+{
+	Glib::Threads::RWLock::ReaderLock lm (_processor_lock, Glib::Threads::TRY_LOCK);
+
+	if (!lm.locked()) {
+		/* the processors are being changed: drop the data that the
+		 * head handed over, and output silence for this cycle.
+		 */
+		_pipeline_stage->discard (nframes);
+		_output->silence (nframes);
+		return;
+	}
+
+	if (!_active || !_pipeline_split) {
+		/* inactive routes are silenced by the head */
+		return;
+	}
+
+	if (roll) {
+		if ((nframes = latency_preroll (nframes, start_sample, end_sample)) == 0) {
+			return;
+		}
+	}
+
+	process_pipeline_tail_unlocked (nframes, start_sample, end_sample, roll && _session.transport_rolling());
+	flush_pipeline_buffers_locked (nframes, true);
+}
+
+/** Process the processors from the split-point onwards with the
+ * data that the head handed over during the previous cycle.
+ * Must be called with the processor lock held.
+ */
+void
+Route::process_pipeline_tail_unlocked (pframes_t nframes, samplepos_t start_sample, samplepos_t end_sample, bool gain_automation_ok)
+{
+	BufferSet& bufs (_session.get_route_buffers (n_process_buffers()));
+
+	bufs.set_count (_pipeline_split->input_streams ());
+	_pipeline_stage->read (bufs, nframes);
+
+	if (gain_automation_ok && _pipeline_amp_in_tail) {
+		_amp->set_gain_automation_buffer (_session.gain_automation_buffer ());
+		_amp->setup_gain_automation (
+				start_sample + _amp->output_latency (),
+				end_sample + _amp->output_latency (),
+				nframes);
+	}
+
+	const double speed = (is_auditioner() ? 1.0 : _session.transport_speed ());
+
+	const sampleoffset_t latency_offset = _signal_latency + output_latency ();
+	if (speed < 0) {
+		start_sample -= latency_offset;
+		end_sample -= latency_offset;
+	} else {
+		start_sample += latency_offset;
+		end_sample += latency_offset;
+	}
+
+	/* align to the latency of processors up to the split point,
+	 * including the one cycle handover.
+	 */
+	samplecnt_t latency = _pipeline_stage->latency ();
+
+	ProcessorList::const_iterator i;
+	for (i = _processors.begin(); i != _processors.end() && (*i) != _pipeline_split; ++i) {
+		if ((*i)->active ()) {
+			latency += (*i)->effective_latency ();
+		}
+	}
+
+	for (; i != _processors.end(); ++i) {
+		if ((*i)->active ()) {
+			latency += (*i)->effective_latency ();
+		}
+
+		(*i)->dsp_profile ().start ();
+		if (speed < 0) {
+			(*i)->run (bufs, start_sample + latency, end_sample + latency, speed, nframes, *i != _processors.back());
+		} else {
+			(*i)->run (bufs, start_sample - latency, end_sample - latency, speed, nframes, *i != _processors.back());
+		}
+		(*i)->dsp_profile ().update ();
+
+		bufs.set_count ((*i)->output_streams());
+	}
+}
+
+/** flush the buffers of either the head or the tail of a pipelined route */
+void
+Route::flush_pipeline_buffers_locked (samplecnt_t nframes, bool tail)
+{
+	bool in_tail = false;
+	for (ProcessorList::iterator i = _processors.begin(); i != _processors.end(); ++i) {
+		if ((*i) == _pipeline_split) {
+			in_tail = true;
+		}
+		if (in_tail != tail) {
+			continue;
+		}
+		boost::shared_ptr<Delivery> d = boost::dynamic_pointer_cast<Delivery> (*i);
+		if (d) {
+			d->flush_buffers (nframes);
+		} else {
+			boost::shared_ptr<PortInsert> p = boost::dynamic_pointer_cast<PortInsert> (*i);
+			if (p) {
+				p->flush_buffers (nframes);
+			}
+		}
+	}
+}
+
 #ifdef __clang__
 __attribute__((annotate("realtime")))
 #endif
@@ -4270,6 +4577,10 @@ Route::update_signal_latency (bool apply_to_delayline, bool* delayline_update_ne
 		if ((*i)->active ()) { // XXX
 			l_out += (*i)->effective_latency ();
 		}
+		if ((*i) == _pipeline_split) {
+			/* handover from head to tail adds one cycle */
+			l_out += _pipeline_stage->latency ();
+		}
 	}
 
 	DEBUG_TRACE (DEBUG::LatencyRoute, string_compose ("%1: internal signal latency = %2\n", _name, l_out));
@@ -4355,6 +4666,11 @@ Route::set_block_size (pframes_t nframes)
 		(*i)->set_block_size (nframes);
 	}
 
+	if (_pipeline_stage) {
+		Glib::Threads::RWLock::WriterLock lm (_processor_lock);
+		_pipeline_stage->set_capacity (processor_max_streams.n_audio (), nframes);
+	}
+
 	_session.ensure_buffers (n_process_buffers ());
 }
 
@@ -5210,6 +5526,8 @@ Route::setup_invisible_processors ()
 		}
 	}
 
+	update_pipeline_split ();
+
 	DEBUG_TRACE (DEBUG::Processors, string_compose ("%1: setup_invisible_processors\n", _name));
 	for (ProcessorList::iterator i = _processors.begin(); i != _processors.end(); ++i) {
 		DEBUG_TRACE (DEBUG::Processors, string_compose ("\t%1\n", (*i)->name ()));
@@ -5326,6 +5644,52 @@ Route::has_external_redirects () const
 	return false;
 }
 
+bool
+Route::disk_plugin_chain (std::vector<boost::shared_ptr<PluginInsert> >& il, bool with_instrument) const
+{
+	il.clear ();
+
+	Glib::Threads::RWLock::ReaderLock lm (_processor_lock);
+
+	ProcessorList::const_iterator i = find (_processors.begin (), _processors.end (), _disk_reader);
+
+	if (i == _processors.end ()) {
+		return false;
+	}
+
+	const ChanCount disk_streams ((*i)->output_streams ());
+	const bool      midi = disk_streams.n_midi () > 0;
+
+	if (midi ? (!with_instrument || disk_streams.n_audio () > 0) : disk_streams.n_audio () == 0) {
+		return false;
+	}
+
+	for (++i; i != _processors.end () && *i != _pipeline_split; ++i) {
+		boost::shared_ptr<PluginInsert> pi = boost::dynamic_pointer_cast<PluginInsert> (*i);
+
+		if (!pi || !pi->active () || pi->has_sidechain ()) {
+			break;
+		}
+		if (midi && il.empty ()) {
+			/* the instrument turns the disk-reader's MIDI into audio */
+			if (pi->input_streams () != disk_streams || pi->output_streams ().n_midi () > 0 || pi->output_streams ().n_audio () == 0) {
+				break;
+			}
+		} else if (pi->input_streams ().n_midi () > 0 || pi->output_streams ().n_midi () > 0 || pi->input_streams ().n_audio () == 0) {
+			break;
+		}
+		il.push_back (pi);
+	}
+
+	if (!midi) {
+		while (!il.empty () && il.back ()->output_streams () != disk_streams) {
+			il.pop_back ();
+		}
+	}
+
+	return !il.empty ();
+}
+
 boost::shared_ptr<Processor>
 Route::the_instrument () const
 {
@@ -5366,6 +5730,10 @@ Route::non_realtime_locate (samplepos_t pos)
 	}
 #endif
 
+	if (_pipeline_stage) {
+		_pipeline_stage->request_clear ();
+	}
+
 	{
 		//Glib::Threads::Mutex::Lock lx (AudioEngine::instance()->process_lock ());
 		Glib::Threads::RWLock::ReaderLock lm (_processor_lock);
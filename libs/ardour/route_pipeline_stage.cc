@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2026 The Ardour Team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "ardour/audio_buffer.h"
+#include "ardour/buffer_set.h"
+#include "ardour/graph.h"
+#include "ardour/route.h"
+#include "ardour/route_pipeline_stage.h"
+
+using namespace ARDOUR;
+
+RoutePipelineStage::RoutePipelineStage (boost::shared_ptr<Graph> graph, Route& r)
+	: GraphNode (graph)
+	, _route (r)
+	, _fifo (0)
+	, _n_channels (0)
+	, _block_size (0)
+	, _wpos (0)
+	, _written (0)
+{
+	g_atomic_int_set (&_scheduled, 0);
+	g_atomic_int_set (&_pending_clear, 0);
+}
+
+RoutePipelineStage::~RoutePipelineStage ()
+{
+	delete [] _fifo;
+}
+
+std::string
+RoutePipelineStage::graph_node_name () const
+{
+	return _route.name () + " (tail)";
+}
+
+void
+RoutePipelineStage::set_capacity (uint32_t n_channels, samplecnt_t block_size)
+{
+	if (n_channels == _n_channels && block_size == _block_size) {
+		return;
+	}
+
+	delete [] _fifo;
+	_fifo = 0;
+
+	_n_channels = n_channels;
+	_block_size = block_size;
+	_wpos       = 0;
+	_written    = 0;
+
+	if (_n_channels > 0 && _block_size > 0) {
+		/* each channel holds one cycle in flight and one cycle being written */
+		_fifo = new Sample[_n_channels * 2 * _block_size];
+		memset (_fifo, 0, sizeof (Sample) * _n_channels * 2 * _block_size);
+	}
+}
+
+void
+RoutePipelineStage::prep (int chain)
+{
+	GraphNode::prep (chain);
+	advance ();
+	g_atomic_int_set (&_scheduled, 1);
+}
+
+bool
+RoutePipelineStage::scheduled ()
+{
+	return g_atomic_int_compare_and_exchange (&_scheduled, 1, 0);
+}
+
+void
+RoutePipelineStage::advance ()
+{
+	if (g_atomic_int_compare_and_exchange (&_pending_clear, 1, 0)) {
+		clear ();
+		return;
+	}
+	if (_block_size > 0) {
+		_wpos = (_wpos + _written) % (2 * _block_size);
+	}
+	_written = 0;
+}
+
+void
+RoutePipelineStage::clear ()
+{
+	if (_fifo) {
+		memset (_fifo, 0, sizeof (Sample) * _n_channels * 2 * _block_size);
+	}
+	_wpos    = 0;
+	_written = 0;
+}
+
+void
+RoutePipelineStage::write (BufferSet const& bufs, pframes_t nframes)
+{
+	assert (nframes <= _block_size);
+	if (!_fifo) {
+		return;
+	}
+
+	samplecnt_t const size = 2 * _block_size;
+	samplecnt_t const n0   = std::min<samplecnt_t> (nframes, size - _wpos);
+	uint32_t const    n_ch = std::min (_n_channels, bufs.count ().n_audio ());
+
+	for (uint32_t c = 0; c < n_ch; ++c) {
+		Sample const* src = bufs.get_audio (c).data ();
+		Sample*       dst = &_fifo[c * size];
+		memcpy (&dst[_wpos], src, sizeof (Sample) * n0);
+		if (n0 < nframes) {
+			memcpy (dst, &src[n0], sizeof (Sample) * (nframes - n0));
+		}
+	}
+	for (uint32_t c = n_ch; c < _n_channels; ++c) {
+		Sample* dst = &_fifo[c * size];
+		memset (&dst[_wpos], 0, sizeof (Sample) * n0);
+		if (n0 < nframes) {
+			memset (dst, 0, sizeof (Sample) * (nframes - n0));
+		}
+	}
+
+	_written = nframes;
+}
+
+void
+RoutePipelineStage::read (BufferSet& bufs, pframes_t nframes)
+{
+	assert (nframes <= _block_size);
+
+	uint32_t const n_audio = bufs.count ().n_audio ();
+
+	if (!_fifo) {
+		for (uint32_t c = 0; c < n_audio; ++c) {
+			bufs.get_audio (c).silence (nframes);
+		}
+		return;
+	}
+
+	/* The head writes [_wpos, _wpos + nframes) concurrently,
+	 * the tail reads the data that was written one cycle earlier.
+	 */
+	samplecnt_t const size = 2 * _block_size;
+	samplecnt_t const rpos = (_wpos + _block_size) % size;
+	samplecnt_t const n0   = std::min<samplecnt_t> (nframes, size - rpos);
+
+	for (uint32_t c = 0; c < n_audio; ++c) {
+		AudioBuffer& ab = bufs.get_audio (c);
+		if (c >= _n_channels) {
+			ab.silence (nframes);
+			continue;
+		}
+		Sample* src = &_fifo[c * size];
+		ab.read_from (&src[rpos], n0);
+		memset (&src[rpos], 0, sizeof (Sample) * n0);
+		if (n0 < nframes) {
+			ab.read_from (src, nframes - n0, n0);
+			memset (src, 0, sizeof (Sample) * (nframes - n0));
+		}
+	}
+}
+
+void
+RoutePipelineStage::discard (pframes_t nframes)
+{
+	assert (nframes <= _block_size);
+
+	if (!_fifo) {
+		return;
+	}
+
+	samplecnt_t const size = 2 * _block_size;
+	samplecnt_t const rpos = (_wpos + _block_size) % size;
+	samplecnt_t const n0   = std::min<samplecnt_t> (nframes, size - rpos);
+
+	for (uint32_t c = 0; c < _n_channels; ++c) {
+		Sample* src = &_fifo[c * size];
+		memset (&src[rpos], 0, sizeof (Sample) * n0);
+		if (n0 < nframes) {
+			memset (src, 0, sizeof (Sample) * (nframes - n0));
+		}
+	}
+}
+
+void
+RoutePipelineStage::process ()
+{
+	_graph->process_one_pipeline_stage (_route);
+}
@@ -18,6 +18,7 @@
 
 #include <iostream>
 #include <algorithm>    // std::reverse
+#include <limits>
 
 #include "pbd/malign.h"
 #include "pbd/compose.h"
@@ -36,59 +37,249 @@ using namespace std;
 using namespace ARDOUR;
 using namespace PBD;
 
+/** @return true if the item was removed by a patch (inline, with no status byte) */
+static
+bool
+item_removed (ARDOUR::RTMidiBuffer::Item const & item)
+{
+	return !item.bytes[0] && !item.bytes[1];
+}
+
+/** @return true if @param key orders the patched event before the
+ * events of the main store with the same timestamp (see Storage::patch)
+ */
+static
+bool
+patched_first (std::pair<samplepos_t, int64_t> const & key)
+{
+	return key.second < 0;
+}
+
+RTMidiBuffer::Storage::Storage ()
+	: size (0)
+	, capacity (0)
+	, data (0)
+	, reversed (false)
+	, pool_size (0)
+	, pool_capacity (0)
+	, pool (0)
+	, index (0)
+	, index_size (0)
+	, index_capacity (0)
+	, index_shift (0)
+	, index_base (0)
+	, patch_seq (0)
+	, n_removed (0)
+{
+}
+
+RTMidiBuffer::Storage::~Storage ()
+{
+	cache_aligned_free (data);
+	cache_aligned_free (pool);
+	cache_aligned_free (index);
+}
+
 RTMidiBuffer::RTMidiBuffer ()
-	: _size (0)
-	, _capacity (0)
-	, _data (0)
-	, _reversed (false)
-	, _pool_size (0)
-	, _pool_capacity (0)
-	, _pool (0)
+	: _active (0)
+	, _writing (0)
 {
 }
 
 RTMidiBuffer::~RTMidiBuffer()
 {
-	cache_aligned_free (_data);
-	cache_aligned_free (_pool);
 }
 
 void
 RTMidiBuffer::resize (size_t size)
 {
-	if (_data && size < _capacity) {
+	assert (_writing);
+	_writing->resize (size);
+}
 
-		if (_size < size) {
+void
+RTMidiBuffer::Storage::resize (size_t sz)
+{
+	if (data && sz < capacity) {
+
+		if (size < sz) {
 			/* truncate */
-			_size = size;
+			size = sz;
 		}
 
 		return;
 	}
 
-	Item* old_data = _data;
+	Item* old_data = data;
 
-	cache_aligned_malloc ((void**) &_data, size * sizeof (Item));
+	cache_aligned_malloc ((void**) &data, sz * sizeof (Item));
 
-	if (_size) {
+	if (size) {
 		assert (old_data);
-		memcpy (_data, old_data, _size * sizeof (Item));
-		cache_aligned_free (old_data);
+		memcpy (data, old_data, size * sizeof (Item));
 	}
 
-	_capacity = size;
+	cache_aligned_free (old_data);
+
+	capacity = sz;
+}
+
+void
+RTMidiBuffer::Storage::copy (Storage const& other)
+{
+	if (capacity < other.size) {
+		cache_aligned_free (data);
+		cache_aligned_malloc ((void**) &data, other.size * sizeof (Item));
+		capacity = other.size;
+	}
+
+	if (other.size) {
+		memcpy (data, other.data, other.size * sizeof (Item));
+	}
+
+	if (pool_capacity < other.pool_size) {
+		/* in bytes, see alloc_blob() */
+		cache_aligned_free (pool);
+		cache_aligned_malloc ((void**) &pool, other.pool_capacity);
+		pool_capacity = other.pool_capacity;
+	}
+
+	if (other.pool_size) {
+		memcpy (pool, other.pool, other.pool_size);
+	}
+
+	if (index_capacity < other.index_size) {
+		cache_aligned_free (index);
+		cache_aligned_malloc ((void**) &index, other.index_size * sizeof (uint32_t));
+		index_capacity = other.index_size;
+	}
+
+	if (other.index_size) {
+		memcpy (index, other.index, other.index_size * sizeof (uint32_t));
+	}
+
+	size        = other.size;
+	pool_size   = other.pool_size;
+	reversed    = other.reversed;
+	index_size  = other.index_size;
+	index_shift = other.index_shift;
+	index_base  = other.index_base;
+	patched     = other.patched;
+	patch_seq   = other.patch_seq;
+	n_removed   = other.n_removed;
+}
+
+void
+RTMidiBuffer::Storage::build_index ()
+{
+	index_size = 0;
+
+	if (size == 0) {
+		return;
+	}
+
+	index_base = data[0].timestamp;
+
+	const samplecnt_t span = data[size - 1].timestamp - index_base;
+
+	/* about one bucket per event, but no less than 256 samples each */
+	index_shift = 8;
+	while ((span >> index_shift) > (samplecnt_t) size) {
+		++index_shift;
+	}
+
+	const size_t n_buckets = (span >> index_shift) + 1;
+
+	if (index_capacity < n_buckets + 1) {
+		cache_aligned_free (index);
+		cache_aligned_malloc ((void**) &index, (n_buckets + 1) * sizeof (uint32_t));
+		index_capacity = n_buckets + 1;
+	}
+
+	size_t n = 0;
+
+	for (size_t b = 0; b < n_buckets; ++b) {
+		const samplepos_t t = index_base + ((samplepos_t) b << index_shift);
+		while (n < size && data[n].timestamp < t) {
+			++n;
+		}
+		index[b] = n;
+	}
+
+	/* sentinel, the end of the last bucket */
+	index[n_buckets] = size;
+	index_size = n_buckets + 1;
+}
+
+size_t
+RTMidiBuffer::size () const
+{
+	return active ().n_events ();
 }
 
 bool
 RTMidiBuffer::reversed () const
 {
-	return _reversed;
+	return active ().reversed;
+}
+
+void
+RTMidiBuffer::begin_write ()
+{
+	/* wait for a reader that may still use the copy from before the last swap */
+	_writing = &inactive ();
+	_writing->lock.writer_lock ();
+}
+
+void
+RTMidiBuffer::end_write ()
+{
+	Storage* written = _writing;
+
+	_writing = 0;
+	written->build_index ();
+	written->lock.writer_unlock ();
+
+	publish ();
+
+	Glib::Threads::RWLock::WriterLock lm (inactive ().lock);
+	inactive ().copy (*written);
+}
+
+void
+RTMidiBuffer::publish ()
+{
+	/* caller holds _write_lock */
+	g_atomic_int_set (&_active, !g_atomic_int_get (&_active));
 }
 
 void
 RTMidiBuffer::reverse ()
 {
-	if (_size == 0) {
+	Glib::Threads::Mutex::Lock lm (_write_lock);
+
+	if (active ().size == 0) {
+		return;
+	}
+
+	{
+		Glib::Threads::RWLock::WriterLock wl (inactive ().lock);
+		inactive ().reverse ();
+	}
+
+	publish ();
+
+	Glib::Threads::RWLock::WriterLock wl (inactive ().lock);
+	inactive ().reverse ();
+}
+
+void
+RTMidiBuffer::Storage::reverse ()
+{
+	/* reversed events are not patched, see patch() */
+	compact ();
+
+	if (size == 0) {
 		return;
 	}
 
@@ -99,20 +290,20 @@ RTMidiBuffer::reverse ()
 
 	memset (previous_note_on, 0, sizeof (Item*) * 16 * 128);
 
-	if (_reversed) {
-		i = _size - 1;
+	if (reversed) {
+		i = size - 1;
 	} else {
 		i = 0;
 	}
 
 	/* iterate from start to end, or end-to-start, depending on current
-	 * _reversed status. Find each note on, and swap it with the relevant
+	 * reversed status. Find each note on, and swap it with the relevant
 	 * note off.
 	 */
 
-	while ((_reversed && (i >= 0)) || (!_reversed && (i < (int32_t) _size))) {
+	while ((reversed && (i >= 0)) || (!reversed && (i < (int32_t) size))) {
 
-		Item* item = &_data[i];
+		Item* item = &data[i];
 
 		if (!item->bytes[0]) {
 			/* event is 3 bytes or less, so regular MIDI data */
@@ -141,33 +332,40 @@ RTMidiBuffer::reverse ()
 			}
 		}
 
-		if (_reversed) {
+		if (reversed) {
 			--i;
 		} else {
 			++i;
 		}
 	}
 
-	_reversed = !_reversed;
+	reversed = !reversed;
 }
 
 void
 RTMidiBuffer::dump (uint32_t cnt)
 {
-	cerr << this << " total items: " << _size << " within " << _capacity << " blob pool: " << _pool_capacity << " used " << _pool_size << endl;
+	Storage const& s (active ());
 
-	for (uint32_t i = 0; i < _size && i < cnt; ++i) {
+	cerr << this << " total items: " << s.size << " within " << s.capacity << " blob pool: " << s.pool_capacity << " used " << s.pool_size
+	     << " patched: " << s.patched.size () << " removed: " << s.n_removed << endl;
 
-		Item* item = &_data[i];
+	for (uint32_t i = 0; i < s.size && i < cnt; ++i) {
+
+		Item* item = &s.data[i];
 		uint8_t* addr;
 		uint32_t size;
 
+		if (item_removed (*item)) {
+			continue;
+		}
+
 		if (item->bytes[0]) {
 
 			/* more than 3 bytes ... indirect */
 
 			uint32_t offset = item->offset & ~(1<<(CHAR_BIT-1));
-			Blob* blob = reinterpret_cast<Blob*> (&_pool[offset]);
+			Blob* blob = reinterpret_cast<Blob*> (&s.pool[offset]);
 
 			size = blob->size;
 			addr = blob->data;
@@ -195,44 +393,61 @@ RTMidiBuffer::write (TimeType time, Evoral::EventType /*type*/, uint32_t size, c
 {
 	/* This buffer stores only MIDI, we don't care about the value of "type" */
 
-	if (_size == _capacity) {
-		resize (_capacity + 1024); // XXX 1024 is completely arbitrary
-	}
+	assert (_writing);
 
-	_data[_size].timestamp = time;
+	Storage& s (*_writing);
+
+	if (s.size == s.capacity) {
+		s.resize (s.capacity + 1024); // XXX 1024 is completely arbitrary
+	}
 
 	if (size > 3) {
 
-		uint32_t off = store_blob (size, buf);
+		s.data[s.size].timestamp = time;
+
+		uint32_t off = s.store_blob (size, buf);
 
 		/* non-zero MSbit indicates that the data (more than 3 bytes) is not inline */
-		_data[_size].offset = (off | (1<<(CHAR_BIT-1)));
+		s.data[s.size].offset = (off | (1<<(CHAR_BIT-1)));
 
 	} else {
 
 		assert ((int) size == Evoral::midi_event_size (buf[0]));
 
 		/* zero MSbit indicates that the data (up to 3 bytes) is inline */
-		_data[_size].bytes[0] = 0;
-
-		switch (size) {
-		case 3:
-			_data[_size].bytes[3] = buf[2];
-			/* fallthru */
-		case 2:
-			_data[_size].bytes[2] = buf[1];
-			/* fallthru */
-		case 1:
-			_data[_size].bytes[1] = buf[0];
-			break;
-		}
+		s.data[s.size] = make_item (time, buf, size);
 	}
 
-	++_size;
+	++s.size;
 
 	return size;
 }
 
+RTMidiBuffer::Item
+RTMidiBuffer::make_item (samplepos_t time, uint8_t const* buf, uint32_t size)
+{
+	assert (size <= 3);
+
+	Item item;
+
+	item.timestamp = time;
+	item.offset    = 0;
+
+	switch (size) {
+	case 3:
+		item.bytes[3] = buf[2];
+		/* fallthru */
+	case 2:
+		item.bytes[2] = buf[1];
+		/* fallthru */
+	case 1:
+		item.bytes[1] = buf[0];
+		break;
+	}
+
+	return item;
+}
+
 /* These (non-matching) comparison arguments weren't supported prior to C99 !!!
 static
 bool
@@ -248,32 +463,326 @@ item_item_earlier (ARDOUR::RTMidiBuffer::Item const & item, ARDOUR::RTMidiBuffer
 	return item.timestamp < other.timestamp;
 }
 
+/** @return true if both items hold the same inline (up to 3 bytes) event */
+static
+bool
+item_same_event (ARDOUR::RTMidiBuffer::Item const & item, ARDOUR::RTMidiBuffer::Item const & other)
+{
+	if (item.bytes[0] || other.bytes[0] || item.bytes[1] != other.bytes[1]) {
+		return false;
+	}
+
+	const int size = Evoral::midi_event_size (item.bytes[1]);
+
+	return size > 0 && size <= 3 && memcmp (&item.bytes[1], &other.bytes[1], size) == 0;
+}
+
+bool
+RTMidiBuffer::patch (std::vector<Item> const& remove, std::vector<Item> const& insert)
+{
+	Glib::Threads::Mutex::Lock lm (_write_lock, Glib::Threads::TRY_LOCK);
+
+	if (!lm.locked ()) {
+		/* a render is in progress, which may or may not include the
+		 * change; let the caller render again.
+		 */
+		return false;
+	}
+
+	{
+		Glib::Threads::RWLock::WriterLock wl (inactive ().lock);
+
+		if (!inactive ().patch (remove, insert)) {
+			inactive ().copy (active ());
+			return false;
+		}
+	}
+
+	publish ();
+
+	/* same content, same result */
+	Glib::Threads::RWLock::WriterLock wl (inactive ().lock);
+	inactive ().patch (remove, insert);
+
+	return true;
+}
+
+bool
+RTMidiBuffer::Storage::patch (std::vector<Item> const& remove, std::vector<Item> const& insert)
+{
+	if (reversed) {
+		return false;
+	}
+
+	/* binary search for the position, then mark the event as removed, or
+	 * add it to the patched events. The main store is not moved until
+	 * there are many of those.
+	 */
+
+	for (std::vector<Item>::const_iterator r = remove.begin (); r != remove.end (); ++r) {
+
+		Item* iend = data + size;
+		Item* item = std::lower_bound (data, iend, *r, item_item_earlier);
+
+		while (item != iend && item->timestamp == r->timestamp && !item_same_event (*item, *r)) {
+			++item;
+		}
+
+		if (item != iend && item->timestamp == r->timestamp) {
+			/* no status byte, see item_removed() */
+			item->bytes[1] = 0;
+			++n_removed;
+			continue;
+		}
+
+		Patched::iterator p = patched.lower_bound (std::make_pair (r->timestamp, std::numeric_limits<int64_t>::min ()));
+
+		while (p != patched.end () && p->first.first == r->timestamp && !item_same_event (p->second, *r)) {
+			++p;
+		}
+
+		if (p == patched.end () || p->first.first != r->timestamp) {
+			return false;
+		}
+
+		patched.erase (p);
+	}
+
+	for (std::vector<Item>::const_iterator i = insert.begin (); i != insert.end (); ++i) {
+
+		const uint8_t status = i->bytes[1] & 0xf0;
+		const bool    off    = status == MIDI_CMD_NOTE_OFF || (status == MIDI_CMD_NOTE_ON && i->bytes[3] == 0);
+
+		if (!off && status == MIDI_CMD_NOTE_ON && contains (*i)) {
+			/* the note is already there, the change was applied before */
+			return false;
+		}
+
+		/* note-offs go before the events with the same timestamp
+		 * (including earlier patched ones), all other events after.
+		 */
+		++patch_seq;
+		patched.insert (std::make_pair (std::make_pair (i->timestamp, off ? -patch_seq : patch_seq), *i));
+	}
+
+	if (patched.size () + n_removed > std::max<size_t> (1024, size / 16)) {
+		/* often enough that reads stay fast, rarely enough that it
+		 * does not add up to a render.
+		 */
+		compact ();
+	}
+
+	return true;
+}
+
+/** @return true if the inline event @param item is present */
+bool
+RTMidiBuffer::Storage::contains (Item const& item) const
+{
+	Item const* ibegin = data;
+	Item const* iend   = data + size;
+
+	for (Item const* other = std::lower_bound (ibegin, iend, item, item_item_earlier); other != iend && other->timestamp == item.timestamp; ++other) {
+		if (item_same_event (*other, item)) {
+			return true;
+		}
+	}
+
+	for (Patched::const_iterator p = patched.lower_bound (std::make_pair (item.timestamp, std::numeric_limits<int64_t>::min ())); p != patched.end () && p->first.first == item.timestamp; ++p) {
+		if (item_same_event (p->second, item)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/** Merge the patched events into the main store, and drop the removed ones */
+void
+RTMidiBuffer::Storage::compact ()
+{
+	if (patched.empty () && n_removed == 0) {
+		return;
+	}
+
+	const size_t n = n_events ();
+	Item*        merged;
+
+	cache_aligned_malloc ((void**) &merged, std::max<size_t> (n, 1) * sizeof (Item));
+
+	Item*                   out = merged;
+	Patched::const_iterator p   = patched.begin ();
+
+	for (size_t i = 0; i < size; ++i) {
+		if (item_removed (data[i])) {
+			continue;
+		}
+		while (p != patched.end () && (p->first.first < data[i].timestamp || (p->first.first == data[i].timestamp && patched_first (p->first)))) {
+			*out++ = p->second;
+			++p;
+		}
+		*out++ = data[i];
+	}
+
+	for (; p != patched.end (); ++p) {
+		*out++ = p->second;
+	}
+
+	assert ((size_t) (out - merged) == n);
+
+	cache_aligned_free (data);
+
+	data      = merged;
+	size      = n;
+	capacity  = std::max<size_t> (n, 1);
+	n_removed = 0;
+	patched.clear ();
+
+	build_index ();
+}
+
+/** @return the first Item at or after @param t */
+RTMidiBuffer::Item*
+RTMidiBuffer::Storage::lower_bound (samplepos_t t) const
+{
+	Item foo;
+	foo.timestamp = t;
+
+	if (index_size == 0) {
+		return std::lower_bound (data, data + size, foo, item_item_earlier);
+	}
+
+	if (t <= index_base) {
+		return data;
+	}
+
+	const samplepos_t b = (t - index_base) >> index_shift;
+
+	if (b >= (samplepos_t) index_size - 1) {
+		return data + size;
+	}
+
+	/* the Item is in bucket b, or it is the first of the next one */
+	return std::lower_bound (data + index[b], data + index[b + 1], foo, item_item_earlier);
+}
+
+/** @return the first Item after @param t */
+RTMidiBuffer::Item*
+RTMidiBuffer::Storage::upper_bound (samplepos_t t) const
+{
+	Item foo;
+	foo.timestamp = t;
+
+	if (index_size == 0) {
+		return std::upper_bound (data, data + size, foo, item_item_earlier);
+	}
+
+	if (t < index_base) {
+		return data;
+	}
+
+	const samplepos_t b = (t - index_base) >> index_shift;
+
+	if (b >= (samplepos_t) index_size - 1) {
+		return data + size;
+	}
+
+	return std::upper_bound (data + index[b], data + index[b + 1], foo, item_item_earlier);
+}
+
 uint32_t
 RTMidiBuffer::read (MidiBuffer& dst, samplepos_t start, samplepos_t end, MidiStateTracker& tracker, samplecnt_t offset)
 {
-	Glib::Threads::RWLock::ReaderLock lm (_lock, Glib::Threads::TRY_LOCK);
+	int n = g_atomic_int_get (&_active);
+
+	/* The writer holds one copy at a time. If this one was swapped out
+	 * and is being updated since we looked, the other one is complete:
+	 * the current one, or the previous one until the writer gets to it
+	 * (which is what was played until now). Only if the writer moved on
+	 * in the meantime, try again.
+	 */
+	for (int attempt = 0; attempt < 3; ++attempt, n = !n) {
+
+		Storage& s (_storage[n]);
+
+		if (s.lock.reader_trylock ()) {
+			const uint32_t rv = s.read (dst, start, end, tracker, offset);
+			s.lock.reader_unlock ();
+			return rv;
+		}
+	}
+
+	return 0;
+}
+
+uint32_t
+RTMidiBuffer::Storage::read (MidiBuffer& dst, samplepos_t start, samplepos_t end, MidiStateTracker& tracker, samplecnt_t offset)
+{
+	if (patched.empty () || start >= end) {
+		/* reversed events are never patched */
+		return read_unpatched (dst, start, end, tracker, offset);
+	}
+
+	/* interleave the patched events with the main store, in the same
+	 * order as compact()
+	 */
+
+	uint32_t    count = 0;
+	samplepos_t pos   = start;
+
+	Patched::const_iterator p = patched.lower_bound (std::make_pair (start, std::numeric_limits<int64_t>::min ()));
+
+	for (; p != patched.end () && p->first.first < end; ++p) {
+
+		const samplepos_t until = patched_first (p->first) ? p->first.first : p->first.first + 1;
+
+		if (pos < until) {
+			count += read_unpatched (dst, pos, until, tracker, offset + pos - start);
+			pos    = until;
+		}
+
+		Item const& item (p->second);
+		const int   sz = Evoral::midi_event_size (item.bytes[1]);
+
+		if (!dst.push_back (item.timestamp - start + offset, Evoral::MIDI_EVENT, sz, &item.bytes[1])) {
+			DEBUG_TRACE (DEBUG::MidiRingBuffer, string_compose ("MidiRingBuffer: overflow in destination MIDI buffer, stopped after %1 events, dst size = %2\n", count, dst.size()));
+			return count;
+		}
+
+		tracker.track (&item.bytes[1]);
+		++count;
+	}
+
+	if (pos < end) {
+		count += read_unpatched (dst, pos, end, tracker, offset + pos - start);
+	}
+
+	return count;
+}
 
-	if (!lm.locked()) {
+uint32_t
+RTMidiBuffer::Storage::read_unpatched (MidiBuffer& dst, samplepos_t start, samplepos_t end, MidiStateTracker& tracker, samplecnt_t offset)
+{
+	if (size == 0) {
 		return 0;
 	}
 
 	bool reverse;
-	Item foo;
 	Item* iend;
 	Item* item;
 
 	uint32_t count = 0;
-	foo.timestamp = start;
+	bool one_by_one = false;
 
 	if (start < end) {
-		iend = _data+_size;
-		item = lower_bound (_data, iend, foo, item_item_earlier);
+		iend = data+size;
+		item = lower_bound (start);
 		reverse = false;
 	} else {
-		iend = _data;
+		iend = data;
 		--iend; /* yes, this is technically "illegal" but we will never indirect */
-		Item* uend = _data+_size;
-		item = upper_bound (_data, uend, foo, item_item_earlier);
+		Item* uend = data+size;
+		item = upper_bound (start);
 
 		if (item == uend) {
 			--item;
@@ -281,17 +790,70 @@ RTMidiBuffer::read (MidiBuffer& dst, samplepos_t start, samplepos_t end, MidiSta
 
 		reverse = true;
 	}
-
 #ifndef NDEBUG
 	TimeType unadjusted_time;
-	Item* last = &_data[_size-1];
+	Item* last = &data[size-1];
 #endif
 
-	DEBUG_TRACE (DEBUG::MidiRingBuffer, string_compose ("read from %1 .. %2 .. initial index = %3 (time = %4) (range in list of  %7 %5..%6)\n", start, end, item - _data, item->timestamp, _data->timestamp, last->timestamp, _size));
+	DEBUG_TRACE (DEBUG::MidiRingBuffer, string_compose ("read from %1 .. %2 .. initial index = %3 (time = %4) (range in list of  %7 %5..%6)\n", start, end, item - data, item->timestamp, data->timestamp, last->timestamp, size));
 	// dump (999);
 
 	while ((item != iend) && ((reverse && (item->timestamp > end)) || (!reverse && (item->timestamp < end)))) {
 
+		if (item_removed (*item)) {
+			if (reverse) {
+				--item;
+			} else {
+				++item;
+			}
+			continue;
+		}
+
+		if (!reverse && !one_by_one && !item->bytes[0] && item->timestamp >= start) {
+
+			/* A run of events of up to 3 bytes (e.g. dense CC data):
+			 * make space for all of them at once, and write them
+			 * without checking each one.
+			 */
+
+			Item*  run   = item;
+			size_t bytes = 0;
+
+			for (; run != iend && run->timestamp < end && !run->bytes[0] && !item_removed (*run); ++run) {
+				const int sz = Evoral::midi_event_size (run->bytes[1]);
+				if (sz <= 0) {
+					break;
+				}
+				bytes += MidiBuffer::record_size (sz);
+			}
+
+			uint8_t* loc = run != item ? dst.reserve_records (bytes) : 0;
+
+			if (loc) {
+
+				count += run - item;
+
+				for (; item != run; ++item) {
+					const int sz = Evoral::midi_event_size (item->bytes[1]);
+
+					*(reinterpret_cast<MidiBuffer::TimeType*> ((uintptr_t) loc)) = item->timestamp - start + offset;
+					*(reinterpret_cast<Evoral::EventType*> ((uintptr_t) (loc + sizeof (MidiBuffer::TimeType)))) = Evoral::MIDI_EVENT;
+					memcpy (loc + sizeof (MidiBuffer::TimeType) + sizeof (Evoral::EventType), &item->bytes[1], sz);
+
+					loc += MidiBuffer::record_size (sz);
+
+					tracker.track (&item->bytes[1]);
+				}
+
+				continue;
+			}
+
+			/* not enough space for all of them, go on one by one
+			 * until the destination is full.
+			 */
+			one_by_one = true;
+		}
+
 		TimeType evtime = item->timestamp;
 
 #ifndef NDEBUG
@@ -317,7 +879,7 @@ RTMidiBuffer::read (MidiBuffer& dst, samplepos_t start, samplepos_t end, MidiSta
 
 		evtime += offset;
 
-		uint32_t size;
+		uint32_t sz;
 		uint8_t* addr;
 
 		if (item->bytes[0]) {
@@ -325,29 +887,29 @@ RTMidiBuffer::read (MidiBuffer& dst, samplepos_t start, samplepos_t end, MidiSta
 			/* more than 3 bytes ... indirect */
 
 			uint32_t offset = item->offset & ~(1<<(CHAR_BIT-1));
-			Blob* blob = reinterpret_cast<Blob*> (&_pool[offset]);
+			Blob* blob = reinterpret_cast<Blob*> (&pool[offset]);
 
-			size = blob->size;
+			sz = blob->size;
 			addr = blob->data;
 
 		} else {
 
-			size = Evoral::midi_event_size (item->bytes[1]);
+			sz = Evoral::midi_event_size (item->bytes[1]);
 			addr = &item->bytes[1];
 
 		}
 
-		if (!dst.push_back (evtime, Evoral::MIDI_EVENT, size, addr)) {
+		if (!dst.push_back (evtime, Evoral::MIDI_EVENT, sz, addr)) {
 			DEBUG_TRACE (DEBUG::MidiRingBuffer, string_compose ("MidiRingBuffer: overflow in destination MIDI buffer, stopped after %1 events, dst size = %2\n", count, dst.size()));
 			break;
 		}
 
-		DEBUG_TRACE (DEBUG::MidiRingBuffer, string_compose ("read event sz %1 @ %2 (=> %3 via -%4 +%5\n", size, unadjusted_time, evtime, start, offset));
+		DEBUG_TRACE (DEBUG::MidiRingBuffer, string_compose ("read event sz %1 @ %2 (=> %3 via -%4 +%5\n", sz, unadjusted_time, evtime, start, offset));
 
 #if 0
-		cerr << "\tevent @ " << unadjusted_time << " evtime " << evtime << " off " << offset << " sz=" << size << '\t';
+		cerr << "\tevent @ " << unadjusted_time << " evtime " << evtime << " off " << offset << " sz=" << sz << '\t';
 		cerr << "\t0x" << hex << (int)addr[0] << dec << ' ';
-		for (size_t j = 1 ; j < size; ++j) {
+		for (size_t j = 1 ; j < sz; ++j) {
 			cerr << "0x" << hex << (int)addr[j] << dec << '/' << (int)addr[j] << ' ';
 		}
 		cerr << '\n';
@@ -368,37 +930,41 @@ RTMidiBuffer::read (MidiBuffer& dst, samplepos_t start, samplepos_t end, MidiSta
 }
 
 uint32_t
-RTMidiBuffer::alloc_blob (uint32_t size)
+RTMidiBuffer::Storage::alloc_blob (uint32_t sz)
 {
-	if (_pool_size + size > _pool_capacity) {
-		uint8_t* old_pool = _pool;
+	/* pool_size and pool_capacity are in bytes */
+
+	if (pool_size + sz > pool_capacity) {
+		uint8_t* old_pool = pool;
 
-		_pool_capacity += size * 4;
+		pool_capacity += sz * 4;
 
-		cache_aligned_malloc ((void **) &_pool, (_pool_capacity * sizeof (Blob)));
-		memcpy (_pool, old_pool, _pool_size * sizeof (Blob));
+		cache_aligned_malloc ((void **) &pool, pool_capacity);
+		if (pool_size) {
+			memcpy (pool, old_pool, pool_size);
+		}
 		cache_aligned_free (old_pool);
 	}
 
-	uint32_t offset = _pool_size;
+	uint32_t offset = pool_size;
 #if defined(__arm__) || defined(__aarch64_)
-		_pool_size += ((size - 1) | 3) + 1;
+		pool_size += ((sz - 1) | 3) + 1;
 #else
-		_pool_size += size;
+		pool_size += sz;
 #endif
 
 	return offset;
 }
 
 uint32_t
-RTMidiBuffer::store_blob (uint32_t size, uint8_t const * data)
+RTMidiBuffer::Storage::store_blob (uint32_t sz, uint8_t const * buf)
 {
-	uint32_t offset = alloc_blob (size);
-	uint8_t* addr = &_pool[offset];
+	uint32_t offset = alloc_blob (sizeof (Blob) + sz);
+	uint8_t* addr = &pool[offset];
 
-	*(reinterpret_cast<uint32_t*> (addr)) = size;
-	addr += sizeof (size);
-	memcpy (addr, data, size);
+	*(reinterpret_cast<uint32_t*> (addr)) = sz;
+	addr += sizeof (sz);
+	memcpy (addr, buf, sz);
 
 	return offset;
 }
@@ -406,10 +972,18 @@ RTMidiBuffer::store_blob (uint32_t size, uint8_t const * data)
 void
 RTMidiBuffer::clear ()
 {
+	assert (_writing);
+
 	/* mark main array as empty */
-	_size = 0;
+	_writing->size = 0;
 	/* free the entire current pool size, if any */
-	_pool_size = 0;
+	_writing->pool_size = 0;
 	/* rendering new data .. it will not be reversed */
-	_reversed = false;
+	_writing->reversed = false;
+	/* rebuilt when writing is complete */
+	_writing->index_size = 0;
+	/* the render includes all patches */
+	_writing->patched.clear ();
+	_writing->patch_seq = 0;
+	_writing->n_removed = 0;
 }
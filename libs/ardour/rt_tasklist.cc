@@ -16,6 +16,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <cstdio>
 #include <cstring>
 
 #include "pbd/pthread_utils.h"
@@ -23,6 +24,7 @@
 #include "ardour/audioengine.h"
 #include "ardour/debug.h"
 #include "ardour/rt_tasklist.h"
+#include "ardour/session_event.h"
 #include "ardour/utils.h"
 
 #include "pbd/i18n.h"
@@ -33,7 +35,10 @@ RTTaskList::RTTaskList ()
 	: _threads_active (0)
 	, _task_run_sem ("rt_task_run", 0)
 	, _task_end_sem ("rt_task_done", 0)
+	, _tasks (0)
+	, _n_tasks (0)
 {
+	g_atomic_int_set (&_next_task, 0);
 	reset_thread_list ();
 }
 
@@ -64,7 +69,15 @@ RTTaskList::drop_threads ()
 RTTaskList::_thread_run (void *arg)
 {
 	RTTaskList *d = static_cast<RTTaskList *>(arg);
-	pthread_set_name ("RTTaskList");
+
+	/* Tasks set controls (Session::rt_set_controls), which
+	 * emit signals to other threads' event loops */
+	char name[64];
+	snprintf (name, 64, "RTTaskList-%p", (void*)DEBUG_THREAD_SELF);
+	pthread_set_name (name);
+	SessionEvent::create_per_thread_pool (name, 64);
+	PBD::notify_event_loops_about_thread_creation (pthread_self (), name, 64);
+
 	d->run ();
 	pthread_exit (0);
 	return 0;
@@ -82,8 +95,9 @@ RTTaskList::reset_thread_list ()
 
 	Glib::Threads::Mutex::Lock pm (_process_mutex);
 
+	/* the thread calling ::process() handles tasks, too */
 	g_atomic_int_set (&_threads_active, 1);
-	for (uint32_t i = 0; i < num_threads; ++i) {
+	for (uint32_t i = 1; i < num_threads; ++i) {
 		pthread_t thread_id;
 		int rv = 1;
 		if (AudioEngine::instance()->is_realtime ()) {
@@ -104,76 +118,62 @@ RTTaskList::reset_thread_list ()
 void
 RTTaskList::run ()
 {
-	Glib::Threads::Mutex::Lock tm (_tasklist_mutex, Glib::Threads::NOT_LOCK);
-	bool wait = true;
-
 	while (true) {
-		if (wait) {
-			_task_run_sem.wait ();
-		}
+		_task_run_sem.wait ();
 
 		if (0 == g_atomic_int_get (&_threads_active)) {
 			_task_end_sem.signal ();
 			break;
 		}
 
-		wait = false;
-
-		boost::function<void ()> to_run;
-		tm.acquire ();
-		if (!_tasklist.empty ()) {
-			to_run = _tasklist.front();
-			_tasklist.pop_front ();
-		}
-		tm.release ();
-
-		if (!to_run.empty ()) {
-			to_run ();
-			continue;
-		}
-
-		if (!wait) {
-			_task_end_sem.signal ();
-		}
+		run_tasks ();
 
-		wait = true;
+		_task_end_sem.signal ();
 	}
 }
 
 void
-RTTaskList::process (TaskList const& tl)
+RTTaskList::run_tasks ()
 {
-	Glib::Threads::Mutex::Lock pm (_process_mutex);
-	Glib::Threads::Mutex::Lock tm (_tasklist_mutex, Glib::Threads::NOT_LOCK);
-
-	tm.acquire ();
-	_tasklist = tl;
-	tm.release ();
-
-	process_tasklist ();
-
-	tm.acquire ();
-	_tasklist.clear ();
-	tm.release ();
+	while (true) {
+		guint i = g_atomic_int_add (&_next_task, 1);
+		if (i >= _n_tasks) {
+			break;
+		}
+		_tasks[i] ();
+	}
 }
 
 void
-RTTaskList::process_tasklist ()
+RTTaskList::process (TaskList const& tl)
 {
-//	if (0 == g_atomic_int_get (&_threads_active) || _threads.size () == 0) {
+	Glib::Threads::Mutex::Lock pm (_process_mutex);
 
-		for (TaskList::iterator i = _tasklist.begin (); i != _tasklist.end(); ++i) {
+	if (0 == g_atomic_int_get (&_threads_active) || _threads.size () == 0 || tl.size () < 2) {
+		for (TaskList::const_iterator i = tl.begin (); i != tl.end(); ++i) {
 			(*i)();
 		}
 		return;
-//	}
+	}
+
+	_tasks   = &tl[0];
+	_n_tasks = tl.size ();
+	g_atomic_int_set (&_next_task, 0);
 
-	uint32_t nt = std::min (_threads.size (), _tasklist.size ());
+	/* wake up helper threads, the semaphore also publishes the tasks */
+	uint32_t nt = std::min (_threads.size (), tl.size () - 1);
 
 	for (uint32_t i = 0; i < nt; ++i) {
 		_task_run_sem.signal ();
 	}
+
+	run_tasks ();
+
+	/* wait for tasks that are still being processed by other threads */
 	for (uint32_t i = 0; i < nt; ++i) {
 		_task_end_sem.wait ();
 	}
+
+	_tasks   = 0;
+	_n_tasks = 0;
 }
@@ -99,6 +99,8 @@
 #include "ardour/recent_sessions.h"
 #include "ardour/region.h"
 #include "ardour/region_factory.h"
+#include "ardour/playback_lookahead.h"
+#include "ardour/render_cache.h"
 #include "ardour/revision.h"
 #include "ardour/route_graph.h"
 #include "ardour/route_group.h"
@@ -232,6 +234,8 @@ Session::Session (AudioEngine &eng,
 	, _current_snapshot_name (snapshot_name)
 	, state_tree (0)
 	, state_was_pending (false)
+	, _state_journal_saves (0)
+	, _state_cache_in_use (false)
 	, _state_of_the_state (StateOfTheState (CannotSave | InitialConnecting | Loading))
 	, _suspend_save (0)
 	, _save_queued (false)
@@ -244,6 +248,7 @@ Session::Session (AudioEngine &eng,
 	, lua (lua_newstate (&PBD::ReallocPool::lalloc, &_mempool))
 	, _n_lua_scripts (0)
 	, _butler (new Butler (*this))
+	, _render_cache_manager (new RenderCacheManager (*this))
 	, _transport_fsm (new TransportFSM (*this))
 	, _post_transport_work (0)
 	, _locations (new Locations (*this))
@@ -607,6 +612,9 @@ Session::destroy ()
 	/* stop auto dis/connecting */
 	auto_connect_thread_terminate ();
 
+	/* cancel background renders, the tracks are going away */
+	_render_cache_manager->stop ();
+
 	_engine.remove_session ();
 
 	/* deregister all ports - there will be no process or any other
@@ -636,6 +644,9 @@ Session::destroy ()
 	delete state_tree;
 	state_tree = 0;
 
+	_state_cache.clear ();
+	_state_cache_pending.clear ();
+
 	{
 		/* unregister all lua functions, drop held references (if any) */
 		Glib::Threads::Mutex::Lock tm (lua_lock, Glib::Threads::TRY_LOCK);
@@ -3936,6 +3947,15 @@ Session::get_routes_with_internal_returns() const
 	return rl;
 }
 
+void
+Session::reset_dsp_profiles ()
+{
+	boost::shared_ptr<RouteList> r = routes.reader ();
+	for (RouteList::iterator i = r->begin(); i != r->end(); ++i) {
+		(*i)->reset_dsp_profiles ();
+	}
+}
+
 bool
 Session::io_name_is_legal (const std::string& name) const
 {
@@ -5652,6 +5672,32 @@ Session::freeze_all (InterThreadInfo& itt)
 	return 0;
 }
 
+void
+Session::update_render_caches ()
+{
+	boost::shared_ptr<RouteList> rl = routes.reader ();
+
+	for (RouteList::iterator i = rl->begin (); i != rl->end (); ++i) {
+		boost::shared_ptr<RenderCache> rc = (*i)->render_cache ();
+		if (rc) {
+			rc->update ();
+		}
+	}
+}
+
+void
+Session::update_playback_lookaheads ()
+{
+	boost::shared_ptr<RouteList> rl = routes.reader ();
+
+	for (RouteList::iterator i = rl->begin (); i != rl->end (); ++i) {
+		boost::shared_ptr<PlaybackLookahead> pl = (*i)->playback_lookahead ();
+		if (pl) {
+			pl->update ();
+		}
+	}
+}
+
 struct MidiSourceLockMap
 {
 	boost::shared_ptr<MidiSource> src;
@@ -92,6 +92,9 @@ Session::memento_command_factory(XMLNode *n)
 
     if (type_name == "ARDOUR::AudioRegion" || type_name == "ARDOUR::MidiRegion" || type_name == "ARDOUR::Region") {
 	    boost::shared_ptr<Region> r = RegionFactory::region_by_id (id);
+	    if (!r && _playlists->load_deferred ()) {
+		    r = RegionFactory::region_by_id (id);
+	    }
 	    if (r) {
 		    return new MementoCommand<Region>(*r, before, after);
 	    }
@@ -127,6 +130,9 @@ Session::memento_command_factory(XMLNode *n)
     } else if (type_name == "Evoral::Curve" || type_name == "ARDOUR::AutomationList") {
 	    if (have_id) {
 		    std::map<PBD::ID, AutomationList*>::iterator i = automation_lists.find(id);
+		    if (i == automation_lists.end() && _playlists->load_deferred ()) {
+			    i = automation_lists.find(id);
+		    }
 		    if (i != automation_lists.end()) {
 			    return new MementoCommand<AutomationList>(*i->second, before, after);
 		    }
@@ -162,6 +168,10 @@ Session::stateful_diff_command_factory (XMLNode* n)
 
 	if ((type_name == "ARDOUR::AudioRegion" || type_name == "ARDOUR::MidiRegion")) {
 		boost::shared_ptr<Region> r = RegionFactory::region_by_id (id);
+		if (!r && _playlists->load_deferred ()) {
+			/* the region may be part of a playlist that was not loaded yet */
+			r = RegionFactory::region_by_id (id);
+		}
 		if (r) {
 			return new StatefulDiffCommand (r, *n);
 		}
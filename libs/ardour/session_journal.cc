@@ -0,0 +1,721 @@
+/*
+ * Copyright (C) 2026 The Ardour Team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/* Incremental session save.
+ *
+ * The session state is split into units: every route, playlist, source and
+ * (whole file) region is a unit of its own, the remaining top-level nodes
+ * of the session are one unit each, and so are the properties of the root
+ * node. After a complete save, the hash of every unit is kept in memory.
+ *
+ * An incremental save writes the units that differ from that base to
+ * <snapshot>.journal (or <snapshot>.pending for periodic safety backups),
+ * the session file itself is not touched. The journal always holds all
+ * changes relative to the base, so it is simply rewritten on every save.
+ * When the journal grows too large, a complete save is made instead, which
+ * removes the journal and becomes the new base.
+ *
+ * Every complete save tags the session file with a new "state-id", and a
+ * journal is only applied to the session file it was made for.
+ *
+ * Routes, playlists and sources are watched for changes from one complete
+ * save to the next (see arm_state_cache()). Objects that did not change
+ * since the base are neither serialized nor hashed by an incremental save,
+ * Session::state() only adds a placeholder, so a save costs O(changed
+ * objects) rather than O(session).
+ */
+
+#include <cerrno>
+#include <map>
+#include <set>
+
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+
+#include "pbd/error.h"
+#include "pbd/gstdio_compat.h"
+#include "pbd/string_convert.h"
+#include "pbd/xml++.h"
+
+#include "ardour/automation_control.h"
+#include "ardour/automation_list.h"
+#include "ardour/delivery.h"
+#include "ardour/filename_extensions.h"
+#include "ardour/io.h"
+#include "ardour/pannable.h"
+#include "ardour/panner_shell.h"
+#include "ardour/playlist.h"
+#include "ardour/plugin.h"
+#include "ardour/plugin_insert.h"
+#include "ardour/rc_configuration.h"
+#include "ardour/region.h"
+#include "ardour/session.h"
+#include "ardour/session_directory.h"
+#include "ardour/session_playlists.h"
+#include "ardour/track.h"
+#include "ardour/utils.h"
+
+#include "pbd/i18n.h"
+
+using namespace std;
+using namespace ARDOUR;
+using namespace PBD;
+
+namespace {
+
+/* journal a complete save when more than 1/N of all units changed ... */
+static const size_t   max_changed_fraction = 4;
+/* ... but always allow a few changes, even in small sessions */
+static const size_t   min_changed_units    = 16;
+/* journal at most this many times in a row, before compacting */
+static const uint32_t max_journal_saves    = 20;
+
+/** session nodes whose children are saved as separate units */
+static const char* split_containers[] = {
+	"Sources",
+	"Regions",
+	"Locations",
+	"Routes",
+	"Playlists",
+	"UnusedPlaylists",
+	0
+};
+
+struct StateUnit {
+	StateUnit () : node (0), hash (0), cached (false) {}
+	StateUnit (std::string const& c, XMLNode const* n, std::string const& i, uint64_t h, bool cc = false)
+		: container (c), name (n ? n->name () : ""), id (i), node (n), hash (h), cached (cc) {}
+
+	std::string    container; ///< name of the top-level node, empty for top-level units
+	std::string    name;      ///< node name
+	std::string    id;        ///< "id" property, or the index among equally named top-level nodes
+	XMLNode const* node;
+	uint64_t       hash;
+	bool           cached;    ///< placeholder for an unchanged object, hash is taken from the base
+};
+
+typedef std::map<std::string, StateUnit> StateUnits;
+
+static const uint64_t fnv_offset = 0xcbf29ce484222325ULL;
+
+static uint64_t
+fnv1a (uint64_t h, std::string const& s)
+{
+	for (std::string::const_iterator i = s.begin (); i != s.end (); ++i) {
+		h ^= (uint8_t) *i;
+		h *= 0x100000001b3ULL;
+	}
+	/* separate consecutive strings */
+	h ^= 0xff;
+	h *= 0x100000001b3ULL;
+	return h;
+}
+
+/* set by complete saves only, not part of the session's state */
+static const char* state_id_property = "state-id";
+
+/* marks the placeholder of an unchanged object, see Session::cached_state() */
+static const char* cached_state_property = "state-cached";
+
+static uint64_t
+hash_properties (uint64_t h, XMLNode const& node)
+{
+	XMLPropertyList const& props (node.properties ());
+	for (XMLPropertyConstIterator p = props.begin (); p != props.end (); ++p) {
+		if ((*p)->name () == state_id_property) {
+			continue;
+		}
+		h = fnv1a (h, (*p)->name ());
+		h = fnv1a (h, (*p)->value ());
+	}
+	return h;
+}
+
+static uint64_t
+hash_node (uint64_t h, XMLNode const& node)
+{
+	h = fnv1a (h, node.name ());
+	if (node.is_content ()) {
+		return fnv1a (h, node.content ());
+	}
+	h = hash_properties (h, node);
+	XMLNodeList const& children (node.children ());
+	for (XMLNodeConstIterator c = children.begin (); c != children.end (); ++c) {
+		h = hash_node (h, **c);
+	}
+	/* close the child list */
+	return fnv1a (h, std::string ());
+}
+
+static std::string
+unit_key (std::string const& container, std::string const& name, std::string const& id)
+{
+	return container + '\n' + name + '\n' + id;
+}
+
+static void
+add_unit (StateUnits& units, StateUnit const& u)
+{
+	units[unit_key (u.container, u.name, u.id)] = u;
+}
+
+/** Children of a split container are units, if they can be told apart by id */
+static bool
+can_split (XMLNode const& node)
+{
+	if (!node.properties ().empty ()) {
+		return false;
+	}
+
+	std::set<std::string> ids;
+	XMLNodeList const& children (node.children ());
+
+	for (XMLNodeConstIterator c = children.begin (); c != children.end (); ++c) {
+		XMLProperty const* prop = (*c)->property (X_("id"));
+		if (!prop || !ids.insert ((*c)->name () + '\n' + prop->value ()).second) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/** Split the given state into units.
+ * @param base hashes of the last complete save, used for placeholders of unchanged objects
+ */
+static void
+collect_state_units (XMLNode const& root, StateUnits& units, std::map<std::string, uint64_t> const* base = 0)
+{
+	add_unit (units, StateUnit ("", 0, "", hash_properties (fnv_offset, root)));
+
+	std::map<std::string, uint32_t> count;
+	XMLNodeList const& children (root.children ());
+
+	for (XMLNodeConstIterator i = children.begin (); i != children.end (); ++i) {
+		XMLNode const& node (**i);
+		uint32_t const n = count[node.name ()]++;
+
+		bool split = false;
+		if (n == 0 && root.children (node.name ()).size () == 1) {
+			for (char const** c = split_containers; *c; ++c) {
+				if (node.name () == *c) {
+					split = can_split (node);
+					break;
+				}
+			}
+		}
+
+		if (!split) {
+			add_unit (units, StateUnit ("", &node, PBD::to_string (n), hash_node (fnv_offset, node)));
+			continue;
+		}
+
+		/* a split container is only present, it has no state of its own */
+		add_unit (units, StateUnit ("", &node, "*", 0));
+
+		XMLNodeList const& items (node.children ());
+		for (XMLNodeConstIterator c = items.begin (); c != items.end (); ++c) {
+			std::string const id ((*c)->property (X_("id"))->value ());
+
+			if (!(*c)->property (cached_state_property)) {
+				add_unit (units, StateUnit (node.name (), *c, id, hash_node (fnv_offset, **c)));
+				continue;
+			}
+
+			std::map<std::string, uint64_t>::const_iterator b;
+			if (base && (b = base->find (unit_key (node.name (), (*c)->name (), id))) != base->end ()) {
+				add_unit (units, StateUnit (node.name (), *c, id, b->second, true));
+			} else {
+				add_unit (units, StateUnit (node.name (), *c, id, 0, true));
+			}
+		}
+	}
+}
+
+/** Find the node for a top-level unit, or a child of a split container */
+static XMLNode*
+find_unit_node (XMLNode& root, std::string const& container, std::string const& name, std::string const& id)
+{
+	if (container.empty ()) {
+		uint32_t index;
+		if (!PBD::string_to (id, index)) {
+			return 0;
+		}
+		XMLNodeList const& children (root.children ());
+		for (XMLNodeConstIterator i = children.begin (); i != children.end (); ++i) {
+			if ((*i)->name () == name && index-- == 0) {
+				return *i;
+			}
+		}
+		return 0;
+	}
+
+	XMLNode* parent = root.child (container.c_str ());
+	if (!parent) {
+		return 0;
+	}
+	XMLNodeList const& children (parent->children ());
+	for (XMLNodeConstIterator i = children.begin (); i != children.end (); ++i) {
+		if ((*i)->name () == name && (*i)->has_property_with_value (X_("id"), id)) {
+			return *i;
+		}
+	}
+	return 0;
+}
+
+static void
+mark_dirty (boost::shared_ptr<gint> const& dirty)
+{
+	g_atomic_int_set (dirty.get (), 1);
+}
+
+static void
+watch_controls (Automatable& a, ScopedConnectionList& c, boost::shared_ptr<gint> const& dirty)
+{
+	Automatable::Controls const& controls (a.controls ());
+
+	for (Automatable::Controls::const_iterator i = controls.begin (); i != controls.end (); ++i) {
+		boost::shared_ptr<AutomationControl> ac = boost::dynamic_pointer_cast<AutomationControl> (i->second);
+		if (!ac) {
+			continue;
+		}
+		ac->Changed.connect_same_thread (c, boost::bind (&mark_dirty, dirty));
+
+		boost::shared_ptr<AutomationList> al = ac->alist ();
+		if (al) {
+			al->Dirty.connect_same_thread (c, boost::bind (&mark_dirty, dirty));
+			al->StateChanged.connect_same_thread (c, boost::bind (&mark_dirty, dirty));
+			al->InterpolationChanged.connect_same_thread (c, boost::bind (&mark_dirty, dirty));
+			al->automation_state_changed.connect_same_thread (c, boost::bind (&mark_dirty, dirty));
+		}
+	}
+}
+
+static void
+watch_pannable (boost::shared_ptr<Pannable> p, ScopedConnectionList& c, boost::shared_ptr<gint> const& dirty)
+{
+	if (p) {
+		watch_controls (*p, c, dirty);
+		p->PropertyChanged.connect_same_thread (c, boost::bind (&mark_dirty, dirty));
+		p->automation_state_changed.connect_same_thread (c, boost::bind (&mark_dirty, dirty));
+	}
+}
+
+/** @param cacheable set to false if the processor has state which can change unnoticed */
+static void
+watch_processor (boost::weak_ptr<Processor> wp, ScopedConnectionList* c, boost::shared_ptr<gint> const& dirty, bool* cacheable)
+{
+	boost::shared_ptr<Processor> p = wp.lock ();
+	if (!p) {
+		return;
+	}
+
+	watch_controls (*p, *c, dirty);
+	p->PropertyChanged.connect_same_thread (*c, boost::bind (&mark_dirty, dirty));
+	p->ActiveChanged.connect_same_thread (*c, boost::bind (&mark_dirty, dirty));
+	p->ConfigurationChanged.connect_same_thread (*c, boost::bind (&mark_dirty, dirty));
+
+	boost::shared_ptr<Delivery> d = boost::dynamic_pointer_cast<Delivery> (p);
+	if (d && d->panner_shell ()) {
+		d->panner_shell ()->Changed.connect_same_thread (*c, boost::bind (&mark_dirty, dirty));
+		d->panner_shell ()->PannableChanged.connect_same_thread (*c, boost::bind (&mark_dirty, dirty));
+		watch_pannable (d->panner_shell ()->unlinked_pannable (), *c, dirty);
+	}
+
+	boost::shared_ptr<PluginInsert> pi = boost::dynamic_pointer_cast<PluginInsert> (p);
+	if (!pi) {
+		return;
+	}
+
+	pi->PluginMapChanged.connect_same_thread (*c, boost::bind (&mark_dirty, dirty));
+	pi->PluginConfigChanged.connect_same_thread (*c, boost::bind (&mark_dirty, dirty));
+
+	for (uint32_t n = 0; n < pi->get_count (); ++n) {
+		boost::shared_ptr<Plugin> plugin = pi->plugin (n);
+		if (plugin->has_editor ()) {
+			/* a plugin GUI can change state that is not exposed as parameter */
+			*cacheable = false;
+		}
+		plugin->PresetLoaded.connect_same_thread (*c, boost::bind (&mark_dirty, dirty));
+		plugin->PresetDirty.connect_same_thread (*c, boost::bind (&mark_dirty, dirty));
+		plugin->PropertyChanged.connect_same_thread (*c, boost::bind (&mark_dirty, dirty));
+		plugin->ParameterChangedExternally.connect_same_thread (*c, boost::bind (&mark_dirty, dirty));
+	}
+}
+
+/** @return false if the route cannot be cached */
+static bool
+watch_route (boost::shared_ptr<Route> r, ScopedConnectionList& c, boost::shared_ptr<gint> const& dirty)
+{
+	r->PropertyChanged.connect_same_thread (c, boost::bind (&mark_dirty, dirty));
+	r->presentation_info ().PropertyChanged.connect_same_thread (c, boost::bind (&mark_dirty, dirty));
+	r->processors_changed.connect_same_thread (c, boost::bind (&mark_dirty, dirty));
+	r->active_changed.connect_same_thread (c, boost::bind (&mark_dirty, dirty));
+	r->comment_changed.connect_same_thread (c, boost::bind (&mark_dirty, dirty));
+	r->denormal_protection_changed.connect_same_thread (c, boost::bind (&mark_dirty, dirty));
+	r->meter_change.connect_same_thread (c, boost::bind (&mark_dirty, dirty));
+	r->io_changed.connect_same_thread (c, boost::bind (&mark_dirty, dirty));
+	r->gui_changed.connect_same_thread (c, boost::bind (&mark_dirty, dirty));
+	r->input ()->changed.connect_same_thread (c, boost::bind (&mark_dirty, dirty));
+	r->output ()->changed.connect_same_thread (c, boost::bind (&mark_dirty, dirty));
+
+	watch_controls (*r, c, dirty);
+	watch_pannable (r->pannable (), c, dirty);
+
+	boost::shared_ptr<Track> t = boost::dynamic_pointer_cast<Track> (r);
+	if (t) {
+		t->PlaylistChanged.connect_same_thread (c, boost::bind (&mark_dirty, dirty));
+		t->FreezeChange.connect_same_thread (c, boost::bind (&mark_dirty, dirty));
+		t->AlignmentStyleChanged.connect_same_thread (c, boost::bind (&mark_dirty, dirty));
+	}
+
+	bool cacheable = true;
+	r->foreach_processor (boost::bind (&watch_processor, _1, &c, dirty, &cacheable));
+	return cacheable;
+}
+
+static void
+watch_region (boost::shared_ptr<Region> r, ScopedConnectionList* c, boost::shared_ptr<gint> const& dirty)
+{
+	r->PropertyChanged.connect_same_thread (*c, boost::bind (&mark_dirty, dirty));
+}
+
+static void
+watch_playlist (boost::shared_ptr<Playlist> p, ScopedConnectionList& c, boost::shared_ptr<gint> const& dirty)
+{
+	p->PropertyChanged.connect_same_thread (c, boost::bind (&mark_dirty, dirty));
+	p->ContentsChanged.connect_same_thread (c, boost::bind (&mark_dirty, dirty));
+	p->RegionAdded.connect_same_thread (c, boost::bind (&mark_dirty, dirty));
+	p->RegionRemoved.connect_same_thread (c, boost::bind (&mark_dirty, dirty));
+	p->NameChanged.connect_same_thread (c, boost::bind (&mark_dirty, dirty));
+	p->LayeringChanged.connect_same_thread (c, boost::bind (&mark_dirty, dirty));
+	/* the playlist's state includes the state of its regions */
+	p->foreach_region (boost::bind (&watch_region, _1, &c, dirty));
+}
+
+} // anonymous namespace
+
+/** Changes of an object since the last complete save */
+struct Session::StateCacheEntry {
+	StateCacheEntry () : dirty (new gint (0)) {}
+
+	boost::shared_ptr<gint>   dirty; ///< atomic, set by any change of the object
+	PBD::ScopedConnectionList connections;
+};
+
+/** Start watching routes, playlists and sources for changes. This is called
+ * before the state of a complete save is taken, so that changes made while
+ * saving are not missed. The result is used once set_state_journal_base()
+ * makes the save the base of incremental saves.
+ */
+void
+Session::arm_state_cache ()
+{
+	_state_cache_pending.clear ();
+
+	if (!Config->get_incremental_save ()) {
+		return;
+	}
+
+	boost::shared_ptr<RouteList> rl = routes.reader ();
+	for (RouteList::const_iterator i = rl->begin (); i != rl->end (); ++i) {
+		if ((*i)->is_auditioner ()) {
+			continue;
+		}
+		boost::shared_ptr<StateCacheEntry> e (new StateCacheEntry);
+		if (watch_route (*i, e->connections, e->dirty)) {
+			_state_cache_pending[(*i)->id ()] = e;
+		}
+	}
+
+	{
+		Glib::Threads::Mutex::Lock lm (_playlists->lock);
+		SessionPlaylists::List const* lists[] = { &_playlists->playlists, &_playlists->unused_playlists };
+		for (size_t n = 0; n < 2; ++n) {
+			for (SessionPlaylists::List::const_iterator i = lists[n]->begin (); i != lists[n]->end (); ++i) {
+				boost::shared_ptr<StateCacheEntry> e (new StateCacheEntry);
+				watch_playlist (*i, e->connections, e->dirty);
+				_state_cache_pending[(*i)->id ()] = e;
+			}
+		}
+	}
+
+	{
+		Glib::Threads::Mutex::Lock sl (source_lock);
+		for (SourceMap::const_iterator i = sources.begin (); i != sources.end (); ++i) {
+			if (i->second->writable ()) {
+				/* may still be written to, or be marked immutable */
+				continue;
+			}
+			boost::shared_ptr<StateCacheEntry> e (new StateCacheEntry);
+			i->second->PropertyChanged.connect_same_thread (e->connections, boost::bind (&mark_dirty, e->dirty));
+			_state_cache_pending[i->first] = e;
+		}
+	}
+}
+
+/** @return a placeholder for the state of the given object, if it did not
+ * change since the last complete save and the state cache is in use, 0 otherwise.
+ */
+XMLNode*
+Session::cached_state (PBD::Stateful const& s, char const* node_name) const
+{
+	if (!_state_cache_in_use) {
+		return 0;
+	}
+
+	StateCache::const_iterator i = _state_cache.find (s.id ());
+	if (i == _state_cache.end () || g_atomic_int_get (i->second->dirty.get ())) {
+		return 0;
+	}
+
+	XMLNode* node = new XMLNode (node_name);
+	node->set_property (X_("id"), s.id ());
+	node->set_property (cached_state_property, true);
+	return node;
+}
+
+/** Write the changes of the given state relative to the last complete save.
+ * @return 0 if the journal was written, 1 if a complete save is needed, -1 on error
+ */
+int
+Session::save_state_journal (XMLNode const& root, std::string const& snapshot_name, bool pending)
+{
+	if (_state_journal_base.empty () || snapshot_name != _current_snapshot_name) {
+		return 1;
+	}
+
+	if (!pending && _state_journal_saves >= max_journal_saves) {
+		return 1;
+	}
+
+	StateUnits units;
+	collect_state_units (root, units, &_state_journal_hashes);
+
+	XMLTree tree;
+	XMLNode* journal = new XMLNode (X_("SessionJournal"));
+	journal->set_property (X_("version"), 1);
+	journal->set_property (X_("base"), _state_journal_base);
+	tree.set_root (journal);
+
+	size_t changed = 0;
+
+	for (StateUnits::const_iterator i = units.begin (); i != units.end (); ++i) {
+		StateUnit const& u (i->second);
+		StateUnitHashes::const_iterator b = _state_journal_hashes.find (i->first);
+
+		if (u.container.empty () && b == _state_journal_hashes.end ()) {
+			/* top-level structure changed */
+			return 1;
+		}
+		if (u.cached && b == _state_journal_hashes.end ()) {
+			/* placeholder without a base, the object's state is needed */
+			return 1;
+		}
+		if (b != _state_journal_hashes.end () && b->second == u.hash) {
+			continue;
+		}
+
+		++changed;
+
+		if (!u.node) {
+			XMLNode* r = journal->add_child (X_("Root"));
+			XMLPropertyList const& props (root.properties ());
+			for (XMLPropertyConstIterator p = props.begin (); p != props.end (); ++p) {
+				if ((*p)->name () == state_id_property) {
+					continue;
+				}
+				r->set_property ((*p)->name ().c_str (), (*p)->value ());
+			}
+			continue;
+		}
+
+		XMLNode* n = journal->add_child (X_("Unit"));
+		n->set_property (X_("container"), u.container);
+		n->set_property (X_("id"), u.id);
+		n->add_child_copy (*u.node);
+	}
+
+	for (StateUnitHashes::const_iterator b = _state_journal_hashes.begin (); b != _state_journal_hashes.end (); ++b) {
+		if (units.find (b->first) != units.end ()) {
+			continue;
+		}
+
+		std::string::size_type const s1 = b->first.find ('\n');
+		std::string::size_type const s2 = b->first.find ('\n', s1 + 1);
+		std::string const container (b->first.substr (0, s1));
+
+		if (container.empty ()) {
+			return 1;
+		}
+
+		++changed;
+
+		XMLNode* n = journal->add_child (X_("Removed"));
+		n->set_property (X_("container"), container);
+		n->set_property (X_("name"), b->first.substr (s1 + 1, s2 - s1 - 1));
+		n->set_property (X_("id"), b->first.substr (s2 + 1));
+	}
+
+	if (changed > std::max (min_changed_units, units.size () / max_changed_fraction)) {
+		return 1;
+	}
+
+	const std::string base_path (Glib::build_filename (_session_dir->root_path (), legalize_for_path (snapshot_name)));
+	const std::string journal_path (base_path + (pending ? pending_suffix : journal_suffix));
+	const std::string tmp_path (base_path + temp_suffix);
+
+	if (changed == 0 && !pending) {
+		/* the session file is up to date, previous changes were reverted */
+		if (Glib::file_test (journal_path, Glib::FILE_TEST_EXISTS)) {
+			::g_remove (journal_path.c_str ());
+		}
+		return 0;
+	}
+
+	if (!tree.write (tmp_path)) {
+		error << string_compose (_("session journal could not be saved to %1"), tmp_path) << endmsg;
+		::g_remove (tmp_path.c_str ());
+		return -1;
+	}
+
+	if (::g_rename (tmp_path.c_str (), journal_path.c_str ()) != 0) {
+		error << string_compose (_("could not rename temporary session file %1 to %2 (%3)"),
+				tmp_path, journal_path, g_strerror (errno)) << endmsg;
+		::g_remove (tmp_path.c_str ());
+		return -1;
+	}
+
+	if (!pending) {
+		++_state_journal_saves;
+	}
+
+	return 0;
+}
+
+/** Remember the given state, as written by a complete save, as base for
+ * subsequent incremental saves.
+ */
+void
+Session::set_state_journal_base (XMLNode const& root)
+{
+	_state_journal_hashes.clear ();
+	_state_journal_base.clear ();
+	_state_journal_saves = 0;
+	_state_cache.clear ();
+
+	if (!Config->get_incremental_save () || !root.get_property (state_id_property, _state_journal_base)) {
+		_state_cache_pending.clear ();
+		return;
+	}
+
+	/* the objects watched since this state was taken */
+	_state_cache.swap (_state_cache_pending);
+
+	StateUnits units;
+	collect_state_units (root, units);
+
+	for (StateUnits::const_iterator i = units.begin (); i != units.end (); ++i) {
+		_state_journal_hashes[i->first] = i->second.hash;
+	}
+}
+
+bool
+Session::is_state_journal (std::string const& path)
+{
+	XMLTree tree;
+	return tree.read (path) && tree.root ()->name () == X_("SessionJournal");
+}
+
+/** Replay a journal written by save_state_journal() on the given session state */
+int
+Session::apply_state_journal (XMLNode& root, std::string const& path)
+{
+	XMLTree tree;
+
+	if (!tree.read (path) || tree.root ()->name () != X_("SessionJournal")) {
+		warning << string_compose (_("Ignoring unreadable session journal %1"), path) << endmsg;
+		return -1;
+	}
+
+	XMLNode const& journal (*tree.root ());
+
+	std::string base;
+	std::string state_id;
+	if (!journal.get_property (X_("base"), base) || !root.get_property (state_id_property, state_id) || base != state_id) {
+		warning << string_compose (_("Ignoring session journal %1, it does not belong to the session file"), path) << endmsg;
+		return -1;
+	}
+
+	XMLNodeList const& entries (journal.children ());
+
+	for (XMLNodeConstIterator i = entries.begin (); i != entries.end (); ++i) {
+		XMLNode const& e (**i);
+		std::string container;
+		std::string id;
+
+		if (e.name () == X_("Root")) {
+			std::vector<std::string> remove;
+			XMLPropertyList const& old_props (root.properties ());
+			for (XMLPropertyConstIterator p = old_props.begin (); p != old_props.end (); ++p) {
+				if (!e.property ((*p)->name ()) && (*p)->name () != state_id_property) {
+					remove.push_back ((*p)->name ());
+				}
+			}
+			for (std::vector<std::string>::const_iterator r = remove.begin (); r != remove.end (); ++r) {
+				root.remove_property (*r);
+			}
+			XMLPropertyList const& props (e.properties ());
+			for (XMLPropertyConstIterator p = props.begin (); p != props.end (); ++p) {
+				root.set_property ((*p)->name ().c_str (), (*p)->value ());
+			}
+			continue;
+		}
+
+		if (!e.get_property (X_("container"), container) || !e.get_property (X_("id"), id)) {
+			continue;
+		}
+
+		if (e.name () == X_("Unit")) {
+			if (e.children ().size () != 1) {
+				continue;
+			}
+			XMLNode const& node (*e.children ().front ());
+			XMLNode* old = find_unit_node (root, container, node.name (), id);
+			if (old) {
+				*old = node;
+			} else if (container.empty ()) {
+				root.add_child_copy (node);
+			} else {
+				XMLNode* parent = root.child (container.c_str ());
+				if (!parent) {
+					parent = root.add_child (container.c_str ());
+				}
+				parent->add_child_copy (node);
+			}
+		} else if (e.name () == X_("Removed")) {
+			std::string name;
+			XMLNode* parent = root.child (container.c_str ());
+			if (parent && e.get_property (X_("name"), name)) {
+				parent->remove_node_and_delete (name, X_("id"), id);
+			}
+		}
+	}
+
+	/* the state now matches what the journal was made from */
+	return 0;
+}
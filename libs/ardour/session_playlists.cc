@@ -35,10 +35,20 @@ using namespace std;
 using namespace PBD;
 using namespace ARDOUR;
 
+SessionPlaylists::SessionPlaylists ()
+	: deferred_session (0)
+{
+}
+
 SessionPlaylists::~SessionPlaylists ()
 {
 	DEBUG_TRACE (DEBUG::Destruction, "delete playlists\n");
 
+	for (DeferredList::iterator i = deferred_unused.begin(); i != deferred_unused.end(); ++i) {
+		delete *i;
+	}
+	deferred_unused.clear ();
+
 	for (List::iterator i = playlists.begin(); i != playlists.end(); ) {
 		SessionPlaylists::List::iterator tmp;
 
@@ -189,46 +199,58 @@ SessionPlaylists::n_playlists () const
 boost::shared_ptr<Playlist>
 SessionPlaylists::by_name (string name)
 {
-	Glib::Threads::Mutex::Lock lm (lock);
+	/* a deferred playlist is either still deferred, or already created */
+	Glib::Threads::RecMutex::Lock dl (deferred_lock);
 
-	for (List::iterator i = playlists.begin(); i != playlists.end(); ++i) {
-		if ((*i)->name() == name) {
-			return* i;
+	{
+		Glib::Threads::Mutex::Lock lm (lock);
+
+		for (List::iterator i = playlists.begin(); i != playlists.end(); ++i) {
+			if ((*i)->name() == name) {
+				return* i;
+			}
 		}
-	}
 
-	for (List::iterator i = unused_playlists.begin(); i != unused_playlists.end(); ++i) {
-		if ((*i)->name() == name) {
-			return* i;
+		for (List::iterator i = unused_playlists.begin(); i != unused_playlists.end(); ++i) {
+			if ((*i)->name() == name) {
+				return* i;
+			}
 		}
 	}
 
-	return boost::shared_ptr<Playlist>();
+	return load_deferred (X_("name"), name);
 }
 
 boost::shared_ptr<Playlist>
 SessionPlaylists::by_id (const PBD::ID& id)
 {
-	Glib::Threads::Mutex::Lock lm (lock);
+	/* a deferred playlist is either still deferred, or already created */
+	Glib::Threads::RecMutex::Lock dl (deferred_lock);
 
-	for (List::iterator i = playlists.begin(); i != playlists.end(); ++i) {
-		if ((*i)->id() == id) {
-			return* i;
+	{
+		Glib::Threads::Mutex::Lock lm (lock);
+
+		for (List::iterator i = playlists.begin(); i != playlists.end(); ++i) {
+			if ((*i)->id() == id) {
+				return* i;
+			}
 		}
-	}
 
-	for (List::iterator i = unused_playlists.begin(); i != unused_playlists.end(); ++i) {
-		if ((*i)->id() == id) {
-			return* i;
+		for (List::iterator i = unused_playlists.begin(); i != unused_playlists.end(); ++i) {
+			if ((*i)->id() == id) {
+				return* i;
+			}
 		}
 	}
 
-	return boost::shared_ptr<Playlist>();
+	return load_deferred (X_("id"), id.to_s ());
 }
 
 void
 SessionPlaylists::unassigned (std::list<boost::shared_ptr<Playlist> > & list)
 {
+	load_deferred ();
+
 	Glib::Threads::Mutex::Lock lm (lock);
 
 	for (List::iterator i = playlists.begin(); i != playlists.end(); ++i) {
@@ -247,6 +269,8 @@ SessionPlaylists::unassigned (std::list<boost::shared_ptr<Playlist> > & list)
 void
 SessionPlaylists::update_orig_2X (PBD::ID old_orig, PBD::ID new_orig)
 {
+	load_deferred ();
+
 	Glib::Threads::Mutex::Lock lm (lock);
 
 	for (List::iterator i = playlists.begin(); i != playlists.end(); ++i) {
@@ -265,6 +289,8 @@ SessionPlaylists::update_orig_2X (PBD::ID old_orig, PBD::ID new_orig)
 void
 SessionPlaylists::get (vector<boost::shared_ptr<Playlist> >& s) const
 {
+	load_deferred ();
+
 	Glib::Threads::Mutex::Lock lm (lock);
 
 	for (List::const_iterator i = playlists.begin(); i != playlists.end(); ++i) {
@@ -279,6 +305,8 @@ SessionPlaylists::get (vector<boost::shared_ptr<Playlist> >& s) const
 void
 SessionPlaylists::destroy_region (boost::shared_ptr<Region> r)
 {
+	load_deferred ();
+
 	Glib::Threads::Mutex::Lock lm (lock);
 
 	for (List::iterator i = playlists.begin(); i != playlists.end(); ++i) {
@@ -303,6 +331,8 @@ SessionPlaylists::find_equivalent_playlist_regions (boost::shared_ptr<Region> re
 uint32_t
 SessionPlaylists::source_use_count (boost::shared_ptr<const Source> src) const
 {
+	load_deferred ();
+
 	uint32_t count = 0;
 
 	/* XXXX this can go wildly wrong in the presence of circular references
@@ -339,6 +369,8 @@ SessionPlaylists::sync_all_regions_with_regions ()
 void
 SessionPlaylists::update_after_tempo_map_change ()
 {
+	load_deferred ();
+
 	for (List::iterator i = playlists.begin(); i != playlists.end(); ++i) {
 		(*i)->update_after_tempo_map_change ();
 	}
@@ -371,7 +403,7 @@ get_id_sorted_playlists (const List& playlists, IDSortedList& id_sorted_playlist
 } // anonymous namespace
 
 void
-SessionPlaylists::add_state (XMLNode* node, bool save_template, bool include_unused)
+SessionPlaylists::add_state (XMLNode* node, bool save_template, bool include_unused, boost::function<XMLNode* (PBD::Stateful const&)> cached_state)
 {
 	XMLNode* child = node->add_child ("Playlists");
 
@@ -380,8 +412,11 @@ SessionPlaylists::add_state (XMLNode* node, bool save_template, bool include_unu
 
 	for (IDSortedList::iterator i = id_sorted_playlists.begin (); i != id_sorted_playlists.end (); ++i) {
 		if (!(*i)->hidden ()) {
+			XMLNode* cached = 0;
 			if (save_template) {
 				child->add_child_nocopy ((*i)->get_template ());
+			} else if (cached_state && (cached = cached_state (**i)) != 0) {
+				child->add_child_nocopy (*cached);
 			} else {
 				child->add_child_nocopy ((*i)->get_state ());
 			}
@@ -392,6 +427,13 @@ SessionPlaylists::add_state (XMLNode* node, bool save_template, bool include_unu
 		return;
 	}
 
+	/* deferred playlists must not be created meanwhile */
+	Glib::Threads::RecMutex::Lock dl (deferred_lock);
+
+	if (save_template) {
+		load_deferred ();
+	}
+
 	child = node->add_child ("UnusedPlaylists");
 
 	IDSortedList id_sorted_unused_playlists;
@@ -401,20 +443,31 @@ SessionPlaylists::add_state (XMLNode* node, bool save_template, bool include_unu
 	     i != id_sorted_unused_playlists.end (); ++i) {
 		if (!(*i)->hidden()) {
 			if (!(*i)->empty()) {
+				XMLNode* cached = 0;
 				if (save_template) {
 					child->add_child_nocopy ((*i)->get_template());
+				} else if (cached_state && (cached = cached_state (**i)) != 0) {
+					child->add_child_nocopy (*cached);
 				} else {
 					child->add_child_nocopy ((*i)->get_state());
 				}
 			}
 		}
 	}
+
+	/* playlists that were never created are saved as they were loaded */
+	Glib::Threads::Mutex::Lock lm (lock);
+	for (DeferredList::const_iterator i = deferred_unused.begin(); i != deferred_unused.end(); ++i) {
+		child->add_child_copy (**i);
+	}
 }
 
 /** @return true for `stop cleanup', otherwise false */
 bool
 SessionPlaylists::maybe_delete_unused (boost::function<int(boost::shared_ptr<Playlist>)> ask)
 {
+	load_deferred ();
+
 	vector<boost::shared_ptr<Playlist> > playlists_tbd;
 
 	bool delete_remaining = false;
@@ -491,8 +544,11 @@ SessionPlaylists::load (Session& session, const XMLNode& node)
 	return 0;
 }
 
+/** @param defer keep the state of unused playlists, and only create them
+ * when they are needed.
+ */
 int
-SessionPlaylists::load_unused (Session& session, const XMLNode& node)
+SessionPlaylists::load_unused (Session& session, const XMLNode& node, bool defer)
 {
 	XMLNodeList nlist;
 	XMLNodeConstIterator niter;
@@ -502,6 +558,13 @@ SessionPlaylists::load_unused (Session& session, const XMLNode& node)
 
 	for (niter = nlist.begin(); niter != nlist.end(); ++niter) {
 
+		if (defer) {
+			Glib::Threads::Mutex::Lock lm (lock);
+			deferred_unused.push_back (new XMLNode (**niter));
+			deferred_session = &session;
+			continue;
+		}
+
 		if ((playlist = XMLPlaylistFactory (session, **niter)) == 0) {
 			error << _("Session: cannot create Playlist from XML description.") << endmsg;
 			continue;
@@ -515,6 +578,74 @@ SessionPlaylists::load_unused (Session& session, const XMLNode& node)
 	return 0;
 }
 
+bool
+SessionPlaylists::load_deferred () const
+{
+	Glib::Threads::RecMutex::Lock dl (deferred_lock);
+
+	DeferredList nodes;
+
+	{
+		Glib::Threads::Mutex::Lock lm (lock);
+		nodes.swap (deferred_unused);
+	}
+
+	if (nodes.empty ()) {
+		return false;
+	}
+
+	for (DeferredList::const_iterator i = nodes.begin(); i != nodes.end(); ++i) {
+		const_cast<SessionPlaylists*> (this)->load_deferred_node (**i);
+		delete *i;
+	}
+
+	return true;
+}
+
+/** Create the first unused playlist whose state has the given property value */
+boost::shared_ptr<Playlist>
+SessionPlaylists::load_deferred (const char* prop, std::string const& value)
+{
+	Glib::Threads::RecMutex::Lock dl (deferred_lock);
+
+	XMLNode* node = 0;
+
+	{
+		Glib::Threads::Mutex::Lock lm (lock);
+		for (DeferredList::iterator i = deferred_unused.begin(); i != deferred_unused.end(); ++i) {
+			if ((*i)->has_property_with_value (prop, value)) {
+				node = *i;
+				deferred_unused.erase (i);
+				break;
+			}
+		}
+	}
+
+	if (!node) {
+		return boost::shared_ptr<Playlist>();
+	}
+
+	boost::shared_ptr<Playlist> playlist = load_deferred_node (*node);
+	delete node;
+	return playlist;
+}
+
+boost::shared_ptr<Playlist>
+SessionPlaylists::load_deferred_node (XMLNode const& node)
+{
+	boost::shared_ptr<Playlist> playlist;
+
+	assert (deferred_session);
+
+	if ((playlist = XMLPlaylistFactory (*deferred_session, node)) == 0) {
+		error << _("Session: cannot create Playlist from XML description.") << endmsg;
+		return playlist;
+	}
+
+	track (false, boost::weak_ptr<Playlist> (playlist));
+	return playlist;
+}
+
 boost::shared_ptr<Playlist>
 SessionPlaylists::XMLPlaylistFactory (Session& session, const XMLNode& node)
 {
@@ -530,6 +661,8 @@ SessionPlaylists::XMLPlaylistFactory (Session& session, const XMLNode& node)
 boost::shared_ptr<Crossfade>
 SessionPlaylists::find_crossfade (const PBD::ID& id)
 {
+	load_deferred ();
+
 	Glib::Threads::Mutex::Lock lm (lock);
 
 	boost::shared_ptr<Crossfade> c;
@@ -554,6 +687,8 @@ SessionPlaylists::find_crossfade (const PBD::ID& id)
 uint32_t
 SessionPlaylists::region_use_count (boost::shared_ptr<Region> region) const
 {
+	load_deferred ();
+
 	Glib::Threads::Mutex::Lock lm (lock);
         uint32_t cnt = 0;
 
@@ -585,6 +720,8 @@ SessionPlaylists::get_used () const
 vector<boost::shared_ptr<Playlist> >
 SessionPlaylists::get_unused () const
 {
+	load_deferred ();
+
 	vector<boost::shared_ptr<Playlist> > pl;
 
 	Glib::Threads::Mutex::Lock lm (lock);
@@ -620,6 +757,10 @@ SessionPlaylists::playlists_for_track (boost::shared_ptr<Track> tr) const
 void
 SessionPlaylists::foreach (boost::function<void(boost::shared_ptr<const Playlist>)> functor, bool incl_unused)
 {
+	if (incl_unused) {
+		load_deferred ();
+	}
+
 	Glib::Threads::Mutex::Lock lm (lock);
 	for (List::iterator i = playlists.begin(); i != playlists.end(); i++) {
 		if (!(*i)->hidden()) {
@@ -25,7 +25,9 @@
 
 #include "ardour/monitor_control.h"
 #include "ardour/route.h"
+#include "ardour/rt_tasklist.h"
 #include "ardour/session.h"
+#include "ardour/slavable_automation_control.h"
 #include "ardour/track.h"
 #include "ardour/vca_manager.h"
 
@@ -48,7 +50,58 @@ Session::set_controls (boost::shared_ptr<ControlList> cl, double val, Controllab
 		(*ci)->pre_realtime_queue_stuff (val, gcd);
 	}
 
-	queue_event (get_rt_event (cl, val, gcd));
+	queue_event (get_rt_event (cl, rt_control_tasks (cl, val, gcd), val, gcd));
+}
+
+/** Build a task-list to set the controls in parallel from the process thread.
+ * This is done here, since allocating the list is not realtime-safe.
+ *
+ * Only controls whose change affects nothing but their own route are
+ * set in parallel. Solo is not, since solo-changes propagate to other
+ * routes (solo by upstream/downstream, implicit mute).
+ *
+ * @return task-list, or a null pointer if the controls are to be set sequentially
+ */
+boost::shared_ptr<RTTaskList::TaskList>
+Session::rt_control_tasks (boost::shared_ptr<ControlList> cl, double val, Controllable::GroupControlDisposition gcd) const
+{
+	/* below this, the synchronization overhead exceeds the work */
+	static const size_t min_parallel_controls = 16;
+
+	if (!_rt_tasklist || cl->size () < min_parallel_controls) {
+		return boost::shared_ptr<RTTaskList::TaskList> ();
+	}
+
+	/* do not fan out into control groups from concurrent threads */
+	if (gcd != Controllable::NoGroup && gcd != Controllable::ForGroup) {
+		return boost::shared_ptr<RTTaskList::TaskList> ();
+	}
+
+	switch (cl->front()->parameter().type()) {
+	case MuteAutomation:
+	case PhaseAutomation:
+	case MonitoringAutomation:
+	case RecEnableAutomation:
+	case RecSafeAutomation:
+		break;
+	default:
+		return boost::shared_ptr<RTTaskList::TaskList> ();
+	}
+
+	boost::shared_ptr<RTTaskList::TaskList> tasks (new RTTaskList::TaskList);
+	tasks->reserve (cl->size ());
+
+	for (ControlList::const_iterator c = cl->begin(); c != cl->end(); ++c) {
+		boost::shared_ptr<SlavableAutomationControl> sc = boost::dynamic_pointer_cast<SlavableAutomationControl> (*c);
+		if (sc && sc->slaved ()) {
+			/* masters are shared among routes */
+			return boost::shared_ptr<RTTaskList::TaskList> ();
+		}
+		/* cl is kept alive by the event, which holds a reference to the list */
+		tasks->push_back (boost::bind (&AutomationControl::set_value, c->get (), val, gcd));
+	}
+
+	return tasks;
 }
 
 void
@@ -64,7 +117,7 @@ Session::set_control (boost::shared_ptr<AutomationControl> ac, double val, Contr
 }
 
 void
-Session::rt_set_controls (boost::shared_ptr<ControlList> cl, double val, Controllable::GroupControlDisposition gcd)
+Session::rt_set_controls (boost::shared_ptr<ControlList> cl, boost::shared_ptr<RTTaskList::TaskList> tasks, double val, Controllable::GroupControlDisposition gcd)
 {
 	/* Note that we require that all controls in the ControlList are of the
 	   same type.
@@ -73,8 +126,12 @@ Session::rt_set_controls (boost::shared_ptr<ControlList> cl, double val, Control
 		return;
 	}
 
-	for (ControlList::iterator c = cl->begin(); c != cl->end(); ++c) {
-		(*c)->set_value (val, gcd);
+	if (tasks && _rt_tasklist) {
+		_rt_tasklist->process (*tasks);
+	} else {
+		for (ControlList::iterator c = cl->begin(); c != cl->end(); ++c) {
+			(*c)->set_value (val, gcd);
+		}
 	}
 
 	/* some controls need global work to take place after they are set. Do
@@ -121,6 +121,7 @@
 #include "ardour/proxy_controllable.h"
 #include "ardour/recent_sessions.h"
 #include "ardour/region_factory.h"
+#include "ardour/render_cache.h"
 #include "ardour/revision.h"
 #include "ardour/route_group.h"
 #include "ardour/send.h"
@@ -254,6 +255,11 @@ Session::post_engine_init ()
 		return -1;
 	}
 
+	if (_render_cache_manager->start ()) {
+		error << _("Render cache thread did not start") << endmsg;
+		return -1;
+	}
+
 	setup_click_sounds (0);
 	setup_midi_control ();
 
@@ -731,6 +737,22 @@ Session::rename_state (string old_name, string new_name)
 	if (::g_rename (old_xml_path.c_str(), new_xml_path.c_str()) != 0) {
 		error << string_compose(_("could not rename snapshot %1 to %2 (%3)"),
 				old_name, new_name, g_strerror(errno)) << endmsg;
+		return;
+	}
+
+	const std::string old_bin_path (Glib::build_filename (_session_dir->root_path(), legalize_for_path (old_name) + binary_statefile_suffix));
+	const std::string new_bin_path (Glib::build_filename (_session_dir->root_path(), legalize_for_path (new_name) + binary_statefile_suffix));
+
+	if (Glib::file_test (old_bin_path, Glib::FILE_TEST_EXISTS) && ::g_rename (old_bin_path.c_str(), new_bin_path.c_str()) != 0) {
+		::g_remove (old_bin_path.c_str());
+	}
+
+	const std::string old_journal_path (Glib::build_filename (_session_dir->root_path(), legalize_for_path (old_name) + journal_suffix));
+	const std::string new_journal_path (Glib::build_filename (_session_dir->root_path(), legalize_for_path (new_name) + journal_suffix));
+
+	if (Glib::file_test (old_journal_path, Glib::FILE_TEST_EXISTS) && ::g_rename (old_journal_path.c_str(), new_journal_path.c_str()) != 0) {
+		error << string_compose(_("could not rename session journal %1 to %2 (%3)"),
+				old_journal_path, new_journal_path, g_strerror(errno)) << endmsg;
 	}
 }
 
@@ -761,6 +783,16 @@ Session::remove_state (string snapshot_name)
 				xml_path, g_strerror (errno)) << endmsg;
 	}
 
+	std::string bin_path = Glib::build_filename (_session_dir->root_path(), legalize_for_path (snapshot_name) + binary_statefile_suffix);
+	if (Glib::file_test (bin_path, Glib::FILE_TEST_EXISTS)) {
+		::g_remove (bin_path.c_str());
+	}
+
+	std::string journal_path = Glib::build_filename (_session_dir->root_path(), legalize_for_path (snapshot_name) + journal_suffix);
+	if (Glib::file_test (journal_path, Glib::FILE_TEST_EXISTS)) {
+		::g_remove (journal_path.c_str());
+	}
+
 	StateSaved (snapshot_name); /* EMIT SIGNAL */
 }
 
@@ -839,11 +871,37 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 		mark_as_clean = false;
 	}
 
+	/* a binary snapshot is only written next to a proper .ardour file */
+	const bool save_binary = Config->get_save_binary_state () && !pending && !template_only && !for_archive;
+
+	/* incremental save: only write the objects that changed since the
+	 * last complete save. Falls through to a complete save when there is
+	 * no base to compare to, or the journal would be too large.
+	 */
+	const bool incremental = fork_state == NormalSave && !template_only && !for_archive && Config->get_incremental_save ();
+
+	/* routes, playlists and sources that did not change since the base
+	 * are not serialized for an incremental save, see session_journal.cc
+	 */
+	const bool use_state_cache = incremental && !_state_journal_base.empty () && (snapshot_name.empty () || snapshot_name == _current_snapshot_name);
+
+	/* a complete save may become the base of incremental saves */
+	const bool arm_cache = !pending && !template_only && !for_archive;
+
 	if (template_only) {
 		mark_as_clean = false;
 		tree.set_root (&get_template());
 	} else {
-		tree.set_root (&state (false, fork_state, only_used_assets));
+		PBD::Unwinder<bool> uc (_state_cache_in_use, use_state_cache);
+		if (arm_cache && !use_state_cache) {
+			arm_state_cache ();
+		}
+		if (save_binary) {
+			Stateful::RawStateArrays raw;
+			tree.set_root (&state (false, fork_state, only_used_assets));
+		} else {
+			tree.set_root (&state (false, fork_state, only_used_assets));
+		}
 	}
 
 	if (snapshot_name.empty()) {
@@ -854,6 +912,43 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 
 	assert (!snapshot_name.empty());
 
+	if (incremental) {
+		switch (save_state_journal (*tree.root(), snapshot_name, pending)) {
+		case 0:
+			if (!pending) {
+				save_history (snapshot_name);
+				if (mark_as_clean) {
+					unset_dirty (/* EMIT SIGNAL */ true);
+				}
+				StateSaved (snapshot_name); /* EMIT SIGNAL */
+				remove_pending_capture_state ();
+			}
+			return 0;
+		case 1:
+			if (use_state_cache) {
+				/* unchanged objects were left out, take the complete state */
+				delete tree.root ();
+				if (arm_cache) {
+					arm_state_cache ();
+				}
+				if (save_binary) {
+					Stateful::RawStateArrays raw;
+					tree.set_root (&state (false, fork_state, only_used_assets));
+				} else {
+					tree.set_root (&state (false, fork_state, only_used_assets));
+				}
+			}
+			break;
+		default:
+			return -1;
+		}
+	}
+
+	if (!pending && !template_only && !for_archive) {
+		/* identifies this file as base of a session journal */
+		tree.root()->set_property (X_("state-id"), PBD::ID ().to_s ());
+	}
+
 	if (!pending) {
 
 		/* proper save: use statefile_suffix (.ardour in English) */
@@ -905,6 +1000,35 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 		}
 	}
 
+	if (!pending && !template_only && !for_archive) {
+
+		std::string bin_path = Glib::build_filename (_session_dir->root_path(), legalize_for_path (snapshot_name) + binary_statefile_suffix);
+
+		/* the binary snapshot is written after the .ardour file, so it is
+		 * never older. If it is not saved, remove the previous one, it would
+		 * otherwise shadow the new .ardour file if both have the same mtime.
+		 */
+		if (save_binary) {
+			if (!tree.write_binary (tmp_path) || ::g_rename (tmp_path.c_str(), bin_path.c_str()) != 0) {
+				warning << string_compose (_("binary session state could not be saved to %1"), bin_path) << endmsg;
+				::g_remove (tmp_path.c_str());
+				::g_remove (bin_path.c_str());
+			}
+		} else if (Glib::file_test (bin_path, Glib::FILE_TEST_EXISTS)) {
+			::g_remove (bin_path.c_str());
+		}
+
+		/* a complete save supersedes the journal */
+		std::string journal_path = Glib::build_filename (_session_dir->root_path(), legalize_for_path (snapshot_name) + journal_suffix);
+		if (Glib::file_test (journal_path, Glib::FILE_TEST_EXISTS)) {
+			::g_remove (journal_path.c_str());
+		}
+
+		if (snapshot_name == _current_snapshot_name) {
+			set_state_journal_base (*tree.root());
+		}
+	}
+
 	//Mixbus auto-backup mechanism
 	if(Profile->get_mixbus()) {
 		if (pending) {  //"pending" save means it's a backup, or some other non-user-initiated save;  a good time to make a backup
@@ -992,8 +1116,19 @@ Session::load_state (string snapshot_name, bool from_template)
 		}
 	}
 
-	if (!state_was_pending) {
+	/* an incremental pending save only holds the changes relative to the
+	 * session file, which supersede the session's journal.
+	 */
+	std::string journal_path;
+
+	if (state_was_pending && is_state_journal (xmlpath)) {
+		journal_path = xmlpath;
+		xmlpath = Glib::build_filename (_session_dir->root_path(), legalize_for_path (snapshot_name) + statefile_suffix);
+	} else if (!state_was_pending) {
 		xmlpath = Glib::build_filename (_session_dir->root_path(), snapshot_name);
+		if (!from_template) {
+			journal_path = Glib::build_filename (_session_dir->root_path(), legalize_for_path (snapshot_name) + journal_suffix);
+		}
 	}
 
 	if (!Glib::file_test (xmlpath, Glib::FILE_TEST_EXISTS)) {
@@ -1010,7 +1145,31 @@ Session::load_state (string snapshot_name, bool from_template)
 
 	_writable = exists_and_writable (xmlpath) && exists_and_writable(Glib::path_get_dirname(xmlpath));
 
-	if (!state_tree->read (xmlpath)) {
+	/* prefer the binary snapshot, if there is one that is not older than the .ardour file */
+	bool have_state = false;
+
+	if ((!state_was_pending || !journal_path.empty ()) && !from_template) {
+		std::string bin_path (xmlpath);
+		const std::string suffix (statefile_suffix);
+		if (bin_path.size () > suffix.size () && bin_path.compare (bin_path.size () - suffix.size (), suffix.size (), suffix) == 0) {
+			bin_path = bin_path.substr (0, bin_path.size () - suffix.size ()) + binary_statefile_suffix;
+		} else {
+			bin_path += binary_statefile_suffix;
+		}
+
+		GStatBuf xml_stat;
+		GStatBuf bin_stat;
+		if (g_stat (bin_path.c_str(), &bin_stat) == 0 && g_stat (xmlpath.c_str(), &xml_stat) == 0 && bin_stat.st_mtime >= xml_stat.st_mtime) {
+			if (state_tree->read_binary (bin_path) && state_tree->root()->name() == X_("Session")) {
+				have_state = true;
+			} else {
+				warning << string_compose (_("Ignoring unreadable binary session state %1"), bin_path) << endmsg;
+			}
+			state_tree->set_filename (xmlpath);
+		}
+	}
+
+	if (!have_state && !state_tree->read (xmlpath)) {
 		error << string_compose(_("Could not understand session file %1"), xmlpath) << endmsg;
 		delete state_tree;
 		state_tree = 0;
@@ -1026,6 +1185,10 @@ Session::load_state (string snapshot_name, bool from_template)
 		return -1;
 	}
 
+	if (!journal_path.empty () && Glib::file_test (journal_path, Glib::FILE_TEST_EXISTS)) {
+		apply_state_journal (*state_tree->root(), journal_path);
+	}
+
 	std::string version;
 	root.get_property ("version", version);
 	Stateful::loading_state_version = parse_stateful_loading_version (version);
@@ -1340,9 +1503,7 @@ Session::state (bool save_template, snapshot_t snapshot_type, bool only_used_ass
 
 					// TODO special-case empty, removable() files: just create a new removable.
 					// (load + write flushes the model and creates the file)
-					if (!ms->model()) {
-						ms->load_model (lm);
-					}
+					ms->load_model (lm);
 					if (ms->write_to (lm, newsrc, Temporal::Beats(), std::numeric_limits<Temporal::Beats>::max())) {
 						error << string_compose (_("Session-Save: Failed to copy MIDI Source '%1' for snapshot"), ancestor_name) << endmsg;
 					} else {
@@ -1375,6 +1536,11 @@ Session::state (bool save_template, snapshot_t snapshot_type, bool only_used_ass
 				}
 			}
 
+			if (XMLNode* cached = cached_state (*siter->second, X_("Source"))) {
+				child->add_child_nocopy (*cached);
+				continue;
+			}
+
 			child->add_child_nocopy (siter->second->get_state());
 		}
 	}
@@ -1478,8 +1644,11 @@ Session::state (bool save_template, snapshot_t snapshot_type, bool only_used_ass
 
 		for (RouteList::const_iterator i = xml_node_order.begin(); i != xml_node_order.end(); ++i) {
 			if (!(*i)->is_auditioner()) {
+				XMLNode* cached = 0;
 				if (save_template) {
 					child->add_child_nocopy ((*i)->get_template());
+				} else if ((cached = cached_state (**i, X_("Route"))) != 0) {
+					child->add_child_nocopy (*cached);
 				} else {
 					child->add_child_nocopy ((*i)->get_state());
 				}
@@ -1487,7 +1656,7 @@ Session::state (bool save_template, snapshot_t snapshot_type, bool only_used_ass
 		}
 	}
 
-	_playlists->add_state (node, save_template, !only_used_assets);
+	_playlists->add_state (node, save_template, !only_used_assets, boost::bind (&Session::cached_state, this, _1, X_("Playlist")));
 
 	child = node->add_child ("RouteGroups");
 	for (list<RouteGroup *>::iterator i = _route_groups.begin(); i != _route_groups.end(); ++i) {
@@ -1676,8 +1845,17 @@ Session::set_state (const XMLNode& node, int version)
 
 	if ((child = find_named_node (node, "UnusedPlaylists")) == 0) {
 		// this is OK
-	} else if (_playlists->load_unused (*this, *child)) {
-		goto out;
+	} else {
+		/* unused playlists are only created when needed, unless their
+		 * state needs to be converted, or compound regions may refer to them.
+		 */
+		XMLNode const* compounds = find_named_node (node, "CompoundAssociations");
+		const bool defer = Config->get_lazy_session_load () && version >= CURRENT_SESSION_FILE_VERSION
+		                   && (!compounds || compounds->children ().empty ());
+
+		if (_playlists->load_unused (*this, *child, defer)) {
+			goto out;
+		}
 	}
 
 	if ((child = find_named_node (node, "CompoundAssociations")) != 0) {
@@ -4165,6 +4343,15 @@ Session::config_changed (std::string p, bool ours)
 		request_sync_source (TransportMasterManager::instance().current());
 	}  else if (p == "denormal-model") {
 		setup_fpu ();
+	} else if (p == "route-pipelining") {
+		if (!loading ()) {
+			boost::shared_ptr<RouteList> r = routes.reader ();
+			for (RouteList::iterator i = r->begin(); i != r->end(); ++i) {
+				(*i)->reset_pipeline ();
+			}
+			resort_routes ();
+			update_latency_compensation (false, false);
+		}
 	} else if (p == "history-depth") {
 		set_history_depth (Config->get_history_depth());
 	} else if (p == "remote-model") {
@@ -632,20 +632,33 @@ SMFSource::load_model (const Glib::Threads::Mutex::Lock& lock, bool force_reload
 		return;
 	}
 
-	if (!_model) {
+	/* regions using this source connect to the model when it is announced */
+	const bool was_deferred = g_atomic_int_get (&_model_deferred);
+
+	/* a new model is only published when it is complete,
+	 * MidiSource::model() may be called concurrently
+	 */
+	boost::shared_ptr<MidiModel> model (_model);
+
+	if (!model) {
 		boost::shared_ptr<SMFSource> smf = boost::dynamic_pointer_cast<SMFSource> ( shared_from_this () );
-		_model = boost::shared_ptr<MidiModel> (new MidiModel (smf));
+		model = boost::shared_ptr<MidiModel> (new MidiModel (smf));
 	} else {
-		_model->clear();
+		model->clear();
 	}
 
 	invalidate(lock);
 
 	if (writable() && !_open) {
+		_model = model;
+		g_atomic_int_set (&_model_deferred, 0);
+		if (was_deferred) {
+			ModelChanged (); /* EMIT SIGNAL */
+		}
 		return;
 	}
 
-	_model->start_write();
+	model->start_write();
 	Evoral::SMF::seek_to_start();
 
 	uint64_t time = 0; /* in SMF ticks */
@@ -723,7 +736,7 @@ SMFSource::load_model (const Glib::Threads::Mutex::Lock& lock, bool force_reload
 
 	std::list< std::pair< Evoral::Event<Temporal::Beats>*, gint > >::iterator it;
 	for (it=eventlist.begin(); it!=eventlist.end(); ++it) {
-		_model->append (*it->first, it->second);
+		model->append (*it->first, it->second);
 		delete it->first;
 	}
 
@@ -731,11 +744,65 @@ SMFSource::load_model (const Glib::Threads::Mutex::Lock& lock, bool force_reload
         // _playback_buf->dump (cerr);
         // cerr << "----------------\n";
 
-	_model->end_write (Evoral::Sequence<Temporal::Beats>::ResolveStuckNotes, _length_beats);
-	_model->set_edited (false);
+	model->end_write (Evoral::Sequence<Temporal::Beats>::ResolveStuckNotes, _length_beats);
+	model->set_edited (false);
+
+	_model = model;
+	g_atomic_int_set (&_model_deferred, 0);
+
 	invalidate(lock);
 
 	free(buf);
+
+	if (was_deferred) {
+		ModelChanged (); /* EMIT SIGNAL */
+	}
+}
+
+bool
+SMFSource::defer_model (const Glib::Threads::Mutex::Lock& lock)
+{
+	if (_model || _writing || !all_automation_played ()) {
+		return false;
+	}
+
+	if (writable() && !_open) {
+		return false;
+	}
+
+	/* the length is still needed, find the last event without
+	 * building the model (same as load_model() does).
+	 */
+	Evoral::SMF::seek_to_start();
+
+	uint64_t time = 0; /* in SMF ticks */
+	uint32_t scratch_size = 0;
+	uint32_t delta_t = 0;
+	uint32_t size    = 0;
+	uint8_t* buf     = NULL;
+	int ret;
+	gint event_id;
+
+	for (unsigned i = 1; i <= num_tracks(); ++i) {
+		if (seek_to_track(i)) continue;
+
+		time = 0;
+
+		while ((ret = read_event (&delta_t, &size, &buf, &event_id)) >= 0) {
+			time += delta_t;
+
+			if (ret > 0) {
+				_length_beats = max(_length_beats, Temporal::Beats::ticks_at_rate(time, ppqn()));
+				scratch_size = std::max(size, scratch_size);
+				size = scratch_size;
+			}
+		}
+	}
+
+	free(buf);
+
+	g_atomic_int_set (&_model_deferred, 1);
+	return true;
 }
 
 void
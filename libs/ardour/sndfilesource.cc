@@ -26,6 +26,7 @@
 #include "libardour-config.h"
 #endif
 
+#include <algorithm>
 #include <cstring>
 #include <cerrno>
 #include <climits>
@@ -33,14 +34,21 @@
 #include <fcntl.h>
 
 #include <sys/stat.h>
+#ifndef PLATFORM_WINDOWS
+#include <unistd.h>
+#endif
 
 #include <glib.h>
 #include "pbd/gstdio_compat.h"
 
+#include <boost/scoped_array.hpp>
+
 #include <glibmm/convert.h>
 #include <glibmm/fileutils.h>
 #include <glibmm/miscutils.h>
 
+#include "ardour/disk_prefetch.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/runtime_functions.h"
 #include "ardour/sndfilesource.h"
 #include "ardour/sndfile_helpers.h"
@@ -323,6 +331,11 @@ SndFileSource::init_sndfile ()
 
 	memset (&_info, 0, sizeof(_info));
 
+	_direct_fd         = -1;
+	_direct_offset     = 0;
+	_direct_format     = DirectNone;
+	_direct_big_endian = false;
+
 	AudioFileSource::HeaderPositionOffsetChanged.connect_same_thread (header_position_connection, boost::bind (&SndFileSource::handle_header_position_change, this));
 }
 
@@ -332,6 +345,8 @@ SndFileSource::close ()
 	if (_sndfile) {
 		sf_close (_sndfile);
 		_sndfile = 0;
+		_direct_fd = -1;
+		_direct_format = DirectNone;
 		file_closed ();
 	}
 }
@@ -383,6 +398,10 @@ SndFileSource::open ()
 
 	_length = _info.frames;
 
+	if (!writable ()) {
+		setup_direct_read (fd);
+	}
+
 #ifdef HAVE_RF64_RIFF
 	if (_file_is_new && _length == 0 && writable()) {
 		if (_flags & RF64_RIFF) {
@@ -513,6 +532,10 @@ SndFileSource::read_unlocked (Sample *dst, samplepos_t start, samplecnt_t cnt) c
 		memset (dst+file_cnt, 0, sizeof (Sample) * delta);
 	}
 
+	if (file_cnt && _direct_format != DirectNone) {
+		return read_direct (dst, start, file_cnt);
+	}
+
 	if (file_cnt) {
 
 		if (sf_seek (_sndfile, (sf_count_t) start, SEEK_SET|SFM_READ) != (sf_count_t) start) {
@@ -563,6 +586,253 @@ SndFileSource::read_unlocked (Sample *dst, samplepos_t start, samplecnt_t cnt) c
 	return nread;
 }
 
+static inline int32_t
+direct_read_16 (uint8_t const* p, bool be)
+{
+	return (int16_t) (be ? ((uint32_t) p[0] << 8 | p[1]) : ((uint32_t) p[1] << 8 | p[0]));
+}
+
+static inline int32_t
+direct_read_24 (uint8_t const* p, bool be)
+{
+	/* left-align, then use an arithmetic shift to sign extend */
+	const uint32_t v = be
+		? ((uint32_t) p[0] << 24 | (uint32_t) p[1] << 16 | (uint32_t) p[2] << 8)
+		: ((uint32_t) p[2] << 24 | (uint32_t) p[1] << 16 | (uint32_t) p[0] << 8);
+	return ((int32_t) v) >> 8;
+}
+
+static inline uint32_t
+direct_read_32 (uint8_t const* p, bool be)
+{
+	return be
+		? ((uint32_t) p[0] << 24 | (uint32_t) p[1] << 16 | (uint32_t) p[2] << 8 | p[3])
+		: ((uint32_t) p[3] << 24 | (uint32_t) p[2] << 16 | (uint32_t) p[1] << 8 | p[0]);
+}
+
+size_t
+SndFileSource::direct_bytes_per_sample () const
+{
+	switch (_direct_format) {
+		case DirectPCM16:
+			return 2;
+		case DirectPCM24:
+			return 3;
+		case DirectPCM32:
+		case DirectFloat:
+			return 4;
+		default:
+			break;
+	}
+	return 0;
+}
+
+/** Check if the file's sample data can be read without libsndfile, and
+ * if so, locate it.
+ *
+ * @param fd the file descriptor that was passed to sf_open_fd()
+ */
+void
+SndFileSource::setup_direct_read (int fd)
+{
+	_direct_fd     = -1;
+	_direct_format = DirectNone;
+
+#ifndef PLATFORM_WINDOWS
+	if (!Config->get_direct_pcm_reads ()) {
+		return;
+	}
+
+	switch (_info.format & SF_FORMAT_TYPEMASK) {
+		case SF_FORMAT_WAV:
+		case SF_FORMAT_W64:
+		case SF_FORMAT_RF64:
+		case SF_FORMAT_AIFF:
+		case SF_FORMAT_CAF:
+			break;
+		default:
+			/* compressed, or the sample layout is not simple (e.g. WAVEX
+			 * may use a larger container than the sample size)
+			 */
+			return;
+	}
+
+	/* ask libsndfile about the byte-order of the data, rather than
+	 * guessing it from the container (e.g. AIFC may be little-endian)
+	 */
+	const bool needs_swap = sf_command (_sndfile, SFC_RAW_DATA_NEEDS_ENDSWAP, 0, 0) == SF_TRUE;
+#if G_BYTE_ORDER == G_BIG_ENDIAN
+	const bool big_endian = !needs_swap;
+#else
+	const bool big_endian = needs_swap;
+#endif
+
+	DirectFormat df;
+
+	switch (_info.format & SF_FORMAT_SUBMASK) {
+		case SF_FORMAT_PCM_16:
+			df = DirectPCM16;
+			break;
+		case SF_FORMAT_PCM_24:
+			df = DirectPCM24;
+			break;
+		case SF_FORMAT_PCM_32:
+			df = DirectPCM32;
+			break;
+		case SF_FORMAT_FLOAT:
+			df = DirectFloat;
+			break;
+		default:
+			return;
+	}
+
+	/* libsndfile shares the file descriptor, seeking to the first sample
+	 * moves the file position to the start of the data chunk.
+	 */
+	if (sf_seek (_sndfile, 0, SEEK_SET) != 0) {
+		return;
+	}
+
+	const off_t offset = ::lseek (fd, 0, SEEK_CUR);
+
+	struct stat st;
+	if (offset <= 0 || ::fstat (fd, &st) != 0) {
+		return;
+	}
+
+	_direct_fd         = fd;
+	_direct_offset     = offset;
+	_direct_format     = df;
+	_direct_big_endian = big_endian;
+
+	const off_t bpf = direct_bytes_per_sample () * _info.channels;
+
+	if (offset + (off_t) _info.frames * bpf > st.st_size) {
+		/* unexpected layout, or truncated file */
+		_direct_fd     = -1;
+		_direct_format = DirectNone;
+		return;
+	}
+
+	/* verify that both methods produce the same result. The start of a
+	 * file is often silent, so compare blocks spread over the file until
+	 * one with non-zero samples was found.
+	 */
+	const samplecnt_t n_check = std::min ((samplecnt_t) 256, (samplecnt_t) _info.frames);
+
+	if (n_check > 0) {
+		boost::scoped_array<Sample> ref (new Sample[n_check * _info.channels]);
+		boost::scoped_array<Sample> tst (new Sample[n_check]);
+
+		bool ok     = true;
+		bool silent = true;
+
+		for (int b = 0; ok && silent && b < 8; ++b) {
+			const samplepos_t pos = (_info.frames - n_check) * b / 7;
+
+			ok = sf_seek (_sndfile, pos, SEEK_SET) == pos
+			     && sf_readf_float (_sndfile, ref.get (), n_check) == n_check
+			     && read_direct (tst.get (), pos, n_check) == n_check;
+
+			for (samplecnt_t n = 0; ok && n < n_check; ++n) {
+				ok = ref[n * _info.channels + _channel] * _gain == tst[n];
+				if (tst[n] != 0) {
+					silent = false;
+				}
+			}
+		}
+
+		if (!ok) {
+			warning << string_compose (_("SndFileSource: cannot directly read data of %1, using libsndfile"), _path) << endmsg;
+			_direct_fd     = -1;
+			_direct_format = DirectNone;
+		}
+	}
+#endif
+}
+
+/** Read and convert the given range of the file, bypassing libsndfile.
+ * The range must be within the file.
+ */
+samplecnt_t
+SndFileSource::read_direct (Sample* dst, samplepos_t start, samplecnt_t cnt) const
+{
+#ifdef PLATFORM_WINDOWS
+	return 0;
+#else
+	const size_t ss    = direct_bytes_per_sample ();
+	const size_t bpf   = ss * _info.channels;
+	const size_t bytes = cnt * bpf;
+	const off_t  pos   = _direct_offset + (off_t) start * bpf;
+
+	/* the raw data needs at most 4 bytes per sample, same as the interleaved float data */
+	uint8_t* raw  = reinterpret_cast<uint8_t*> (get_interleave_buffer (cnt * _info.channels));
+	size_t   done = 0;
+
+	while (done < bytes) {
+		ssize_t r = ::pread (_direct_fd, raw + done, bytes - done, pos + done);
+		if (r < 0 && errno == EINTR) {
+			continue;
+		}
+		if (r <= 0) {
+			error << string_compose(_("SndFileSource: @ %1 could not read %2 within %3 (%4)"), start, cnt, _name.val().substr (1), strerror (errno)) << endmsg;
+			break;
+		}
+		done += r;
+	}
+
+	const samplecnt_t nread = done / bpf;
+	const bool        be    = _direct_big_endian;
+	uint8_t const*    p     = raw + _channel * ss;
+
+	/* same scaling as libsndfile's normalized int to float conversion */
+	switch (_direct_format) {
+		case DirectPCM16:
+			for (samplecnt_t n = 0; n < nread; ++n, p += bpf) {
+				dst[n] = (float) direct_read_16 (p, be) * (1.f / 32768.f);
+			}
+			break;
+		case DirectPCM24:
+			for (samplecnt_t n = 0; n < nread; ++n, p += bpf) {
+				dst[n] = (float) direct_read_24 (p, be) * (1.f / 8388608.f);
+			}
+			break;
+		case DirectPCM32:
+			for (samplecnt_t n = 0; n < nread; ++n, p += bpf) {
+				dst[n] = (float) (int32_t) direct_read_32 (p, be) * (1.f / 2147483648.f);
+			}
+			break;
+		case DirectFloat:
+			for (samplecnt_t n = 0; n < nread; ++n, p += bpf) {
+				const uint32_t v = direct_read_32 (p, be);
+				memcpy (&dst[n], &v, sizeof (float));
+			}
+			break;
+		default:
+			return 0;
+	}
+
+	if (_gain != 1.f) {
+		apply_gain_to_buffer (dst, nread, _gain);
+	}
+
+	return nread;
+#endif
+}
+
+void
+SndFileSource::prefetch_unlocked (DiskPrefetch& dp, samplepos_t start, samplecnt_t cnt) const
+{
+	if (_direct_format == DirectNone || start >= _length) {
+		return;
+	}
+
+	cnt = std::min (cnt, _length - start);
+
+	const off_t bpf = direct_bytes_per_sample () * _info.channels;
+	dp.add (_direct_fd, _direct_offset + start * bpf, cnt * bpf);
+}
+
 samplecnt_t
 SndFileSource::write_unlocked (Sample *data, samplecnt_t cnt)
 {
@@ -24,8 +24,13 @@
 #include "libardour-config.h"
 #endif
 
+#include <map>
+
+#include <boost/smart_ptr/owner_less.hpp>
+
 #include "pbd/error.h"
 #include "pbd/convert.h"
+#include "pbd/cpus.h"
 #include "pbd/pthread_utils.h"
 #include "pbd/stacktrace.h"
 
@@ -35,6 +40,7 @@
 #include "ardour/midi_playlist.h"
 #include "ardour/midi_playlist_source.h"
 #include "ardour/mp3filesource.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/source.h"
 #include "ardour/source_factory.h"
 #include "ardour/sndfilesource.h"
@@ -59,6 +65,19 @@ std::list<boost::weak_ptr<AudioSource> > SourceFactory::files_with_peaks;
 
 static int active_threads = 0;
 
+/* position of each source in SourceFactory::files_with_peaks */
+typedef std::map<boost::weak_ptr<AudioSource>, std::list<boost::weak_ptr<AudioSource> >::iterator, boost::owner_less<boost::weak_ptr<AudioSource> > > PeakQueueIndex;
+static PeakQueueIndex queued_peakfiles;
+
+/* sources whose peak pyramid is to be (re)built. These are only built
+ * once no peakfiles are waiting, and are not counted as peak work.
+ */
+static std::list<boost::weak_ptr<AudioSource> > pyramids_to_build;
+
+/* progress of the current batch, reset whenever the queue runs dry */
+static uint32_t peak_jobs_done = 0;
+static uint32_t peak_jobs_total = 0;
+
 static void
 peak_thread_work ()
 {
@@ -70,15 +89,27 @@ peak_thread_work ()
 		SourceFactory::peak_building_lock.lock ();
 
 	  wait:
-		if (SourceFactory::files_with_peaks.empty()) {
+		if (SourceFactory::files_with_peaks.empty() && pyramids_to_build.empty ()) {
 			SourceFactory::PeaksToBuild.wait (SourceFactory::peak_building_lock);
 		}
 
-		if (SourceFactory::files_with_peaks.empty()) {
+		if (SourceFactory::files_with_peaks.empty() && pyramids_to_build.empty ()) {
 			goto wait;
 		}
 
+		if (SourceFactory::files_with_peaks.empty()) {
+			boost::shared_ptr<AudioSource> as (pyramids_to_build.front().lock());
+			pyramids_to_build.pop_front ();
+			SourceFactory::peak_building_lock.unlock ();
+
+			if (as) {
+				as->build_peak_pyramid ();
+			}
+			continue;
+		}
+
 		boost::shared_ptr<AudioSource> as (SourceFactory::files_with_peaks.front().lock());
+		queued_peakfiles.erase (SourceFactory::files_with_peaks.front());
 		SourceFactory::files_with_peaks.pop_front ();
 		++active_threads;
 		SourceFactory::peak_building_lock.unlock ();
@@ -90,6 +121,7 @@ peak_thread_work ()
 		as->setup_peakfile ();
 		SourceFactory::peak_building_lock.lock ();
 		--active_threads;
+		++peak_jobs_done;
 		SourceFactory::peak_building_lock.unlock ();
 	}
 }
@@ -102,14 +134,53 @@ SourceFactory::peak_work_queue_length ()
 	return SourceFactory::files_with_peaks.size () + active_threads;
 }
 
+void
+SourceFactory::peak_work_progress (uint32_t& done, uint32_t& total)
+{
+	Glib::Threads::Mutex::Lock lm (peak_building_lock);
+	done = peak_jobs_done;
+	total = peak_jobs_total;
+}
+
 void
 SourceFactory::init ()
 {
-	for (int n = 0; n < 2; ++n) {
+	/* peak building is I/O bound, more threads than that only add seeks */
+	uint32_t n_threads = Config->get_peak_building_threads ();
+	if (n_threads == 0) {
+		n_threads = std::max (2U, std::min (hardware_concurrency () / 2, 8U));
+	}
+
+	for (uint32_t n = 0; n < n_threads; ++n) {
 		Glib::Threads::Thread::create (sigc::ptr_fun (::peak_thread_work));
 	}
 }
 
+/** Move a source that is waiting for its peaks to the front of the queue,
+ * so that peaks which are about to be displayed are built first.
+ */
+void
+SourceFactory::prioritize_peakfile (boost::shared_ptr<AudioSource> as)
+{
+	Glib::Threads::Mutex::Lock lm (peak_building_lock);
+
+	PeakQueueIndex::iterator i = queued_peakfiles.find (as);
+	if (i != queued_peakfiles.end ()) {
+		files_with_peaks.splice (files_with_peaks.begin(), files_with_peaks, i->second);
+	}
+}
+
+/** Queue (re)building the peak pyramid of a source that has a complete
+ * peakfile, see AudioSource::build_peak_pyramid ().
+ */
+void
+SourceFactory::queue_peak_pyramid (boost::shared_ptr<AudioSource> as)
+{
+	Glib::Threads::Mutex::Lock lm (peak_building_lock);
+	pyramids_to_build.push_back (boost::weak_ptr<AudioSource> (as));
+	PeaksToBuild.broadcast ();
+}
+
 int
 SourceFactory::setup_peakfile (boost::shared_ptr<Source> s, bool async)
 {
@@ -121,7 +192,16 @@ SourceFactory::setup_peakfile (boost::shared_ptr<Source> s, bool async)
 		if (async && !as->empty() && !(as->flags() & Source::NoPeakFile)) {
 
 			Glib::Threads::Mutex::Lock lm (peak_building_lock);
+			if (queued_peakfiles.find (as) != queued_peakfiles.end ()) {
+				/* already queued */
+				return 0;
+			}
+			if (files_with_peaks.empty () && active_threads == 0) {
+				peak_jobs_done = peak_jobs_total = 0;
+			}
 			files_with_peaks.push_back (boost::weak_ptr<AudioSource> (as));
+			queued_peakfiles[as] = --files_with_peaks.end ();
+			++peak_jobs_total;
 			PeaksToBuild.broadcast ();
 
 		} else {
@@ -216,7 +296,9 @@ SourceFactory::create (Session& s, const XMLNode& node, bool defer_peaks)
 		try {
 			boost::shared_ptr<SMFSource> src (new SMFSource (s, node));
 			Source::Lock lock(src->mutex());
-			src->load_model (lock, true);
+			if (!s.loading () || !Config->get_lazy_session_load () || !src->defer_model (lock)) {
+				src->load_model (lock, true);
+			}
 			BOOST_MARK_SOURCE (src);
 			src->check_for_analysis_data_on_disk ();
 			SourceCreated (src);
@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <cassert>
+#include <glib.h>
 #include "pbd/compose.h"
 #include "pbd/fpu.h"
 #include "pbd/malign.h"
@@ -68,6 +70,40 @@ FPUTest::run (size_t align_max)
 			default_mix_buffers_no_gain (&_comp1[off], &_comp2[off], cnt);
 			compare (string_compose ("Mix Buffers no gain not aligned off: %1 cnt: %2", off, cnt), cnt);
 
+			/* mix N buffers */
+			const float  gains[4] = { 0.1f, 0.7f, 1.f, 0.33f };
+			const float* srcs_test[4] = { &_test2[off], &_test2[off + 1], &_test2[off + 2], &_test2[off + 3] };
+			const float* srcs_comp[4] = { &_comp2[off], &_comp2[off + 1], &_comp2[off + 2], &_comp2[off + 3] };
+			mix_buffers_n (&_test1[off], srcs_test, gains, 4, cnt);
+			for (int s = 0; s < 4; ++s) {
+				default_mix_buffers_with_gain (&_comp1[off], srcs_comp[s], cnt, gains[s]);
+			}
+			compare (string_compose ("Mix N Buffers w/gain not aligned off: %1 cnt: %2", off, cnt), cnt);
+
+			mix_buffers_n (&_test1[off], srcs_test, 0, 3, cnt);
+			for (int s = 0; s < 3; ++s) {
+				default_mix_buffers_no_gain (&_comp1[off], srcs_comp[s], cnt);
+			}
+			compare (string_compose ("Mix N Buffers no gain not aligned off: %1 cnt: %2", off, cnt), cnt);
+
+			/* apply gain vector */
+			apply_gain_vector (&_test1[off], &_test2[off], cnt);
+			default_apply_gain_vector (&_comp1[off], &_comp2[off], cnt);
+			compare (string_compose ("Apply Gain Vector not aligned off: %1 cnt: %2", off, cnt), cnt);
+
+			/* gain ramp, closed form vs. recursion; differs by rounding only */
+			float  g_test = apply_gain_ramp (&_test1[off], cnt, 0.2f, 1.f, 0.01f);
+			double g_comp = 0.2;
+			for (size_t i = 0; i < cnt; ++i) {
+				_comp1[off + i] *= g_comp;
+				g_comp += 0.01 * (1.0 - g_comp);
+			}
+			CPPUNIT_ASSERT_MESSAGE (string_compose ("Gain Ramp not aligned off: %1 cnt: %2", off, cnt), fabs (g_test - g_comp) < 1e-6);
+			for (size_t i = 0; i < cnt; ++i) {
+				CPPUNIT_ASSERT_MESSAGE (string_compose ("Gain Ramp not aligned off: %1 cnt: %2", off, cnt), fabsf (_test1[off + i] - _comp1[off + i]) <= 2e-6 * std::max (1.f, fabsf (_comp1[off + i])));
+			}
+			copy_vector (_test1, _comp1, _size);
+
 			/* copy vector */
 			copy_vector (&_test1[off], &_test2[off], cnt);
 			default_copy_vector (&_comp1[off], &_comp2[off], cnt);
@@ -97,8 +133,108 @@ FPUTest::compare (std::string msg, size_t cnt)
 	CPPUNIT_ASSERT_MESSAGE (msg, err == 0);
 }
 
+/* Compare the throughput of the function-set under test with
+ * the default (compiler vectorized) implementation. mix_buffers_n()
+ * is compared to calling mix_buffers_with_gain() once per source.
+ */
+void
+FPUTest::bench (std::string const& name)
+{
+	const int n_iter = 20000;
+	int64_t   t_opt[5];
+	int64_t   t_def[5];
+	float     pk = 0;
+
+	int64_t t0 = g_get_monotonic_time ();
+	for (int i = 0; i < n_iter; ++i) { pk = compute_peak (_test1, _size, pk); }
+	int64_t t1 = g_get_monotonic_time ();
+	for (int i = 0; i < n_iter; ++i) { pk = default_compute_peak (_comp1, _size, pk); }
+	int64_t t2 = g_get_monotonic_time ();
+	t_opt[0] = t1 - t0;
+	t_def[0] = t2 - t1;
+
+	t0 = g_get_monotonic_time ();
+	for (int i = 0; i < n_iter; ++i) { apply_gain_to_buffer (_test1, _size, 1.f); }
+	t1 = g_get_monotonic_time ();
+	for (int i = 0; i < n_iter; ++i) { default_apply_gain_to_buffer (_comp1, _size, 1.f); }
+	t2 = g_get_monotonic_time ();
+	t_opt[1] = t1 - t0;
+	t_def[1] = t2 - t1;
+
+	t0 = g_get_monotonic_time ();
+	for (int i = 0; i < n_iter; ++i) { mix_buffers_with_gain (_test1, _test2, _size, 1e-3f); }
+	t1 = g_get_monotonic_time ();
+	for (int i = 0; i < n_iter; ++i) { default_mix_buffers_with_gain (_comp1, _comp2, _size, 1e-3f); }
+	t2 = g_get_monotonic_time ();
+	t_opt[2] = t1 - t0;
+	t_def[2] = t2 - t1;
+
+	t0 = g_get_monotonic_time ();
+	for (int i = 0; i < n_iter; ++i) { mix_buffers_no_gain (_test1, _test2, _size); }
+	t1 = g_get_monotonic_time ();
+	for (int i = 0; i < n_iter; ++i) { default_mix_buffers_no_gain (_comp1, _comp2, _size); }
+	t2 = g_get_monotonic_time ();
+	t_opt[3] = t1 - t0;
+	t_def[3] = t2 - t1;
+
+	const float  gains[8] = { 1e-3f, 1e-3f, 1e-3f, 1e-3f, 1e-3f, 1e-3f, 1e-3f, 1e-3f };
+	const float* srcs[8]  = { _test2, _test2, _test2, _test2, _test2, _test2, _test2, _test2 };
+
+	t0 = g_get_monotonic_time ();
+	for (int i = 0; i < n_iter; ++i) { mix_buffers_n (_test1, srcs, gains, 8, _size); }
+	t1 = g_get_monotonic_time ();
+	for (int i = 0; i < n_iter; ++i) {
+		for (int s = 0; s < 8; ++s) {
+			mix_buffers_with_gain (_comp1, srcs[s], _size, gains[s]);
+		}
+	}
+	t2 = g_get_monotonic_time ();
+	t_opt[4] = t1 - t0;
+	t_def[4] = t2 - t1;
+
+	const char* fn[5] = { "compute_peak", "apply_gain", "mix_with_gain", "mix_no_gain", "mix_n (8 src)" };
+	for (int i = 0; i < 5; ++i) {
+		printf ("%s %-14s %7.1f Msamples/sec (%.2fx %s)\n",
+		        name.c_str (), fn[i],
+		        n_iter * (double)_size / std::max<int64_t> (1, t_opt[i]),
+		        t_def[i] / (double) std::max<int64_t> (1, t_opt[i]),
+		        i < 4 ? "default" : "per source");
+	}
+}
+
 #if defined(ARCH_X86) && defined(BUILD_SSE_OPTIMIZATIONS)
 
+#ifdef FPU_AVX512F_SUPPORT
+void
+FPUTest::avx512fTest ()
+{
+	PBD::FPU* fpu = PBD::FPU::instance ();
+	if (!fpu->has_avx512f ()) {
+		printf ("AVX-512F is not available at run-time\n");
+		return;
+	}
+
+	/* the AVX-512 functions use masked loads and stores, and do not
+	 * depend on alignment. Test all offsets and lengths up to two
+	 * full vectors (+ one partial vector).
+	 */
+	size_t align_max = 48;
+
+	compute_peak          = x86_avx512f_compute_peak;
+	find_peaks            = x86_avx512f_find_peaks;
+	apply_gain_to_buffer  = x86_avx512f_apply_gain_to_buffer;
+	mix_buffers_with_gain = x86_avx512f_mix_buffers_with_gain;
+	mix_buffers_no_gain   = x86_avx512f_mix_buffers_no_gain;
+	copy_vector           = x86_avx512f_copy_vector;
+	mix_buffers_n         = x86_avx512f_mix_buffers_n;
+	apply_gain_ramp       = x86_avx512f_apply_gain_ramp;
+	apply_gain_vector     = x86_avx512f_apply_gain_vector;
+
+	run (align_max);
+	bench ("AVX-512F");
+}
+#endif
+
 void
 FPUTest::avxFmaTest ()
 {
@@ -122,8 +258,12 @@ FPUTest::avxFmaTest ()
 	mix_buffers_with_gain = x86_fma_mix_buffers_with_gain;
 	mix_buffers_no_gain   = x86_sse_avx_mix_buffers_no_gain;
 	copy_vector           = x86_sse_avx_copy_vector;
+	mix_buffers_n         = default_mix_buffers_n;
+	apply_gain_ramp       = default_apply_gain_ramp;
+	apply_gain_vector     = default_apply_gain_vector;
 
 	run (align_max);
+	bench ("AVX/FMA");
 }
 
 void
@@ -149,8 +289,12 @@ FPUTest::avxTest ()
 	mix_buffers_with_gain = x86_sse_avx_mix_buffers_with_gain;
 	mix_buffers_no_gain   = x86_sse_avx_mix_buffers_no_gain;
 	copy_vector           = x86_sse_avx_copy_vector;
+	mix_buffers_n         = default_mix_buffers_n;
+	apply_gain_ramp       = default_apply_gain_ramp;
+	apply_gain_vector     = default_apply_gain_vector;
 
 	run (align_max);
+	bench ("AVX");
 }
 
 void
@@ -176,6 +320,9 @@ FPUTest::sseTest ()
 	mix_buffers_with_gain = x86_sse_mix_buffers_with_gain;
 	mix_buffers_no_gain   = x86_sse_mix_buffers_no_gain;
 	copy_vector           = default_copy_vector;
+	mix_buffers_n         = default_mix_buffers_n;
+	apply_gain_ramp       = default_apply_gain_ramp;
+	apply_gain_vector     = default_apply_gain_vector;
 
 	run (align_max);
 }
@@ -200,9 +347,39 @@ FPUTest::neonTest ()
 	mix_buffers_with_gain = arm_neon_mix_buffers_with_gain;
 	mix_buffers_no_gain   = arm_neon_mix_buffers_no_gain;
 	copy_vector           = arm_neon_copy_vector;
+	mix_buffers_n         = default_mix_buffers_n;
+	apply_gain_ramp       = arm_neon_apply_gain_ramp;
+	apply_gain_vector     = arm_neon_apply_gain_vector;
 
 	run (128);
+	bench ("NEON");
+}
+
+#ifdef ARM_SVE_SUPPORT
+void
+FPUTest::sveTest ()
+{
+	PBD::FPU* fpu = PBD::FPU::instance ();
+	if (!fpu->has_sve ()) {
+		printf ("SVE is not available at run-time\n");
+		return;
+	}
+
+	compute_peak          = arm_sve_compute_peak;
+	find_peaks            = arm_sve_find_peaks;
+	apply_gain_to_buffer  = arm_sve_apply_gain_to_buffer;
+	mix_buffers_with_gain = arm_sve_mix_buffers_with_gain;
+	mix_buffers_no_gain   = arm_sve_mix_buffers_no_gain;
+	copy_vector           = arm_sve_copy_vector;
+	mix_buffers_n         = arm_sve_mix_buffers_n;
+	apply_gain_ramp       = arm_neon_apply_gain_ramp;
+	apply_gain_vector     = arm_neon_apply_gain_vector;
+
+	/* 2048 bit max. vector length, 64 floats */
+	run (130);
+	bench ("SVE");
 }
+#endif
 
 #elif defined(__APPLE__) && defined(BUILD_VECLIB_OPTIMIZATIONS)
 
@@ -224,6 +401,9 @@ FPUTest::veclibTest ()
 	mix_buffers_with_gain = veclib_mix_buffers_with_gain;
 	mix_buffers_no_gain   = veclib_mix_buffers_no_gain;
 	copy_vector           = default_copy_vector;
+	mix_buffers_n         = default_mix_buffers_n;
+	apply_gain_ramp       = default_apply_gain_ramp;
+	apply_gain_vector     = default_apply_gain_vector;
 
 	run (16);
 }
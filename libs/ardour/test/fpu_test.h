@@ -10,8 +10,14 @@ class FPUTest : public CppUnit::TestFixture
 	CPPUNIT_TEST (sseTest);
 	CPPUNIT_TEST (avxTest);
 	CPPUNIT_TEST (avxFmaTest);
+#ifdef FPU_AVX512F_SUPPORT
+	CPPUNIT_TEST (avx512fTest);
+#endif
 #elif defined ARM_NEON_SUPPORT
 	CPPUNIT_TEST (neonTest);
+#ifdef ARM_SVE_SUPPORT
+	CPPUNIT_TEST (sveTest);
+#endif
 #elif defined(__APPLE__) && defined(BUILD_VECLIB_OPTIMIZATIONS)
 	CPPUNIT_TEST (veclibTest);
 #else
@@ -27,8 +33,14 @@ public:
 	void avxFmaTest ();
 	void avxTest ();
 	void sseTest ();
+#ifdef FPU_AVX512F_SUPPORT
+	void avx512fTest ();
+#endif
 #elif defined ARM_NEON_SUPPORT
 	void neonTest ();
+#ifdef ARM_SVE_SUPPORT
+	void sveTest ();
+#endif
 #elif defined(__APPLE__) && defined(BUILD_VECLIB_OPTIMIZATIONS)
 	void veclibTest ();
 #else
@@ -38,6 +50,7 @@ public:
 private:
 	void run (size_t);
 	void compare (std::string, size_t);
+	void bench (std::string const&);
 
 	ARDOUR::compute_peak_t          compute_peak;
 	ARDOUR::find_peaks_t            find_peaks;
@@ -45,6 +58,9 @@ private:
 	ARDOUR::mix_buffers_with_gain_t mix_buffers_with_gain;
 	ARDOUR::mix_buffers_no_gain_t   mix_buffers_no_gain;
 	ARDOUR::copy_vector_t           copy_vector;
+	ARDOUR::mix_buffers_n_t         mix_buffers_n;
+	ARDOUR::apply_gain_ramp_t       apply_gain_ramp;
+	ARDOUR::apply_gain_vector_t     apply_gain_vector;
 
 	size_t _size;
 
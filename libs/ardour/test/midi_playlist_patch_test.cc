@@ -0,0 +1,219 @@
+#include "evoral/midi_events.h"
+
+#include "ardour/midi_buffer.h"
+#include "ardour/midi_channel_filter.h"
+#include "ardour/midi_playlist.h"
+#include "ardour/midi_region.h"
+#include "ardour/midi_source.h"
+#include "ardour/midi_state_tracker.h"
+#include "ardour/playlist_factory.h"
+#include "ardour/region_factory.h"
+#include "ardour/rt_midibuffer.h"
+#include "ardour/session.h"
+#include "ardour/tempo.h"
+
+#include "midi_playlist_patch_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (MidiPlaylistPatchTest);
+
+using namespace std;
+using namespace ARDOUR;
+using namespace PBD;
+
+typedef MidiModel::NoteDiffCommand NoteDiffCommand;
+
+/* A region that plays beats 4 .. 12 of its source, at quarter note 2 of
+ * the session. Notes are added to the source as (channel, start, length,
+ * note number).
+ */
+void
+MidiPlaylistPatchTest::setUp ()
+{
+	TestNeedingSession::setUp ();
+
+	boost::shared_ptr<MidiSource> src = _session->create_midi_source_for_session ("patch");
+
+	_model.reset (new MidiModel (src));
+	{
+		Glib::Threads::Mutex::Lock lm (src->mutex ());
+		src->set_model (lm, _model);
+	}
+
+	_notes.clear ();
+	_notes.push_back (_model->new_note (0, Temporal::Beats (3.0), Temporal::Beats (0.5), 60)); // before the region
+	_notes.push_back (_model->new_note (0, Temporal::Beats (5.0), Temporal::Beats (1.0), 62));
+	_notes.push_back (_model->new_note (1, Temporal::Beats (6.0), Temporal::Beats (1.0), 64));
+	_notes.push_back (_model->new_note (0, Temporal::Beats (7.0), Temporal::Beats (1.0), 65));
+	_notes.push_back (_model->new_note (0, Temporal::Beats (10.0), Temporal::Beats (4.0), 67)); // beyond the region end
+
+	NoteDiffCommand* cmd = _model->new_note_diff_command ();
+	for (vector<MidiModel::NotePtr>::const_iterator n = _notes.begin (); n != _notes.end (); ++n) {
+		cmd->add (*n);
+	}
+	(*cmd) ();
+	delete cmd;
+
+	SourceList srcs;
+	srcs.push_back (src);
+
+	PropertyList plist;
+	plist.add (Properties::start, sample_at (4));
+	plist.add (Properties::length, sample_at (8));
+	plist.add (Properties::start_beats, 4.0);
+	plist.add (Properties::length_beats, 8.0);
+	plist.add (Properties::name, "patch");
+
+	_region = boost::dynamic_pointer_cast<MidiRegion> (RegionFactory::create (srcs, plist));
+	CPPUNIT_ASSERT (_region);
+
+	_playlist = boost::dynamic_pointer_cast<MidiPlaylist> (PlaylistFactory::create (DataType::MIDI, *_session, "patch"));
+	CPPUNIT_ASSERT (_playlist);
+	_playlist->add_region (_region, sample_at (2));
+}
+
+void
+MidiPlaylistPatchTest::tearDown ()
+{
+	_playlist.reset ();
+	_region.reset ();
+	_notes.clear ();
+	_model.reset ();
+
+	TestNeedingSession::tearDown ();
+}
+
+samplepos_t
+MidiPlaylistPatchTest::sample_at (double qn) const
+{
+	return _session->tempo_map ().sample_at_quarter_note (qn);
+}
+
+MidiPlaylistPatchTest::Events
+MidiPlaylistPatchTest::rendered () const
+{
+	MidiBuffer       buf (16384);
+	MidiStateTracker tracker;
+	Events           events;
+
+	_playlist->rendered ()->read (buf, 0, sample_at (32), tracker);
+
+	for (MidiBuffer::iterator e = buf.begin (); e != buf.end (); ++e) {
+		CPPUNIT_ASSERT_EQUAL ((uint32_t) 3, (*e).size ());
+		uint8_t const* b = (*e).buffer ();
+		events.push_back (make_pair ((samplepos_t) (*e).time (), (uint32_t) ((b[0] << 16) | (b[1] << 8) | b[2])));
+	}
+
+	return events;
+}
+
+MidiPlaylistPatchTest::Events
+MidiPlaylistPatchTest::render (MidiChannelFilter* filter)
+{
+	_playlist->render (filter);
+	return rendered ();
+}
+
+/** Check that an edit was applied to the rendered events, and that the
+ * result is the same as rendering everything again.
+ */
+void
+MidiPlaylistPatchTest::check_patched (Events const& before, MidiChannelFilter* filter)
+{
+	/* nothing here renders on its own, so a change is the patch */
+	const Events patched = rendered ();
+	CPPUNIT_ASSERT (patched != before);
+
+	/* readers alternate between two copies, both must be patched */
+	CPPUNIT_ASSERT (_playlist->rendered ()->patch (vector<RTMidiBuffer::Item> (), vector<RTMidiBuffer::Item> ()));
+	CPPUNIT_ASSERT (patched == rendered ());
+
+	CPPUNIT_ASSERT (patched == render (filter));
+}
+
+void
+MidiPlaylistPatchTest::regionOffsetTest ()
+{
+	Events before = render (0);
+
+	/* 4 notes in the region, one of which is resolved at its end */
+	CPPUNIT_ASSERT_EQUAL ((size_t) 8, before.size ());
+	CPPUNIT_ASSERT_EQUAL (sample_at (3), before.front ().first);
+	CPPUNIT_ASSERT_EQUAL (sample_at (10), before.back ().first);
+
+	NoteDiffCommand* cmd = _model->new_note_diff_command ();
+	cmd->change (_notes[3], NoteDiffCommand::StartTime, Temporal::Beats (8.0));
+	cmd->change (_notes[1], NoteDiffCommand::Velocity, (uint8_t) 100);
+	(*cmd) ();
+	check_patched (before, 0);
+
+	/* and back */
+	before = rendered ();
+	cmd->undo ();
+	check_patched (before, 0);
+	delete cmd;
+
+	/* a new note */
+	before = rendered ();
+	cmd = _model->new_note_diff_command ();
+	cmd->add (_model->new_note (0, Temporal::Beats (4.0), Temporal::Beats (0.5), 70));
+	(*cmd) ();
+	check_patched (before, 0);
+	delete cmd;
+}
+
+void
+MidiPlaylistPatchTest::channelFilterTest ()
+{
+	MidiChannelFilter filter;
+
+	/* only channel 1 */
+	filter.set_channel_mode (FilterChannels, 0x1);
+
+	Events before = render (&filter);
+	CPPUNIT_ASSERT_EQUAL ((size_t) 6, before.size ());
+
+	NoteDiffCommand* cmd = _model->new_note_diff_command ();
+	cmd->change (_notes[2], NoteDiffCommand::NoteNumber, (uint8_t) 66);
+	cmd->change (_notes[1], NoteDiffCommand::StartTime, Temporal::Beats (5.5));
+	(*cmd) ();
+	check_patched (before, &filter);
+	delete cmd;
+
+	/* everything on channel 6 */
+	filter.set_channel_mode (ForceChannel, 5);
+
+	before = render (&filter);
+	CPPUNIT_ASSERT_EQUAL ((size_t) 8, before.size ());
+	CPPUNIT_ASSERT_EQUAL ((uint32_t) 5, (before.front ().second >> 16) & 0xf);
+
+	cmd = _model->new_note_diff_command ();
+	cmd->change (_notes[2], NoteDiffCommand::StartTime, Temporal::Beats (6.5));
+	(*cmd) ();
+	check_patched (before, &filter);
+	delete cmd;
+}
+
+void
+MidiPlaylistPatchTest::regionEndTest ()
+{
+	Events before = render (0);
+
+	/* the last note-off is resolved at the region end */
+	CPPUNIT_ASSERT_EQUAL (sample_at (10), before.back ().first);
+	CPPUNIT_ASSERT_EQUAL ((uint32_t) ((MIDI_CMD_NOTE_OFF << 16) | (67 << 8)), before.back ().second);
+
+	NoteDiffCommand* cmd = _model->new_note_diff_command ();
+	cmd->change (_notes[1], NoteDiffCommand::Length, Temporal::Beats (9.0));
+	cmd->change (_notes[4], NoteDiffCommand::Length, Temporal::Beats (1.0));
+	(*cmd) ();
+	check_patched (before, 0);
+
+	Events after = rendered ();
+	CPPUNIT_ASSERT_EQUAL (sample_at (10), after.back ().first);
+	CPPUNIT_ASSERT_EQUAL ((uint32_t) ((MIDI_CMD_NOTE_OFF << 16) | (62 << 8)), after.back ().second);
+
+	before = after;
+	cmd->undo ();
+	check_patched (before, 0);
+	delete cmd;
+}
@@ -0,0 +1,42 @@
+#include <vector>
+
+#include "ardour/midi_model.h"
+#include "ardour/types.h"
+#include "test_needing_session.h"
+
+namespace ARDOUR {
+	class MidiChannelFilter;
+	class MidiPlaylist;
+	class MidiRegion;
+}
+
+class MidiPlaylistPatchTest : public TestNeedingSession
+{
+	CPPUNIT_TEST_SUITE (MidiPlaylistPatchTest);
+	CPPUNIT_TEST (regionOffsetTest);
+	CPPUNIT_TEST (channelFilterTest);
+	CPPUNIT_TEST (regionEndTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp ();
+	void tearDown ();
+
+	void regionOffsetTest ();
+	void channelFilterTest ();
+	void regionEndTest ();
+
+private:
+	/** time and the 3 bytes of each rendered event */
+	typedef std::vector<std::pair<ARDOUR::samplepos_t, uint32_t> > Events;
+
+	boost::shared_ptr<ARDOUR::MidiModel>    _model;
+	std::vector<ARDOUR::MidiModel::NotePtr> _notes;
+	boost::shared_ptr<ARDOUR::MidiRegion>   _region;
+	boost::shared_ptr<ARDOUR::MidiPlaylist> _playlist;
+
+	ARDOUR::samplepos_t sample_at (double qn) const;
+	Events rendered () const;
+	Events render (ARDOUR::MidiChannelFilter*);
+	void check_patched (Events const& before, ARDOUR::MidiChannelFilter*);
+};
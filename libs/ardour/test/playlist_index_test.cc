@@ -0,0 +1,156 @@
+#include <iostream>
+#include <cstdlib>
+
+#include "pbd/compose.h"
+#include "pbd/timing.h"
+
+#include "ardour/audioplaylist.h"
+#include "ardour/audioregion.h"
+#include "ardour/playlist.h"
+#include "ardour/region_factory.h"
+#include "ardour/session.h"
+
+#include "playlist_index_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (PlaylistIndexTest);
+
+using namespace std;
+using namespace PBD;
+using namespace ARDOUR;
+
+/** Check that the region index finds the same regions, in the same order,
+ *  as a scan of the whole region list.
+ */
+void
+PlaylistIndexTest::check_touched (samplepos_t start, samplepos_t end)
+{
+	boost::shared_ptr<RegionList> touched = _playlist->regions_touched (start, end);
+
+	RegionList expected;
+	RegionList const& all (_playlist->region_list_property ().rlist ());
+	for (RegionList::const_iterator i = all.begin (); i != all.end (); ++i) {
+		if ((*i)->coverage (start, end) != Evoral::OverlapNone) {
+			expected.push_back (*i);
+		}
+	}
+
+	CPPUNIT_ASSERT_EQUAL (expected.size (), touched->size ());
+	CPPUNIT_ASSERT (expected == *touched);
+}
+
+/* Add, move, trim and remove single regions, each of which updates the
+ * index in place.
+ */
+void
+PlaylistIndexTest::editTest ()
+{
+	srand (42);
+
+	for (int i = 0; i < 16; ++i) {
+		_playlist->add_region (_r[i], rand () % 2000);
+	}
+
+	check_touched (0, 2100);
+
+	for (int n = 0; n < 2000; ++n) {
+		boost::shared_ptr<Region> r = _r[rand () % 16];
+
+		switch (rand () % 4) {
+		case 0:
+			r->set_position (rand () % 2000);
+			break;
+		case 1:
+			/* also moves regions next to others at the same position */
+			r->set_position (_r[rand () % 16]->position ());
+			break;
+		case 2:
+			r->set_length (1 + rand () % 200, 0);
+			break;
+		default:
+			if (_playlist->region_list_property ().rlist ().size () > 8 && r->playlist ()) {
+				_playlist->remove_region (r);
+			} else if (!r->playlist ()) {
+				_playlist->add_region (r, rand () % 2000);
+			}
+			break;
+		}
+
+		samplepos_t const start = rand () % 2200;
+		check_touched (start, start + rand () % 300);
+	}
+
+	check_touched (0, 2300);
+}
+
+static void
+report (string const& what, TimingStats const& t)
+{
+	uint64_t min, max;
+	double   avg, dev;
+	if (t.get_stats (min, max, avg, dev)) {
+		cout << string_compose ("  %1: min %2 usec, avg %3 usec, max %4 usec, dev %5\n", what, min, avg, max, dev);
+	}
+}
+
+/* Read a playlist with many small, overlapping regions (a comped take)
+ * in butler sized chunks, and look up the regions touched by each chunk.
+ * Then move a region before every read, as a drag does.
+ */
+void
+PlaylistIndexTest::readBenchmark ()
+{
+	int const n_regions = 2000;
+	int const chunk     = 8192;
+
+	samplepos_t pos = 0;
+	_playlist->freeze ();
+	for (int i = 0; i < n_regions; ++i) {
+		samplecnt_t const len = 200 + rand () % 1800;
+		PropertyList plist;
+		plist.add (Properties::start, rand () % (4096 - len));
+		plist.add (Properties::length, len);
+		_playlist->add_region (RegionFactory::create (_source, plist), pos);
+		pos += len - rand () % (len / 4);
+	}
+	_playlist->thaw ();
+
+	samplepos_t const end = _playlist->get_extent ().second;
+
+	Sample* buf  = new Sample[chunk];
+	Sample* mbuf = new Sample[chunk];
+	float*  gbuf = new float[chunk];
+
+	TimingStats lookup;
+	TimingStats read;
+
+	for (samplepos_t s = 0; s < end; s += chunk) {
+		lookup.start ();
+		_playlist->regions_touched (s, s + chunk - 1);
+		lookup.update ();
+
+		read.start ();
+		_audio_playlist->read (buf, mbuf, gbuf, s, chunk, 0);
+		read.update ();
+	}
+
+	TimingStats edit_read;
+	boost::shared_ptr<Region> moved = _playlist->region_list_property ().rlist ().front ();
+
+	for (samplepos_t s = 0; s < end; s += chunk) {
+		edit_read.start ();
+		moved->set_position (s);
+		_audio_playlist->read (buf, mbuf, gbuf, s, chunk, 0);
+		edit_read.update ();
+	}
+
+	check_touched (0, end);
+
+	delete[] buf;
+	delete[] mbuf;
+	delete[] gbuf;
+
+	cout << string_compose ("\n%1 regions, %2 samples, reading in chunks of %3\n", n_regions, end, chunk);
+	report ("Region lookup", lookup);
+	report ("Read", read);
+	report ("Move region and read", edit_read);
+}
@@ -0,0 +1,17 @@
+#include "ardour/types.h"
+#include "audio_region_test.h"
+
+class PlaylistIndexTest : public AudioRegionTest
+{
+	CPPUNIT_TEST_SUITE (PlaylistIndexTest);
+	CPPUNIT_TEST (editTest);
+	CPPUNIT_TEST (readBenchmark);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void editTest ();
+	void readBenchmark ();
+
+private:
+	void check_touched (ARDOUR::samplepos_t start, ARDOUR::samplepos_t end);
+};
@@ -0,0 +1,144 @@
+#include <iostream>
+#include <glibmm.h>
+
+#include "pbd/compose.h"
+#include "pbd/enumwriter.h"
+#include "pbd/timing.h"
+
+#include "ardour/audioengine.h"
+#include "ardour/graph.h"
+#include "ardour/rc_configuration.h"
+#include "ardour/session.h"
+#include "ardour/types_convert.h"
+#include "ardour/utils.h"
+
+#include "test_util.h"
+
+using namespace std;
+using namespace PBD;
+using namespace ARDOUR;
+
+static const char* localedir = LOCALEDIR;
+
+struct Result {
+	Result () : load_sum (0), load_max (0), n_load (0), cycles (0), exec_50 (0), exec_99 (0), exec_max (0) {}
+
+	double   load_sum;
+	float    load_max;
+	int      n_load;
+	uint32_t cycles;
+	uint64_t exec_50;
+	uint64_t exec_99;
+	uint64_t exec_max;
+
+	double load_avg () const { return n_load > 0 ? load_sum / n_load : 0; }
+};
+
+/* Run the session with the given scheduler for a while, sampling the
+ * DSP load and the time it takes the graph to process all routes.
+ */
+static void
+measure (boost::shared_ptr<Graph> graph, GraphSchedulerModel gsm, int seconds, Result& r)
+{
+	Config->set_graph_scheduler (gsm);
+
+	/* settle, the scheduler is switched at the start of the next cycle */
+	Glib::usleep (500000);
+
+	TimingHistogram& h (graph->execution_time ());
+	h.reset ();
+
+	for (int i = 0; i < seconds * 100; ++i) {
+		Glib::usleep (10000);
+		float const load = 100.f * AudioEngine::instance ()->get_dsp_load ();
+		r.load_sum += load;
+		r.load_max  = std::max (r.load_max, load);
+		++r.n_load;
+	}
+
+	r.cycles  += h.n_samples ();
+	r.exec_50  = std::max (r.exec_50, h.percentile (50));
+	r.exec_99  = std::max (r.exec_99, h.percentile (99));
+	r.exec_max = std::max (r.exec_max, h.max_usec ());
+}
+
+static void
+report (GraphSchedulerModel gsm, Result const& r)
+{
+	cout << string_compose ("%1: %2 cycles, avg DSP load: %3%% max DSP load: %4%%, execution 50%%: %5 usec 99%%: %6 usec max: %7 usec\n",
+	                        enum_2_string (gsm), r.cycles, r.load_avg (), r.load_max, r.exec_50, r.exec_99, r.exec_max);
+}
+
+/* Compare the work-stealing scheduler with the baseline shared trigger-queue
+ * for a given session. The session is run with the dummy backend; both
+ * schedulers are run alternately, so that both see the same conditions.
+ *
+ * Fails if either scheduler did not process, or if work-stealing has a
+ * higher average DSP load than the baseline by more than the given
+ * tolerance (in percent of the baseline).
+ */
+int
+main (int argc, char* argv[])
+{
+	if (argc < 2) {
+		cerr << argv[0] << ": <session> [seconds] [rounds] [tolerance]\n";
+		exit (EXIT_FAILURE);
+	}
+
+	int const    seconds   = argc > 2 ? atoi (argv[2]) : 5;
+	int const    rounds    = argc > 3 ? atoi (argv[3]) : 4;
+	double const tolerance = argc > 4 ? atof (argv[4]) : 10;
+
+	ARDOUR::init (false, true, localedir);
+
+	create_and_start_dummy_backend ();
+
+	Session* session = load_session (
+		string_compose ("../libs/ardour/test/profiling/sessions/%1", argv[1]),
+		string_compose ("%1.ardour", argv[1])
+		);
+
+	boost::shared_ptr<Graph> graph = session->process_graph ();
+	if (!graph) {
+		cerr << "Session does not use the process graph.\n";
+		exit (EXIT_FAILURE);
+	}
+
+	cout << "INFO: " << session->get_routes()->size() << " routes, " << how_many_dsp_threads () << " DSP threads.\n";
+
+	session->request_transport_speed (1.0);
+
+	Result baseline;
+	Result stealing;
+
+	for (int n = 0; n < rounds; ++n) {
+		measure (graph, SharedTriggerQueue, seconds, baseline);
+		measure (graph, WorkStealing, seconds, stealing);
+	}
+
+	Config->set_graph_scheduler (SharedTriggerQueue);
+
+	AudioEngine::instance ()->remove_session ();
+	delete session;
+	AudioEngine::instance ()->stop ();
+	AudioEngine::destroy ();
+
+	report (SharedTriggerQueue, baseline);
+	report (WorkStealing, stealing);
+
+	if (baseline.cycles == 0 || stealing.cycles == 0) {
+		cerr << "FAIL: the graph did not process.\n";
+		return EXIT_FAILURE;
+	}
+
+	double const change = baseline.load_avg () > 0 ? 100. * (stealing.load_avg () - baseline.load_avg ()) / baseline.load_avg () : 0;
+
+	cout << string_compose ("%1 vs. %2: avg DSP load %3%4%%\n", enum_2_string (WorkStealing), enum_2_string (SharedTriggerQueue), change > 0 ? "+" : "", change);
+
+	if (change > tolerance) {
+		cerr << string_compose ("FAIL: %1 is slower than %2 by more than %3%%\n", enum_2_string (WorkStealing), enum_2_string (SharedTriggerQueue), tolerance);
+		return EXIT_FAILURE;
+	}
+
+	return 0;
+}
@@ -0,0 +1,91 @@
+#include <iostream>
+#include <glibmm.h>
+
+#include "pbd/compose.h"
+#include "pbd/timing.h"
+
+#include "ardour/audioengine.h"
+#include "ardour/graph.h"
+#include "ardour/rc_configuration.h"
+#include "ardour/session.h"
+
+#include "test_util.h"
+
+using namespace std;
+using namespace PBD;
+using namespace ARDOUR;
+
+static const char* localedir = LOCALEDIR;
+
+/* Measure the time it takes the process graph to wake up for a
+ * process callback, for various buffer sizes and spin-times.
+ */
+static void
+measure (boost::shared_ptr<Graph> graph, uint32_t spin_usec, int seconds)
+{
+	Config->set_graph_spin_usec (spin_usec);
+
+	/* settle, the spin time is updated at the start of the next cycle */
+	Glib::usleep (250000);
+
+	TimingHistogram& h (graph->wakeup_latency ());
+	h.reset ();
+
+	float max_load = 0;
+	for (int i = 0; i < seconds * 100; ++i) {
+		Glib::usleep (10000);
+		max_load = std::max (max_load, 100.f * AudioEngine::instance ()->get_dsp_load ());
+	}
+
+	cout << string_compose ("  spin %1 usec: %2 cycles, wakeup 50%%: %3 usec 99%%: %4 usec max: %5 usec, max DSP load: %6%%\n",
+	                        spin_usec, h.n_samples (), h.percentile (50), h.percentile (99), h.max_usec (), max_load);
+}
+
+int
+main (int argc, char* argv[])
+{
+	if (argc < 2) {
+		cerr << argv[0] << ": <session> [seconds]\n";
+		exit (EXIT_FAILURE);
+	}
+
+	int seconds = argc > 2 ? atoi (argv[2]) : 5;
+
+	ARDOUR::init (false, true, localedir);
+
+	create_and_start_dummy_backend ();
+
+	Session* session = load_session (
+		string_compose ("../libs/ardour/test/profiling/sessions/%1", argv[1]),
+		string_compose ("%1.ardour", argv[1])
+		);
+
+	boost::shared_ptr<Graph> graph = session->process_graph ();
+	if (!graph) {
+		cerr << "Session does not use the process graph.\n";
+		exit (EXIT_FAILURE);
+	}
+
+	session->request_transport_speed (1.0);
+
+	static const uint32_t buffer_sizes[] = { 32, 64, 128, 256, 1024 };
+	static const uint32_t spin_times[]   = { 0, 10, 25, 100 };
+
+	for (size_t b = 0; b < sizeof (buffer_sizes) / sizeof (uint32_t); ++b) {
+		if (AudioEngine::instance ()->set_buffer_size (buffer_sizes[b])) {
+			cerr << string_compose ("Cannot set buffer size to %1\n", buffer_sizes[b]);
+			continue;
+		}
+		cout << string_compose ("Buffer size %1:\n", buffer_sizes[b]);
+		for (size_t s = 0; s < sizeof (spin_times) / sizeof (uint32_t); ++s) {
+			measure (graph, spin_times[s], seconds);
+		}
+	}
+
+	AudioEngine::instance ()->remove_session ();
+	delete session;
+	AudioEngine::instance ()->stop ();
+	AudioEngine::destroy ();
+
+	return 0;
+}
@@ -0,0 +1,84 @@
+#include <iostream>
+#include <cstdlib>
+
+#include "pbd/compose.h"
+#include "pbd/timing.h"
+
+#include "evoral/midi_events.h"
+
+#include "ardour/midi_buffer.h"
+#include "ardour/midi_state_tracker.h"
+#include "ardour/rt_midibuffer.h"
+
+using namespace std;
+using namespace PBD;
+using namespace ARDOUR;
+
+static void
+report (string const& what, TimingStats const& t)
+{
+	uint64_t min, max;
+	double   avg, dev;
+	if (t.get_stats (min, max, avg, dev)) {
+		cout << string_compose ("  %1: min %2 usec, avg %3 usec, max %4 usec, dev %5\n", what, min, avg, max, dev);
+	}
+}
+
+/* Read the rendered events of a playlist with dense per-note controller
+ * data (MPE pitch-bend and pressure on 15 channels) in process cycles,
+ * as the disk-reader does.
+ */
+int
+main (int argc, char* argv[])
+{
+	int const         interval = argc > 1 ? atoi (argv[1]) : 16; /* samples between controller events per channel */
+	int const         cycle    = 1024;
+	samplecnt_t const length   = 48000 * 600;
+
+	RTMidiBuffer rtm;
+
+	{
+		RTMidiBuffer::WriteProtectRender wpr (rtm);
+		wpr.acquire ();
+		rtm.clear ();
+
+		for (samplepos_t s = 0; s < length; s += interval) {
+			for (uint8_t chn = 1; chn < 16; ++chn) {
+				uint8_t bend[3]     = { (uint8_t) (MIDI_CMD_BENDER | chn), (uint8_t) (s & 0x7f), 0x40 };
+				uint8_t pressure[2] = { (uint8_t) (MIDI_CMD_CHANNEL_PRESSURE | chn), (uint8_t) ((s >> 4) & 0x7f) };
+				rtm.write (s, Evoral::MIDI_EVENT, 3, bend);
+				rtm.write (s, Evoral::MIDI_EVENT, 2, pressure);
+			}
+		}
+	}
+
+	cout << string_compose ("%1 events, %2 per cycle of %3 samples\n", rtm.size (), rtm.size () * cycle / length, cycle);
+
+	MidiBuffer       buf (rtm.size () * cycle / length * MidiBuffer::record_size (3) * 2);
+	MidiStateTracker tracker;
+	TimingStats      read;
+
+	for (samplepos_t s = 0; s < length; s += cycle) {
+		buf.clear ();
+		read.start ();
+		rtm.read (buf, s, s + cycle, tracker);
+		read.update ();
+	}
+
+	report ("Read", read);
+
+	/* locate: random access */
+	TimingStats locate;
+
+	for (int i = 0; i < 10000; ++i) {
+		samplepos_t const s = (samplepos_t) (rand () / (double) RAND_MAX * (length - cycle));
+		buf.clear ();
+		locate.start ();
+		rtm.read (buf, s, s + cycle, tracker);
+		locate.update ();
+	}
+
+	report ("Locate and read", locate);
+
+	return 0;
+}
@@ -0,0 +1,278 @@
+#include <vector>
+
+#include "evoral/midi_events.h"
+
+#include "ardour/midi_buffer.h"
+#include "ardour/midi_state_tracker.h"
+#include "ardour/rt_midibuffer.h"
+
+#include "rt_midibuffer_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (RTMidiBufferTest);
+
+using namespace std;
+using namespace ARDOUR;
+
+static void
+write_note (RTMidiBuffer& rtm, samplepos_t on, samplepos_t off, uint8_t note)
+{
+	uint8_t buf[3] = { MIDI_CMD_NOTE_ON, note, 100 };
+	rtm.write (on, Evoral::MIDI_EVENT, 3, buf);
+	buf[0] = MIDI_CMD_NOTE_OFF;
+	buf[2] = 0;
+	rtm.write (off, Evoral::MIDI_EVENT, 3, buf);
+}
+
+static RTMidiBuffer::Item
+item (samplepos_t time, uint8_t status, uint8_t note, uint8_t velocity)
+{
+	uint8_t buf[3] = { status, note, velocity };
+	return RTMidiBuffer::make_item (time, buf, 3);
+}
+
+/** Read all events, and check that the notes (on and off) are as given */
+static void
+check_events (RTMidiBuffer& rtm, samplepos_t const* times, uint8_t const* status, uint8_t const* notes, size_t n)
+{
+	MidiBuffer buf (1024);
+	MidiStateTracker tracker;
+
+	CPPUNIT_ASSERT_EQUAL (n, rtm.size ());
+	CPPUNIT_ASSERT_EQUAL ((uint32_t) n, rtm.read (buf, 0, 10000, tracker));
+
+	size_t i = 0;
+	for (MidiBuffer::iterator e = buf.begin (); e != buf.end (); ++e, ++i) {
+		CPPUNIT_ASSERT_EQUAL (times[i], (samplepos_t) (*e).time ());
+		CPPUNIT_ASSERT_EQUAL (status[i], (*e).buffer ()[0]);
+		CPPUNIT_ASSERT_EQUAL (notes[i], (*e).buffer ()[1]);
+	}
+}
+
+void
+RTMidiBufferTest::patchTest ()
+{
+	RTMidiBuffer rtm;
+
+	{
+		RTMidiBuffer::WriteProtectRender wpr (rtm);
+		wpr.acquire ();
+		rtm.clear ();
+		write_note (rtm, 0, 100, 60);
+		write_note (rtm, 100, 200, 62);
+		write_note (rtm, 200, 300, 64);
+	}
+
+	/* move the second note to 300 .. 400 */
+	vector<RTMidiBuffer::Item> remove;
+	vector<RTMidiBuffer::Item> insert;
+
+	remove.push_back (item (100, MIDI_CMD_NOTE_ON, 62, 100));
+	remove.push_back (item (200, MIDI_CMD_NOTE_OFF, 62, 0));
+	insert.push_back (item (300, MIDI_CMD_NOTE_ON, 62, 100));
+	insert.push_back (item (400, MIDI_CMD_NOTE_OFF, 62, 0));
+
+	CPPUNIT_ASSERT (rtm.patch (remove, insert));
+
+	{
+		/* the note-off at 300 must precede the note-on */
+		samplepos_t times[] = { 0, 100, 200, 300, 300, 400 };
+		uint8_t status[]    = { MIDI_CMD_NOTE_ON, MIDI_CMD_NOTE_OFF, MIDI_CMD_NOTE_ON, MIDI_CMD_NOTE_OFF, MIDI_CMD_NOTE_ON, MIDI_CMD_NOTE_OFF };
+		uint8_t notes[]     = { 60, 60, 64, 64, 62, 62 };
+		check_events (rtm, times, status, notes, 6);
+
+		/* an empty patch swaps the copies, the other one must match */
+		CPPUNIT_ASSERT (rtm.patch (vector<RTMidiBuffer::Item> (), vector<RTMidiBuffer::Item> ()));
+		check_events (rtm, times, status, notes, 6);
+	}
+
+	/* add a note at the start, both copies must be updated */
+	remove.clear ();
+	insert.clear ();
+	insert.push_back (item (0, MIDI_CMD_NOTE_ON, 48, 100));
+	insert.push_back (item (50, MIDI_CMD_NOTE_OFF, 48, 0));
+
+	CPPUNIT_ASSERT (rtm.patch (remove, insert));
+
+	{
+		samplepos_t times[] = { 0, 0, 50, 100, 200, 300, 300, 400 };
+		uint8_t status[]    = { MIDI_CMD_NOTE_ON, MIDI_CMD_NOTE_ON, MIDI_CMD_NOTE_OFF, MIDI_CMD_NOTE_OFF, MIDI_CMD_NOTE_ON, MIDI_CMD_NOTE_OFF, MIDI_CMD_NOTE_ON, MIDI_CMD_NOTE_OFF };
+		uint8_t notes[]     = { 60, 48, 48, 60, 64, 64, 62, 62 };
+		check_events (rtm, times, status, notes, 8);
+		CPPUNIT_ASSERT (rtm.patch (vector<RTMidiBuffer::Item> (), vector<RTMidiBuffer::Item> ()));
+		check_events (rtm, times, status, notes, 8);
+	}
+}
+
+void
+RTMidiBufferTest::rejectTest ()
+{
+	RTMidiBuffer rtm;
+
+	{
+		RTMidiBuffer::WriteProtectRender wpr (rtm);
+		wpr.acquire ();
+		rtm.clear ();
+		write_note (rtm, 0, 100, 60);
+	}
+
+	samplepos_t times[] = { 0, 100 };
+	uint8_t status[]    = { MIDI_CMD_NOTE_ON, MIDI_CMD_NOTE_OFF };
+	uint8_t notes[]     = { 60, 60 };
+
+	vector<RTMidiBuffer::Item> remove;
+	vector<RTMidiBuffer::Item> insert;
+
+	/* not present */
+	remove.push_back (item (100, MIDI_CMD_NOTE_ON, 60, 100));
+	insert.push_back (item (200, MIDI_CMD_NOTE_ON, 60, 100));
+	CPPUNIT_ASSERT (!rtm.patch (remove, insert));
+	check_events (rtm, times, status, notes, 2);
+
+	/* already present */
+	remove.clear ();
+	insert.clear ();
+	insert.push_back (item (0, MIDI_CMD_NOTE_ON, 60, 100));
+	CPPUNIT_ASSERT (!rtm.patch (remove, insert));
+	check_events (rtm, times, status, notes, 2);
+
+	/* a render in progress */
+	insert.clear ();
+	insert.push_back (item (200, MIDI_CMD_NOTE_ON, 62, 100));
+	{
+		RTMidiBuffer::WriteProtectRender wpr (rtm);
+		CPPUNIT_ASSERT (!rtm.patch (remove, insert));
+	}
+	check_events (rtm, times, status, notes, 2);
+}
+
+void
+RTMidiBufferTest::readTest ()
+{
+	RTMidiBuffer rtm;
+
+	{
+		RTMidiBuffer::WriteProtectRender wpr (rtm);
+		wpr.acquire ();
+		rtm.clear ();
+
+		/* dense controller data, with some sysex in between */
+		for (int i = 0; i < 1000; ++i) {
+			uint8_t cc[3] = { MIDI_CMD_CONTROL, 1, (uint8_t) (i & 0x7f) };
+			rtm.write (i * 3, Evoral::MIDI_EVENT, 3, cc);
+			if (i % 100 == 50) {
+				uint8_t sysex[6] = { MIDI_CMD_COMMON_SYSEX, 0x7e, 0x7f, 0x06, 0x01, MIDI_CMD_COMMON_SYSEX_END };
+				rtm.write (i * 3, Evoral::MIDI_EVENT, 6, sysex);
+			}
+		}
+	}
+
+	/* read in cycles, event times are relative to the start of the cycle */
+	MidiStateTracker tracker;
+	size_t n_cc    = 0;
+	size_t n_sysex = 0;
+
+	for (samplepos_t s = 0; s < 3000; s += 64) {
+		MidiBuffer buf (4096);
+		rtm.read (buf, s, s + 64, tracker);
+
+		for (MidiBuffer::iterator e = buf.begin (); e != buf.end (); ++e) {
+			CPPUNIT_ASSERT ((*e).time () < 64);
+
+			if ((*e).buffer ()[0] == MIDI_CMD_COMMON_SYSEX) {
+				CPPUNIT_ASSERT_EQUAL ((uint32_t) 6, (*e).size ());
+				++n_sysex;
+			} else {
+				const samplepos_t t = s + (*e).time ();
+				CPPUNIT_ASSERT_EQUAL ((samplepos_t) 0, t % 3);
+				CPPUNIT_ASSERT_EQUAL ((uint8_t) ((t / 3) & 0x7f), (*e).buffer ()[2]);
+				++n_cc;
+			}
+		}
+	}
+
+	CPPUNIT_ASSERT_EQUAL ((size_t) 1000, n_cc);
+	CPPUNIT_ASSERT_EQUAL ((size_t) 10, n_sysex);
+
+	/* a destination without space for all events gets as many as fit */
+	MidiBuffer small (MidiBuffer::record_size (3) * 4);
+	CPPUNIT_ASSERT_EQUAL ((uint32_t) 3, rtm.read (small, 0, 300, tracker));
+}
+
+void
+RTMidiBufferTest::compactTest ()
+{
+	RTMidiBuffer rtm;
+
+	{
+		RTMidiBuffer::WriteProtectRender wpr (rtm);
+		wpr.acquire ();
+		rtm.clear ();
+		write_note (rtm, 0, 10, 60);
+	}
+
+	vector<RTMidiBuffer::Item> remove;
+	vector<RTMidiBuffer::Item> insert;
+
+	/* patched events can be removed again before they are merged */
+	insert.push_back (item (20, MIDI_CMD_NOTE_ON, 61, 100));
+	insert.push_back (item (30, MIDI_CMD_NOTE_OFF, 61, 0));
+	CPPUNIT_ASSERT (rtm.patch (remove, insert));
+	CPPUNIT_ASSERT (rtm.patch (insert, remove));
+
+	{
+		samplepos_t times[] = { 0, 10 };
+		uint8_t status[]    = { MIDI_CMD_NOTE_ON, MIDI_CMD_NOTE_OFF };
+		uint8_t notes[]     = { 60, 60 };
+		check_events (rtm, times, status, notes, 2);
+	}
+
+	/* enough single-note edits for the patched events to be merged
+	 * into the main store, some of them in between
+	 */
+	for (int i = 1; i <= 1000; ++i) {
+		remove.clear ();
+		insert.clear ();
+		insert.push_back (item (i * 10, MIDI_CMD_NOTE_ON, 62, 100));
+		insert.push_back (item (i * 10 + 5, MIDI_CMD_NOTE_OFF, 62, 0));
+		CPPUNIT_ASSERT (rtm.patch (remove, insert));
+	}
+
+	/* and move the first note behind all others */
+	remove.clear ();
+	insert.clear ();
+	remove.push_back (item (0, MIDI_CMD_NOTE_ON, 60, 100));
+	remove.push_back (item (10, MIDI_CMD_NOTE_OFF, 60, 0));
+	insert.push_back (item (20000, MIDI_CMD_NOTE_ON, 60, 100));
+	insert.push_back (item (20010, MIDI_CMD_NOTE_OFF, 60, 0));
+	CPPUNIT_ASSERT (rtm.patch (remove, insert));
+
+	for (int copy = 0; copy < 2; ++copy) {
+		CPPUNIT_ASSERT_EQUAL ((size_t) 2002, rtm.size ());
+
+		MidiStateTracker tracker;
+		samplepos_t      t = 0;
+		size_t           n = 0;
+
+		for (samplepos_t s = 0; s < 20100; s += 64) {
+			MidiBuffer buf (4096);
+			rtm.read (buf, s, s + 64, tracker);
+
+			for (MidiBuffer::iterator e = buf.begin (); e != buf.end (); ++e, ++n) {
+				CPPUNIT_ASSERT (s + (*e).time () >= t);
+				t = s + (*e).time ();
+
+				if (n < 2000) {
+					CPPUNIT_ASSERT_EQUAL ((uint8_t) 62, (*e).buffer ()[1]);
+					CPPUNIT_ASSERT_EQUAL ((samplepos_t) ((n / 2 + 1) * 10 + (n % 2) * 5), t);
+				} else {
+					CPPUNIT_ASSERT_EQUAL ((uint8_t) 60, (*e).buffer ()[1]);
+				}
+			}
+		}
+
+		CPPUNIT_ASSERT_EQUAL ((size_t) 2002, n);
+
+		/* swap the copies */
+		CPPUNIT_ASSERT (rtm.patch (vector<RTMidiBuffer::Item> (), vector<RTMidiBuffer::Item> ()));
+	}
+}
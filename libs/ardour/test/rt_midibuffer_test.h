@@ -0,0 +1,18 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class RTMidiBufferTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (RTMidiBufferTest);
+	CPPUNIT_TEST (patchTest);
+	CPPUNIT_TEST (rejectTest);
+	CPPUNIT_TEST (readTest);
+	CPPUNIT_TEST (compactTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void patchTest ();
+	void rejectTest ();
+	void readTest ();
+	void compactTest ();
+};
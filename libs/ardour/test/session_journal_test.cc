@@ -0,0 +1,113 @@
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+
+#include "pbd/xml++.h"
+
+#include "ardour/audioengine.h"
+#include "ardour/filename_extensions.h"
+#include "ardour/location.h"
+#include "ardour/rc_configuration.h"
+#include "ardour/route.h"
+#include "ardour/session.h"
+
+#include "test_util.h"
+
+#include "session_journal_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (SessionJournalTest);
+
+using namespace std;
+using namespace ARDOUR;
+using namespace PBD;
+
+static void
+check_same_state (string const& a, string const& b)
+{
+	XMLTree ta;
+	XMLTree tb;
+	CPPUNIT_ASSERT (ta.read (a));
+	CPPUNIT_ASSERT (tb.read (b));
+
+	const char* nodes[] = { "Sources", "Regions", "Locations", "Routes", "Playlists", 0 };
+
+	for (const char** n = nodes; *n; ++n) {
+		XMLNode* na = ta.root ()->child (*n);
+		XMLNode* nb = tb.root ()->child (*n);
+		CPPUNIT_ASSERT ((na == 0) == (nb == 0));
+		if (na) {
+			CPPUNIT_ASSERT_MESSAGE (*n, *na == *nb);
+		}
+	}
+}
+
+/* Make a complete save, change the session and save it incrementally.
+ * The session loaded from the file and the journal must be the same as
+ * a complete save of the changed session.
+ */
+void
+SessionJournalTest::roundTrip ()
+{
+	const string session_name ("journal");
+	const string dir          = Glib::build_filename (new_test_output_dir ("session_journal"), session_name);
+	const string journal      = Glib::build_filename (dir, session_name + journal_suffix);
+
+	const bool incremental = Config->get_incremental_save ();
+	Config->set_incremental_save (true);
+
+	create_and_start_dummy_backend ();
+
+	Session* session = load_session (dir, session_name);
+	CPPUNIT_ASSERT (session);
+
+	/* complete save, the base of the journal */
+	CPPUNIT_ASSERT_EQUAL (0, session->save_state (""));
+	CPPUNIT_ASSERT (!Glib::file_test (journal, Glib::FILE_TEST_EXISTS));
+
+	/* nothing changed, no journal is needed */
+	CPPUNIT_ASSERT_EQUAL (0, session->save_state (""));
+	CPPUNIT_ASSERT (!Glib::file_test (journal, Glib::FILE_TEST_EXISTS));
+
+	/* change state, and save incrementally */
+	session->locations ()->add (new Location (*session, 1000, 2000, "range", Location::IsRangeMarker));
+	session->locations ()->add (new Location (*session, 3000, 3000, "mark", Location::IsMark));
+	CPPUNIT_ASSERT_EQUAL (0, session->save_state (""));
+	CPPUNIT_ASSERT (Glib::file_test (journal, Glib::FILE_TEST_EXISTS));
+
+	/* a route that was not serialized by the previous incremental save,
+	 * its change must be noticed */
+	session->master_out ()->gain_control ()->set_value_unchecked (0.5);
+	CPPUNIT_ASSERT_EQUAL (0, session->save_state (""));
+	CPPUNIT_ASSERT (Glib::file_test (journal, Glib::FILE_TEST_EXISTS));
+
+	/* complete save of the same state */
+	CPPUNIT_ASSERT_EQUAL (0, session->save_state ("reference"));
+
+	delete session;
+	stop_and_destroy_backend ();
+
+	/* reload, applying the journal */
+	create_and_start_dummy_backend ();
+
+	session = new Session (*AudioEngine::instance (), dir, session_name);
+	CPPUNIT_ASSERT (session);
+
+	Locations::LocationList const& ll (session->locations ()->list ());
+	int n_markers = 0;
+	for (Locations::LocationList::const_iterator i = ll.begin (); i != ll.end (); ++i) {
+		if ((*i)->name () == "range" || (*i)->name () == "mark") {
+			++n_markers;
+		}
+	}
+	CPPUNIT_ASSERT_EQUAL (2, n_markers);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.5, session->master_out ()->gain_control ()->get_value (), 1e-6);
+
+	CPPUNIT_ASSERT_EQUAL (0, session->save_state ("reloaded"));
+
+	delete session;
+	stop_and_destroy_backend ();
+
+	check_same_state (Glib::build_filename (dir, string ("reference") + statefile_suffix),
+	                  Glib::build_filename (dir, string ("reloaded") + statefile_suffix));
+
+	Config->set_incremental_save (incremental);
+}
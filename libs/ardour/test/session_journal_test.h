@@ -0,0 +1,12 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class SessionJournalTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (SessionJournalTest);
+	CPPUNIT_TEST (roundTrip);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void roundTrip ();
+};
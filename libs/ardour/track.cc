@@ -499,6 +499,18 @@ Track::do_refill ()
 	return _disk_reader->do_refill ();
 }
 
+void
+Track::prefetch (DiskPrefetch& dp)
+{
+	_disk_reader->prefetch (dp);
+}
+
+int
+Track::do_refill (Sample* sum_buffer, Sample* mixdown_buffer, gain_t* gain_buffer)
+{
+	return _disk_reader->do_refill (sum_buffer, mixdown_buffer, gain_buffer);
+}
+
 int
 Track::do_flush (RunContext c, bool force)
 {
@@ -654,6 +654,17 @@ VSTPlugin::plugin_latency () const
 #endif
 }
 
+samplecnt_t
+VSTPlugin::plugin_tail () const
+{
+	/* 0: default (unknown), 1: no tail */
+	intptr_t tail = _plugin->dispatcher (_plugin, effGetTailSize, 0, 0, NULL, 0.0f);
+	if (tail == 0) {
+		return -1;
+	}
+	return tail == 1 ? 0 : tail;
+}
+
 set<Evoral::Parameter>
 VSTPlugin::automatable () const
 {
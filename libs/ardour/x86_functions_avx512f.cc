@@ -0,0 +1,412 @@
+/*
+ * Copyright (C) 2026 The Ardour Team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "ardour/mix.h"
+
+#include <immintrin.h>
+
+/* AVX-512 loads and stores do not require aligned memory, and there is no
+ * penalty for unaligned access as long as no cache-line is crossed. So
+ * rather than processing leading samples one at a time, the head and the
+ * tail of the buffer are processed using masked loads and stores.
+ */
+
+static inline __mmask16
+tail_mask (uint32_t nframes)
+{
+	return (__mmask16) ((1U << nframes) - 1);
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized routine for compute peak procedure
+ * @param src Pointer to source buffer
+ * @param nframes Number of samples to process
+ * @param current Current peak value
+ * @return float New peak value
+ */
+float
+x86_avx512f_compute_peak (const float* src, uint32_t nframes, float current)
+{
+	__m512 vmax0 = _mm512_set1_ps (current);
+	__m512 vmax1 = vmax0;
+
+	while (nframes >= 32) {
+		__m512 x0 = _mm512_loadu_ps (src + 0);
+		__m512 x1 = _mm512_loadu_ps (src + 16);
+
+		vmax0 = _mm512_max_ps (vmax0, _mm512_abs_ps (x0));
+		vmax1 = _mm512_max_ps (vmax1, _mm512_abs_ps (x1));
+
+		src += 32;
+		nframes -= 32;
+	}
+
+	if (nframes >= 16) {
+		vmax0 = _mm512_max_ps (vmax0, _mm512_abs_ps (_mm512_loadu_ps (src)));
+		src += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		/* masked-out elements are zero, which does not affect the peak */
+		__m512 x0 = _mm512_maskz_loadu_ps (tail_mask (nframes), src);
+		vmax1 = _mm512_max_ps (vmax1, _mm512_abs_ps (x0));
+	}
+
+	vmax0 = _mm512_max_ps (vmax0, vmax1);
+	return _mm512_reduce_max_ps (vmax0);
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized routine for find peak procedure
+ * @param src Pointer to source buffer
+ * @param nframes Number of samples to process
+ * @param[in,out] minf Current minimum value, updated
+ * @param[in,out] maxf Current maximum value, updated
+ */
+void
+x86_avx512f_find_peaks (const float* src, uint32_t nframes, float* minf, float* maxf)
+{
+	__m512 vmin = _mm512_set1_ps (*minf);
+	__m512 vmax = _mm512_set1_ps (*maxf);
+
+	while (nframes >= 16) {
+		__m512 x0 = _mm512_loadu_ps (src);
+
+		vmin = _mm512_min_ps (vmin, x0);
+		vmax = _mm512_max_ps (vmax, x0);
+
+		src += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		/* only update the active elements */
+		const __mmask16 m  = tail_mask (nframes);
+		__m512          x0 = _mm512_maskz_loadu_ps (m, src);
+
+		vmin = _mm512_mask_min_ps (vmin, m, vmin, x0);
+		vmax = _mm512_mask_max_ps (vmax, m, vmax, x0);
+	}
+
+	*minf = _mm512_reduce_min_ps (vmin);
+	*maxf = _mm512_reduce_max_ps (vmax);
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized routine for apply gain routine
+ * @param[in,out] dst Pointer to the destination buffer, which gets updated
+ * @param nframes Number of samples to process
+ * @param gain Gain to apply
+ */
+void
+x86_avx512f_apply_gain_to_buffer (float* dst, uint32_t nframes, float gain)
+{
+	const __m512 g0 = _mm512_set1_ps (gain);
+
+	while (nframes >= 32) {
+		__m512 x0 = _mm512_loadu_ps (dst + 0);
+		__m512 x1 = _mm512_loadu_ps (dst + 16);
+
+		_mm512_storeu_ps (dst + 0, _mm512_mul_ps (x0, g0));
+		_mm512_storeu_ps (dst + 16, _mm512_mul_ps (x1, g0));
+
+		dst += 32;
+		nframes -= 32;
+	}
+
+	if (nframes >= 16) {
+		_mm512_storeu_ps (dst, _mm512_mul_ps (_mm512_loadu_ps (dst), g0));
+		dst += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		_mm512_mask_storeu_ps (dst, m, _mm512_mul_ps (_mm512_maskz_loadu_ps (m, dst), g0));
+	}
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized routine for mixing buffer with gain.
+ *
+ * Multiplication and addition are deliberately not fused, so that the
+ * result is identical to default_mix_buffers_with_gain().
+ *
+ * @param[in,out] dst Pointer to destination buffer, which gets updated
+ * @param[in] src Pointer to source buffer (not updated)
+ * @param nframes Number of samples to process
+ * @param gain Gain to apply
+ */
+void
+x86_avx512f_mix_buffers_with_gain (float* dst, const float* src, uint32_t nframes, float gain)
+{
+	const __m512 g0 = _mm512_set1_ps (gain);
+
+	while (nframes >= 32) {
+		__m512 s0 = _mm512_loadu_ps (src + 0);
+		__m512 s1 = _mm512_loadu_ps (src + 16);
+		__m512 d0 = _mm512_loadu_ps (dst + 0);
+		__m512 d1 = _mm512_loadu_ps (dst + 16);
+
+		_mm512_storeu_ps (dst + 0, _mm512_add_ps (d0, _mm512_mul_ps (s0, g0)));
+		_mm512_storeu_ps (dst + 16, _mm512_add_ps (d1, _mm512_mul_ps (s1, g0)));
+
+		src += 32;
+		dst += 32;
+		nframes -= 32;
+	}
+
+	if (nframes >= 16) {
+		__m512 s0 = _mm512_loadu_ps (src);
+		__m512 d0 = _mm512_loadu_ps (dst);
+		_mm512_storeu_ps (dst, _mm512_add_ps (d0, _mm512_mul_ps (s0, g0)));
+
+		src += 16;
+		dst += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m  = tail_mask (nframes);
+		__m512          s0 = _mm512_maskz_loadu_ps (m, src);
+		__m512          d0 = _mm512_maskz_loadu_ps (m, dst);
+		_mm512_mask_storeu_ps (dst, m, _mm512_add_ps (d0, _mm512_mul_ps (s0, g0)));
+	}
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized routine for mixing buffer without gain.
+ *
+ * @param[in,out] dst Pointer to destination buffer, which gets updated
+ * @param[in] src Pointer to source buffer (not updated)
+ * @param nframes Number of samples to process
+ */
+void
+x86_avx512f_mix_buffers_no_gain (float* dst, const float* src, uint32_t nframes)
+{
+	while (nframes >= 32) {
+		__m512 s0 = _mm512_loadu_ps (src + 0);
+		__m512 s1 = _mm512_loadu_ps (src + 16);
+		__m512 d0 = _mm512_loadu_ps (dst + 0);
+		__m512 d1 = _mm512_loadu_ps (dst + 16);
+
+		_mm512_storeu_ps (dst + 0, _mm512_add_ps (d0, s0));
+		_mm512_storeu_ps (dst + 16, _mm512_add_ps (d1, s1));
+
+		src += 32;
+		dst += 32;
+		nframes -= 32;
+	}
+
+	if (nframes >= 16) {
+		_mm512_storeu_ps (dst, _mm512_add_ps (_mm512_loadu_ps (dst), _mm512_loadu_ps (src)));
+
+		src += 16;
+		dst += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m  = tail_mask (nframes);
+		__m512          s0 = _mm512_maskz_loadu_ps (m, src);
+		__m512          d0 = _mm512_maskz_loadu_ps (m, dst);
+		_mm512_mask_storeu_ps (dst, m, _mm512_add_ps (d0, s0));
+	}
+}
+
+/**
+ * @brief Copy vector from one location to another
+ *
+ * @param[out] dst Pointer to destination buffer
+ * @param[in] src Pointer to source buffer
+ * @param nframes Number of samples to copy
+ */
+void
+x86_avx512f_copy_vector (float* dst, const float* src, uint32_t nframes)
+{
+	while (nframes >= 64) {
+		__m512 x0 = _mm512_loadu_ps (src + 0);
+		__m512 x1 = _mm512_loadu_ps (src + 16);
+		__m512 x2 = _mm512_loadu_ps (src + 32);
+		__m512 x3 = _mm512_loadu_ps (src + 48);
+
+		_mm512_storeu_ps (dst + 0, x0);
+		_mm512_storeu_ps (dst + 16, x1);
+		_mm512_storeu_ps (dst + 32, x2);
+		_mm512_storeu_ps (dst + 48, x3);
+
+		src += 64;
+		dst += 64;
+		nframes -= 64;
+	}
+
+	while (nframes >= 16) {
+		_mm512_storeu_ps (dst, _mm512_loadu_ps (src));
+
+		src += 16;
+		dst += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		_mm512_mask_storeu_ps (dst, m, _mm512_maskz_loadu_ps (m, src));
+	}
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized routine for mixing many buffers into one.
+ *
+ * The destination is kept in registers while all sources are added, so
+ * it is only read and written once, regardless of the number of sources.
+ *
+ * @param[in,out] dst Pointer to destination buffer, which gets updated
+ * @param[in] srcs Array of \p n_src pointers to source buffers
+ * @param[in] gains Array of \p n_src gain coefficients, or NULL for unity gain
+ * @param n_src Number of source buffers
+ * @param nframes Number of samples to process
+ */
+void
+x86_avx512f_mix_buffers_n (float* dst, const float* const* srcs, const float* gains, uint32_t n_src, uint32_t nframes)
+{
+	uint32_t off = 0;
+
+	while (nframes - off >= 64) {
+		__m512 d0 = _mm512_loadu_ps (dst + off + 0);
+		__m512 d1 = _mm512_loadu_ps (dst + off + 16);
+		__m512 d2 = _mm512_loadu_ps (dst + off + 32);
+		__m512 d3 = _mm512_loadu_ps (dst + off + 48);
+
+		for (uint32_t s = 0; s < n_src; ++s) {
+			const float* src = srcs[s] + off;
+			__m512 s0 = _mm512_loadu_ps (src + 0);
+			__m512 s1 = _mm512_loadu_ps (src + 16);
+			__m512 s2 = _mm512_loadu_ps (src + 32);
+			__m512 s3 = _mm512_loadu_ps (src + 48);
+			if (gains) {
+				const __m512 g0 = _mm512_set1_ps (gains[s]);
+				s0 = _mm512_mul_ps (s0, g0);
+				s1 = _mm512_mul_ps (s1, g0);
+				s2 = _mm512_mul_ps (s2, g0);
+				s3 = _mm512_mul_ps (s3, g0);
+			}
+			d0 = _mm512_add_ps (d0, s0);
+			d1 = _mm512_add_ps (d1, s1);
+			d2 = _mm512_add_ps (d2, s2);
+			d3 = _mm512_add_ps (d3, s3);
+		}
+
+		_mm512_storeu_ps (dst + off + 0, d0);
+		_mm512_storeu_ps (dst + off + 16, d1);
+		_mm512_storeu_ps (dst + off + 32, d2);
+		_mm512_storeu_ps (dst + off + 48, d3);
+
+		off += 64;
+	}
+
+	while (off < nframes) {
+		const uint32_t  n = nframes - off;
+		const __mmask16 m = n >= 16 ? (__mmask16) 0xffff : tail_mask (n);
+
+		__m512 d0 = _mm512_maskz_loadu_ps (m, dst + off);
+
+		for (uint32_t s = 0; s < n_src; ++s) {
+			__m512 s0 = _mm512_maskz_loadu_ps (m, srcs[s] + off);
+			if (gains) {
+				s0 = _mm512_mul_ps (s0, _mm512_set1_ps (gains[s]));
+			}
+			d0 = _mm512_add_ps (d0, s0);
+		}
+
+		_mm512_mask_storeu_ps (dst + off, m, d0);
+		off += 16;
+	}
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized one-pole gain ramp, see default_apply_gain_ramp()
+ * @param[in,out] dst Pointer to the destination buffer, which gets updated
+ * @param nframes Number of samples to process
+ * @param initial Gain at the first sample
+ * @param target Target gain
+ * @param coeff Low-pass filter coefficient
+ * @return float Gain after the last sample
+ */
+float
+x86_avx512f_apply_gain_ramp (float* dst, uint32_t nframes, float initial, float target, float coeff)
+{
+	const float r   = 1.f - coeff;
+	const float r2  = r * r;
+	const float r4  = r2 * r2;
+	const float r8  = r4 * r4;
+	const float r16 = r8 * r8;
+
+	/* distance to target for 16 consecutive samples */
+	float d[16];
+	d[0] = initial - target;
+	for (int k = 1; k < 16; ++k) {
+		d[k] = d[k - 1] * r;
+	}
+
+	const __m512 vt   = _mm512_set1_ps (target);
+	const __m512 vr16 = _mm512_set1_ps (r16);
+	__m512       vd   = _mm512_loadu_ps (d);
+
+	while (nframes >= 16) {
+		__m512 x0 = _mm512_loadu_ps (dst);
+		_mm512_storeu_ps (dst, _mm512_mul_ps (x0, _mm512_add_ps (vt, vd)));
+		vd = _mm512_mul_ps (vd, vr16);
+		dst += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m  = tail_mask (nframes);
+		__m512          x0 = _mm512_maskz_loadu_ps (m, dst);
+		_mm512_mask_storeu_ps (dst, m, _mm512_mul_ps (x0, _mm512_add_ps (vt, vd)));
+		/* advance to the first sample after the tail */
+		_mm512_storeu_ps (d, vd);
+		return target + d[nframes - 1] * r;
+	}
+
+	_mm512_storeu_ps (d, vd);
+	return target + d[0];
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized routine to apply a per-sample gain
+ * @param[in,out] dst Pointer to the destination buffer, which gets updated
+ * @param[in] gain Pointer to the gain coefficients, one per sample
+ * @param nframes Number of samples to process
+ */
+void
+x86_avx512f_apply_gain_vector (float* dst, const float* gain, uint32_t nframes)
+{
+	while (nframes >= 16) {
+		_mm512_storeu_ps (dst, _mm512_mul_ps (_mm512_loadu_ps (dst), _mm512_loadu_ps (gain)));
+		dst += 16;
+		gain += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		_mm512_mask_storeu_ps (dst, m, _mm512_mul_ps (_mm512_maskz_loadu_ps (m, dst), _mm512_maskz_loadu_ps (m, gain)));
+	}
+}
@@ -35,6 +35,7 @@
 
 #define GUARD_POINT_DELTA 64
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <iostream>
@@ -66,6 +67,7 @@ ControlList::ControlList (const Parameter& id, const ParameterDescriptor& desc)
 	, _interpolation (default_interpolation ())
 	, _curve(0)
 {
+	_generation = 1;
 	_frozen = 0;
 	_changed_when_thawed = false;
 	_lookup_cache.left = -1;
@@ -87,6 +89,7 @@ ControlList::ControlList (const ControlList& other)
 	, _interpolation(other._interpolation)
 	, _curve(0)
 {
+	_generation = 1;
 	_frozen = 0;
 	_changed_when_thawed = false;
 	_lookup_cache.range.first = _events.end();
@@ -109,6 +112,7 @@ ControlList::ControlList (const ControlList& other, double start, double end)
 	, _interpolation(other._interpolation)
 	, _curve(0)
 {
+	_generation = 1;
 	_frozen = 0;
 	_changed_when_thawed = false;
 	_lookup_cache.range.first = _events.end();
@@ -549,8 +553,7 @@ ControlList::add_guard_point (double when, double offset)
 
 	when += offset;
 
-	ControlEvent cp (when, 0.0);
-	most_recent_insert_iterator = lower_bound (_events.begin(), _events.end(), &cp, time_comparator);
+	most_recent_insert_iterator = lower_bound_unlocked (when);
 
 	double eval_value = unlocked_eval (when);
 
@@ -559,6 +562,7 @@ ControlList::add_guard_point (double when, double offset)
 		DEBUG_TRACE (DEBUG::ControlList, string_compose ("@%1 insert iterator at end, adding eval-value there %2\n", this, eval_value));
 		_events.push_back (new ControlEvent (when, eval_value));
 		/* leave insert iterator at the end */
+		mark_dirty ();
 
 	} else if ((*most_recent_insert_iterator)->when == when) {
 
@@ -584,6 +588,7 @@ ControlList::add_guard_point (double when, double offset)
 								 this, eval_value, (*most_recent_insert_iterator)->when));
 
 		most_recent_insert_iterator = _events.insert (most_recent_insert_iterator, new ControlEvent (when, eval_value));
+		mark_dirty ();
 
 		/* advance most_recent_insert_iterator so that the "real"
 		 * insert occurs in the right place, since it
@@ -608,7 +613,7 @@ ControlList::editor_add (double when, double value, bool with_guard)
 		Glib::Threads::RWLock::WriterLock lm (_lock);
 
 		ControlEvent cp (when, 0.0f);
-		iterator i = lower_bound (_events.begin(), _events.end(), &cp, time_comparator);
+		iterator i = lower_bound_unlocked (when);
 
 		if (i != _events.end () && (*i)->when == when) {
 			return false;
@@ -626,6 +631,7 @@ ControlList::editor_add (double when, double value, bool with_guard)
 			if (when >= 1) {
 				_events.insert (_events.end(), new ControlEvent (0, value));
 				DEBUG_TRACE (DEBUG::ControlList, string_compose ("@%1 added value %2 at zero\n", this, value));
+				mark_dirty ();
 			}
 		}
 
@@ -663,6 +669,7 @@ ControlList::maybe_add_insert_guard (double when)
 			   new control point so that our insert will happen correctly. */
 			most_recent_insert_iterator = _events.insert ( most_recent_insert_iterator,
 					new ControlEvent (when + GUARD_POINT_DELTA, (*most_recent_insert_iterator)->value));
+			mark_dirty ();
 
 			DEBUG_TRACE (DEBUG::ControlList, string_compose ("@%1 added insert guard point @ %2 = %3\n",
 			                                                 this, when + GUARD_POINT_DELTA,
@@ -710,6 +717,7 @@ ControlList::erase_from_iterator_to (iterator iter, double when)
 			DEBUG_TRACE (DEBUG::ControlList, string_compose ("@%1 erase existing @ %2\n", this, (*iter)->when));
 			delete *iter;
 			iter = _events.erase (iter);
+			mark_dirty ();
 			continue;
 		} else if ((*iter)->when >= when) {
 			break;
@@ -751,6 +759,8 @@ ControlList::add (double when, double value, bool with_guards, bool with_initial
 					_events.insert (_events.end(), new ControlEvent (0, value));
 					DEBUG_TRACE (DEBUG::ControlList, string_compose ("@%1 added default value %2 at zero\n", this, _desc.normal));
 				}
+				/* lookups below must not use the index */
+				mark_dirty ();
 			}
 		}
 
@@ -763,8 +773,7 @@ ControlList::add (double when, double value, bool with_guards, bool with_initial
 				did_write_during_pass = true;
 			} else {
 				/* not adding a guard, but we need to set iterator appropriately */
-				const ControlEvent cp (when, 0.0);
-				most_recent_insert_iterator = lower_bound (_events.begin(), _events.end(), &cp, time_comparator);
+				most_recent_insert_iterator = lower_bound_unlocked (when);
 			}
 			WritePassStarted (); /* EMIT SIGNAL w/WriteLock */
 			new_write_pass = false;
@@ -791,8 +800,7 @@ ControlList::add (double when, double value, bool with_guards, bool with_initial
 			/* not in a write pass: figure out the iterator we should insert in front of */
 
 			DEBUG_TRACE (DEBUG::ControlList, string_compose ("compute(b) MRI for position %1\n", when));
-			ControlEvent cp (when, 0.0f);
-			most_recent_insert_iterator = lower_bound (_events.begin(), _events.end(), &cp, time_comparator);
+			most_recent_insert_iterator = lower_bound_unlocked (when);
 		}
 
 		/* OK, now we're really ready to add a new point */
@@ -1132,7 +1140,14 @@ ControlList::thaw ()
 			unlocked_remove_duplicates ();
 			unlocked_invalidate_insert_iterator ();
 			_sort_pending = false;
+			mark_dirty ();
 		}
+
+		/* thaw is usually called after loading or a larger edit,
+		 * prepare the index for realtime readers.
+		 */
+		Glib::Threads::Mutex::Lock il (_index_lock);
+		update_index (true);
 	}
 	maybe_signal_changed ();
 }
@@ -1146,6 +1161,11 @@ ControlList::mark_dirty () const
 	_search_cache.left = -1;
 	_search_cache.first = _events.end();
 
+	{
+		Glib::Threads::Mutex::Lock il (_index_lock);
+		++_generation;
+	}
+
 	if (_curve) {
 		_curve->mark_dirty();
 	}
@@ -1425,6 +1445,14 @@ ControlList::multipoint_eval (double x) const
 	double uval, lval;
 	double fraction;
 
+	{
+		/* binary search in contiguous memory, if possible */
+		Glib::Threads::Mutex::Lock il (_index_lock, Glib::Threads::TRY_LOCK);
+		if (il.locked () && update_index (false)) {
+			return index_eval (x);
+		}
+	}
+
 	/* "Stepped" lookup (no interpolation) */
 	/* FIXME: no cache.  significant? */
 	if (_interpolation == Discrete) {
@@ -1503,6 +1531,159 @@ ControlList::multipoint_eval (double x) const
 	return (*range.first)->value;
 }
 
+/** Rebuild the event index if it was invalidated.
+ *
+ * The caller must hold _index_lock, and a read or write lock on _lock.
+ * Unless \p may_allocate is true, this does not allocate memory and fails
+ * if the index has insufficient capacity for all events.
+ *
+ * @return true if the index is valid
+ */
+bool
+ControlList::update_index (bool may_allocate) const
+{
+	if (index_current ()) {
+		return true;
+	}
+
+	_index.generation = 0;
+
+	const size_t capacity = std::min (_index.when.capacity (), std::min (_index.value.capacity (), _index.iter.capacity ()));
+
+	_index.when.clear ();
+	_index.value.clear ();
+	_index.iter.clear ();
+
+	EventList& events (const_cast<EventList&> (_events));
+
+	for (iterator i = events.begin (); i != events.end (); ++i) {
+		if (!may_allocate && _index.when.size () == capacity) {
+			return false;
+		}
+		_index.when.push_back ((*i)->when);
+		_index.value.push_back ((*i)->value);
+		_index.iter.push_back (i);
+	}
+
+	if (may_allocate) {
+		/* leave some room, so that realtime readers can rebuild
+		 * the index after points have been added.
+		 */
+		const size_t reserve = _index.when.size () + _index.when.size () / 2 + 64;
+		_index.when.reserve (reserve);
+		_index.value.reserve (reserve);
+		_index.iter.reserve (reserve);
+	}
+
+	_index.generation = _generation;
+	return true;
+}
+
+/** @return true if the index was built for the current _events.
+ *
+ * Besides the generation, the index is checked against the size and both
+ * ends of the list, so that an edit that misses mark_dirty() cannot leave
+ * dangling iterators in a current index. The caller must hold _index_lock.
+ */
+bool
+ControlList::index_current () const
+{
+	if (_index.generation != _generation) {
+		return false;
+	}
+
+	EventList& events (const_cast<EventList&> (_events));
+
+	const bool consistent = _index.iter.size () == events.size ()
+		&& (events.empty () || (_index.iter.front () == events.begin () && _index.iter.back () == --events.end ()));
+
+	/* _events was modified without calling mark_dirty () */
+	assert (consistent);
+
+	return consistent;
+}
+
+/** @return position of the first event at or after \p when, requires a valid index */
+size_t
+ControlList::index_lower_bound (double when) const
+{
+	assert (_index.generation == _generation);
+	return std::lower_bound (_index.when.begin (), _index.when.end (), when) - _index.when.begin ();
+}
+
+/** multipoint_eval() using the event index, requires a valid index */
+double
+ControlList::index_eval (double x) const
+{
+	const size_t n  = _index.when.size ();
+	const size_t lb = index_lower_bound (x);
+
+	assert (n > 0);
+
+	if (_interpolation == Discrete) {
+		// shouldn't have made it to multipoint_eval
+		assert (lb < n);
+		if (lb == 0 || _index.when[lb] == x) {
+			return _index.value[lb];
+		}
+		return _index.value[lb - 1];
+	}
+
+	if (lb < n && _index.when[lb] == x) {
+		/* x is a control point in the data */
+		return _index.value[lb];
+	}
+
+	if (lb == 0) {
+		/* we're before the first point */
+		return _index.value.front ();
+	}
+
+	if (lb == n) {
+		/* we're after the last point */
+		return _index.value.back ();
+	}
+
+	const double lpos = _index.when[lb - 1];
+	const double lval = _index.value[lb - 1];
+	const double upos = _index.when[lb];
+	const double uval = _index.value[lb];
+
+	const double fraction = (double) (x - lpos) / (double) (upos - lpos);
+
+	switch (_interpolation) {
+		case Logarithmic:
+			return interpolate_logarithmic (lval, uval, fraction, _desc.lower, _desc.upper);
+		case Exponential:
+			return interpolate_gain (lval, uval, fraction, _desc.upper);
+		case Curved:
+			/* only used x-fade curves, never direct eval */
+			assert (0);
+		default: // Linear
+			return interpolate_linear (lval, uval, fraction);
+	}
+}
+
+/** Find the first event at or after \p when, to be called with the write-lock held.
+ *
+ * This uses the index if it is currently valid, but does not rebuild it,
+ * since the caller is about to modify the list.
+ */
+ControlList::iterator
+ControlList::lower_bound_unlocked (double when)
+{
+	{
+		Glib::Threads::Mutex::Lock il (_index_lock, Glib::Threads::TRY_LOCK);
+		if (il.locked () && index_current ()) {
+			const size_t lb = index_lower_bound (when);
+			return lb < _index.iter.size () ? _index.iter[lb] : _events.end ();
+		}
+	}
+
+	const ControlEvent cp (when, 0.0);
+	return lower_bound (_events.begin(), _events.end(), &cp, time_comparator);
+}
+
 void
 ControlList::build_search_cache_if_necessary (double start) const
 {
@@ -1514,9 +1695,15 @@ ControlList::build_search_cache_if_necessary (double start) const
 	} else if ((_search_cache.left < 0) || (_search_cache.left > start)) {
 		/* Marked dirty (left < 0), or we're too far forward, re-search. */
 
-		const ControlEvent start_point (start, 0);
+		Glib::Threads::Mutex::Lock il (_index_lock, Glib::Threads::TRY_LOCK);
 
-		_search_cache.first = lower_bound (_events.begin(), _events.end(), &start_point, time_comparator);
+		if (il.locked () && update_index (false)) {
+			const size_t lb = index_lower_bound (start);
+			_search_cache.first = lb < _index.iter.size () ? _index.iter[lb] : _events.end ();
+		} else {
+			const ControlEvent start_point (start, 0);
+			_search_cache.first = lower_bound (_events.begin(), _events.end(), &start_point, time_comparator);
+		}
 		_search_cache.left = start;
 	}
 
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2026 The Ardour Team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <cassert>
+
+#include "evoral/NoteArena.h"
+
+using namespace Evoral;
+
+/* blocks are aligned as memory returned by operator new */
+static const size_t block_alignment = 16;
+/* blocks in the first chunk of a pool */
+static const size_t min_blocks_per_chunk = 32;
+/* blocks larger than this are taken from the heap */
+static const size_t max_block_size = 512;
+
+NoteArena::NoteArena (size_t max_blocks_per_chunk)
+	: _max_blocks_per_chunk (std::max (max_blocks_per_chunk, min_blocks_per_chunk))
+{
+}
+
+NoteArena::~NoteArena ()
+{
+	for (std::vector<Pool>::iterator p = _pools.begin (); p != _pools.end (); ++p) {
+		for (std::vector<char*>::iterator c = p->chunks.begin (); c != p->chunks.end (); ++c) {
+			::operator delete (*c);
+		}
+	}
+}
+
+NoteArena::Pool&
+NoteArena::pool (size_t size)
+{
+	for (std::vector<Pool>::iterator p = _pools.begin (); p != _pools.end (); ++p) {
+		if (p->size == size) {
+			return *p;
+		}
+	}
+	_pools.push_back (Pool (size));
+	return _pools.back ();
+}
+
+void*
+NoteArena::allocate (size_t size)
+{
+	size = (std::max (size, sizeof (void*)) + block_alignment - 1) & ~(block_alignment - 1);
+
+	if (size > max_block_size) {
+		return ::operator new (size);
+	}
+
+	Glib::Threads::Mutex::Lock lm (_lock);
+	Pool& p (pool (size));
+
+	++p.used;
+
+	if (p.free_list) {
+		void* rv = p.free_list;
+		p.free_list = *static_cast<void**> (rv);
+		return rv;
+	}
+
+	if (p.fill == p.capacity) {
+		p.capacity = p.capacity ? std::min (2 * p.capacity, _max_blocks_per_chunk) : min_blocks_per_chunk;
+		p.chunks.push_back (static_cast<char*> (::operator new (size * p.capacity)));
+		p.reserved += p.capacity;
+		p.fill = 0;
+	}
+
+	return p.chunks.back () + size * p.fill++;
+}
+
+void
+NoteArena::deallocate (void* ptr, size_t size)
+{
+	if (!ptr) {
+		return;
+	}
+
+	size = (std::max (size, sizeof (void*)) + block_alignment - 1) & ~(block_alignment - 1);
+
+	if (size > max_block_size) {
+		::operator delete (ptr);
+		return;
+	}
+
+	Glib::Threads::Mutex::Lock lm (_lock);
+	Pool& p (pool (size));
+
+	assert (p.used > 0);
+	--p.used;
+
+	*static_cast<void**> (ptr) = p.free_list;
+	p.free_list = ptr;
+}
+
+size_t
+NoteArena::reserved () const
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+	size_t rv = 0;
+	for (std::vector<Pool>::const_iterator p = _pools.begin (); p != _pools.end (); ++p) {
+		rv += p->reserved * p->size;
+	}
+	return rv;
+}
+
+size_t
+NoteArena::used () const
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+	size_t rv = 0;
+	for (std::vector<Pool>::const_iterator p = _pools.begin (); p != _pools.end (); ++p) {
+		rv += p->used;
+	}
+	return rv;
+}
+
+size_t
+NoteArena::chunks () const
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+	size_t rv = 0;
+	for (std::vector<Pool>::const_iterator p = _pools.begin (); p != _pools.end (); ++p) {
+		rv += p->chunks.size ();
+	}
+	return rv;
+}
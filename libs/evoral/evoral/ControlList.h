@@ -25,6 +25,7 @@
 
 #include <cassert>
 #include <list>
+#include <vector>
 #include <stdint.h>
 
 #include <boost/pool/pool.hpp>
@@ -244,6 +245,11 @@ public:
 	 */
 	double eval (double where) const {
 		Glib::Threads::RWLock::ReaderLock lm (_lock);
+		{
+			/* not realtime context, (re)build the index if needed */
+			Glib::Threads::Mutex::Lock il (_index_lock);
+			update_index (true);
+		}
 		return unlocked_eval (where);
 	}
 
@@ -362,6 +368,11 @@ protected:
 
 	void build_search_cache_if_necessary (double start) const;
 
+	bool     update_index (bool may_allocate) const;
+	size_t   index_lower_bound (double when) const;
+	double   index_eval (double x) const;
+	iterator lower_bound_unlocked (double when);
+
 	boost::shared_ptr<ControlList> cut_copy_clear (double, double, int op);
 	bool erase_range_internal (double start, double end, EventList &);
 
@@ -376,6 +387,34 @@ protected:
 	mutable LookupCache   _lookup_cache;
 	mutable SearchCache   _search_cache;
 
+	/** Contiguous copy of event times and values (structure of arrays).
+	 *
+	 * The list remains the authoritative storage, since iterators into it
+	 * must stay valid while editing. Lookups however use a binary search
+	 * on the flat arrays, rather than walking the list.
+	 *
+	 * Every change of _events must be followed by mark_dirty() before the
+	 * next lookup, which increments _generation and so invalidates the
+	 * index. It is lazily rebuilt by readers, see update_index().
+	 * It is protected by _index_lock.
+	 *
+	 * Since the index holds iterators, it is also checked against the
+	 * size and both ends of _events before it is used, see index_current().
+	 */
+	struct EventIndex {
+		EventIndex () : generation (0) {}
+		std::vector<double>   when;
+		std::vector<double>   value;
+		std::vector<iterator> iter;
+		uint64_t              generation; ///< _generation the index was built for
+	};
+
+	bool index_current () const;
+
+	mutable EventIndex            _index;
+	mutable uint64_t              _generation;
+	mutable Glib::Threads::Mutex  _index_lock;
+
 	mutable Glib::Threads::RWLock _lock;
 
 	Parameter             _parameter;
@@ -107,7 +107,11 @@ public:
 	inline const Event<Time>& off_event() const { return _off_event; }
 
 private:
-	// Event buffers are self-contained
+	/* The events use these buffers, so that a note is a single allocation.
+	 * They must be declared before the events.
+	 */
+	uint8_t     _on_buf[3];
+	uint8_t     _off_buf[3];
 	Event<Time> _on_event;
 	Event<Time> _off_event;
 };
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2026 The Ardour Team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EVORAL_NOTE_ARENA_HPP
+#define EVORAL_NOTE_ARENA_HPP
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+#include <glibmm/threads.h>
+
+#include "evoral/visibility.h"
+
+namespace Evoral {
+
+/** Memory for the notes of a Sequence.
+ *
+ * This is a pool allocator, used through NoteAllocator and
+ * boost::allocate_shared(). The sequence still indexes its notes with
+ * shared_ptr, in time-sorted sets; the arena only decides where notes are
+ * placed in memory.
+ *
+ * Notes (together with the reference count of their shared_ptr) are carved
+ * out of large chunks, in the order they are created. Notes that are
+ * loaded or recorded in time order therefore end up next to each other,
+ * in time order, and creating a note costs one allocation from the arena
+ * instead of several from the heap. Notes created later by editing are
+ * placed in freed blocks or at the end, not by time.
+ *
+ * Blocks are grouped by size, freed blocks are reused for blocks of the
+ * same size. Chunks start small and double in size up to a limit, so that
+ * short sequences do not waste memory. They are only released when the
+ * arena is destroyed, which is after the sequence and the last note that
+ * came from it are gone.
+ */
+class LIBEVORAL_API NoteArena {
+public:
+	NoteArena (size_t max_blocks_per_chunk = 4096);
+	~NoteArena ();
+
+	void* allocate (size_t size);
+	void  deallocate (void* p, size_t size);
+
+	/** @return number of bytes allocated from the heap */
+	size_t reserved () const;
+	/** @return number of blocks in use */
+	size_t used () const;
+	/** @return number of chunks allocated from the heap */
+	size_t chunks () const;
+
+private:
+	struct Pool {
+		Pool (size_t s) : size (s), free_list (0), capacity (0), fill (0), used (0), reserved (0) {}
+		size_t             size;      ///< block size
+		void*              free_list; ///< singly linked list of freed blocks
+		size_t             capacity;  ///< blocks in the last chunk
+		size_t             fill;      ///< blocks handed out from the last chunk
+		size_t             used;      ///< blocks in use
+		size_t             reserved;  ///< blocks in all chunks
+		std::vector<char*> chunks;
+	};
+
+	NoteArena (NoteArena const&);
+	NoteArena& operator= (NoteArena const&);
+
+	Pool& pool (size_t size);
+
+	mutable Glib::Threads::Mutex _lock;
+	std::vector<Pool>            _pools;
+	const size_t                 _max_blocks_per_chunk;
+};
+
+/** Standard allocator using a NoteArena, for boost::allocate_shared().
+ * A default constructed allocator uses the heap.
+ */
+template<typename T>
+class /*LIBEVORAL_API*/ NoteAllocator {
+public:
+	typedef T              value_type;
+	typedef T*             pointer;
+	typedef const T*       const_pointer;
+	typedef T&             reference;
+	typedef const T&       const_reference;
+	typedef std::size_t    size_type;
+	typedef std::ptrdiff_t difference_type;
+
+	template<typename U> struct rebind { typedef NoteAllocator<U> other; };
+
+	NoteAllocator () {}
+	NoteAllocator (boost::shared_ptr<NoteArena> const& a) : _arena (a) {}
+	template<typename U> NoteAllocator (NoteAllocator<U> const& other) : _arena (other.arena ()) {}
+
+	pointer allocate (size_type n, const void* = 0) {
+		if (n == 1 && _arena) {
+			return static_cast<pointer> (_arena->allocate (sizeof (T)));
+		}
+		return static_cast<pointer> (::operator new (n * sizeof (T)));
+	}
+
+	void deallocate (pointer p, size_type n) {
+		if (n == 1 && _arena) {
+			_arena->deallocate (p, sizeof (T));
+		} else {
+			::operator delete (p);
+		}
+	}
+
+	void construct (pointer p, const T& val) { new (p) T (val); }
+	void destroy (pointer p) { p->~T (); }
+
+	pointer       address (reference x) const       { return &x; }
+	const_pointer address (const_reference x) const { return &x; }
+	size_type     max_size () const                 { return size_t (-1) / sizeof (T); }
+
+	boost::shared_ptr<NoteArena> const& arena () const { return _arena; }
+
+	template<typename U> bool operator== (NoteAllocator<U> const& other) const { return _arena == other.arena (); }
+	template<typename U> bool operator!= (NoteAllocator<U> const& other) const { return _arena != other.arena (); }
+
+private:
+	boost::shared_ptr<NoteArena> _arena;
+};
+
+} // namespace Evoral
+
+#endif // EVORAL_NOTE_ARENA_HPP
@@ -33,6 +33,7 @@
 
 #include "evoral/visibility.h"
 #include "evoral/Note.h"
+#include "evoral/NoteArena.h"
 #include "evoral/ControlSet.h"
 #include "evoral/ControlList.h"
 #include "evoral/PatchChange.h"
@@ -116,6 +117,14 @@ public:
 	const TypeMap& type_map() const { return _type_map; }
 
 	inline size_t n_notes() const { return _notes.size(); }
+
+	/** Create a note in the memory arena of this sequence.
+	 * The note is not added, see add_note_unlocked().
+	 */
+	NotePtr new_note (uint8_t chan, Time time, Time len, uint8_t note, uint8_t vel = 0x40) const;
+	NotePtr new_note (const Note<Time>& other) const;
+
+	boost::shared_ptr<const NoteArena> note_arena () const { return _note_arena; }
 	inline bool   empty()   const { return _notes.empty() && _sysexes.empty() && _patch_changes.empty() && ControlSet::controls_empty(); }
 
 	inline static bool note_time_comparator(const boost::shared_ptr< const Note<Time> >& a,
@@ -350,6 +359,8 @@ private:
 
 	const TypeMap& _type_map;
 
+	boost::shared_ptr<NoteArena> _note_arena;
+
 	Notes        _notes;       // notes indexed by time
 	Pitches      _pitches[16]; // notes indexed by channel+pitch
 	SysExes      _sysexes;
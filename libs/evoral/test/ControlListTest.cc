@@ -0,0 +1,191 @@
+#include "ControlListTest.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (ControlListTest);
+
+using namespace Evoral;
+
+void
+ControlListTest::evalAfterEdit ()
+{
+	boost::shared_ptr<ControlList> cl = TestCtrlList ();
+	cl->set_interpolation (ControlList::Linear);
+
+	// y = x / 1000 at every 100th sample
+	for (int i = 0; i <= 10; ++i) {
+		cl->fast_simple_add (i * 100, i * .1);
+	}
+
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.0,  cl->eval (-10), 1e-9);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.05, cl->eval (50), 1e-9);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.3,  cl->eval (300), 1e-9);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.99, cl->eval (990), 1e-9);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (1.0,  cl->eval (2000), 1e-9);
+
+	// insert a point, the previously cached lookups must not be used
+	CPPUNIT_ASSERT (cl->editor_add (350, 1.0, false));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.65, cl->eval (325), 1e-9);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (1.0,  cl->eval (350), 1e-9);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.7,  cl->eval (375), 1e-9);
+
+	// adding at an existing position fails
+	CPPUNIT_ASSERT (!cl->editor_add (350, 0.5, false));
+
+	// move and erase points
+	ControlList::iterator i = cl->begin ();
+	++i;
+	cl->modify (i, 100, 0.5);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.25, cl->eval (50), 1e-9);
+
+	cl->erase (i);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.05, cl->eval (50), 1e-9);
+
+	cl->erase_range (300, 400);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.3, cl->eval (300), 1e-9);
+
+	// bulk edit
+	cl->freeze ();
+	for (int i = 0; i <= 10; ++i) {
+		cl->editor_add (i * 100 + 50, 0, false);
+	}
+	cl->thaw ();
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.0,  cl->eval (450), 1e-9);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.25, cl->eval (475), 1e-9);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.5,  cl->eval (500), 1e-9);
+
+	// realtime readers must work with, or without the index
+	bool ok;
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.25, cl->rt_safe_eval (475, ok), 1e-9);
+	CPPUNIT_ASSERT (ok);
+	cl->editor_add (475, 1.0, false);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.5,  cl->rt_safe_eval (462.5, ok), 1e-9);
+	CPPUNIT_ASSERT (ok);
+}
+
+void
+ControlListTest::discreteEval ()
+{
+	boost::shared_ptr<ControlList> cl = TestCtrlList ();
+	cl->set_interpolation (ControlList::Discrete);
+
+	cl->fast_simple_add (0, 1);
+	cl->fast_simple_add (100, 2);
+	cl->fast_simple_add (200, 3);
+	cl->fast_simple_add (300, 4);
+
+	CPPUNIT_ASSERT_EQUAL (1.0, cl->eval (0));
+	CPPUNIT_ASSERT_EQUAL (1.0, cl->eval (99));
+	CPPUNIT_ASSERT_EQUAL (2.0, cl->eval (100));
+	CPPUNIT_ASSERT_EQUAL (3.0, cl->eval (299));
+	CPPUNIT_ASSERT_EQUAL (4.0, cl->eval (1000));
+
+	cl->editor_add (150, 5, false);
+	CPPUNIT_ASSERT_EQUAL (2.0, cl->eval (149));
+	CPPUNIT_ASSERT_EQUAL (5.0, cl->eval (199));
+}
+
+void
+ControlListTest::earliestEvent ()
+{
+	boost::shared_ptr<ControlList> cl = TestCtrlList ();
+	cl->set_interpolation (ControlList::Discrete);
+
+	for (int i = 0; i < 10; ++i) {
+		cl->fast_simple_add (i * 100, i);
+	}
+
+	double x, y;
+	CPPUNIT_ASSERT (cl->rt_safe_earliest_event_discrete_unlocked (250, x, y, false));
+	CPPUNIT_ASSERT_EQUAL (300.0, x);
+	CPPUNIT_ASSERT_EQUAL (3.0, y);
+
+	CPPUNIT_ASSERT (cl->rt_safe_earliest_event_discrete_unlocked (300, x, y, true));
+	CPPUNIT_ASSERT_EQUAL (300.0, x);
+
+	// search backwards, this requires a re-search
+	CPPUNIT_ASSERT (cl->rt_safe_earliest_event_discrete_unlocked (50, x, y, true));
+	CPPUNIT_ASSERT_EQUAL (100.0, x);
+
+	cl->editor_add (75, 42, false);
+	CPPUNIT_ASSERT (cl->rt_safe_earliest_event_discrete_unlocked (50, x, y, true));
+	CPPUNIT_ASSERT_EQUAL (75.0, x);
+	CPPUNIT_ASSERT_EQUAL (42.0, y);
+
+	CPPUNIT_ASSERT (!cl->rt_safe_earliest_event_discrete_unlocked (900, x, y, false));
+}
+
+void
+ControlListTest::writePassGuard ()
+{
+	boost::shared_ptr<ControlList> cl = TestCtrlList ();
+	cl->set_interpolation (ControlList::Linear);
+
+	for (int i = 0; i <= 10; ++i) {
+		cl->fast_simple_add (i * 100, i * .1);
+	}
+
+	// build the index
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.25, cl->eval (250), 1e-9);
+
+	// start of a write-pass adds a guard-point with the current value
+	cl->set_in_write_pass (true, true, 250);
+	cl->set_in_write_pass (false);
+	CPPUNIT_ASSERT_EQUAL ((size_t) 12, (size_t) cl->size ());
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.25, cl->eval (250), 1e-9);
+
+	// adding a point at the same position replaces the guard-point
+	cl->add (250, 1.0, false);
+	CPPUNIT_ASSERT_EQUAL ((size_t) 12, (size_t) cl->size ());
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (1.0, cl->eval (250), 1e-9);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.6, cl->eval (275), 1e-9);
+
+	bool ok;
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (1.0, cl->rt_safe_eval (250, ok), 1e-9);
+	CPPUNIT_ASSERT (ok);
+}
+
+void
+ControlListTest::truncateAndThin ()
+{
+	boost::shared_ptr<ControlList> cl = TestCtrlList ();
+	cl->set_interpolation (ControlList::Linear);
+
+	for (int i = 0; i <= 10; ++i) {
+		cl->fast_simple_add (i * 100, i * .1);
+	}
+
+	bool ok;
+
+	// build the index, each edit below must invalidate it
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.55, cl->eval (550), 1e-9);
+
+	// shorten: the last point is moved to the new end
+	cl->truncate_end (750);
+	CPPUNIT_ASSERT_EQUAL ((size_t) 9, cl->size ());
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.725, cl->eval (725), 1e-9);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.75,  cl->eval (2000), 1e-9);
+
+	// the insert position is looked up using the index
+	CPPUNIT_ASSERT (cl->editor_add (725, 0, false));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.0,   cl->eval (725), 1e-9);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.375, cl->eval (737.5), 1e-9);
+
+	// remove points up to 250, shift the rest to start at zero
+	cl->truncate_start (500);
+	CPPUNIT_ASSERT_EQUAL ((size_t) 8, cl->size ());
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.25, cl->eval (0), 1e-9);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.35, cl->eval (100), 1e-9);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.0,  cl->eval (475), 1e-9);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.35, cl->rt_safe_eval (100, ok), 1e-9);
+	CPPUNIT_ASSERT (ok);
+
+	// collinear points are removed
+	cl->thin (1);
+	CPPUNIT_ASSERT (cl->size () < 8);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.35,  cl->eval (100), 1e-9);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.375, cl->eval (487.5), 1e-9);
+
+	CPPUNIT_ASSERT (cl->editor_add (300, 1.0, false));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (1.0,  cl->eval (300), 1e-9);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.85, cl->rt_safe_eval (375, ok), 1e-9);
+	CPPUNIT_ASSERT (ok);
+}
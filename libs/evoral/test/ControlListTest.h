@@ -0,0 +1,29 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <boost/shared_ptr.hpp>
+#include "evoral/ControlList.h"
+
+class ControlListTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (ControlListTest);
+	CPPUNIT_TEST (evalAfterEdit);
+	CPPUNIT_TEST (discreteEval);
+	CPPUNIT_TEST (earliestEvent);
+	CPPUNIT_TEST (writePassGuard);
+	CPPUNIT_TEST (truncateAndThin);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void evalAfterEdit ();
+	void discreteEval ();
+	void earliestEvent ();
+	void writePassGuard ();
+	void truncateAndThin ();
+
+private:
+	boost::shared_ptr<Evoral::ControlList> TestCtrlList() {
+		Evoral::Parameter param (Evoral::Parameter(0));
+		const Evoral::ParameterDescriptor desc;
+		return boost::shared_ptr<Evoral::ControlList> (new Evoral::ControlList(param, desc));
+	}
+};
@@ -1,5 +1,6 @@
 #include "SequenceTest.h"
 #include <cassert>
+#include <map>
 
 CPPUNIT_TEST_SUITE_REGISTRATION(SequenceTest);
 
@@ -194,3 +195,122 @@ SequenceTest::controlInterpolationTest ()
 		last_value = i->second;
 	}
 }
+
+void
+SequenceTest::noteArenaTest ()
+{
+	static const size_t n_notes = 10000;
+
+	seq->clear();
+
+	for (size_t i = 0; i < n_notes; ++i) {
+		seq->add_note_unlocked (seq->new_note (0, Time (i), Time (1), 60 + (i % 12), 64));
+	}
+	CPPUNIT_ASSERT_EQUAL (n_notes, seq->notes().size());
+	CPPUNIT_ASSERT_EQUAL (n_notes, seq->note_arena()->used());
+	CPPUNIT_ASSERT (seq->note_arena()->reserved() >= n_notes * sizeof (Note<Time>));
+
+	/* notes refer to their own buffers */
+	Time last;
+	for (Sequence<Time>::Notes::const_iterator i = seq->notes().begin(); i != seq->notes().end(); ++i) {
+		CPPUNIT_ASSERT ((*i)->time() >= last);
+		CPPUNIT_ASSERT_EQUAL ((uint8_t) (MIDI_CMD_NOTE_ON), (uint8_t) ((*i)->on_event().buffer()[0] & 0xf0));
+		CPPUNIT_ASSERT_EQUAL ((uint8_t) (MIDI_CMD_NOTE_OFF), (uint8_t) ((*i)->off_event().buffer()[0] & 0xf0));
+		CPPUNIT_ASSERT_EQUAL ((*i)->note(), (*i)->on_event().buffer()[1]);
+		last = (*i)->time();
+	}
+
+	/* a copy has its own arena, notes outlive the sequence they came from */
+	MySequence<Time>* copy = new MySequence<Time> (*seq);
+	CPPUNIT_ASSERT (copy->note_arena() != seq->note_arena());
+	CPPUNIT_ASSERT_EQUAL (n_notes, copy->note_arena()->used());
+
+	Sequence<Time>::NotePtr kept = *copy->notes().begin();
+	delete copy;
+	CPPUNIT_ASSERT_EQUAL ((uint8_t) 60, kept->note());
+	CPPUNIT_ASSERT_EQUAL ((uint8_t) 64, kept->on_event().buffer()[2]);
+
+	/* freed blocks are reused */
+	const size_t reserved = seq->note_arena()->reserved();
+	seq->clear();
+	CPPUNIT_ASSERT_EQUAL ((size_t) 0, seq->note_arena()->used());
+	for (size_t i = 0; i < n_notes; ++i) {
+		seq->add_note_unlocked (seq->new_note (0, Time (i), Time (1), 60, 64));
+	}
+	CPPUNIT_ASSERT_EQUAL (reserved, seq->note_arena()->reserved());
+}
+
+/** @return the most common distance between consecutive notes in memory,
+ * and the number of times it differs.
+ */
+static ptrdiff_t
+note_stride (Sequence<Temporal::Beats> const& seq, size_t& jumps)
+{
+	vector<char const*> addr;
+	for (Sequence<Temporal::Beats>::Notes::const_iterator i = seq.notes().begin(); i != seq.notes().end(); ++i) {
+		addr.push_back (reinterpret_cast<char const*> ((*i).get()));
+	}
+
+	map<ptrdiff_t, size_t> strides;
+	for (size_t i = 1; i < addr.size(); ++i) {
+		++strides[addr[i] - addr[i - 1]];
+	}
+
+	ptrdiff_t stride = 0;
+	size_t    n      = 0;
+	for (map<ptrdiff_t, size_t>::const_iterator i = strides.begin(); i != strides.end(); ++i) {
+		if (i->second > n) {
+			stride = i->first;
+			n      = i->second;
+		}
+	}
+
+	jumps = addr.size() - 1 - n;
+	return stride;
+}
+
+/* Notes are placed in memory in the order they are created, which is
+ * time order when a sequence is loaded, and time order is the order in
+ * which the sequence is iterated.
+ */
+void
+SequenceTest::noteArenaLayoutTest ()
+{
+	static const size_t n_notes = 10000;
+
+	seq->clear();
+
+	for (size_t i = 0; i < n_notes; ++i) {
+		seq->add_note_unlocked (seq->new_note (0, Time (i), Time (1), 60 + (i % 12), 64));
+	}
+
+	/* iteration is in time order, and visits the notes front to back in
+	 * memory, leaving a chunk only to go to the start of the next */
+	size_t          jumps;
+	const ptrdiff_t stride = note_stride (*seq, jumps);
+	const size_t    chunks = seq->note_arena()->chunks();
+
+	CPPUNIT_ASSERT (stride >= (ptrdiff_t) sizeof (Note<Time>));
+	CPPUNIT_ASSERT (jumps < chunks);
+
+	Time last;
+	for (Sequence<Time>::Notes::const_iterator i = seq->notes().begin(); i != seq->notes().end(); ++i) {
+		CPPUNIT_ASSERT ((*i)->time() >= last);
+		last = (*i)->time();
+	}
+
+	/* memory: a handful of heap allocations instead of several per note,
+	 * at most half of the reserved blocks are unused */
+	CPPUNIT_ASSERT (chunks < 16);
+	CPPUNIT_ASSERT (seq->note_arena()->reserved() <= 2 * n_notes * stride);
+
+	/* notes created in reverse time order are laid out in reverse: the
+	 * layout follows creation, not time */
+	MySequence<Time> reversed (*type_map);
+	for (size_t i = 0; i < n_notes; ++i) {
+		reversed.add_note_unlocked (reversed.new_note (0, Time (n_notes - i), Time (1), 60, 64));
+	}
+
+	CPPUNIT_ASSERT_EQUAL (-stride, note_stride (reversed, jumps));
+	CPPUNIT_ASSERT (jumps < reversed.note_arena()->chunks());
+}
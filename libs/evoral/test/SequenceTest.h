@@ -121,6 +121,8 @@ class SequenceTest : public CppUnit::TestFixture
 	CPPUNIT_TEST (preserveEventOrderingTest);
 	CPPUNIT_TEST (iteratorSeekTest);
 	CPPUNIT_TEST (controlInterpolationTest);
+	CPPUNIT_TEST (noteArenaTest);
+	CPPUNIT_TEST (noteArenaLayoutTest);
 	CPPUNIT_TEST_SUITE_END ();
 
 public:
@@ -151,6 +153,8 @@ public:
 	void preserveEventOrderingTest ();
 	void iteratorSeekTest ();
 	void controlInterpolationTest ();
+	void noteArenaTest ();
+	void noteArenaLayoutTest ();
 
 private:
 	DummyTypeMap*       type_map;
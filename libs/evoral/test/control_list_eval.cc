@@ -0,0 +1,71 @@
+#include <iostream>
+#include <cstdlib>
+
+#include <boost/shared_ptr.hpp>
+
+#include "pbd/compose.h"
+#include "pbd/timing.h"
+
+#include "evoral/ControlList.h"
+
+using namespace std;
+using namespace PBD;
+using namespace Evoral;
+
+/* Evaluate and edit automation lists of increasing size,
+ * as done by automation playback and the GUI.
+ */
+int
+main (int argc, char* argv[])
+{
+	int const sizes[] = { 10000, 100000, 1000000 };
+	int const n_eval   = 100000;
+	int const n_insert = 100;
+
+	srand (42);
+	cout << string_compose ("%1 %2 %3 %4\n", "Points", "eval [nsec]", "insert [usec]", "thin [msec]");
+
+	for (size_t s = 0; s < sizeof (sizes) / sizeof (sizes[0]); ++s) {
+		int const n_points = sizes[s];
+
+		boost::shared_ptr<ControlList> cl (new ControlList (Parameter (0), ParameterDescriptor ()));
+		cl->set_interpolation (ControlList::Linear);
+
+		for (int i = 0; i < n_points; ++i) {
+			cl->fast_simple_add (i * 64.0, (rand () % 1000) / 1000.0);
+		}
+
+		double const len = n_points * 64.0;
+		double       sum = 0;
+
+		/* random access, evaluating the list */
+		Timing t;
+		for (int i = 0; i < n_eval; ++i) {
+			sum += cl->eval (len * (rand () / (RAND_MAX + 1.0)));
+		}
+		t.update ();
+		double const t_eval = 1000.0 * t.elapsed () / n_eval;
+
+		/* interleaved edits and reads, as done by the GUI */
+		t.start ();
+		for (int i = 0; i < n_insert; ++i) {
+			double const when = len * (rand () / (RAND_MAX + 1.0)) + .5;
+			cl->editor_add (when, .5, false);
+			sum += cl->eval (when);
+		}
+		t.update ();
+		double const t_insert = t.elapsed () / (double) n_insert;
+
+		t.start ();
+		cl->thin (20);
+		t.update ();
+
+		cout << string_compose ("%1 %2 %3 %4\n", n_points, t_eval, t_insert, t.elapsed () / 1000.0);
+
+		if (sum <= 0) {
+			return 1;
+		}
+	}
+
+	return 0;
+}
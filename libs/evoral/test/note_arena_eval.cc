@@ -0,0 +1,94 @@
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <boost/make_shared.hpp>
+
+#include "pbd/compose.h"
+#include "pbd/timing.h"
+
+#include "temporal/beats.h"
+
+#include "evoral/Note.h"
+#include "evoral/NoteArena.h"
+#include "evoral/Sequence.h"
+
+using namespace std;
+using namespace PBD;
+
+typedef Temporal::Beats                        Time;
+typedef Evoral::Note<Time>                     Note;
+typedef Evoral::Sequence<Time>::NotePtr        NotePtr;
+typedef Evoral::Sequence<Time>::Notes          Notes;
+typedef Evoral::NoteAllocator<Note>            Allocator;
+
+static void
+report (string const& what, TimingStats const& t)
+{
+	uint64_t min, max;
+	double   avg, dev;
+	if (t.get_stats (min, max, avg, dev)) {
+		cout << string_compose ("  %1: min %2 usec, avg %3 usec, max %4 usec, dev %5\n", what, min, avg, max, dev);
+	}
+}
+
+/* Create, iterate and destroy the notes of a sequence, once with notes
+ * allocated from a NoteArena (as Sequence::new_note does) and once from
+ * the heap. Other small allocations are interleaved with the notes, as
+ * happens when a model is loaded along with the rest of a session.
+ */
+static void
+run (string const& what, boost::shared_ptr<Evoral::NoteArena> arena, size_t n_notes, int n_runs)
+{
+	TimingStats create;
+	TimingStats iterate;
+	TimingStats destroy;
+	uint64_t    sum = 0;
+
+	for (int r = 0; r < n_runs; ++r) {
+		Notes          notes;
+		vector<string> noise;
+		noise.reserve (n_notes);
+
+		create.start ();
+		for (size_t i = 0; i < n_notes; ++i) {
+			notes.insert (boost::allocate_shared<Note> (Allocator (arena), 0, Time::ticks (i * 120), Time::ticks (60), 60 + (i % 24), 64));
+			noise.push_back (string (16 + (i % 48), 'x'));
+		}
+		create.update ();
+
+		iterate.start ();
+		for (Notes::const_iterator i = notes.begin (); i != notes.end (); ++i) {
+			sum += (*i)->note () + (*i)->velocity () + (*i)->on_event ().buffer ()[0];
+		}
+		iterate.update ();
+
+		destroy.start ();
+		notes.clear ();
+		destroy.update ();
+	}
+
+	cout << string_compose ("%1 (checksum %2)\n", what, sum);
+	report ("Create", create);
+	report ("Iterate", iterate);
+	report ("Destroy", destroy);
+
+	if (arena) {
+		cout << string_compose ("  Arena: %1 bytes reserved, %2 bytes per note\n", arena->reserved (), arena->reserved () / n_notes);
+	}
+}
+
+int
+main (int argc, char* argv[])
+{
+	size_t const n_notes = argc > 1 ? atoi (argv[1]) : 100000;
+	int const    n_runs  = argc > 2 ? atoi (argv[2]) : 20;
+
+	cout << string_compose ("%1 notes, %2 runs, sizeof (Note) = %3\n", n_notes, n_runs, sizeof (Note));
+
+	run ("Heap", boost::shared_ptr<Evoral::NoteArena> (), n_notes, n_runs);
+	run ("NoteArena", boost::shared_ptr<Evoral::NoteArena> (new Evoral::NoteArena), n_notes, n_runs);
+
+	return 0;
+}
@@ -77,6 +77,30 @@ __cpuid(int regs[4], int cpuid_leaf)
 			"%ecx", "%edx", "memory");
 }
 
+static void
+__cpuidex(int regs[4], int cpuid_leaf, int cpuid_subleaf)
+{
+	asm volatile (
+#if defined(__i386__)
+			"pushl %%ebx;\n\t"
+#endif
+			"cpuid;\n\t"
+			"movl %%eax, (%2);\n\t"
+			"movl %%ebx, 4(%2);\n\t"
+			"movl %%ecx, 8(%2);\n\t"
+			"movl %%edx, 12(%2);\n\t"
+#if defined(__i386__)
+			"popl %%ebx;\n\t"
+#endif
+			:"+a" (cpuid_leaf), "+c" (cpuid_subleaf) /* %eax, %ecx clobbered by CPUID */
+			:"S" (regs)
+			:
+#if !defined(__i386__)
+			"%ebx",
+#endif
+			"%edx", "memory");
+}
+
 #endif /* !PLATFORM_WINDOWS */
 
 #ifndef HAVE_XGETBV // Allow definition by build system
@@ -172,6 +196,14 @@ FPU::FPU ()
 # endif
 #endif
 
+#if defined ARM_SVE_SUPPORT && defined __aarch64__ && defined HWCAP_SVE
+	/* scalable vectors, the vector length is only known at run-time */
+	if (getauxval(AT_HWCAP) & HWCAP_SVE) {
+		info << _("ARM SVE capable processor") << endmsg;
+		_flags = Flags(_flags | HasSVE);
+	}
+#endif
+
 #if !( (defined __x86_64__) || (defined __i386__) || (defined _M_X64) || (defined _M_IX86) ) // !ARCH_X86
 	/* Non-Intel architecture, nothing to do here */
 	return;
@@ -219,6 +251,17 @@ FPU::FPU ()
 			_flags = Flags (_flags | (HasFMA));
 		}
 
+		if (num_ids >= 7 && (_flags & HasAVX)) {
+			int ext_info[4];
+			__cpuidex (ext_info, 7, 0);
+
+			if ((ext_info[1] & (1<<16)) /* AVX512F */ &&
+			    ((_xgetbv (_XCR_XFEATURE_ENABLED_MASK) & 0xe6) == 0xe6)) { /* OS saves opmask and ZMM registers */
+				info << _("AVX-512F capable processor") << endmsg;
+				_flags = Flags (_flags | (HasAVX512F));
+			}
+		}
+
 		if (cpu_info[3] & (1<<25)) {
 			_flags = Flags (_flags | (HasSSE|HasFlushToZero));
 		}
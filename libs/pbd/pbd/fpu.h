@@ -34,6 +34,8 @@ class LIBPBD_API FPU {
 		HasAVX = 0x10,
 		HasNEON = 0x20,
 		HasFMA = 0x40,
+		HasAVX512F = 0x80,
+		HasSVE = 0x100,
 	};
 
   public:
@@ -48,7 +50,9 @@ class LIBPBD_API FPU {
 	bool has_sse2 () const { return _flags & HasSSE2; }
 	bool has_avx () const { return _flags & HasAVX; }
 	bool has_fma() const { return _flags & HasFMA; }
+	bool has_avx512f () const { return _flags & HasAVX512F; }
 	bool has_neon () const { return _flags & HasNEON; }
+	bool has_sve () const { return _flags & HasSVE; }
 
   private:
 	Flags _flags;
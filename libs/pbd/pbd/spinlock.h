@@ -22,6 +22,10 @@
 #include <boost/smart_ptr/detail/spinlock.hpp>
 #include <cstring>
 
+#if defined _MSC_VER && (defined _M_IX86 || defined _M_X64)
+#include <intrin.h>
+#endif
+
 #include "pbd/libpbd_visibility.h"
 
 namespace PBD {
@@ -65,6 +69,21 @@ private:
 	spinlock_t (const spinlock_t&);
 };
 
+/** Hint the CPU that the calling thread is in a spin-wait loop.
+ * This saves power and frees resources for a hyper-thread sibling.
+ */
+static inline void
+cpu_relax ()
+{
+#if defined _MSC_VER && (defined _M_IX86 || defined _M_X64)
+	_mm_pause ();
+#elif defined __i386__ || defined __x86_64__
+	__asm__ __volatile__ ("pause");
+#elif defined __aarch64__ || (defined __arm__ && defined __ARM_ARCH && __ARM_ARCH >= 7)
+	__asm__ __volatile__ ("yield");
+#endif
+}
+
 /* RAII wrapper */
 class LIBPBD_API SpinLock {
 
@@ -84,6 +84,19 @@ class LIBPBD_API Stateful {
 		}
 	};
 
+	/* RAII structure to allow bulk numeric data to be stored as raw
+	 * arrays (see XML_RAW_F64_PROPERTY) by get_state() in this thread.
+	 * Only for state that is written as binary.
+	 */
+	struct RawStateArrays {
+		RawStateArrays () {
+			set_raw_state_arrays_in_this_thread (true);
+		}
+		~RawStateArrays () {
+			set_raw_state_arrays_in_this_thread (false);
+		}
+	};
+
 	/* history management */
 
 	void clear_changes ();
@@ -135,14 +148,18 @@ class LIBPBD_API Stateful {
 	virtual void mid_thaw (const PropertyChange&) { }
 
 	bool regenerate_xml_or_string_ids () const;
+	bool raw_state_arrays () const;
 
   private:
 	friend struct ForceIDRegeneration;
 	static Glib::Threads::Private<bool> _regenerate_xml_or_string_ids;
+	friend struct RawStateArrays;
+	static Glib::Threads::Private<bool> _raw_state_arrays;
 	PBD::ID  _id;
 	gint     _stateful_frozen;
 
 	static void set_regenerate_xml_and_string_ids_in_this_thread (bool yn);
+	static void set_raw_state_arrays_in_this_thread (bool yn);
 };
 
 } // namespace PBD
@@ -23,6 +23,7 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 #include <string>
@@ -194,6 +195,132 @@ private:
 	double   _vs;
 };
 
+/** Lock-free histogram of execution times.
+ *
+ * Durations are sorted into power-of-two microsecond buckets.
+ * There must only be a single writer (the thread calling start () and
+ * update ()), all query methods can be used concurrently from any thread.
+ */
+class LIBPBD_API TimingHistogram
+{
+public:
+	/** bucket 0: < 1 usec, bucket N: [2^(N-1), 2^N) usec,
+	 * the last bucket also collects all longer durations.
+	 */
+	static const int n_buckets = 24;
+
+	TimingHistogram ()
+		: _start (0)
+		, _reset (0)
+	{
+		clear ();
+	}
+
+	void start ()
+	{
+		_start = g_get_monotonic_time ();
+	}
+
+	void update ()
+	{
+		if (_start != 0) {
+			add (g_get_monotonic_time () - _start);
+		}
+	}
+
+	void add (uint64_t usec)
+	{
+		if (g_atomic_int_compare_and_exchange (&_reset, 1, 0)) {
+			clear ();
+		}
+
+		int b = 0;
+		while (b < n_buckets - 1 && usec >= ((uint64_t)1 << b)) {
+			++b;
+		}
+		g_atomic_int_inc (&_buckets[b]);
+		g_atomic_int_inc (&_cnt);
+
+		const gint us = usec > G_MAXINT ? G_MAXINT : (gint) usec;
+		if (us > g_atomic_int_get (&_max)) {
+			g_atomic_int_set (&_max, us);
+		}
+	}
+
+	/** ask the writer to clear the histogram before adding the next value */
+	void reset ()
+	{
+		g_atomic_int_set (&_reset, 1);
+	}
+
+	uint32_t n_samples () const
+	{
+		return g_atomic_int_get (&_cnt);
+	}
+
+	uint32_t bucket_count (int b) const
+	{
+		if (b < 0 || b >= n_buckets) {
+			return 0;
+		}
+		return g_atomic_int_get (&_buckets[b]);
+	}
+
+	/** @return upper limit [usec] of the given bucket (exclusive) */
+	static uint64_t bucket_limit (int b)
+	{
+		if (b >= n_buckets - 1) {
+			return std::numeric_limits<uint64_t>::max ();
+		}
+		return (uint64_t)1 << b;
+	}
+
+	/** @return longest recorded duration [usec] */
+	uint64_t max_usec () const
+	{
+		return g_atomic_int_get (&_max);
+	}
+
+	/** @param p percentile 0..100
+	 * @return upper limit [usec] of the bucket that contains the given
+	 * percentile, or the longest recorded duration if that is smaller.
+	 */
+	uint64_t percentile (double p) const
+	{
+		const uint32_t cnt = n_samples ();
+		if (cnt == 0) {
+			return 0;
+		}
+		const uint64_t thresh = std::max<uint64_t> (1, ceil (cnt * p / 100.0));
+		const uint64_t max    = max_usec ();
+
+		uint64_t acc = 0;
+		for (int b = 0; b < n_buckets; ++b) {
+			acc += bucket_count (b);
+			if (acc >= thresh) {
+				return std::min (bucket_limit (b), max);
+			}
+		}
+		return max;
+	}
+
+private:
+	void clear ()
+	{
+		for (int b = 0; b < n_buckets; ++b) {
+			g_atomic_int_set (&_buckets[b], 0);
+		}
+		g_atomic_int_set (&_cnt, 0);
+		g_atomic_int_set (&_max, 0);
+	}
+
+	uint64_t      _start;
+	volatile gint _reset;
+	volatile gint _cnt;
+	volatile gint _max;
+	volatile gint _buckets[n_buckets];
+};
+
 class LIBPBD_API TimingData
 {
 public:
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2026 The Ardour Team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _pbd_work_stealing_deque_h_
+#define _pbd_work_stealing_deque_h_
+
+#include <cassert>
+#include <glib.h>
+#include <stdint.h>
+
+namespace PBD {
+
+/** Bounded lock free single producer, multiple consumer work-stealing deque.
+ *
+ * The owner thread pushes and pops at the bottom (LIFO), any other
+ * thread may steal from the top (FIFO).
+ *
+ * based on "Dynamic Circular Work-Stealing Deque" by Chase and Lev (SPAA 2005),
+ * without dynamic resizing: the capacity has to be reserved in advance
+ * and must not be exceeded between calls to clear().
+ */
+template <typename T>
+class /*LIBPBD_API*/ WorkStealingDeque
+{
+public:
+	WorkStealingDeque (size_t buffer_size = 8)
+		: _buffer (0)
+		, _buffer_mask (0)
+	{
+		reserve (buffer_size);
+	}
+
+	~WorkStealingDeque ()
+	{
+		delete[] _buffer;
+	}
+
+	static size_t
+	power_of_two_size (size_t sz)
+	{
+		int32_t power_of_two;
+		for (power_of_two = 1; 1U << power_of_two < sz; ++power_of_two) ;
+		return 1U << power_of_two;
+	}
+
+	/** must not be called concurrently with push, pop or steal */
+	void
+	reserve (size_t buffer_size)
+	{
+		buffer_size = power_of_two_size (buffer_size);
+		assert ((buffer_size >= 2) && ((buffer_size & (buffer_size - 1)) == 0));
+		if (_buffer_mask >= buffer_size - 1) {
+			return;
+		}
+		delete[] _buffer;
+		_buffer      = new T[buffer_size];
+		_buffer_mask = buffer_size - 1;
+		clear ();
+	}
+
+	/** must not be called concurrently with push, pop or steal */
+	void
+	clear ()
+	{
+		g_atomic_int_set (&_top, 0);
+		g_atomic_int_set (&_bottom, 0);
+	}
+
+	/** owner thread only */
+	bool
+	push (T const& data)
+	{
+		gint b = g_atomic_int_get (&_bottom);
+		gint t = g_atomic_int_get (&_top);
+		if ((size_t)(b - t) > _buffer_mask) {
+			assert (0);
+			return false;
+		}
+		_buffer[b & _buffer_mask] = data;
+		/* publish; g_atomic_int_set implies a full memory barrier */
+		g_atomic_int_set (&_bottom, b + 1);
+		return true;
+	}
+
+	/** owner thread only, returns the most recently pushed item */
+	bool
+	pop (T& data)
+	{
+		gint b = g_atomic_int_get (&_bottom) - 1;
+		g_atomic_int_set (&_bottom, b);
+		gint t = g_atomic_int_get (&_top);
+
+		if (t > b) {
+			/* empty */
+			g_atomic_int_set (&_bottom, b + 1);
+			return false;
+		}
+
+		data = _buffer[b & _buffer_mask];
+
+		if (t == b) {
+			/* last item, race against concurrent steal() */
+			bool won = g_atomic_int_compare_and_exchange (&_top, t, t + 1);
+			g_atomic_int_set (&_bottom, b + 1);
+			return won;
+		}
+		return true;
+	}
+
+	/** any thread, returns the oldest item */
+	bool
+	steal (T& data)
+	{
+		gint t = g_atomic_int_get (&_top);
+		gint b = g_atomic_int_get (&_bottom);
+
+		if (t >= b) {
+			return false;
+		}
+
+		data = _buffer[t & _buffer_mask];
+		return g_atomic_int_compare_and_exchange (&_top, t, t + 1);
+	}
+
+	/** approximate number of queued items */
+	size_t
+	size () const
+	{
+		gint b = g_atomic_int_get (&_bottom);
+		gint t = g_atomic_int_get (&_top);
+		return b > t ? b - t : 0;
+	}
+
+private:
+	T*     _buffer;
+	size_t _buffer_mask;
+
+	volatile gint _top;
+	volatile gint _bottom;
+};
+
+} /* end namespace */
+
+#endif
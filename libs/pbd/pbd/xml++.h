@@ -49,6 +49,13 @@
 class XMLTree;
 class XMLNode;
 
+/** A node with this property holds its numeric data as raw native doubles
+ * in its content child, instead of text. The property value is the number
+ * of columns. Such nodes are only created for binary serialization, when
+ * written as XML the data is converted to text and the property dropped.
+ */
+#define XML_RAW_F64_PROPERTY "raw-f64"
+
 class LIBPBD_API XMLProperty {
 public:
 	XMLProperty(const std::string& n, const std::string& v = std::string());
@@ -100,6 +107,15 @@ public:
 
 	const std::string& write_buffer() const;
 
+	/* Compact binary serialization of the same tree, without libxml2.
+	 * The format is native-endian and only meant as a cache next to
+	 * an XML file, see xml++.cc for the layout.
+	 */
+	bool read_binary();
+	bool read_binary(const std::string& fn) { set_filename(fn); return read_binary(); }
+	bool write_binary() const;
+	bool write_binary(const std::string& fn) { set_filename(fn); return write_binary(); }
+
 	boost::shared_ptr<XMLSharedNodeList> find(const std::string xpath, XMLNode* = 0) const;
 
 private:
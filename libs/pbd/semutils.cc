@@ -87,4 +87,10 @@ Semaphore::reset ()
 	return rv;
 }
 
+bool
+Semaphore::try_wait ()
+{
+	return WaitForSingleObject(_sem, 0) == WAIT_OBJECT_0;
+}
+
 #endif
@@ -49,6 +49,7 @@ int Stateful::current_state_version = 0;
 int Stateful::loading_state_version = 0;
 
 Glib::Threads::Private<bool> Stateful::_regenerate_xml_or_string_ids;
+Glib::Threads::Private<bool> Stateful::_raw_state_arrays;
 
 Stateful::Stateful ()
 	: _extra_xml (0)
@@ -436,4 +437,18 @@ Stateful::set_regenerate_xml_and_string_ids_in_this_thread (bool yn)
 	_regenerate_xml_or_string_ids.set (val);
 }
 
+bool
+Stateful::raw_state_arrays () const
+{
+	bool* raw = _raw_state_arrays.get();
+	return raw && *raw;
+}
+
+void
+Stateful::set_raw_state_arrays_in_this_thread (bool yn)
+{
+	bool* val = new bool (yn);
+	_raw_state_arrays.set (val);
+}
+
 } // namespace PBD
@@ -304,3 +304,55 @@ XMLTest::testPerfLargeXMLDocument ()
 
 	test_xml_document ("testPerfLargeXMLDocument", node_options);
 }
+
+void
+XMLTest::testBinaryRoundTrip ()
+{
+	std::vector<NodeOptions> node_options;
+
+	node_options.push_back (NodeOptions (child_node_name, 32, 2));
+	node_options.push_back (NodeOptions (grandchild_node_name, 32, 16, get_event_content (16)));
+	node_options.push_back (NodeOptions (great_grandchild_node_name, 8, 8));
+
+	const string test_output_dir = test_output_directory ("testBinaryRoundTrip");
+	const string bin_path = Glib::build_filename (test_output_dir, "tree.bin");
+	const string xml_path = Glib::build_filename (test_output_dir, "tree.xml");
+
+	XMLTree test_xml;
+	CPPUNIT_ASSERT (create_xml_doc (test_xml, node_options));
+
+	/* binary -> tree is lossless */
+	CPPUNIT_ASSERT (test_xml.write_binary (bin_path));
+
+	XMLTree read_bin;
+	CPPUNIT_ASSERT (read_bin.read_binary (bin_path));
+	CPPUNIT_ASSERT (*read_bin.root () == *test_xml.root ());
+
+	/* an XML file is not a binary tree */
+	CPPUNIT_ASSERT (test_xml.write (xml_path));
+	XMLTree not_bin;
+	CPPUNIT_ASSERT (!not_bin.read_binary (xml_path));
+
+	/* raw arrays are converted to text when written as XML */
+	const double events[4] = { 0.0, 0.5, 48000.0, 1.0 };
+	XMLTree raw_xml;
+	raw_xml.set_root (new XMLNode (root_node_name));
+	XMLNode* ev = raw_xml.root ()->add_child ("events");
+	ev->set_property (XML_RAW_F64_PROPERTY, (uint32_t) 2);
+	ev->add_content (std::string ((char const*) events, sizeof (events)));
+
+	CPPUNIT_ASSERT (raw_xml.write_binary (bin_path));
+	XMLTree raw_bin;
+	CPPUNIT_ASSERT (raw_bin.read_binary (bin_path));
+	CPPUNIT_ASSERT (*raw_bin.root () == *raw_xml.root ());
+
+	CPPUNIT_ASSERT (raw_bin.write (xml_path));
+	XMLTree text_xml (xml_path);
+	XMLNode* text_ev = text_xml.root ()->child ("events");
+	CPPUNIT_ASSERT (text_ev);
+	CPPUNIT_ASSERT (!text_ev->property (XML_RAW_F64_PROPERTY));
+	CPPUNIT_ASSERT (text_ev->children ().front ()->content ().find ("48000 1") != std::string::npos);
+
+	CPPUNIT_ASSERT (g_remove (bin_path.c_str ()) == 0);
+	CPPUNIT_ASSERT (g_remove (xml_path.c_str ()) == 0);
+}
@@ -6,8 +6,14 @@
  */
 
 #include <string.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <iostream>
+#include <map>
 
+#include <glib.h>
+
+#include "pbd/gstdio_compat.h"
 #include "pbd/stacktrace.h"
 #include "pbd/xml++.h"
 
@@ -229,6 +235,240 @@ XMLTree::write_buffer() const
 	return retval;
 }
 
+/* Binary format
+ *
+ *  header  : "PBDX", uint32 version, uint32 byte-order mark
+ *  names   : uint32 count, count x string (node and property names, interned)
+ *  root    : node
+ *
+ *  node    : uint32 name-index, uint8 is-content, string content,
+ *            uint32 n-properties, n x (uint32 name-index, string value),
+ *            uint32 n-children, n x node
+ *  string  : uint32 length, bytes
+ *
+ * Content is stored verbatim, so raw (XML_RAW_F64_PROPERTY) data survives.
+ */
+
+static const uint32_t binary_version = 1;
+static const uint32_t binary_bom = 0x01020304;
+
+typedef std::map<std::string, uint32_t> BinaryNameMap;
+
+static void
+binary_collect_names (XMLNode const* n, BinaryNameMap& names, std::vector<std::string const*>& order)
+{
+	if (names.insert (std::make_pair (n->name (), (uint32_t) order.size ())).second) {
+		order.push_back (&n->name ());
+	}
+	for (XMLPropertyConstIterator i = n->properties ().begin (); i != n->properties ().end (); ++i) {
+		if (names.insert (std::make_pair ((*i)->name (), (uint32_t) order.size ())).second) {
+			order.push_back (&(*i)->name ());
+		}
+	}
+	for (XMLNodeConstIterator i = n->children ().begin (); i != n->children ().end (); ++i) {
+		binary_collect_names (*i, names, order);
+	}
+}
+
+static inline void
+binary_put_u32 (std::string& buf, uint32_t v)
+{
+	buf.append ((char const*) &v, sizeof (v));
+}
+
+static inline void
+binary_put_string (std::string& buf, std::string const& s)
+{
+	binary_put_u32 (buf, s.size ());
+	buf.append (s);
+}
+
+static void
+binary_write_node (std::string& buf, XMLNode const* n, BinaryNameMap const& names)
+{
+	binary_put_u32 (buf, names.find (n->name ())->second);
+	buf.push_back (n->is_content () ? 1 : 0);
+	binary_put_string (buf, n->content ());
+
+	binary_put_u32 (buf, n->properties ().size ());
+	for (XMLPropertyConstIterator i = n->properties ().begin (); i != n->properties ().end (); ++i) {
+		binary_put_u32 (buf, names.find ((*i)->name ())->second);
+		binary_put_string (buf, (*i)->value ());
+	}
+
+	binary_put_u32 (buf, n->children ().size ());
+	for (XMLNodeConstIterator i = n->children ().begin (); i != n->children ().end (); ++i) {
+		binary_write_node (buf, *i, names);
+	}
+}
+
+bool
+XMLTree::write_binary () const
+{
+	if (!_root) {
+		return false;
+	}
+
+	BinaryNameMap names;
+	std::vector<std::string const*> order;
+	binary_collect_names (_root, names, order);
+
+	std::string buf;
+	buf.append ("PBDX", 4);
+	binary_put_u32 (buf, binary_version);
+	binary_put_u32 (buf, binary_bom);
+
+	binary_put_u32 (buf, order.size ());
+	for (std::vector<std::string const*>::const_iterator i = order.begin (); i != order.end (); ++i) {
+		binary_put_string (buf, **i);
+	}
+
+	binary_write_node (buf, _root, names);
+
+	FILE* f = g_fopen (_filename.c_str (), "wb");
+	if (!f) {
+		return false;
+	}
+
+	bool ok = fwrite (buf.data (), 1, buf.size (), f) == buf.size ();
+
+	if (fclose (f) != 0) {
+		ok = false;
+	}
+
+	return ok;
+}
+
+namespace {
+
+struct BinaryReader {
+	BinaryReader (char const* d, size_t len) : p (d), end (d + len) {}
+
+	bool get_u32 (uint32_t& v) {
+		if (end - p < (ptrdiff_t) sizeof (v)) {
+			return false;
+		}
+		memcpy (&v, p, sizeof (v));
+		p += sizeof (v);
+		return true;
+	}
+
+	bool get_u8 (uint8_t& v) {
+		if (p == end) {
+			return false;
+		}
+		v = *p++;
+		return true;
+	}
+
+	bool get_string (std::string& s) {
+		uint32_t len;
+		if (!get_u32 (len) || (size_t) (end - p) < len) {
+			return false;
+		}
+		s.assign (p, len);
+		p += len;
+		return true;
+	}
+
+	char const* p;
+	char const* end;
+	std::vector<std::string> names;
+};
+
+}
+
+static XMLNode*
+binary_read_node (BinaryReader& r)
+{
+	uint32_t name;
+	uint8_t is_content;
+	std::string content;
+
+	if (!r.get_u32 (name) || name >= r.names.size () || !r.get_u8 (is_content) || !r.get_string (content)) {
+		return 0;
+	}
+
+	XMLNode* node = is_content ? new XMLNode (r.names[name], content) : new XMLNode (r.names[name]);
+
+	uint32_t n;
+	if (!r.get_u32 (n)) {
+		delete node;
+		return 0;
+	}
+
+	for (uint32_t i = 0; i < n; ++i) {
+		uint32_t pname;
+		std::string value;
+		if (!r.get_u32 (pname) || pname >= r.names.size () || !r.get_string (value)) {
+			delete node;
+			return 0;
+		}
+		node->set_property (r.names[pname].c_str (), value);
+	}
+
+	if (!r.get_u32 (n)) {
+		delete node;
+		return 0;
+	}
+
+	for (uint32_t i = 0; i < n; ++i) {
+		XMLNode* child = binary_read_node (r);
+		if (!child) {
+			delete node;
+			return 0;
+		}
+		node->add_child_nocopy (*child);
+	}
+
+	return node;
+}
+
+bool
+XMLTree::read_binary ()
+{
+	delete _root;
+	_root = 0;
+
+	if (_doc) {
+		xmlFreeDoc (_doc);
+		_doc = 0;
+	}
+
+	gchar* data;
+	gsize len;
+
+	if (!g_file_get_contents (_filename.c_str (), &data, &len, NULL)) {
+		return false;
+	}
+
+	BinaryReader r (data, len);
+	uint32_t version, bom, n_names;
+
+	bool ok = len >= 4 && memcmp (data, "PBDX", 4) == 0;
+	if (ok) {
+		r.p += 4;
+	}
+
+	ok = ok && r.get_u32 (version) && version == binary_version;
+	ok = ok && r.get_u32 (bom) && bom == binary_bom;
+	ok = ok && r.get_u32 (n_names);
+
+	for (uint32_t i = 0; ok && i < n_names; ++i) {
+		std::string s;
+		ok = r.get_string (s);
+		r.names.push_back (s);
+	}
+
+	if (ok) {
+		_root = binary_read_node (r);
+	}
+
+	g_free (data);
+
+	return _root != 0;
+}
+
 static const int PROPERTY_RESERVE_COUNT = 16;
 
 XMLNode::XMLNode(const string& n)
@@ -737,6 +977,23 @@ readnode(xmlNodePtr node)
 	return tmp;
 }
 
+/** convert raw native doubles to text, one row of @param columns per line */
+static string
+raw_f64_to_text (string const& raw, uint32_t columns)
+{
+	const size_t n = raw.size () / sizeof (double);
+	string str;
+
+	for (size_t i = 0; i < n; ++i) {
+		double v;
+		memcpy (&v, raw.data () + i * sizeof (double), sizeof (double));
+		str += PBD::to_string (v);
+		str += ((i + 1) % columns) ? ' ' : '\n';
+	}
+
+	return str;
+}
+
 static void
 writenode(xmlDocPtr doc, XMLNode* n, xmlNodePtr p, int root = 0)
 {
@@ -754,9 +1011,14 @@ writenode(xmlDocPtr doc, XMLNode* n, xmlNodePtr p, int root = 0)
 	}
 
 	const XMLPropertyList& props = n->properties();
+	uint32_t raw_columns = 0;
 
 	for (XMLPropertyConstIterator prop_iter = props.begin (); prop_iter != props.end ();
 	     ++prop_iter) {
+		if ((*prop_iter)->name () == XML_RAW_F64_PROPERTY) {
+			PBD::string_to_uint32 ((*prop_iter)->value (), raw_columns);
+			continue;
+		}
 		xmlSetProp (node, (const xmlChar*)(*prop_iter)->name ().c_str (),
 		            (const xmlChar*)(*prop_iter)->value ().c_str ());
 	}
@@ -764,7 +1026,13 @@ writenode(xmlDocPtr doc, XMLNode* n, xmlNodePtr p, int root = 0)
 	const XMLNodeList& children = n->children ();
 	for (XMLNodeConstIterator child_iter = children.begin (); child_iter != children.end ();
 	     ++child_iter) {
-		writenode (doc, *child_iter, node);
+		if (raw_columns > 0 && (*child_iter)->is_content ()) {
+			XMLNode text (**child_iter);
+			text.set_content (raw_f64_to_text ((*child_iter)->content (), raw_columns));
+			writenode (doc, &text, node);
+		} else {
+			writenode (doc, *child_iter, node);
+		}
 	}
 }
 
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2026 The Ardour Team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <glibmm.h>
+
+#include "pbd/gstdio_compat.h"
+#include "pbd/xml++.h"
+
+#include "common.h"
+
+using namespace std;
+
+/** store the text content of automation event lists as raw arrays,
+ * the same way the session does when saving binary state.
+ */
+static void
+raw_automation (XMLNode* node)
+{
+	if (node->name () == "events" && !node->property (XML_RAW_F64_PROPERTY)
+	    && node->children ().size () == 1 && node->children ().front ()->is_content ()) {
+
+		XMLNode* content = node->children ().front ();
+		stringstream str (content->content ());
+		string raw;
+		string tok;
+		size_t n = 0;
+
+		while (str >> tok) {
+			double v;
+			if (!PBD::string_to<double> (tok, v)) {
+				return;
+			}
+			raw.append ((char const*) &v, sizeof (v));
+			++n;
+		}
+
+		if (n % 2) {
+			return;
+		}
+
+		content->set_content (raw);
+		node->set_property (XML_RAW_F64_PROPERTY, (uint32_t) 2);
+		return;
+	}
+
+	for (XMLNodeConstIterator i = node->children ().begin (); i != node->children ().end (); ++i) {
+		raw_automation (*i);
+	}
+}
+
+static bool
+is_binary (string const& path)
+{
+	char magic[4];
+	FILE* f = g_fopen (path.c_str (), "rb");
+	if (!f) {
+		return false;
+	}
+	bool rv = fread (magic, 1, 4, f) == 4 && memcmp (magic, "PBDX", 4) == 0;
+	fclose (f);
+	return rv;
+}
+
+static void usage () {
+	// help2man compatible format (standard GNU help-text)
+	printf (UTILNAME " - convert session state between XML and binary format.\n\n");
+	printf ("Usage: " UTILNAME " [ OPTIONS ] <input-file> <output-file>\n\n");
+	printf ("Options:\n\
+  -h, --help                 display this help and exit\n\
+  -V, --version              print version information and exit\n\
+\n");
+	printf ("\n\
+This tool reads a session file (.ardour) and writes it as binary snapshot\n\
+(.ardourb), or the other way around. The direction is taken from the input\n\
+file. When converting to XML, automation data stored as raw arrays is\n\
+converted back to text.\n\
+\n\
+The session itself uses the binary snapshot only if it is not older than\n\
+the .ardour file with the same name.\n\
+\n");
+
+	printf ("Report bugs to <http://tracker.ardour.org/>\n"
+	        "Website: <http://ardour.org/>\n");
+	::exit (EXIT_SUCCESS);
+}
+
+int main (int argc, char* argv[])
+{
+	const char *optstring = "hV";
+
+	const struct option longopts[] = {
+		{ "help",       0, 0, 'h' },
+		{ "version",    0, 0, 'V' },
+	};
+
+	int c = 0;
+	while (EOF != (c = getopt_long (argc, argv,
+					optstring, longopts, (int *) 0))) {
+		switch (c) {
+			case 'V':
+				printf ("ardour-utils version %s\n\n", VERSIONSTRING);
+				printf ("Copyright (C) GPL 2026 The Ardour Team\n");
+				exit (EXIT_SUCCESS);
+				break;
+
+			case 'h':
+				usage ();
+				break;
+
+			default:
+				cerr << "Error: unrecognized option. See --help for usage information.\n";
+				::exit (EXIT_FAILURE);
+				break;
+		}
+	}
+
+	if (optind + 2 > argc) {
+		cerr << "Error: Missing parameter. See --help for usage information.\n";
+		::exit (EXIT_FAILURE);
+	}
+
+	const string in (argv[optind]);
+	const string out (argv[optind + 1]);
+
+	XMLTree tree;
+	const bool to_xml = is_binary (in);
+
+	if (!(to_xml ? tree.read_binary (in) : tree.read (in))) {
+		cerr << "Error: cannot read session state from '" << in << "'.\n";
+		::exit (EXIT_FAILURE);
+	}
+
+	if (!to_xml) {
+		raw_automation (tree.root ());
+	}
+
+	if (!(to_xml ? tree.write (out) : tree.write_binary (out))) {
+		cerr << "Error: cannot write session state to '" << out << "'.\n";
+		::exit (EXIT_FAILURE);
+	}
+
+	return 0;
+}
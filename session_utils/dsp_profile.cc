@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2026 The Ardour Team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <getopt.h>
+#include <inttypes.h>
+#include <glibmm.h>
+
+#include <boost/bind.hpp>
+
+#include "pbd/timing.h"
+
+#include "ardour/processor.h"
+#include "ardour/route.h"
+#include "ardour/session.h"
+
+#include "common.h"
+
+using namespace std;
+using namespace ARDOUR;
+using namespace SessionUtils;
+
+static bool opt_processors = false;
+
+static void
+print_profile (string const& name, PBD::TimingHistogram& h, uint64_t period, int indent)
+{
+	if (h.n_samples () == 0) {
+		return;
+	}
+	const uint64_t max = h.max_usec ();
+	printf ("%*s%-*s %8u %8" PRIu64 " %8" PRIu64 " %8" PRIu64 "%s\n",
+	        indent, "", 32 - indent, name.substr (0, 32 - indent).c_str (),
+	        h.n_samples (), h.percentile (50), h.percentile (99), max,
+	        max > period ? "  (!)" : "");
+}
+
+static void
+print_processor (boost::weak_ptr<Processor> wp, uint64_t period)
+{
+	boost::shared_ptr<Processor> p = wp.lock ();
+	if (p) {
+		print_profile (p->display_name (), p->dsp_profile (), period, 2);
+	}
+}
+
+static void
+dsp_profile (Session* s, int seconds)
+{
+	const uint64_t period = 1000000 * (uint64_t) s->get_block_size () / s->sample_rate ();
+
+	s->reset_dsp_profiles ();
+	s->request_transport_speed (1.0);
+
+	Glib::usleep (seconds * 1000000);
+
+	s->request_transport_speed (0.0);
+
+	printf ("Cycle period: %" PRIu64 " usec (%d samples @ %" PRId64 " Hz)\n\n", period, s->get_block_size (), s->sample_rate ());
+	printf ("%-32s %8s %8s %8s %8s\n", "Name", "Cycles", "50% [us]", "99% [us]", "Max [us]");
+
+	boost::shared_ptr<RouteList> rl = s->get_routes ();
+	for (RouteList::const_iterator i = rl->begin (); i != rl->end (); ++i) {
+		print_profile ((*i)->name (), (*i)->dsp_profile (), period, 0);
+		if (opt_processors) {
+			(*i)->foreach_processor (boost::bind (&print_processor, _1, period));
+		}
+	}
+
+	printf ("\nPercentiles are the upper limit of the histogram bucket, (!) marks routes\n"
+	        "or processors that exceeded the cycle period at least once.\n");
+}
+
+static void usage () {
+	// help2man compatible format (standard GNU help-text)
+	printf (UTILNAME " - profile the DSP load of routes and processors.\n\n");
+	printf ("Usage: " UTILNAME " [ OPTIONS ] <session-dir> <session/snapshot-name>\n\n");
+	printf ("Options:\n\
+  -d, --duration <sec>       roll the session for the given time (default 10)\n\
+  -h, --help                 display this help and exit\n\
+  -p, --processors           also list all processors of every route\n\
+  -V, --version              print version information and exit\n\
+\n");
+	printf ("\n\
+This tool loads the given session using the dummy backend, starts the\n\
+transport and prints a histogram summary of the time it took to process each\n\
+route (and optionally each of the route's processors) per cycle.\n\
+\n\
+Note: the tool expects a session-name without .ardour file-name extension.\n\
+\n");
+
+	printf ("Report bugs to <http://tracker.ardour.org/>\n"
+	        "Website: <http://ardour.org/>\n");
+	::exit (EXIT_SUCCESS);
+}
+
+int main (int argc, char* argv[])
+{
+	int seconds = 10;
+
+	const char *optstring = "d:hpV";
+
+	const struct option longopts[] = {
+		{ "duration",   1, 0, 'd' },
+		{ "help",       0, 0, 'h' },
+		{ "processors", 0, 0, 'p' },
+		{ "version",    0, 0, 'V' },
+	};
+
+	int c = 0;
+	while (EOF != (c = getopt_long (argc, argv,
+					optstring, longopts, (int *) 0))) {
+		switch (c) {
+			case 'd':
+				seconds = atoi (optarg);
+				if (seconds < 1) {
+					fprintf(stderr, "Invalid duration\n");
+					::exit (EXIT_FAILURE);
+				}
+				break;
+
+			case 'p':
+				opt_processors = true;
+				break;
+
+			case 'V':
+				printf ("ardour-utils version %s\n\n", VERSIONSTRING);
+				printf ("Copyright (C) GPL 2026 The Ardour Team\n");
+				exit (EXIT_SUCCESS);
+				break;
+
+			case 'h':
+				usage ();
+				break;
+
+			default:
+				cerr << "Error: unrecognized option. See --help for usage information.\n";
+				::exit (EXIT_FAILURE);
+				break;
+		}
+	}
+
+	if (optind + 2 > argc) {
+		cerr << "Error: Missing parameter. See --help for usage information.\n";
+		::exit (EXIT_FAILURE);
+	}
+
+	SessionUtils::init (false);
+	Session* s = SessionUtils::load_session (argv[optind], argv[optind+1]);
+
+	dsp_profile (s, seconds);
+
+	SessionUtils::unload_session (s);
+	SessionUtils::cleanup ();
+
+	return 0;
+}